@@ -0,0 +1,47 @@
+#
+# Google Benchmark
+#
+option(USE_BUNDLED_BENCHMARK "Enable building of the bundled Google Benchmark" ${USE_BUNDLED_DEPS})
+
+if(BENCHMARK_INCLUDE)
+	# we already have Google Benchmark
+elseif(NOT USE_BUNDLED_BENCHMARK)
+	find_path(BENCHMARK_INCLUDE benchmark/benchmark.h)
+	find_library(BENCHMARK_LIB NAMES benchmark)
+	if(BENCHMARK_INCLUDE AND BENCHMARK_LIB)
+		message(STATUS "Found Google Benchmark: include: ${BENCHMARK_INCLUDE}, lib: ${BENCHMARK_LIB}")
+	else()
+		message(FATAL_ERROR "Couldn't find system Google Benchmark")
+	endif()
+else()
+	set(BENCHMARK_SRC "${PROJECT_BINARY_DIR}/benchmark-prefix/src/benchmark")
+	set(BENCHMARK_INCLUDE "${BENCHMARK_SRC}/include")
+	set(BENCHMARK_LIB "${BENCHMARK_SRC}/lib/${CMAKE_STATIC_LIBRARY_PREFIX}benchmark${CMAKE_STATIC_LIBRARY_SUFFIX}")
+
+	if(NOT TARGET benchmark)
+		message(STATUS "Using bundled Google Benchmark in '${BENCHMARK_SRC}'")
+
+		# The benchmarks are never installed, so neither is the library
+		ExternalProject_Add(benchmark
+			PREFIX "${PROJECT_BINARY_DIR}/benchmark-prefix"
+			GIT_REPOSITORY "https://github.com/google/benchmark.git"
+			GIT_TAG "v1.8.3"
+			BINARY_DIR "${PROJECT_BINARY_DIR}/benchmark-prefix/build"
+			BUILD_BYPRODUCTS ${BENCHMARK_LIB}
+			UPDATE_COMMAND ""
+			CMAKE_ARGS
+				-DCMAKE_BUILD_TYPE=Release
+				-DCMAKE_INSTALL_LIBDIR=lib
+				-DCMAKE_INSTALL_PREFIX=${BENCHMARK_SRC}
+				-DBENCHMARK_ENABLE_TESTING=OFF
+				-DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+				-DBENCHMARK_ENABLE_INSTALL=ON
+				-DBUILD_SHARED_LIBS=OFF)
+	endif()
+endif()
+
+if(NOT TARGET benchmark)
+	add_custom_target(benchmark)
+endif()
+
+include_directories(${BENCHMARK_INCLUDE})
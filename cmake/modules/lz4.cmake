@@ -0,0 +1,53 @@
+#
+# LZ4
+#
+option(USE_BUNDLED_LZ4 "Enable building of the bundled LZ4" ${USE_BUNDLED_DEPS})
+
+if(LZ4_INCLUDE)
+	# we already have LZ4
+elseif(NOT USE_BUNDLED_LZ4)
+	find_path(LZ4_INCLUDE lz4.h)
+	find_library(LZ4_LIB NAMES lz4)
+	if(LZ4_INCLUDE AND LZ4_LIB)
+		message(STATUS "Found LZ4: include: ${LZ4_INCLUDE}, lib: ${LZ4_LIB}")
+	else()
+		message(FATAL_ERROR "Couldn't find system LZ4")
+	endif()
+else()
+	if(WIN32)
+		message(FATAL_ERROR "Bundled LZ4 is not supported on Windows, use the system one")
+	endif()
+
+	set(LZ4_SRC "${PROJECT_BINARY_DIR}/lz4-prefix/src/lz4")
+	set(LZ4_INCLUDE "${LZ4_SRC}/lib")
+	set(LZ4_LIB "${LZ4_SRC}/lib/liblz4.a")
+
+	if(NOT TARGET lz4)
+		message(STATUS "Using bundled LZ4 in '${LZ4_SRC}'")
+
+		set(LZ4_CFLAGS "-O3")
+		if(ENABLE_PIC)
+			set(LZ4_CFLAGS "${LZ4_CFLAGS} -fPIC")
+		endif()
+
+		ExternalProject_Add(lz4
+			PREFIX "${PROJECT_BINARY_DIR}/lz4-prefix"
+			URL "https://github.com/lz4/lz4/archive/v1.9.4.tar.gz"
+			URL_HASH "SHA256=0b0e3aa07c8c063ddf40b082bdf7e37a1562bda40a0ff5272957f3e987e0e54b"
+			CONFIGURE_COMMAND ""
+			BUILD_COMMAND ${CMAKE_COMMAND} -E env "CFLAGS=${LZ4_CFLAGS}" ${CMAKE_MAKE_PROGRAM} -C lib liblz4.a
+			BUILD_IN_SOURCE 1
+			BUILD_BYPRODUCTS ${LZ4_LIB}
+			INSTALL_COMMAND "")
+		install(FILES "${LZ4_LIB}" DESTINATION "${CMAKE_INSTALL_LIBDIR}/${LIBS_PACKAGE_NAME}"
+				COMPONENT "libs-deps")
+		install(FILES "${LZ4_INCLUDE}/lz4.h" DESTINATION "${CMAKE_INSTALL_INCLUDEDIR}/${LIBS_PACKAGE_NAME}/lz4"
+				COMPONENT "libs-deps")
+	endif()
+endif()
+
+if(NOT TARGET lz4)
+	add_custom_target(lz4)
+endif()
+
+include_directories(${LZ4_INCLUDE})
@@ -4,7 +4,7 @@
 #include <syscall.h>
 #include <helpers/engines.h>
 
-scap_t* open_modern_bpf_engine(char* error_buf, int32_t* rc, unsigned long buffer_dim, uint16_t cpus_for_each_buffer, bool online_only, std::unordered_set<uint32_t> ppm_sc_set = {})
+scap_t* open_modern_bpf_engine(char* error_buf, int32_t* rc, unsigned long buffer_dim, uint16_t cpus_for_each_buffer, bool online_only, std::unordered_set<uint32_t> ppm_sc_set = {}, bool heap_consumer = false)
 {
 	struct scap_open_args oargs = {
 		.engine_name = MODERN_BPF_ENGINE,
@@ -32,6 +32,7 @@ scap_t* open_modern_bpf_engine(char* error_buf, int32_t* rc, unsigned long buffe
 		.allocate_online_only = online_only,
 		.buffer_bytes_dim = buffer_dim,
 		.verbose = false,
+		.heap_consumer = heap_consumer,
 	};
 	oargs.engine_params = &modern_bpf_params;
 
@@ -192,6 +193,29 @@ TEST(modern_bpf, read_in_order_one_buffer_shared_between_all_possible_CPUs)
 	scap_close(h);
 }
 
+TEST(modern_bpf, read_in_order_heap_consumer_one_buffer_per_online_CPU)
+{
+	char error_buffer[FILENAME_MAX] = {0};
+	int ret = 0;
+	/* We use buffers of 1 MB to be sure that we don't have drops */
+	scap_t* h = open_modern_bpf_engine(error_buffer, &ret, 1 * 1024 * 1024, 1, true, {}, true);
+	ASSERT_FALSE(!h || ret != SCAP_SUCCESS) << "unable to open modern bpf engine with the heap consumer: " << error_buffer << std::endl;
+
+	check_event_order(h);
+	scap_close(h);
+}
+
+TEST(modern_bpf, heap_consumer_one_buffer_per_possible_CPU)
+{
+	char error_buffer[FILENAME_MAX] = {0};
+	int ret = 0;
+	scap_t* h = open_modern_bpf_engine(error_buffer, &ret, 4 * 4096, 1, false, {}, true);
+	ASSERT_FALSE(!h || ret != SCAP_SUCCESS) << "unable to open modern bpf engine with the heap consumer: " << error_buffer << std::endl;
+
+	check_event_is_not_overwritten(h);
+	scap_close(h);
+}
+
 TEST(modern_bpf, scap_stats_check)
 {
 	char error_buffer[FILENAME_MAX] = {0};
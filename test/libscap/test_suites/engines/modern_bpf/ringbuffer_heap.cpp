@@ -0,0 +1,169 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+extern "C"
+{
+#include <libpman.h>
+#include <ppm_events_public.h>
+#include "state.h"
+#include "ringbuffer_definitions.h"
+}
+
+/* These tests drive the consumer of libpman with ring buffers that live in
+ * userspace memory, without loading the probe: `g_state` is set up as
+ * `pman_init_state` and the ring buffer manager would do.
+ */
+class synthetic_rings
+{
+public:
+	static constexpr unsigned long RING_SIZE = 64 * 1024;
+
+	synthetic_rings(uint16_t n_rings, uint32_t heap_rescan_interval):
+		m_rings(n_rings),
+		m_data(n_rings, std::vector<uint8_t>(RING_SIZE)),
+		m_cons(n_rings, 0),
+		m_prod(n_rings, 0),
+		m_cons_pos(n_rings, 0),
+		m_prod_pos(n_rings, 0),
+		m_heap(n_rings),
+		m_ring_in_heap(new bool[n_rings]())
+	{
+		for(uint16_t i = 0; i < n_rings; i++)
+		{
+			m_rings[i].data = m_data[i].data();
+			m_rings[i].mask = RING_SIZE - 1;
+			m_rings[i].consumer_pos = &m_cons[i];
+			m_rings[i].producer_pos = &m_prod[i];
+		}
+		m_rb.rings = m_rings.data();
+		m_rb.ring_cnt = n_rings;
+
+		pman_clear_state();
+		g_state.rb_manager = &m_rb;
+		g_state.n_required_buffers = n_rings;
+		g_state.cons_pos = m_cons_pos.data();
+		g_state.prod_pos = m_prod_pos.data();
+		g_state.last_ring_read = -1;
+		g_state.heap_consumer = true;
+		g_state.heap = m_heap.data();
+		g_state.ring_in_heap = m_ring_in_heap.get();
+		g_state.heap_rescan_interval = heap_rescan_interval;
+	}
+
+	~synthetic_rings()
+	{
+		pman_clear_state();
+	}
+
+	/* Write an event as the probe does: length header, then the event */
+	void write_event(uint16_t ring, uint64_t ts)
+	{
+		uint32_t len = sizeof(struct ppm_evt_hdr);
+		uint8_t* hdr = m_data[ring].data() + (m_prod[ring] & (RING_SIZE - 1));
+		struct ppm_evt_hdr* evt = (struct ppm_evt_hdr*)(hdr + BPF_RINGBUF_HDR_SZ);
+		evt->ts = ts;
+		evt->tid = ring;
+		evt->len = len;
+		evt->type = PPME_SYSCALL_CLOSE_E;
+		evt->nparams = 0;
+		*(uint32_t*)hdr = len;
+		m_prod[ring] += roundup_len(len);
+	}
+
+	struct ppm_evt_hdr* next_event()
+	{
+		void* evt = NULL;
+		int16_t buffer_id = -1;
+		pman_consume_first_event(&evt, &buffer_id);
+		return (struct ppm_evt_hdr*)evt;
+	}
+
+private:
+	struct ring_buffer m_rb = {};
+	std::vector<struct ring> m_rings;
+	std::vector<std::vector<uint8_t>> m_data;
+	std::vector<unsigned long> m_cons;
+	std::vector<unsigned long> m_prod;
+	std::vector<unsigned long> m_cons_pos;
+	std::vector<unsigned long> m_prod_pos;
+	std::vector<struct ring_head> m_heap;
+	std::unique_ptr<bool[]> m_ring_in_heap;
+};
+
+TEST(ringbuffer_heap, read_in_order)
+{
+	/* Every ring holds its events in order, as the probe writes them */
+	synthetic_rings rings(8, 4);
+	for(uint64_t ts = 0; ts < 100; ts++)
+	{
+		rings.write_event((ts * 7919) % 8, ts);
+	}
+	for(uint64_t ts = 0; ts < 100; ts++)
+	{
+		struct ppm_evt_hdr* evt = rings.next_event();
+		ASSERT_NE(evt, nullptr);
+		ASSERT_EQ(evt->ts, ts);
+	}
+	ASSERT_EQ(rings.next_event(), nullptr);
+}
+
+/* An event written into a ring that was empty at the last scan can be returned after
+ * at most `heap_rescan_interval` events with a later timestamp.
+ */
+TEST(ringbuffer_heap, late_event_in_empty_ring)
+{
+	for(uint32_t interval : {1, 4, 16, 64})
+	{
+		for(uint32_t written_after = 0; written_after < interval + 2; written_after++)
+		{
+			synthetic_rings rings(4, interval);
+			for(uint64_t ts = 1000; ts < 1200; ts++)
+			{
+				rings.write_event(0, ts);
+			}
+
+			for(uint32_t i = 0; i <= written_after; i++)
+			{
+				ASSERT_EQ(rings.next_event()->ts, 1000 + i);
+			}
+
+			/* The ring 3 was empty until now, and its event is older than all the ones left */
+			rings.write_event(3, 500);
+			uint32_t overtaken = 0;
+			while(true)
+			{
+				struct ppm_evt_hdr* evt = rings.next_event();
+				ASSERT_NE(evt, nullptr);
+				if(evt->ts == 500)
+				{
+					break;
+				}
+				overtaken++;
+			}
+			ASSERT_LE(overtaken, interval) << "interval " << interval << ", written after " << written_after << " events";
+			if(interval == 1)
+			{
+				/* Same order as the linear scan */
+				ASSERT_EQ(overtaken, 0);
+			}
+		}
+	}
+}
@@ -0,0 +1,292 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <scap.h>
+#include <scap_platform_api.h>
+#include <uthash_ext.h>
+#include <engine/nodriver/nodriver_public.h>
+
+static scap_t* open_nodriver(uint32_t proc_scan_threads, bool proc_scan_incremental = false)
+{
+	char error[SCAP_LASTERR_SIZE];
+	int32_t rc;
+	struct scap_open_args oargs = {};
+	struct scap_nodriver_engine_params params = {};
+
+	params.full_proc_scan = true;
+	oargs.engine_name = NODRIVER_ENGINE;
+	oargs.mode = SCAP_MODE_NODRIVER;
+	oargs.proc_scan_threads = proc_scan_threads;
+	oargs.proc_scan_incremental = proc_scan_incremental;
+	oargs.engine_params = &params;
+
+	scap_t* h = scap_open(&oargs, error, &rc);
+	EXPECT_NE(h, nullptr) << error;
+	return h;
+}
+
+static scap_threadinfo* find_thread(scap_t* h, uint64_t tid)
+{
+	scap_threadinfo* table = scap_get_proc_table(h);
+	scap_threadinfo* tinfo = NULL;
+	HASH_FIND_INT64(table, &tid, tinfo);
+	return tinfo;
+}
+
+static scap_fdinfo* find_fd(scap_threadinfo* tinfo, int64_t fd)
+{
+	scap_fdinfo* fdi = NULL;
+	HASH_FIND_INT64(tinfo->fdlist, &fd, fdi);
+	return fdi;
+}
+
+TEST(scap_proc_scan, refresh_reads_changes)
+{
+	char path[] = "/tmp/scap_proc_scan_XXXXXX";
+	int new_fd = mkstemp(path);
+	ASSERT_GE(new_fd, 0);
+	close(new_fd);
+
+	char old_comm[16] = {};
+	ASSERT_EQ(prctl(PR_GET_NAME, old_comm), 0);
+	int old_fd = open("/dev/null", O_RDONLY);
+	ASSERT_GE(old_fd, 0);
+
+	scap_t* h = open_nodriver(0);
+	ASSERT_NE(h, nullptr);
+	scap_threadinfo* tinfo = find_thread(h, getpid());
+	if(tinfo == nullptr)
+	{
+		// e.g. the cgroups of the process can't be resolved in this environment
+		scap_close(h);
+		close(old_fd);
+		unlink(path);
+		GTEST_SKIP() << "The /proc scan can't read the test process";
+	}
+	ASSERT_STREQ(tinfo->comm, old_comm);
+	ASSERT_NE(find_fd(tinfo, old_fd), nullptr);
+
+	// rename the thread, and swap an fd for another one
+	ASSERT_EQ(prctl(PR_SET_NAME, "rescanned"), 0);
+	close(old_fd);
+	new_fd = open(path, O_RDONLY);
+	ASSERT_GE(new_fd, 0);
+
+	ASSERT_EQ(scap_refresh_proc_table(h), SCAP_SUCCESS);
+	tinfo = find_thread(h, getpid());
+	ASSERT_NE(tinfo, nullptr);
+	EXPECT_STREQ(tinfo->comm, "rescanned");
+	if(new_fd != old_fd)
+	{
+		EXPECT_EQ(find_fd(tinfo, old_fd), nullptr);
+	}
+	scap_fdinfo* fdi = find_fd(tinfo, new_fd);
+	ASSERT_NE(fdi, nullptr);
+	EXPECT_EQ(fdi->type, SCAP_FD_FILE_V2);
+	EXPECT_STREQ(fdi->info.regularinfo.fname, path);
+
+	scap_close(h);
+	close(new_fd);
+	unlink(path);
+	prctl(PR_SET_NAME, old_comm);
+}
+
+static void check_incremental_refresh(uint32_t proc_scan_threads)
+{
+	char old_comm[16] = {};
+	ASSERT_EQ(prctl(PR_GET_NAME, old_comm), 0);
+	int old_fd = open("/dev/null", O_RDONLY);
+	ASSERT_GE(old_fd, 0);
+
+	// a child that runs /bin/sleep once the first scan is done
+	int go[2];
+	int exec_done[2];
+	ASSERT_EQ(pipe(go), 0);
+	ASSERT_EQ(pipe2(exec_done, O_CLOEXEC), 0);
+	pid_t child = fork();
+	ASSERT_GE(child, 0);
+	if(child == 0)
+	{
+		char c;
+		close(go[1]);
+		close(exec_done[0]);
+		if(read(go[0], &c, 1) == 1)
+		{
+			execl("/bin/sleep", "sleep", "60", (char*)NULL);
+		}
+		_exit(1);
+	}
+	close(go[0]);
+	close(exec_done[1]);
+
+	scap_t* h = open_nodriver(proc_scan_threads, true);
+	scap_threadinfo* tinfo = h ? find_thread(h, getpid()) : nullptr;
+	scap_threadinfo* child_tinfo = h ? find_thread(h, child) : nullptr;
+	bool scanned = tinfo != nullptr && child_tinfo != nullptr;
+	if(scanned)
+	{
+		EXPECT_STREQ(tinfo->comm, old_comm);
+		EXPECT_STREQ(child_tinfo->exepath, tinfo->exepath);
+
+		// the test process keeps its start time and executable, the child
+		// runs another executable
+		EXPECT_EQ(prctl(PR_SET_NAME, "rescanned"), 0);
+		EXPECT_EQ(write(go[1], "x", 1), 1);
+		char c;
+		EXPECT_EQ(read(exec_done[0], &c, 1), 0);
+
+		EXPECT_EQ(scap_refresh_proc_table(h), SCAP_SUCCESS);
+		scap_threadinfo* reused = find_thread(h, getpid());
+		ASSERT_NE(reused, nullptr);
+		EXPECT_EQ(reused, tinfo);
+		EXPECT_STREQ(reused->comm, old_comm);
+		EXPECT_NE(find_fd(reused, old_fd), nullptr);
+
+		child_tinfo = find_thread(h, child);
+		ASSERT_NE(child_tinfo, nullptr);
+		char sleep_path[PATH_MAX];
+		ASSERT_NE(realpath("/bin/sleep", sleep_path), nullptr);
+		EXPECT_STREQ(child_tinfo->exepath, sleep_path);
+	}
+
+	if(h != nullptr)
+	{
+		scap_close(h);
+	}
+	close(go[1]);
+	close(exec_done[0]);
+	kill(child, SIGKILL);
+	waitpid(child, NULL, 0);
+	close(old_fd);
+	prctl(PR_SET_NAME, old_comm);
+	if(!scanned)
+	{
+		// e.g. the cgroups of the process can't be resolved in this environment
+		GTEST_SKIP() << "The /proc scan can't read the test processes";
+	}
+}
+
+TEST(scap_proc_scan, incremental_refresh_reuses_unchanged)
+{
+	check_incremental_refresh(0);
+}
+
+TEST(scap_proc_scan, parallel_incremental_refresh_reuses_unchanged)
+{
+	check_incremental_refresh(4);
+}
+
+// The fields of a thread that don't depend on when the scan ran
+static std::string thread_summary(scap_threadinfo* tinfo)
+{
+	std::string s = std::to_string(tinfo->pid) + "," + std::to_string(tinfo->ptid) + "," +
+			std::to_string(tinfo->vtid) + "," + std::to_string(tinfo->vpid) + "," +
+			std::to_string(tinfo->uid) + "," + std::to_string(tinfo->gid) + "," +
+			std::to_string(tinfo->flags) + "," + tinfo->comm + "," + tinfo->exe + "," +
+			tinfo->exepath + "," + tinfo->cwd + "," + tinfo->root + "," +
+			std::string(tinfo->args, tinfo->args_len) + "," +
+			std::string(tinfo->cgroups.path, tinfo->cgroups.len);
+
+	scap_fdinfo* fdi;
+	scap_fdinfo* tfdi;
+	std::map<int64_t, std::string> fds;
+	HASH_ITER(hh, tinfo->fdlist, fdi, tfdi)
+	{
+		fds[fdi->fd] = std::to_string(fdi->type) + ":" + std::to_string(fdi->ino);
+	}
+	for(const auto& fd : fds)
+	{
+		s += "," + std::to_string(fd.first) + "=" + fd.second;
+	}
+	return s;
+}
+
+static std::map<uint64_t, std::string> scan(uint32_t proc_scan_threads)
+{
+	std::map<uint64_t, std::string> threads;
+	scap_t* h = open_nodriver(proc_scan_threads);
+	if(h == nullptr)
+	{
+		return threads;
+	}
+
+	scap_threadinfo* tinfo;
+	scap_threadinfo* ttinfo;
+	HASH_ITER(hh, scap_get_proc_table(h), tinfo, ttinfo)
+	{
+		// the fds and threads of the scanning process are the scan's own
+		if(tinfo->pid != (uint64_t)getpid())
+		{
+			threads[tinfo->tid] = thread_summary(tinfo);
+		}
+	}
+	scap_close(h);
+	return threads;
+}
+
+TEST(scap_proc_scan, parallel_matches_serial)
+{
+	// the processes that don't change between two serial scans must be
+	// found by the parallel scan in between, with the same fields and fds
+	auto before = scan(0);
+	auto parallel = scan(4);
+	auto after = scan(0);
+	if(before.empty())
+	{
+		GTEST_SKIP() << "The /proc scan can't read any process";
+	}
+
+	uint64_t stable = 0;
+	for(const auto& t : before)
+	{
+		auto it = after.find(t.first);
+		if(it == after.end() || it->second != t.second)
+		{
+			continue;
+		}
+		stable++;
+		auto pt = parallel.find(t.first);
+		ASSERT_NE(pt, parallel.end()) << "tid " << t.first;
+		EXPECT_EQ(pt->second, t.second) << "tid " << t.first;
+	}
+	ASSERT_GT(stable, 0);
+
+	// nothing that the serial scans didn't see, unless it was short-lived
+	for(const auto& t : parallel)
+	{
+		if(before.count(t.first) == 0 && after.count(t.first) == 0)
+		{
+			std::string path = "/proc/" + std::to_string(t.first);
+			EXPECT_NE(access(path.c_str(), F_OK), 0) << "tid " << t.first;
+		}
+	}
+}
@@ -0,0 +1,128 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifndef _WIN32
+
+#include <gtest/gtest.h>
+#include <engine/savefile/scap_reader.h>
+#include <unistd.h>
+#include <vector>
+
+#define DATA_SIZE 100000
+#define BLOCK_SIZE 1000
+#define NUM_BLOCKS 3
+
+static uint8_t data_at(int64_t pos)
+{
+	return (uint8_t)((pos * 31) ^ (pos >> 8));
+}
+
+class scap_reader_prefetch_test : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		int fd = mkstemp(m_path);
+		ASSERT_NE(fd, -1);
+		gzFile f = gzdopen(fd, "wb");
+		ASSERT_NE(f, nullptr);
+		std::vector<uint8_t> data(DATA_SIZE);
+		for(int64_t i = 0; i < DATA_SIZE; i++)
+		{
+			data[i] = data_at(i);
+		}
+		ASSERT_EQ(gzwrite(f, data.data(), DATA_SIZE), DATA_SIZE);
+		gzclose(f);
+
+		gzFile in = gzopen(m_path, "rb");
+		ASSERT_NE(in, nullptr);
+		m_reader = scap_reader_open_prefetch(scap_reader_open_gzfile(in), BLOCK_SIZE, NUM_BLOCKS, true);
+		ASSERT_NE(m_reader, nullptr);
+	}
+
+	void TearDown() override
+	{
+		if(m_reader != nullptr)
+		{
+			m_reader->close(m_reader);
+		}
+		unlink(m_path);
+	}
+
+	void assert_read(uint32_t len)
+	{
+		std::vector<uint8_t> buf(len);
+		int64_t pos = m_reader->tell(m_reader);
+		ASSERT_EQ(m_reader->read(m_reader, buf.data(), len), (int)len);
+		for(uint32_t i = 0; i < len; i++)
+		{
+			ASSERT_EQ(buf[i], data_at(pos + i)) << "at position " << pos + i;
+		}
+		ASSERT_EQ(m_reader->tell(m_reader), pos + len);
+	}
+
+	char m_path[64] = "/tmp/scap_reader_prefetch_XXXXXX";
+	scap_reader_t* m_reader = nullptr;
+};
+
+TEST_F(scap_reader_prefetch_test, sequential_read)
+{
+	// read sizes that don't align with the block size
+	int64_t total = 0;
+	uint32_t len = 1;
+	while(total + len <= DATA_SIZE)
+	{
+		assert_read(len);
+		total += len;
+		len = (len * 7 + 3) % 2500 + 1;
+	}
+
+	// a read past the end of data returns the remaining bytes only
+	std::vector<uint8_t> buf(DATA_SIZE);
+	ASSERT_EQ(m_reader->read(m_reader, buf.data(), DATA_SIZE), (int)(DATA_SIZE - total));
+	ASSERT_EQ(m_reader->read(m_reader, buf.data(), 1), 0);
+	int err = 0;
+	m_reader->error(m_reader, &err);
+	ASSERT_EQ(err, 0);
+}
+
+TEST_F(scap_reader_prefetch_test, seek)
+{
+	assert_read(500);
+
+	// backward inside the current block
+	ASSERT_EQ(m_reader->seek(m_reader, -200, SEEK_CUR), 300);
+	assert_read(100);
+
+	// forward across several blocks
+	ASSERT_EQ(m_reader->seek(m_reader, 12345, SEEK_CUR), 12745);
+	assert_read(2000);
+
+	// backward outside the current block
+	ASSERT_EQ(m_reader->seek(m_reader, -5000, SEEK_CUR), 9745);
+	assert_read(3000);
+
+	// absolute
+	ASSERT_EQ(m_reader->seek(m_reader, 42, SEEK_SET), 42);
+	assert_read(DATA_SIZE - 42);
+
+	// skipping past the end of data is an error
+	ASSERT_EQ(m_reader->seek(m_reader, 0, SEEK_SET), 0);
+	ASSERT_LT(m_reader->seek(m_reader, DATA_SIZE + 1, SEEK_CUR), 0);
+}
+
+#endif // _WIN32
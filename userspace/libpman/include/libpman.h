@@ -53,9 +53,14 @@ extern "C"
 	 * @param buf_bytes_dim dimension of a single per-CPU buffer in bytes.
 	 * @param cpus_for_each_buffer number of CPUs to which we want to associate a ring buffer.
 	 * @param allocate_online_only if true, allocate ring buffers taking only into account online CPUs.
+	 * @param heap_consumer if true, merge the ring buffers through a min-heap of their
+	 * first events instead of scanning all the ring buffers for every event.
+	 * @param heap_rescan_interval in heap consumer mode, number of consumed events after
+	 * which the ring buffers that were empty are read again. `0` selects the default (16).
+	 * See `pman_consume_first_event` for the effect on the order of the events.
 	 * @return `0` on success, `-1` in case of error.
 	 */
-	int pman_init_state(bool verbosity, unsigned long buf_bytes_dim, uint16_t cpus_for_each_buffer, bool allocate_online_only);
+	int pman_init_state(bool verbosity, unsigned long buf_bytes_dim, uint16_t cpus_for_each_buffer, bool allocate_online_only, bool heap_consumer, uint32_t heap_rescan_interval);
 
 	/**
 	 * @brief Clear the `libpman` global state before it is used.
@@ -265,6 +270,16 @@ extern "C"
 	 * @brief Search for the event with the lowest timestamp in
 	 * all the ring buffers.
 	 *
+	 * In heap consumer mode (see `pman_init_state`) the first event of
+	 * every ring buffer is kept in a min-heap, so only the ring buffer
+	 * we have just consumed is read again. The ring buffers that were
+	 * empty are read again only when the heap is empty or after we have
+	 * consumed `heap_rescan_interval` events. This relaxes the order of
+	 * the events: an event written into a ring buffer that was empty at
+	 * the last read can be returned after at most `heap_rescan_interval`
+	 * events with a later timestamp. With `heap_rescan_interval` set to
+	 * `1` the order is the one of the linear scan.
+	 *
 	 * @param event_ptr in case of success return a pointer
 	 * to the event, otherwise return NULL.
 	 * @param buffer_id in case of success returns the id of the ring buffer
@@ -272,6 +287,20 @@ extern "C"
 	 */
 	void pman_consume_first_event(void** event_ptr, int16_t* buffer_id);
 
+	/**
+	 * @brief Same as `pman_consume_first_event` but returns up to
+	 * `max_events` events ordered by timestamp. All the returned
+	 * events remain valid until the next consume call.
+	 *
+	 * @param event_ptrs array of at least `max_events` pointers, filled
+	 * with the consumed events.
+	 * @param buffer_ids array of at least `max_events` ids, filled with the
+	 * ids of the ring buffers from which we retrieved the events.
+	 * @param max_events maximum number of events to consume.
+	 * @param n_events number of consumed events, `0` if there are no events.
+	 */
+	void pman_consume_first_events(void** event_ptrs, int16_t* buffer_ids, uint32_t max_events, uint32_t* n_events);
+
 	/////////////////////////////
 	// CAPTURE (EXCHANGE VALUES WITH BPF SIDE)
 	/////////////////////////////
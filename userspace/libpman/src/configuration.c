@@ -61,11 +61,18 @@ void pman_clear_state()
 	g_state.buffer_bytes_dim = 0;
 	g_state.last_ring_read = -1;
 	g_state.last_event_size = 0;
+	g_state.unpublished_cons_pos = false;
+	g_state.heap_consumer = false;
+	g_state.heap = NULL;
+	g_state.ring_in_heap = NULL;
+	g_state.heap_size = 0;
+	g_state.heap_pops = 0;
+	g_state.heap_rescan_interval = 0;
 	g_state.n_attached_progs = 0;
 	g_state.stats = NULL;
 }
 
-int pman_init_state(bool verbosity, unsigned long buf_bytes_dim, uint16_t cpus_for_each_buffer, bool allocate_online_only)
+int pman_init_state(bool verbosity, unsigned long buf_bytes_dim, uint16_t cpus_for_each_buffer, bool allocate_online_only, bool heap_consumer, uint32_t heap_rescan_interval)
 {
 	char error_message[MAX_ERROR_MESSAGE_LEN];
 
@@ -156,6 +163,11 @@ int pman_init_state(bool verbosity, unsigned long buf_bytes_dim, uint16_t cpus_f
 	/* These will be used during the ring buffer consumption phase. */
 	g_state.last_ring_read = -1;
 	g_state.last_event_size = 0;
+	g_state.unpublished_cons_pos = false;
+	g_state.heap_consumer = heap_consumer;
+	g_state.heap_size = 0;
+	g_state.heap_pops = 0;
+	g_state.heap_rescan_interval = heap_rescan_interval ? heap_rescan_interval : DEFAULT_HEAP_RESCAN_INTERVAL;
 	return 0;
 }
 
@@ -89,6 +89,16 @@ void pman_close_probe()
 		free(g_state.prod_pos);
 	}
 
+	if(g_state.heap)
+	{
+		free(g_state.heap);
+	}
+
+	if(g_state.ring_in_heap)
+	{
+		free(g_state.ring_in_heap);
+	}
+
 	if(g_state.skel)
 	{
 		bpf_probe__detach(g_state.skel);
@@ -78,6 +78,19 @@ static int allocate_consumer_producer_positions()
 		pman_print_error("failed to alloc memory for cons_pos and prod_pos");
 		return errno;
 	}
+
+	if(g_state.heap_consumer)
+	{
+		g_state.heap_size = 0;
+		g_state.heap_pops = 0;
+		g_state.heap = (struct ring_head *)calloc(g_state.n_required_buffers, sizeof(struct ring_head));
+		g_state.ring_in_heap = (bool *)calloc(g_state.n_required_buffers, sizeof(bool));
+		if(g_state.heap == NULL || g_state.ring_in_heap == NULL)
+		{
+			pman_print_error("failed to alloc memory for the ring buffers heap");
+			return errno;
+		}
+	}
 	return 0;
 }
 
@@ -276,6 +289,56 @@ static inline void *ringbuf__get_first_ring_event(struct ring *r, int pos)
 	return sample;
 }
 
+static inline void ringbuf__heap_push_ring(struct ring_buffer *rb, uint16_t ring_id);
+
+/* If the last consume operation was successful move the consumer position after the event we have read.
+ * When `publish` is false the new position is only stored locally: the producer cannot overwrite
+ * the event until we call `ringbuf__publish_consumer_positions`.
+ */
+static inline void ringbuf__advance_last_ring(struct ring_buffer *rb, bool publish)
+{
+	int ring_id = g_state.last_ring_read;
+	if(ring_id == -1)
+	{
+		return;
+	}
+
+	g_state.cons_pos[ring_id] += g_state.last_event_size;
+	if(publish)
+	{
+		smp_store_release(rb->rings[ring_id].consumer_pos, g_state.cons_pos[ring_id]);
+	}
+	else
+	{
+		g_state.unpublished_cons_pos = true;
+	}
+	g_state.last_ring_read = -1;
+	g_state.last_event_size = 0;
+
+	/* In heap consumer mode only the consumed ring can have a new first event. */
+	if(g_state.heap_consumer)
+	{
+		ringbuf__heap_push_ring(rb, ring_id);
+	}
+}
+
+static inline void ringbuf__publish_consumer_positions(struct ring_buffer *rb)
+{
+	if(!g_state.unpublished_cons_pos)
+	{
+		return;
+	}
+
+	for(uint16_t pos = 0; pos < rb->ring_cnt; pos++)
+	{
+		if(*rb->rings[pos].consumer_pos != g_state.cons_pos[pos])
+		{
+			smp_store_release(rb->rings[pos].consumer_pos, g_state.cons_pos[pos]);
+		}
+	}
+	g_state.unpublished_cons_pos = false;
+}
+
 static void ringbuf__consume_first_event(struct ring_buffer *rb, struct ppm_evt_hdr **event_ptr, int16_t *buffer_id)
 {
 	uint64_t min_ts = 0xffffffffffffffffLL;
@@ -283,14 +346,6 @@ static void ringbuf__consume_first_event(struct ring_buffer *rb, struct ppm_evt_
 	int tmp_ring = -1;
 	unsigned long tmp_cons_increment = 0;
 
-	/* If the last consume operation was successful we can push the consumer position */
-	if(g_state.last_ring_read != -1)
-	{
-		struct ring *r = &(rb->rings[g_state.last_ring_read]);
-		g_state.cons_pos[g_state.last_ring_read] += g_state.last_event_size;
-		smp_store_release(r->consumer_pos, g_state.cons_pos[g_state.last_ring_read]);
-	}
-
 	for(uint16_t pos = 0; pos < rb->ring_cnt; pos++)
 	{
 		*event_ptr = ringbuf__get_first_ring_event(&rb->rings[pos], pos);
@@ -316,8 +371,182 @@ static void ringbuf__consume_first_event(struct ring_buffer *rb, struct ppm_evt_
 	g_state.last_event_size = tmp_cons_increment;
 }
 
+/* Heap consumer mode.
+ *
+ * Scanning all the ring buffers for every event costs one header read for each ring,
+ * even if only the ring we have just consumed can have a different first event.
+ * Here we keep the first events in a min-heap ordered by timestamp: after a consume
+ * operation only the consumed ring is read again and pushed back into the heap.
+ *
+ * A ring that is empty (or whose first event is not yet committed) leaves the heap,
+ * so we periodically read again the rings outside the heap to pick up new events. This happens
+ * when the heap is empty or when we have consumed `heap_rescan_interval` events since the last
+ * scan, so the cost of the scan is amortized over the consumed events.
+ *
+ * The price is a weaker ordering than the linear scan: an event written into a ring outside
+ * the heap is seen only at the next scan, so up to `heap_rescan_interval` events with a later
+ * timestamp can be returned before it. The interval bounds this reordering, and with an
+ * interval of 1 the rings outside the heap are read before every event, as the linear scan does.
+ */
+
+static inline void ringbuf__heap_swap(struct ring_head *a, struct ring_head *b)
+{
+	struct ring_head tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+static inline void ringbuf__heap_sift_up(uint32_t pos)
+{
+	struct ring_head *heap = g_state.heap;
+	while(pos > 0)
+	{
+		uint32_t parent = (pos - 1) / 2;
+		if(heap[parent].ts <= heap[pos].ts)
+		{
+			break;
+		}
+		ringbuf__heap_swap(&heap[parent], &heap[pos]);
+		pos = parent;
+	}
+}
+
+static inline void ringbuf__heap_sift_down(uint32_t pos)
+{
+	struct ring_head *heap = g_state.heap;
+	while(true)
+	{
+		uint32_t min = pos;
+		uint32_t left = 2 * pos + 1;
+		uint32_t right = left + 1;
+		if(left < g_state.heap_size && heap[left].ts < heap[min].ts)
+		{
+			min = left;
+		}
+		if(right < g_state.heap_size && heap[right].ts < heap[min].ts)
+		{
+			min = right;
+		}
+		if(min == pos)
+		{
+			break;
+		}
+		ringbuf__heap_swap(&heap[min], &heap[pos]);
+		pos = min;
+	}
+}
+
+/* Read the first event of the ring and, if there is one, push it into the heap.
+ * `ringbuf__get_first_ring_event` only refreshes the producer position of a ring it finds empty,
+ * and the linear scan sees the new events at the next call. A ring outside the heap is read again
+ * only at the next scan, so here we refresh the producer position first.
+ */
+static inline void ringbuf__heap_push_ring(struct ring_buffer *rb, uint16_t ring_id)
+{
+	if(g_state.cons_pos[ring_id] >= g_state.prod_pos[ring_id])
+	{
+		g_state.prod_pos[ring_id] = smp_load_acquire(rb->rings[ring_id].producer_pos);
+	}
+
+	struct ppm_evt_hdr *evt = ringbuf__get_first_ring_event(&rb->rings[ring_id], ring_id);
+	if(evt == NULL)
+	{
+		return;
+	}
+
+	struct ring_head *node = &g_state.heap[g_state.heap_size];
+	node->ts = evt->ts;
+	node->evt = evt;
+	node->evt_size = g_state.last_event_size;
+	node->ring_id = ring_id;
+	g_state.ring_in_heap[ring_id] = true;
+	ringbuf__heap_sift_up(g_state.heap_size++);
+}
+
+static void ringbuf__heap_scan_idle_rings(struct ring_buffer *rb)
+{
+	g_state.heap_pops = 0;
+	for(uint16_t pos = 0; pos < rb->ring_cnt; pos++)
+	{
+		if(!g_state.ring_in_heap[pos])
+		{
+			ringbuf__heap_push_ring(rb, pos);
+		}
+	}
+}
+
+static void ringbuf__heap_consume_first_event(struct ring_buffer *rb, struct ppm_evt_hdr **event_ptr, int16_t *buffer_id)
+{
+	if(g_state.heap_size == 0 || g_state.heap_pops >= g_state.heap_rescan_interval)
+	{
+		ringbuf__heap_scan_idle_rings(rb);
+	}
+
+	if(g_state.heap_size == 0)
+	{
+		*event_ptr = NULL;
+		*buffer_id = -1;
+		g_state.last_ring_read = -1;
+		g_state.last_event_size = 0;
+		return;
+	}
+
+	/* Pop the first event of the heap, the ring will be pushed again at the next call. */
+	struct ring_head min = g_state.heap[0];
+	g_state.heap[0] = g_state.heap[--g_state.heap_size];
+	ringbuf__heap_sift_down(0);
+	g_state.ring_in_heap[min.ring_id] = false;
+	g_state.heap_pops++;
+
+	*event_ptr = min.evt;
+	*buffer_id = min.ring_id;
+	g_state.last_ring_read = min.ring_id;
+	g_state.last_event_size = min.evt_size;
+}
+
+static inline void ringbuf__select_first_event(struct ring_buffer *rb, struct ppm_evt_hdr **event_ptr, int16_t *buffer_id)
+{
+	if(g_state.heap_consumer)
+	{
+		ringbuf__heap_consume_first_event(rb, event_ptr, buffer_id);
+		return;
+	}
+	ringbuf__consume_first_event(rb, event_ptr, buffer_id);
+}
+
 /* Consume */
 void pman_consume_first_event(void **event_ptr, int16_t *buffer_id)
 {
-	ringbuf__consume_first_event(g_state.rb_manager, (struct ppm_evt_hdr **)event_ptr, buffer_id);
+	struct ring_buffer *rb = g_state.rb_manager;
+
+	ringbuf__publish_consumer_positions(rb);
+	ringbuf__advance_last_ring(rb, true);
+	ringbuf__select_first_event(rb, (struct ppm_evt_hdr **)event_ptr, buffer_id);
+}
+
+void pman_consume_first_events(void **event_ptrs, int16_t *buffer_ids, uint32_t max_events, uint32_t *n_events)
+{
+	struct ring_buffer *rb = g_state.rb_manager;
+
+	ringbuf__publish_consumer_positions(rb);
+	ringbuf__advance_last_ring(rb, true);
+
+	*n_events = 0;
+	while(*n_events < max_events)
+	{
+		ringbuf__select_first_event(rb, (struct ppm_evt_hdr **)&event_ptrs[*n_events], &buffer_ids[*n_events]);
+		if(event_ptrs[*n_events] == NULL)
+		{
+			break;
+		}
+		(*n_events)++;
+
+		/* The events of the batch must stay valid until the next call, so we move the consumer
+		 * positions only locally. The last event follows the usual path of `pman_consume_first_event`.
+		 */
+		if(*n_events < max_events)
+		{
+			ringbuf__advance_last_ring(rb, false);
+		}
+	}
 }
@@ -26,11 +26,23 @@ limitations under the License.
 
 #define MAX_ERROR_MESSAGE_LEN 200
 
+/* Events consumed in heap consumer mode before reading again the ring buffers that were empty */
+#define DEFAULT_HEAP_RESCAN_INTERVAL 16
+
 /* Pay attention this need to be bumped every time we add a new bpf program that is directly attached into the kernel */
 #define MODERN_BPF_PROG_ATTACHED_MAX 9
 
 struct scap_stats_v2;
 
+/* Node of the min-heap used by the heap consumer mode. */
+struct ring_head
+{
+	uint64_t ts;		/* timestamp of the first event in the ring. */
+	void* evt;		/* pointer to the first event in the ring. */
+	unsigned long evt_size; /* size of the first event, used to increment the consumer position. */
+	uint16_t ring_id;	/* ring buffer that holds the event. */
+};
+
 struct internal_state
 {
 	struct bpf_probe* skel;		/* bpf skeleton with all programs and maps. */
@@ -47,6 +59,13 @@ struct internal_state
 	unsigned long buffer_bytes_dim; /* dimension of a single per-CPU ringbuffer in bytes. */
 	int last_ring_read;		/* Last ring from which we have correctly read an event. Could be `-1` if there were no successful reads. */
 	unsigned long last_event_size;	/* Last event correctly read. Could be `0` if there were no successful reads. */
+	bool unpublished_cons_pos;	/* If true some consumer positions were moved only locally while reading a batch of events. */
+	bool heap_consumer;		/* If true we merge the ring buffers through a min-heap instead of scanning all of them for every event. */
+	struct ring_head* heap;		/* min-heap of ring heads ordered by timestamp, used only in heap consumer mode. */
+	bool* ring_in_heap;		/* for every ring buffer, true if its first event is inside the heap. */
+	uint32_t heap_size;		/* number of ring heads currently inside the heap. */
+	uint32_t heap_pops;		/* events consumed since the last full scan of the ring buffers. */
+	uint32_t heap_rescan_interval;	/* events consumed after which the ring buffers outside the heap are read again. */
 
 	/* Stats v2 utilities */
 	int32_t attached_progs_fds[MODERN_BPF_PROG_ATTACHED_MAX]; /* file descriptors of attached programs, used to collect stats */
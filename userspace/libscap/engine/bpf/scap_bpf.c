@@ -1836,6 +1836,11 @@ static int32_t next(struct scap_engine_handle engine, OUT scap_evt** pevent, OUT
 	return ringbuffer_next(&engine.m_handle->m_dev_set, pevent, pcpuid);
 }
 
+static int32_t next_batch(struct scap_engine_handle engine, uint32_t max_evts, OUT scap_evt** pevents, OUT uint16_t* pcpuids, OUT uint32_t* nevts)
+{
+	return ringbuffer_next_batch(&engine.m_handle->m_dev_set, max_evts, pevents, pcpuids, nevts);
+}
+
 static int32_t unsupported_config(struct scap_engine_handle engine, const char* msg)
 {
 	struct bpf_engine* handle = engine.m_handle;
@@ -2035,6 +2040,7 @@ const struct scap_vtable scap_bpf_engine = {
 	.free_handle = free_handle,
 	.close = scap_bpf_close,
 	.next = next,
+	.next_batch = next_batch,
 	.start_capture = scap_bpf_start_capture,
 	.stop_capture = scap_bpf_stop_capture,
 	.configure = configure,
@@ -525,6 +525,11 @@ int32_t scap_kmod_next(struct scap_engine_handle engine, OUT scap_evt** pevent,
 	return ringbuffer_next(&engine.m_handle->m_dev_set, pevent, pcpuid);
 }
 
+int32_t scap_kmod_next_batch(struct scap_engine_handle engine, uint32_t max_evts, OUT scap_evt** pevents, OUT uint16_t* pcpuids, OUT uint32_t* nevts)
+{
+	return ringbuffer_next_batch(&engine.m_handle->m_dev_set, max_evts, pevents, pcpuids, nevts);
+}
+
 uint32_t scap_kmod_get_n_devs(struct scap_engine_handle engine)
 {
 	return engine.m_handle->m_dev_set.m_ndevs;
@@ -986,6 +991,7 @@ struct scap_vtable scap_kmod_engine = {
 	.free_handle = free_handle,
 	.close = scap_kmod_close,
 	.next = scap_kmod_next,
+	.next_batch = scap_kmod_next_batch,
 	.start_capture = scap_kmod_start_capture,
 	.stop_capture = scap_kmod_stop_capture,
 	.configure = configure,
@@ -29,6 +29,8 @@ extern "C"
 		bool allocate_online_only; ///< [EXPERIMENTAL] Allocate ring buffers only for online CPUs. The number of ring buffers allocated changes according to the `cpus_for_each_buffer` param. Please note: this buffer will be mapped twice both kernel and userspace-side, so pay attention to its size.
 		unsigned long buffer_bytes_dim; ///< Dimension of a ring buffer in bytes. The number of ring buffers allocated changes according to the `cpus_for_each_buffer` param. Please note: this buffer will be mapped twice both kernel and userspace-side, so pay attention to its size.
 		bool verbose; ///< [EXPERIMENTAL] Use libbpf in verbose mode.
+		bool heap_consumer; ///< [EXPERIMENTAL] Keep the first event of every ring buffer in a min-heap, so that only the consumed ring buffer is read again for every event. Useful when many ring buffers are allocated.
+		uint32_t heap_rescan_interval; ///< [EXPERIMENTAL] With `heap_consumer`, number of events after which the empty ring buffers are read again, 0 for the default. An event can be returned after at most this number of events with a later timestamp, 1 gives the same order as without `heap_consumer`.
 	};
 
 #ifdef __cplusplus
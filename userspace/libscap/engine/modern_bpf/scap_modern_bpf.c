@@ -66,6 +66,24 @@ static int32_t scap_modern_bpf__next(struct scap_engine_handle engine, OUT scap_
 	return SCAP_SUCCESS;
 }
 
+static int32_t scap_modern_bpf__next_batch(struct scap_engine_handle engine, uint32_t max_evts, OUT scap_evt** pevents, OUT uint16_t* buffer_ids, OUT uint32_t* nevts)
+{
+	pman_consume_first_events((void**)pevents, (int16_t*)buffer_ids, max_evts, nevts);
+
+	if((*nevts) == 0)
+	{
+		/* Same backoff as `scap_modern_bpf__next`. */
+		usleep(engine.m_handle->m_retry_us);
+		engine.m_handle->m_retry_us = MIN(engine.m_handle->m_retry_us * 2, BUFFER_EMPTY_WAIT_TIME_US_MAX);
+		return SCAP_TIMEOUT;
+	}
+	else
+	{
+		engine.m_handle->m_retry_us = BUFFER_EMPTY_WAIT_TIME_US_START;
+	}
+	return SCAP_SUCCESS;
+}
+
 static int32_t scap_modern_bpf_start_dropping_mode(struct scap_engine_handle engine, uint32_t sampling_ratio)
 {
 	pman_set_sampling_ratio(sampling_ratio);
@@ -179,7 +197,7 @@ int32_t scap_modern_bpf__init(scap_t* handle, scap_open_args* oargs)
 	 * Validation of `cpus_for_each_buffer` is made inside libpman
 	 * since this is the unique place where we have the number of CPUs
 	 */
-	if(pman_init_state(params->verbose, params->buffer_bytes_dim, params->cpus_for_each_buffer, params->allocate_online_only))
+	if(pman_init_state(params->verbose, params->buffer_bytes_dim, params->cpus_for_each_buffer, params->allocate_online_only, params->heap_consumer, params->heap_rescan_interval))
 	{
 		snprintf(handle->m_lasterr, SCAP_LASTERR_SIZE, "unable to configure the libpman state.");
 		return SCAP_FAILURE;
@@ -280,6 +298,7 @@ struct scap_vtable scap_modern_bpf_engine = {
 	.free_handle = scap_modern_bpf__free_engine,
 	.close = scap_modern_bpf__close,
 	.next = scap_modern_bpf__next,
+	.next_batch = scap_modern_bpf__next_batch,
 	.start_capture = scap_modern_bpf__start_capture,
 	.stop_capture = scap_modern_bpf__stop_capture,
 	.configure = scap_modern_bpf__configure,
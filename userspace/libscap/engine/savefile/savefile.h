@@ -24,6 +24,7 @@ limitations under the License.
 #include "scap_savefile.h"
 
 #define READER_BUF_SIZE (1 << 16) // UINT16_MAX + 1, ie: 65536
+#define READER_PREFETCH_BLOCK_SIZE (1 << 20)
 
 #define CHECK_READ_SIZE_ERR(read_size, expected_size, error) if(read_size != expected_size) \
 	{\
@@ -103,5 +104,8 @@ struct savefile_engine
 	char* m_reader_evt_buf;
 	size_t m_reader_evt_buf_size;
 	uint32_t m_last_evt_dump_flags;
+	int64_t m_events_pos; // Position of the first event block
+	index_block_entry* m_index; // Time index loaded from the end of the file
+	uint32_t m_index_len;
 };
 
@@ -28,6 +28,7 @@ extern "C"
 		const char* fname;     ///< The name of the file to open.
 		uint64_t start_offset; ///< Used to start reading a capture file from an arbitrary offset. This is leveraged when opening merged files.
 		uint32_t fbuffer_size; ///< If non-zero, offline captures will read from file using a buffer of this size.
+		uint32_t prefetch_blocks; ///< If non-zero, the file is read and decompressed ahead on a background thread, in up to this many blocks of fbuffer_size bytes (or a default size if fbuffer_size is zero).
 	};
 
 	struct scap_platform;
@@ -98,6 +98,47 @@ scap_reader_t *scap_reader_open_gzfile(gzFile file);
  */
 scap_reader_t *scap_reader_open_buffered(scap_reader_t* reader, uint32_t bufsize, bool own_reader);
 
+/**
+ * @brief Opens a reader wrapping another reader, and transparently
+ * decompresses capture files written with block compression (see
+ * CB_BLOCK_TYPE_LZ4 and CB_BLOCK_TYPE_ZSTD). The header of every block is
+ * checked, so the sections of merged files can each use a different
+ * compression, and uncompressed blocks are returned as-is. The data must be
+ * read from the beginning of the section header block. Seeking backwards in
+ * a run of compressed blocks restarts from its first block, while seeking
+ * forward skips whole blocks without decompressing them.
+ * @param own_reader if true, the wrapped reader will be closed and de-allocated
+ * using its close() function when the reader gets closed.
+ */
+scap_reader_t *scap_reader_open_cblock(scap_reader_t* reader, bool own_reader);
+
+/**
+ * @brief Registers a position from which a reader opened with
+ * scap_reader_open_cblock can resume decompressing, such as the ones
+ * stored in the time index of a capture file. Seeking to a position at or
+ * after a seek point jumps to it directly instead of walking through all
+ * the blocks in between. Seek points must be added in increasing order, and
+ * only for files with a single section, since the blocks that are jumped
+ * over are not checked for a change of compression.
+ * @param pos is the uncompressed position of the start of a block
+ * @param raw_offset is the offset of that block in the wrapped reader
+ */
+void scap_reader_cblock_add_seek_point(scap_reader_t* r, int64_t pos, int64_t raw_offset);
+
+/**
+ * @brief Opens a reader wrapping another reader, and reads data ahead of
+ * the consumer on a background thread. This is suitable to move the cost of
+ * decompression away from the thread parsing the data, as the wrapped reader
+ * is only accessed by the background thread, which fills a bounded queue of
+ * data blocks. Seeking inside the current block and forward seeking are
+ * served from the queue, while other seeks restart the background thread.
+ * @param bufsize is the size of each data block
+ * @param nbufs is the number of data blocks that can be read ahead
+ * @param own_reader if true, the wrapped reader will be closed and de-allocated
+ * using its close() function when the prefetch reader gets closed.
+ */
+scap_reader_t *scap_reader_open_prefetch(scap_reader_t* reader, uint32_t bufsize, uint32_t nbufs, bool own_reader);
+
 
 #ifdef __cplusplus
 }
@@ -92,10 +92,19 @@ static int64_t buffered_seek(scap_reader_t *r, int64_t offset, int whence)
             h->m_buffer_off += (uint32_t) offset;
             return r->tell(r);
         }
+        // the wrapped reader is ahead of us by the buffered data
+        offset += r->tell(r);
+        whence = SEEK_SET;
     }
+    h->m_has_err = false;
     h->m_buffer_off = 0;
     h->m_buffer_len = 0;
-    h->m_offset = h->m_reader->seek(h->m_reader, offset, whence);
+    int64_t res = h->m_reader->seek(h->m_reader, offset, whence);
+    if (res < 0)
+    {
+        return res;
+    }
+    h->m_offset = h->m_reader->tell(h->m_reader);
     return h->m_offset;
 }
 
@@ -0,0 +1,832 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "scap_reader.h"
+#include "scap_const.h"
+#include "scap_savefile.h"
+#include <string.h>
+
+#ifdef HAS_LZ4
+#include <lz4.h>
+#endif
+#ifdef HAS_ZSTD
+#include <zstd.h>
+#endif
+
+// Upper bound for the uncompressed size of a compressed block, to protect
+// against allocating absurd amounts of memory for corrupted files
+#define CBLOCK_MAX_UNCOMPRESSED_LEN (64 * 1024 * 1024)
+
+typedef struct cblock_seek_point
+{
+    int64_t m_pos; ///< The uncompressed position of the start of a block
+    int64_t m_raw_offset; ///< The position of that block in the wrapped reader
+} cblock_seek_point_t;
+
+//
+// A run of consecutive blocks that are either all compressed or all
+// uncompressed. Merged files are made of many sections, and each one can
+// use a different compression, so the runs are discovered while reading.
+//
+typedef struct cblock_run
+{
+    int64_t m_pos; ///< The uncompressed position of the first block of the run
+    int64_t m_raw_offset; ///< The position of the first block of the run in the wrapped reader
+    int64_t m_scanned_raw; ///< For uncompressed runs, the position in the wrapped reader of the first block header not checked yet
+    bool m_compressed; ///< True if the blocks of the run are compressed
+} cblock_run_t;
+
+typedef struct reader_handle
+{
+    bool m_close_reader; ///< Whether the reader should be closed
+    bool m_compressed; ///< True if the current block is compressed
+    bool m_has_err; ///< True if the most recent decompression had an error
+    char m_errbuf[SCAP_LASTERR_SIZE]; ///< The message of the decompression error
+    scap_reader_t* m_reader; ///< The reader to read compressed data from
+    int64_t m_start; ///< The position of the first block in m_reader
+    int64_t m_next_block; ///< The position in m_reader of the next block header, when not compressed
+    int64_t m_delta; ///< The difference between the positions in the data and in m_reader, when not compressed
+    uint8_t* m_stash; ///< Bytes read from m_reader in advance, returned before reading m_reader again
+    uint32_t m_stash_cap; ///< The physical size of m_stash
+    uint32_t m_stash_len; ///< The number of bytes in m_stash
+    uint32_t m_stash_off; ///< The number of bytes of m_stash already consumed
+    uint8_t* m_buffer; ///< The uncompressed data, either a block header or a decompressed block
+    uint32_t m_buffer_cap; ///< The physical size of the buffer
+    uint32_t m_buffer_len; ///< The number of bytes used in the buffer
+    uint32_t m_buffer_off; ///< The cursor position in the buffer
+    int64_t m_buffer_pos; ///< The position of m_buffer[0] in the uncompressed data
+    uint8_t* m_in; ///< The compressed data of the current block
+    uint32_t m_in_cap; ///< The physical size of m_in
+    cblock_run_t* m_runs; ///< The runs found so far, in increasing order
+    uint32_t m_runs_len; ///< The number of entries in m_runs
+    uint32_t m_runs_cap; ///< The physical size of m_runs
+    uint32_t m_run; ///< The index of the run being read
+    cblock_seek_point_t* m_seek_points; ///< The known positions of blocks where reading can resume
+    uint32_t m_seek_points_len; ///< The number of entries in m_seek_points
+    uint32_t m_seek_points_cap; ///< The physical size of m_seek_points
+#ifdef HAS_ZSTD
+    ZSTD_DCtx* m_zstd_ctx; ///< The zstd decompression context, created with the first zstd block
+#endif
+} reader_handle_t;
+
+static bool cblock_set_error(reader_handle_t* h, const char* msg)
+{
+    h->m_has_err = true;
+    snprintf(h->m_errbuf, sizeof(h->m_errbuf), "%s", msg);
+    return false;
+}
+
+static bool cblock_reserve(uint8_t** buf, uint32_t* cap, uint32_t size)
+{
+    if (*cap >= size)
+    {
+        return true;
+    }
+    uint8_t* tmp = (uint8_t*) realloc(*buf, size);
+    if (tmp == NULL)
+    {
+        return false;
+    }
+    *buf = tmp;
+    *cap = size;
+    return true;
+}
+
+static int64_t cblock_raw_tell(reader_handle_t* h)
+{
+    return h->m_reader->tell(h->m_reader) - (h->m_stash_len - h->m_stash_off);
+}
+
+static int cblock_raw_read(reader_handle_t* h, void* buf, uint32_t len)
+{
+    uint8_t* buf_bytes = (uint8_t*) buf;
+    uint32_t stashed = h->m_stash_len - h->m_stash_off;
+    uint32_t size = len < stashed ? len : stashed;
+    if (size > 0)
+    {
+        memcpy(buf_bytes, h->m_stash + h->m_stash_off, size);
+        h->m_stash_off += size;
+    }
+    if (size == len)
+    {
+        return (int) len;
+    }
+
+    int nread = h->m_reader->read(h->m_reader, buf_bytes + size, len - size);
+    if (nread < 0)
+    {
+        return size > 0 ? (int) size : nread;
+    }
+    return (int) size + nread;
+}
+
+//
+// Pushes back bytes read from the wrapped reader, so that they are
+// returned again by the next reads
+//
+static bool cblock_unread(reader_handle_t* h, const uint8_t* buf, uint32_t len)
+{
+    uint32_t stashed = h->m_stash_len - h->m_stash_off;
+    if (!cblock_reserve(&h->m_stash, &h->m_stash_cap, len + stashed))
+    {
+        return cblock_set_error(h, "error allocating the decompression buffers");
+    }
+    memmove(h->m_stash + len, h->m_stash + h->m_stash_off, stashed);
+    memcpy(h->m_stash, buf, len);
+    h->m_stash_off = 0;
+    h->m_stash_len = len + stashed;
+    return true;
+}
+
+static int64_t cblock_raw_seek(reader_handle_t* h, int64_t raw_offset)
+{
+    if (raw_offset == cblock_raw_tell(h))
+    {
+        return raw_offset;
+    }
+    h->m_stash_len = 0;
+    h->m_stash_off = 0;
+    return h->m_reader->seek(h->m_reader, raw_offset, SEEK_SET);
+}
+
+static bool cblock_raw_skip(reader_handle_t* h, int64_t len)
+{
+    uint32_t stashed = h->m_stash_len - h->m_stash_off;
+    if (len <= stashed)
+    {
+        h->m_stash_off += (uint32_t) len;
+        return true;
+    }
+    h->m_stash_off = h->m_stash_len;
+    return h->m_reader->seek(h->m_reader, len - stashed, SEEK_CUR) >= 0;
+}
+
+//
+// Returns the index of the last run starting at or before the uncompressed
+// position pos
+//
+static uint32_t cblock_find_run(reader_handle_t* h, int64_t pos)
+{
+    uint32_t lo = 0;
+    uint32_t hi = h->m_runs_len;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (h->m_runs[mid].m_pos <= pos)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo > 0 ? lo - 1 : 0;
+}
+
+//
+// Makes the run containing the block at the uncompressed position pos the
+// current one, adding it to the known runs if it was not found yet
+//
+static bool cblock_enter_run(reader_handle_t* h, int64_t pos, int64_t raw_offset, bool compressed)
+{
+    cblock_run_t* last = &h->m_runs[h->m_runs_len - 1];
+    if (pos <= last->m_pos || last->m_compressed == compressed)
+    {
+        h->m_run = cblock_find_run(h, pos);
+        return true;
+    }
+
+    if (h->m_runs_len == h->m_runs_cap)
+    {
+        uint32_t cap = h->m_runs_cap * 2;
+        cblock_run_t* tmp = (cblock_run_t*) realloc(h->m_runs, cap * sizeof(cblock_run_t));
+        if (tmp == NULL)
+        {
+            return cblock_set_error(h, "error allocating the decompression buffers");
+        }
+        h->m_runs = tmp;
+        h->m_runs_cap = cap;
+    }
+    h->m_runs[h->m_runs_len].m_pos = pos;
+    h->m_runs[h->m_runs_len].m_raw_offset = raw_offset;
+    h->m_runs[h->m_runs_len].m_scanned_raw = raw_offset;
+    h->m_runs[h->m_runs_len].m_compressed = compressed;
+    h->m_run = h->m_runs_len++;
+    return true;
+}
+
+static void cblock_update_scanned(reader_handle_t* h)
+{
+    cblock_run_t* run = &h->m_runs[h->m_run];
+    if (!run->m_compressed && h->m_next_block > run->m_scanned_raw)
+    {
+        run->m_scanned_raw = h->m_next_block;
+    }
+}
+
+//
+// Stops looking for block headers, the rest of the data is returned as-is.
+// This is for data that is not a capture file, or is corrupted.
+//
+static void cblock_set_opaque(reader_handle_t* h)
+{
+    h->m_next_block = INT64_MAX;
+    cblock_update_scanned(h);
+}
+
+//
+// Moves to the uncompressed block whose header bh has been read from the
+// position raw_offset of the wrapped reader, at the position pos of the
+// data. The header is returned from the buffer, the rest of the block as-is.
+//
+static bool cblock_raw_block(reader_handle_t* h, const block_header* bh, int64_t pos, int64_t raw_offset)
+{
+    if (!cblock_reserve(&h->m_buffer, &h->m_buffer_cap, sizeof(*bh)))
+    {
+        return cblock_set_error(h, "error allocating the decompression buffers");
+    }
+    memcpy(h->m_buffer, bh, sizeof(*bh));
+    h->m_buffer_len = sizeof(*bh);
+    h->m_buffer_off = 0;
+    h->m_buffer_pos = pos;
+    h->m_delta = pos - raw_offset;
+    if (h->m_compressed)
+    {
+        h->m_compressed = false;
+        if (!cblock_enter_run(h, pos, raw_offset, false))
+        {
+            return false;
+        }
+    }
+
+    if (bh->block_total_length < sizeof(*bh))
+    {
+        cblock_set_opaque(h);
+        return true;
+    }
+    h->m_next_block = raw_offset + bh->block_total_length;
+    cblock_update_scanned(h);
+    return true;
+}
+
+//
+// Reads the header of the block at m_next_block, when not decompressing.
+// Every block is checked, since a compressed run can start after each
+// section header in merged files. Returns false at the end of data or on error.
+//
+static bool cblock_next_raw(reader_handle_t* h)
+{
+    block_header bh;
+    int64_t raw_offset = h->m_next_block;
+    int64_t pos = raw_offset + h->m_delta;
+    int nread = cblock_raw_read(h, &bh, sizeof(bh));
+    if (nread <= 0)
+    {
+        return false;
+    }
+
+    if (nread != sizeof(bh) || (raw_offset == h->m_start && bh.block_type != SHB_BLOCK_TYPE))
+    {
+        // not a capture file we can recognize, return it as-is
+        memcpy(h->m_buffer, &bh, nread);
+        h->m_buffer_len = (uint32_t) nread;
+        h->m_buffer_off = 0;
+        h->m_buffer_pos = pos;
+        cblock_set_opaque(h);
+        return true;
+    }
+
+    if (bh.block_type == CB_BLOCK_TYPE_LZ4 || bh.block_type == CB_BLOCK_TYPE_ZSTD)
+    {
+        // the header is read again by cblock_read_header
+        if (!cblock_unread(h, (const uint8_t*) &bh, sizeof(bh)))
+        {
+            return false;
+        }
+        h->m_compressed = true;
+        h->m_buffer_len = 0;
+        h->m_buffer_off = 0;
+        h->m_buffer_pos = pos;
+        return cblock_enter_run(h, pos, raw_offset, true);
+    }
+
+    return cblock_raw_block(h, &bh, pos, raw_offset);
+}
+
+//
+// Checks the headers of the blocks starting in data, which has been read
+// as-is from the position raw_offset of the wrapped reader. The bytes from
+// the start of a compressed block, or of a header that is not entirely in
+// data, are pushed back to be read again. Returns the number of bytes to
+// keep, or -1 on error.
+//
+static int cblock_scan(reader_handle_t* h, const uint8_t* data, int64_t raw_offset, uint32_t len)
+{
+    while (h->m_next_block < raw_offset + len)
+    {
+        block_header bh;
+        uint32_t off = (uint32_t) (h->m_next_block - raw_offset);
+        if (len - off >= sizeof(bh))
+        {
+            memcpy(&bh, data + off, sizeof(bh));
+        }
+
+        if (len - off < sizeof(bh) ||
+            bh.block_type == CB_BLOCK_TYPE_LZ4 || bh.block_type == CB_BLOCK_TYPE_ZSTD)
+        {
+            cblock_update_scanned(h);
+            return cblock_unread(h, data + off, len - off) ? (int) off : -1;
+        }
+
+        if (bh.block_total_length < sizeof(bh))
+        {
+            cblock_set_opaque(h);
+            return (int) len;
+        }
+        h->m_next_block += bh.block_total_length;
+    }
+    cblock_update_scanned(h);
+    return (int) len;
+}
+
+//
+// Reads the header of the next compressed block from the wrapped reader.
+// Returns false at the end of data or on error, and when the compressed run
+// is over: then the header of the uncompressed block that follows is in
+// the buffer.
+//
+static bool cblock_read_header(reader_handle_t* h, block_header* bh, compressed_block_header* cbh)
+{
+    if (cblock_raw_read(h, bh, sizeof(*bh)) != sizeof(*bh))
+    {
+        return false;
+    }
+
+    if (bh->block_type == IDX_BLOCK_TYPE || bh->block_type == SHB_BLOCK_TYPE)
+    {
+        // the compressed blocks are over: the index is stored
+        // uncompressed after them, and the sections of other files may
+        // follow in merged files, each one with its own compression
+        cblock_raw_block(h, bh, h->m_buffer_pos, cblock_raw_tell(h) - (int64_t) sizeof(*bh));
+        return false;
+    }
+
+    if (bh->block_type != CB_BLOCK_TYPE_LZ4 && bh->block_type != CB_BLOCK_TYPE_ZSTD)
+    {
+        return cblock_set_error(h, "unexpected block type in a compressed capture file");
+    }
+
+    if (cblock_raw_read(h, cbh, sizeof(*cbh)) != sizeof(*cbh))
+    {
+        return cblock_set_error(h, "truncated compressed block header");
+    }
+
+    if (cbh->uncompressed_length > CBLOCK_MAX_UNCOMPRESSED_LEN ||
+        bh->block_total_length < sizeof(*bh) + sizeof(*cbh) + cbh->compressed_length + sizeof(uint32_t))
+    {
+        return cblock_set_error(h, "corrupted compressed block header");
+    }
+    return true;
+}
+
+//
+// Reads the rest of the compressed block whose headers have been read with
+// cblock_read_header, and decompresses it into the buffer
+//
+static bool cblock_decompress(reader_handle_t* h, const block_header* bh, const compressed_block_header* cbh)
+{
+    uint32_t toread = bh->block_total_length - sizeof(*bh) - sizeof(*cbh);
+    if (!cblock_reserve(&h->m_in, &h->m_in_cap, toread) ||
+        !cblock_reserve(&h->m_buffer, &h->m_buffer_cap, cbh->uncompressed_length))
+    {
+        return cblock_set_error(h, "error allocating the decompression buffers");
+    }
+
+    if (cblock_raw_read(h, h->m_in, toread) != (int) toread)
+    {
+        return cblock_set_error(h, "truncated compressed block");
+    }
+
+    int64_t res = -1;
+    switch (bh->block_type)
+    {
+#ifdef HAS_LZ4
+    case CB_BLOCK_TYPE_LZ4:
+        res = LZ4_decompress_safe((const char*) h->m_in, (char*) h->m_buffer,
+                                  cbh->compressed_length, cbh->uncompressed_length);
+        break;
+#endif
+#ifdef HAS_ZSTD
+    case CB_BLOCK_TYPE_ZSTD:
+    {
+        if (h->m_zstd_ctx == NULL && (h->m_zstd_ctx = ZSTD_createDCtx()) == NULL)
+        {
+            return cblock_set_error(h, "error allocating the decompression buffers");
+        }
+        size_t zres = ZSTD_decompressDCtx(h->m_zstd_ctx, h->m_buffer, cbh->uncompressed_length,
+                                          h->m_in, cbh->compressed_length);
+        res = ZSTD_isError(zres) ? -1 : (int64_t) zres;
+        break;
+    }
+#endif
+    default:
+        return cblock_set_error(h, "the compression of the capture file is not supported by this build");
+    }
+
+    if (res != (int64_t) cbh->uncompressed_length)
+    {
+        return cblock_set_error(h, "error decompressing block");
+    }
+    return true;
+}
+
+//
+// Moves to the next compressed block, decompressing it only if it contains
+// the uncompressed position target. Returns false at the end of data or on error.
+//
+static bool cblock_next(reader_handle_t* h, int64_t target)
+{
+    block_header bh;
+    compressed_block_header cbh;
+    int64_t pos = h->m_buffer_pos + h->m_buffer_len;
+
+    h->m_buffer_len = 0;
+    h->m_buffer_off = 0;
+    h->m_buffer_pos = pos;
+    if (!cblock_read_header(h, &bh, &cbh))
+    {
+        return !h->m_compressed && !h->m_has_err;
+    }
+
+    if (target >= pos + cbh.uncompressed_length)
+    {
+        if (!cblock_raw_skip(h, bh.block_total_length - sizeof(bh) - sizeof(cbh)))
+        {
+            return cblock_set_error(h, "error skipping compressed block");
+        }
+        h->m_buffer_pos = pos + cbh.uncompressed_length;
+        return true;
+    }
+
+    if (!cblock_decompress(h, &bh, &cbh))
+    {
+        return false;
+    }
+    h->m_buffer_len = cbh.uncompressed_length;
+    return true;
+}
+
+static int cblock_read(scap_reader_t *r, void* buf, uint32_t len)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    uint8_t* buf_bytes = (uint8_t*) buf;
+    while (len > 0 && !h->m_has_err)
+    {
+        if (h->m_buffer_off < h->m_buffer_len)
+        {
+            uint32_t buffer_len = h->m_buffer_len - h->m_buffer_off;
+            uint32_t size = len < buffer_len ? len : buffer_len;
+            memcpy(buf_bytes, h->m_buffer + h->m_buffer_off, size);
+            buf_bytes += size;
+            h->m_buffer_off += size;
+            len -= size;
+            continue;
+        }
+
+        if (h->m_compressed)
+        {
+            if (!cblock_next(h, h->m_buffer_pos + h->m_buffer_len))
+            {
+                break;
+            }
+            continue;
+        }
+
+        int64_t raw_offset = cblock_raw_tell(h);
+        if (raw_offset == h->m_next_block)
+        {
+            if (!cblock_next_raw(h))
+            {
+                break;
+            }
+            continue;
+        }
+
+        // uncompressed blocks are returned as-is, checking the headers
+        // that pass by to find where a compressed run starts
+        int nread = cblock_raw_read(h, buf_bytes, len);
+        if (nread <= 0)
+        {
+            break;
+        }
+        nread = cblock_scan(h, buf_bytes, raw_offset, (uint32_t) nread);
+        if (nread < 0)
+        {
+            break;
+        }
+        buf_bytes += nread;
+        len -= nread;
+    }
+    return buf_bytes - (uint8_t*) buf;
+}
+
+static int64_t cblock_offset(scap_reader_t *r)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    return h->m_reader->offset(h->m_reader);
+}
+
+static int64_t cblock_tell(scap_reader_t *r)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    if (!h->m_compressed && h->m_buffer_off >= h->m_buffer_len)
+    {
+        return cblock_raw_tell(h) + h->m_delta;
+    }
+    return h->m_buffer_pos + h->m_buffer_off;
+}
+
+//
+// Returns the last seek point at or before the uncompressed position
+// target, or NULL if there isn't any
+//
+static const cblock_seek_point_t* cblock_find_seek_point(reader_handle_t* h, int64_t target)
+{
+    uint32_t lo = 0;
+    uint32_t hi = h->m_seek_points_len;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (h->m_seek_points[mid].m_pos <= target)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo > 0 ? &h->m_seek_points[lo - 1] : NULL;
+}
+
+//
+// Moves forward to the uncompressed position target, one block at a time
+//
+static int64_t cblock_seek_forward(reader_handle_t* h, int64_t target)
+{
+    while (true)
+    {
+        if (h->m_compressed)
+        {
+            if (target <= h->m_buffer_pos + h->m_buffer_len)
+            {
+                h->m_buffer_off = (uint32_t) (target - h->m_buffer_pos);
+                return target;
+            }
+            if (!cblock_next(h, target))
+            {
+                return -1;
+            }
+            continue;
+        }
+
+        if (target >= h->m_buffer_pos && target < h->m_buffer_pos + h->m_buffer_len)
+        {
+            h->m_buffer_off = (uint32_t) (target - h->m_buffer_pos);
+            return target;
+        }
+
+        int64_t raw_offset = target - h->m_delta;
+        if (raw_offset <= h->m_next_block)
+        {
+            // no block header to check up to there
+            if (cblock_raw_seek(h, raw_offset) < 0)
+            {
+                return -1;
+            }
+            h->m_buffer_off = h->m_buffer_len;
+            return target;
+        }
+
+        if (cblock_raw_seek(h, h->m_next_block) < 0 || !cblock_next_raw(h))
+        {
+            return -1;
+        }
+    }
+}
+
+static int64_t cblock_seek(scap_reader_t *r, int64_t offset, int whence)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    int64_t target;
+
+    if (whence == SEEK_CUR)
+    {
+        target = r->tell(r) + offset;
+    }
+    else if (whence == SEEK_SET)
+    {
+        target = offset;
+    }
+    else
+    {
+        return -1;
+    }
+
+    if (target < h->m_start)
+    {
+        return -1;
+    }
+
+    h->m_has_err = false;
+    if (h->m_compressed && target >= h->m_buffer_pos && target <= h->m_buffer_pos + h->m_buffer_len)
+    {
+        h->m_buffer_off = (uint32_t) (target - h->m_buffer_pos);
+        return target;
+    }
+
+    //
+    // Find the closest block header before target, and move forward from
+    // there. In uncompressed runs, the positions up to the first block
+    // header not checked yet can be reached directly.
+    //
+    uint32_t i = cblock_find_run(h, target);
+    const cblock_run_t* run = &h->m_runs[i];
+    int64_t pos = run->m_pos;
+    int64_t raw_offset = run->m_raw_offset;
+    if (!run->m_compressed)
+    {
+        if (raw_offset + (target - pos) <= run->m_scanned_raw)
+        {
+            if (cblock_raw_seek(h, raw_offset + (target - pos)) < 0)
+            {
+                return -1;
+            }
+            h->m_compressed = false;
+            h->m_run = i;
+            h->m_delta = pos - raw_offset;
+            h->m_next_block = run->m_scanned_raw;
+            h->m_buffer_len = 0;
+            h->m_buffer_off = 0;
+            h->m_buffer_pos = target;
+            return target;
+        }
+        pos += run->m_scanned_raw - raw_offset;
+        raw_offset = run->m_scanned_raw;
+    }
+
+    const cblock_seek_point_t* sp = cblock_find_seek_point(h, target);
+    if (sp != NULL && sp->m_pos > pos)
+    {
+        // jump straight to the closest block where decompression can start
+        pos = sp->m_pos;
+        raw_offset = sp->m_raw_offset;
+    }
+
+    if (h->m_compressed && h->m_buffer_pos > pos && h->m_buffer_pos <= target)
+    {
+        // the current block is closer, compressed blocks can only be read forward
+        return cblock_seek_forward(h, target);
+    }
+
+    if (cblock_raw_seek(h, raw_offset) < 0)
+    {
+        return -1;
+    }
+    h->m_compressed = false;
+    h->m_run = cblock_find_run(h, pos);
+    h->m_delta = pos - raw_offset;
+    h->m_next_block = raw_offset;
+    h->m_buffer_len = 0;
+    h->m_buffer_off = 0;
+    h->m_buffer_pos = pos;
+    return cblock_seek_forward(h, target);
+}
+
+static const char* cblock_error(scap_reader_t *r, int *errnum)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    if (h->m_has_err)
+    {
+        *errnum = -1;
+        return h->m_errbuf;
+    }
+    return h->m_reader->error(h->m_reader, errnum);
+}
+
+static int cblock_close(scap_reader_t *r)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    int res = 0;
+    if (h->m_close_reader)
+    {
+        res = h->m_reader->close(h->m_reader);
+    }
+#ifdef HAS_ZSTD
+    if (h->m_zstd_ctx != NULL)
+    {
+        ZSTD_freeDCtx(h->m_zstd_ctx);
+    }
+#endif
+    free(h->m_stash);
+    free(h->m_buffer);
+    free(h->m_in);
+    free(h->m_runs);
+    free(h->m_seek_points);
+    free(h);
+    free(r);
+    return res;
+}
+
+void scap_reader_cblock_add_seek_point(scap_reader_t* r, int64_t pos, int64_t raw_offset)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    if (pos < h->m_start ||
+        (h->m_seek_points_len > 0 && pos <= h->m_seek_points[h->m_seek_points_len - 1].m_pos))
+    {
+        return;
+    }
+
+    if (h->m_seek_points_len == h->m_seek_points_cap)
+    {
+        uint32_t cap = h->m_seek_points_cap > 0 ? h->m_seek_points_cap * 2 : 64;
+        cblock_seek_point_t* tmp = (cblock_seek_point_t*) realloc(h->m_seek_points, cap * sizeof(cblock_seek_point_t));
+        if (tmp == NULL)
+        {
+            // seek points are only an optimization
+            return;
+        }
+        h->m_seek_points = tmp;
+        h->m_seek_points_cap = cap;
+    }
+    h->m_seek_points[h->m_seek_points_len].m_pos = pos;
+    h->m_seek_points[h->m_seek_points_len].m_raw_offset = raw_offset;
+    h->m_seek_points_len++;
+}
+
+scap_reader_t *scap_reader_open_cblock(scap_reader_t* reader, bool own_reader)
+{
+    if (reader == NULL)
+    {
+        return NULL;
+    }
+
+    reader_handle_t* h = (reader_handle_t *) calloc (1, sizeof (reader_handle_t));
+    if (h == NULL)
+    {
+        return NULL;
+    }
+    h->m_close_reader = own_reader;
+    h->m_reader = reader;
+    h->m_start = reader->tell(reader);
+    h->m_next_block = h->m_start;
+    h->m_buffer_pos = h->m_start;
+
+    // the data starts with an uncompressed run, the section header block
+    h->m_runs = (cblock_run_t*) malloc(4 * sizeof(cblock_run_t));
+    if (h->m_runs == NULL ||
+        !cblock_reserve(&h->m_buffer, &h->m_buffer_cap, sizeof(block_header)))
+    {
+        free(h->m_runs);
+        free(h);
+        return NULL;
+    }
+    h->m_runs_cap = 4;
+    h->m_runs_len = 1;
+    h->m_runs[0].m_pos = h->m_start;
+    h->m_runs[0].m_raw_offset = h->m_start;
+    h->m_runs[0].m_scanned_raw = h->m_start;
+    h->m_runs[0].m_compressed = false;
+
+    scap_reader_t* r = (scap_reader_t *) malloc (sizeof (scap_reader_t));
+    r->handle = h;
+    r->read = &cblock_read;
+    r->offset = &cblock_offset;
+    r->tell = &cblock_tell;
+    r->seek = &cblock_seek;
+    r->error = &cblock_error;
+    r->close = &cblock_close;
+    return r;
+}
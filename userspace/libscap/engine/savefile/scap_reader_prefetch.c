@@ -0,0 +1,363 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "scap_reader.h"
+#include "scap_const.h"
+#include <string.h>
+#include <pthread.h>
+
+typedef struct prefetch_block
+{
+    uint8_t* m_data; ///< The data read from the wrapped reader
+    uint32_t m_len; ///< The number of valid bytes in m_data
+    int64_t m_offset; ///< The offset of the wrapped reader right after filling this block
+} prefetch_block_t;
+
+//
+// The blocks are used as a bounded single-producer/single-consumer queue.
+// The producer thread only writes the slot at (m_head + m_count) % m_nblocks
+// and only when m_count < m_nblocks, while the consumer only reads the
+// block at m_head. The block being consumed stays accounted in m_count
+// until all its bytes have been read, so the producer never overwrites it.
+//
+typedef struct reader_handle
+{
+    bool m_close_reader; ///< Whether the reader should be closed
+    scap_reader_t* m_reader; ///< The reader the producer thread reads from
+    prefetch_block_t* m_blocks; ///< The ring of blocks
+    uint32_t m_nblocks; ///< The number of blocks in the ring
+    uint32_t m_block_cap; ///< The physical size of each block
+    uint32_t m_head; ///< The block the consumer is reading from
+    uint32_t m_count; ///< The number of blocks filled and not yet fully consumed
+    uint32_t m_block_off; ///< The cursor position in the block at m_head
+    int64_t m_pos; ///< The position of the next byte returned by read()
+    int64_t m_offset; ///< The offset of the wrapped reader for the current block
+    bool m_eof; ///< True if the producer reached the end of data or an error
+    bool m_stop; ///< True if the producer has been asked to terminate
+    bool m_running; ///< True if the producer thread has been started
+    int m_errnum; ///< The error number captured by the producer
+    char m_errbuf[SCAP_LASTERR_SIZE]; ///< The error message captured by the producer
+    pthread_t m_thread;
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_not_empty;
+    pthread_cond_t m_not_full;
+} reader_handle_t;
+
+static void* prefetch_thread(void* arg)
+{
+    reader_handle_t* h = (reader_handle_t*) arg;
+    while (true)
+    {
+        pthread_mutex_lock(&h->m_mutex);
+        while (!h->m_stop && h->m_count == h->m_nblocks)
+        {
+            pthread_cond_wait(&h->m_not_full, &h->m_mutex);
+        }
+        if (h->m_stop)
+        {
+            pthread_mutex_unlock(&h->m_mutex);
+            break;
+        }
+        // m_head + m_count is left unchanged when the consumer releases
+        // a block, so the slot stays ours after we drop the lock
+        prefetch_block_t* b = &h->m_blocks[(h->m_head + h->m_count) % h->m_nblocks];
+        pthread_mutex_unlock(&h->m_mutex);
+
+        int nread = h->m_reader->read(h->m_reader, b->m_data, h->m_block_cap);
+        int64_t offset = nread > 0 ? h->m_reader->offset(h->m_reader) : 0;
+        int errnum = 0;
+        const char* err = nread < 0 ? h->m_reader->error(h->m_reader, &errnum) : NULL;
+
+        pthread_mutex_lock(&h->m_mutex);
+        if (nread <= 0)
+        {
+            if (err != NULL)
+            {
+                h->m_errnum = errnum;
+                snprintf(h->m_errbuf, sizeof(h->m_errbuf), "%s", err);
+            }
+            h->m_eof = true;
+            pthread_cond_signal(&h->m_not_empty);
+            pthread_mutex_unlock(&h->m_mutex);
+            break;
+        }
+        b->m_len = (uint32_t) nread;
+        b->m_offset = offset;
+        h->m_count++;
+        pthread_cond_signal(&h->m_not_empty);
+        pthread_mutex_unlock(&h->m_mutex);
+    }
+    return NULL;
+}
+
+static int prefetch_start(reader_handle_t* h)
+{
+    h->m_head = 0;
+    h->m_count = 0;
+    h->m_block_off = 0;
+    h->m_eof = false;
+    h->m_stop = false;
+    h->m_errnum = 0;
+    h->m_errbuf[0] = '\0';
+    if (pthread_create(&h->m_thread, NULL, &prefetch_thread, h) != 0)
+    {
+        h->m_running = false;
+        return -1;
+    }
+    h->m_running = true;
+    return 0;
+}
+
+static void prefetch_stop(reader_handle_t* h)
+{
+    if (!h->m_running)
+    {
+        return;
+    }
+    pthread_mutex_lock(&h->m_mutex);
+    h->m_stop = true;
+    pthread_cond_signal(&h->m_not_full);
+    pthread_mutex_unlock(&h->m_mutex);
+    pthread_join(h->m_thread, NULL);
+    h->m_running = false;
+}
+
+//
+// Returns the block at m_head, waiting for the producer if needed, or NULL
+// if no more data will be available. The returned block is owned by the
+// consumer until it gets released with prefetch_release_block.
+//
+static prefetch_block_t* prefetch_acquire_block(reader_handle_t* h)
+{
+    pthread_mutex_lock(&h->m_mutex);
+    while (h->m_count == 0 && !h->m_eof)
+    {
+        pthread_cond_wait(&h->m_not_empty, &h->m_mutex);
+    }
+    prefetch_block_t* b = h->m_count > 0 ? &h->m_blocks[h->m_head] : NULL;
+    pthread_mutex_unlock(&h->m_mutex);
+    if (b != NULL)
+    {
+        h->m_offset = b->m_offset;
+    }
+    return b;
+}
+
+static void prefetch_release_block(reader_handle_t* h)
+{
+    pthread_mutex_lock(&h->m_mutex);
+    h->m_head = (h->m_head + 1) % h->m_nblocks;
+    h->m_count--;
+    h->m_block_off = 0;
+    pthread_cond_signal(&h->m_not_full);
+    pthread_mutex_unlock(&h->m_mutex);
+}
+
+//
+// Moves the cursor forward by len bytes, copying them into buf if it is
+// not NULL. Returns the number of bytes actually consumed.
+//
+static uint32_t prefetch_consume(reader_handle_t* h, uint8_t* buf, uint32_t len)
+{
+    uint32_t done = 0;
+    while (done < len && h->m_running)
+    {
+        prefetch_block_t* b = prefetch_acquire_block(h);
+        if (b == NULL)
+        {
+            break;
+        }
+        uint32_t avail = b->m_len - h->m_block_off;
+        uint32_t size = len - done < avail ? len - done : avail;
+        if (buf != NULL)
+        {
+            memcpy(buf + done, b->m_data + h->m_block_off, size);
+        }
+        h->m_block_off += size;
+        done += size;
+        if (h->m_block_off == b->m_len)
+        {
+            prefetch_release_block(h);
+        }
+    }
+    h->m_pos += done;
+    return done;
+}
+
+static int prefetch_read(scap_reader_t *r, void* buf, uint32_t len)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    return (int) prefetch_consume(h, (uint8_t*) buf, len);
+}
+
+static int64_t prefetch_offset(scap_reader_t *r)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    return h->m_offset;
+}
+
+static int64_t prefetch_tell(scap_reader_t *r)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    return h->m_pos;
+}
+
+static int64_t prefetch_seek(scap_reader_t *r, int64_t offset, int whence)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    if (whence == SEEK_CUR)
+    {
+        if (offset < 0 && h->m_block_off >= (uint32_t) (offset * -1))
+        {
+            h->m_block_off -= (uint32_t) (offset * -1);
+            h->m_pos += offset;
+            return h->m_pos;
+        }
+        else if (offset >= 0 && offset <= UINT32_MAX)
+        {
+            // skipping forward is served from the prefetched blocks,
+            // the wrapped reader would have to inflate them anyway
+            if (prefetch_consume(h, NULL, (uint32_t) offset) != (uint32_t) offset)
+            {
+                return -1;
+            }
+            return h->m_pos;
+        }
+        // translate into an absolute position, since the wrapped
+        // reader is ahead of us by the amount of prefetched data
+        offset += h->m_pos;
+        whence = SEEK_SET;
+    }
+
+    prefetch_stop(h);
+    int64_t res = h->m_reader->seek(h->m_reader, offset, whence);
+    if (res < 0)
+    {
+        return res;
+    }
+    h->m_pos = h->m_reader->tell(h->m_reader);
+    h->m_offset = h->m_reader->offset(h->m_reader);
+    if (prefetch_start(h) != 0)
+    {
+        return -1;
+    }
+    return h->m_pos;
+}
+
+static const char* prefetch_error(scap_reader_t *r, int *errnum)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    // the wrapped reader can only be accessed safely once the producer
+    // is done with it, otherwise report what the producer captured
+    if (!h->m_running)
+    {
+        return h->m_reader->error(h->m_reader, errnum);
+    }
+    pthread_mutex_lock(&h->m_mutex);
+    *errnum = h->m_errnum;
+    pthread_mutex_unlock(&h->m_mutex);
+    return h->m_errbuf;
+}
+
+static int prefetch_close(scap_reader_t *r)
+{
+    ASSERT(r != NULL);
+    reader_handle_t* h = (reader_handle_t*) r->handle;
+    int res = 0;
+    prefetch_stop(h);
+    if (h->m_close_reader)
+    {
+        res = h->m_reader->close(h->m_reader);
+    }
+    for (uint32_t i = 0; i < h->m_nblocks; i++)
+    {
+        free(h->m_blocks[i].m_data);
+    }
+    free(h->m_blocks);
+    pthread_cond_destroy(&h->m_not_full);
+    pthread_cond_destroy(&h->m_not_empty);
+    pthread_mutex_destroy(&h->m_mutex);
+    free(h);
+    free(r);
+    return res;
+}
+
+scap_reader_t *scap_reader_open_prefetch(scap_reader_t* reader, uint32_t bufsize, uint32_t nbufs, bool own_reader)
+{
+    if (reader == NULL || bufsize == 0 || nbufs == 0)
+    {
+        return NULL;
+    }
+
+    reader_handle_t* h = (reader_handle_t *) calloc (1, sizeof (reader_handle_t));
+    if (h == NULL)
+    {
+        return NULL;
+    }
+    h->m_close_reader = own_reader;
+    h->m_reader = reader;
+    h->m_block_cap = bufsize;
+    h->m_nblocks = nbufs;
+    h->m_pos = reader->tell(reader);
+    h->m_offset = reader->offset(reader);
+    h->m_blocks = (prefetch_block_t*) calloc (nbufs, sizeof(prefetch_block_t));
+    if (h->m_blocks == NULL)
+    {
+        free(h);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < nbufs; i++)
+    {
+        h->m_blocks[i].m_data = (uint8_t*) malloc (sizeof(uint8_t) * bufsize);
+        if (h->m_blocks[i].m_data == NULL)
+        {
+            for (uint32_t j = 0; j < i; j++)
+            {
+                free(h->m_blocks[j].m_data);
+            }
+            free(h->m_blocks);
+            free(h);
+            return NULL;
+        }
+    }
+    pthread_mutex_init(&h->m_mutex, NULL);
+    pthread_cond_init(&h->m_not_empty, NULL);
+    pthread_cond_init(&h->m_not_full, NULL);
+
+    scap_reader_t* r = (scap_reader_t *) malloc (sizeof (scap_reader_t));
+    r->handle = h;
+    r->read = &prefetch_read;
+    r->offset = &prefetch_offset;
+    r->tell = &prefetch_tell;
+    r->seek = &prefetch_seek;
+    r->error = &prefetch_error;
+    r->close = &prefetch_close;
+
+    if (prefetch_start(h) != 0)
+    {
+        // don't let close() release a reader the caller still owns
+        h->m_close_reader = false;
+        prefetch_close(r);
+        return NULL;
+    }
+    return r;
+}
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 
 #ifndef _WIN32
 #include <unistd.h>
@@ -1971,6 +1972,21 @@ static int32_t next(struct scap_engine_handle engine, scap_evt **pevent, uint16_
 			}
 		}
 
+		if(bh.block_type == IDX_BLOCK_TYPE)
+		{
+			//
+			// The time index closes a section of the file, but the
+			// sections of other files may follow it in merged files
+			//
+			if(bh.block_total_length < sizeof(bh) ||
+			   r->seek(r, bh.block_total_length - sizeof(bh), SEEK_CUR) < 0)
+			{
+				snprintf(handle->m_lasterr, SCAP_LASTERR_SIZE, "error skipping the time index block");
+				return SCAP_FAILURE;
+			}
+			continue;
+		}
+
 		if(bh.block_type != EV_BLOCK_TYPE &&
 		   bh.block_type != EV_BLOCK_TYPE_V2 &&
 		   bh.block_type != EV_BLOCK_TYPE_V2_LARGE &&
@@ -2142,6 +2158,147 @@ void scap_savefile_fseek(struct scap_engine_handle engine, uint64_t off)
 	reader->seek(reader, off, SEEK_SET);
 }
 
+//
+// Move to the first event with a timestamp greater or equal than ts. The
+// time index is used to find a close position to start from, otherwise the
+// events are read from the beginning of the file.
+//
+int32_t scap_savefile_seek_ts(struct scap_engine_handle engine, uint64_t ts, uint64_t* evtnum)
+{
+	struct savefile_engine* handle = engine.m_handle;
+	scap_reader_t* reader = handle->m_reader;
+	int64_t pos = handle->m_events_pos;
+	uint64_t num = 0;
+	uint32_t lo = 0;
+	uint32_t hi = handle->m_index_len;
+	scap_evt* pevent;
+	uint16_t cpuid;
+	int32_t res;
+
+	while(lo < hi)
+	{
+		uint32_t mid = lo + (hi - lo) / 2;
+		if(handle->m_index[mid].ts <= ts)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	if(lo > 0)
+	{
+		pos = handle->m_index[lo - 1].pos;
+		num = handle->m_index[lo - 1].evtnum;
+	}
+
+	if(reader->seek(reader, pos, SEEK_SET) < 0)
+	{
+		snprintf(handle->m_lasterr, SCAP_LASTERR_SIZE, "error seeking to the events of timestamp %" PRIu64, ts);
+		return SCAP_FAILURE;
+	}
+	handle->m_use_last_block_header = false;
+
+	//
+	// Skip the events that precede ts, and rewind to
+	// the beginning of the first one that doesn't
+	//
+	while(true)
+	{
+		int64_t evtpos = reader->tell(reader);
+		res = next(engine, &pevent, &cpuid);
+		if(res == SCAP_EOF || res == SCAP_UNEXPECTED_BLOCK)
+		{
+			// the sections that follow the first one in merged
+			// files are left to the regular reads
+			break;
+		}
+		else if(res != SCAP_SUCCESS)
+		{
+			return res;
+		}
+
+		if(pevent->ts >= ts)
+		{
+			if(reader->seek(reader, evtpos - reader->tell(reader), SEEK_CUR) < 0)
+			{
+				snprintf(handle->m_lasterr, SCAP_LASTERR_SIZE, "error seeking to the events of timestamp %" PRIu64, ts);
+				return SCAP_FAILURE;
+			}
+			break;
+		}
+		num++;
+	}
+
+	*evtnum = num;
+	return SCAP_SUCCESS;
+}
+
+//
+// Load the time index from the end of the file, using a reader that
+// returns the raw content of the file. The position of the reader is
+// restored afterwards. A missing or invalid index is not an error, seeking
+// by timestamp simply needs to read all the events from the beginning.
+//
+static void scap_read_index(struct savefile_engine* handle, scap_reader_t* raw_reader, scap_reader_t* cblock_reader, int64_t file_size)
+{
+	block_header bh;
+	index_block_header ih;
+	uint32_t bt;
+	uint32_t nentries;
+	uint32_t i;
+	uint8_t* entries;
+	int64_t pos = raw_reader->tell(raw_reader);
+
+	if(file_size < (int64_t)(sizeof(bh) + sizeof(ih) + sizeof(bt)) ||
+	   raw_reader->seek(raw_reader, file_size - sizeof(bt), SEEK_SET) < 0 ||
+	   raw_reader->read(raw_reader, &bt, sizeof(bt)) != sizeof(bt) ||
+	   bt < sizeof(bh) + sizeof(ih) + sizeof(bt) ||
+	   bt > file_size ||
+	   raw_reader->seek(raw_reader, file_size - bt, SEEK_SET) < 0 ||
+	   raw_reader->read(raw_reader, &bh, sizeof(bh)) != sizeof(bh) ||
+	   raw_reader->read(raw_reader, &ih, sizeof(ih)) != sizeof(ih) ||
+	   bh.block_type != IDX_BLOCK_TYPE ||
+	   bh.block_total_length != bt ||
+	   ih.offset != (uint64_t)(file_size - bt) ||
+	   ih.entry_len < sizeof(index_block_entry))
+	{
+		raw_reader->seek(raw_reader, pos, SEEK_SET);
+		return;
+	}
+
+	nentries = (bt - sizeof(bh) - sizeof(ih) - sizeof(bt)) / ih.entry_len;
+	entries = (uint8_t*)malloc(nentries * ih.entry_len);
+	handle->m_index = (index_block_entry*)malloc(nentries * sizeof(index_block_entry));
+	if(entries == NULL || handle->m_index == NULL ||
+	   raw_reader->read(raw_reader, entries, nentries * ih.entry_len) != (int)(nentries * ih.entry_len))
+	{
+		free(entries);
+		free(handle->m_index);
+		handle->m_index = NULL;
+		raw_reader->seek(raw_reader, pos, SEEK_SET);
+		return;
+	}
+
+	for(i = 0; i < nentries; i++)
+	{
+		index_block_entry* entry = &handle->m_index[i];
+		memcpy(entry, entries + i * ih.entry_len, sizeof(index_block_entry));
+		if(entry->raw_offset >= ih.offset ||
+		   (i > 0 && (entry->ts < entry[-1].ts || entry->pos <= entry[-1].pos)))
+		{
+			break;
+		}
+		scap_reader_cblock_add_seek_point(cblock_reader, entry->pos, entry->raw_offset);
+	}
+	handle->m_index_len = i;
+
+	free(entries);
+	raw_reader->seek(raw_reader, pos, SEEK_SET);
+}
+
 static int32_t
 scap_savefile_init_platform(struct scap_platform *platform, char *lasterr, struct scap_engine_handle engine,
 			    struct scap_open_args *oargs)
@@ -2238,6 +2395,51 @@ static int32_t init(struct scap* main_handle, struct scap_open_args* oargs)
 		return SCAP_FAILURE;
 	}
 
+	//
+	// Files written with block compression are decompressed transparently
+	//
+	scap_reader_t* cblock_reader = scap_reader_open_cblock(reader, true);
+	if(!cblock_reader)
+	{
+		reader->close(reader);
+		snprintf(main_handle->m_lasterr, SCAP_LASTERR_SIZE, "error allocating the compressed block reader");
+		return SCAP_FAILURE;
+	}
+
+	//
+	// The time index can only be read from files that are not gzip
+	// compressed. Merged files are skipped, the index of the last
+	// section would not match the offsets in the merged file.
+	//
+	if(start_offset == 0 && gzdirect(gzfile))
+	{
+		struct stat st;
+		int statres = (fd != 0) ? fstat(fd, &st) : stat(fname, &st);
+		if(statres == 0 && (st.st_mode & S_IFMT) == S_IFREG)
+		{
+			scap_read_index(handle, reader, cblock_reader, (int64_t)st.st_size);
+		}
+	}
+	reader = cblock_reader;
+
+#ifndef _WIN32
+	if (params->prefetch_blocks > 0)
+	{
+		scap_reader_t* prefetch_reader = scap_reader_open_prefetch(
+			reader,
+			fbuffer_size > 0 ? fbuffer_size : READER_PREFETCH_BLOCK_SIZE,
+			params->prefetch_blocks,
+			true);
+		if(!prefetch_reader)
+		{
+			reader->close(reader);
+			snprintf(main_handle->m_lasterr, SCAP_LASTERR_SIZE, "error starting the prefetch reader");
+			return SCAP_FAILURE;
+		}
+		reader = prefetch_reader;
+	}
+	else
+#endif
 	if (fbuffer_size > 0)
 	{
 		scap_reader_t* buffered_reader = scap_reader_open_buffered(reader, fbuffer_size, true);
@@ -2283,6 +2485,7 @@ static int32_t init(struct scap* main_handle, struct scap_open_args* oargs)
 	}
 	handle->m_reader_evt_buf_size = READER_BUF_SIZE;
 	handle->m_reader = reader;
+	handle->m_events_pos = reader->tell(reader) - (handle->m_use_last_block_header ? sizeof(block_header) : 0);
 
 	if(!oargs->import_users)
 	{
@@ -2316,6 +2519,10 @@ static int32_t scap_savefile_close(struct scap_engine_handle engine)
 		handle->m_reader_evt_buf = NULL;
 	}
 
+	free(handle->m_index);
+	handle->m_index = NULL;
+	handle->m_index_len = 0;
+
 	return SCAP_SUCCESS;
 }
 
@@ -2339,7 +2546,17 @@ static int32_t scap_savefile_restart_capture(scap_t* handle)
 		char error[SCAP_LASTERR_SIZE];
 		snprintf(error, SCAP_LASTERR_SIZE, "could not restart capture: %s", scap_getlasterr(handle));
 		strlcpy(handle->m_lasterr, error, SCAP_LASTERR_SIZE);
+		return res;
 	}
+
+	//
+	// The time index doesn't cover the sections of merged files
+	//
+	free(engine->m_index);
+	engine->m_index = NULL;
+	engine->m_index_len = 0;
+	engine->m_events_pos = engine->m_reader->tell(engine->m_reader) -
+		(engine->m_use_last_block_header ? sizeof(block_header) : 0);
 	return res;
 }
 
@@ -2356,6 +2573,7 @@ static uint32_t get_event_dump_flags(struct scap_engine_handle engine)
 static struct scap_savefile_vtable savefile_ops = {
 	.ftell_capture = scap_savefile_ftell,
 	.fseek_capture = scap_savefile_fseek,
+	.seek_ts_capture = scap_savefile_seek_ts,
 
 	.restart_capture = scap_savefile_restart_capture,
 	.get_readfile_offset = get_readfile_offset,
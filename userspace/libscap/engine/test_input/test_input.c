@@ -68,6 +68,28 @@ static int32_t next(struct scap_engine_handle handle, scap_evt** pevent, uint16_
 	return SCAP_SUCCESS;
 }
 
+static int32_t next_batch(struct scap_engine_handle handle, uint32_t max_evts, scap_evt** pevents, uint16_t* pcpuids, uint32_t* nevts)
+{
+	test_input_engine *engine = handle.m_handle;
+	scap_test_input_data *data = engine->m_data;
+
+	*nevts = 0;
+	if (!data->events || data->event_count == 0)
+	{
+		return SCAP_EOF;
+	}
+
+	/* Test events are owned by the caller, so they all remain valid */
+	while(*nevts < max_evts && data->event_count > 0)
+	{
+		pevents[*nevts] = *(data->events++);
+		pcpuids[*nevts] = 1;
+		data->event_count--;
+		(*nevts)++;
+	}
+	return SCAP_SUCCESS;
+}
+
 static int32_t init(scap_t* main_handle, scap_open_args* oargs)
 {
 	test_input_engine *engine = main_handle->m_engine.m_handle;
@@ -92,6 +114,7 @@ const struct scap_vtable scap_test_input_engine = {
 	.free_handle = noop_free_handle,
 	.close = noop_close_engine,
 	.next = next,
+	.next_batch = next_batch,
 	.start_capture = noop_start_capture,
 	.stop_capture = noop_stop_capture,
 	.configure = noop_configure,
@@ -40,6 +40,9 @@ limitations under the License.
 #define SIMPLE_SET_OPTION "--simple_set"
 #define CPUS_FOR_EACH_BUFFER_MODE "--cpus_for_buf"
 #define ALL_AVAILABLE_CPUS_MODE "--available_cpus"
+#define HEAP_CONSUMER_MODE "--heap_consumer"
+#define HEAP_RESCAN_INTERVAL_OPTION "--heap_rescan_interval"
+#define PREFETCH_OPTION "--prefetch"
 #define DROP_FAILED "--drop-failed"
 
 /* PRINT */
@@ -538,7 +541,11 @@ void print_help()
 	printf("[MODERN PROBE ONLY, EXPERIMENTAL]\n");
 	printf("'%s <cpus_for_each_buffer>': allocate a ring buffer for every `cpus_for_each_buffer` CPUs.\n", CPUS_FOR_EACH_BUFFER_MODE);
 	printf("'%s': allocate ring buffers for all available CPUs. Default: allocate ring buffers for online CPUs only.\n", ALL_AVAILABLE_CPUS_MODE);
+	printf("'%s': merge ring buffers through a min-heap instead of scanning all of them for every event.\n", HEAP_CONSUMER_MODE);
+	printf("'%s <num_events>': with '%s', read the empty ring buffers again every `num_events` events.\n", HEAP_RESCAN_INTERVAL_OPTION, HEAP_CONSUMER_MODE);
 	printf("'%s': instrument drivers to drop failed syscalls (exit) events.\n", DROP_FAILED);
+	printf("[SCAP FILE ONLY]\n");
+	printf("'%s <num_blocks>': decompress the scap file on a background thread, reading ahead up to `num_blocks` blocks.\n", PREFETCH_OPTION);
 	printf("\n------> PRINT OPTIONS\n");
 	printf("'%s': print all supported syscalls with different sources and configurations.\n", PRINT_SYSCALLS_OPTION);
 	printf("'%s': print this menu.\n", PRINT_HELP_OPTION);
@@ -560,12 +567,12 @@ void print_scap_source()
 	else if(strcmp(oargs.engine_name, MODERN_BPF_ENGINE) == 0)
 	{
 		struct scap_modern_bpf_engine_params* params = oargs.engine_params;
-		printf("* Modern BPF probe, 1 ring buffer every %d CPUs\n", params->cpus_for_each_buffer);
+		printf("* Modern BPF probe, 1 ring buffer every %d CPUs%s\n", params->cpus_for_each_buffer, params->heap_consumer ? ", heap consumer" : "");
 	}
 	else if(strcmp(oargs.engine_name, SAVEFILE_ENGINE) == 0)
 	{
 		struct scap_savefile_engine_params* params = oargs.engine_params;
-		printf("* Scap file: '%s'.\n", params->fname);
+		printf("* Scap file: '%s'%s.\n", params->fname, params->prefetch_blocks ? ", prefetch reader" : "");
 	}
 	else
 	{
@@ -724,6 +731,31 @@ void parse_CLI_options(int argc, char** argv)
 		{
 			modern_bpf_params.allocate_online_only = false;
 		}
+		/* This should be used only with the modern probe */
+		if(!strcmp(argv[i], HEAP_CONSUMER_MODE))
+		{
+			modern_bpf_params.heap_consumer = true;
+		}
+		/* This should be used only with the modern probe */
+		if(!strcmp(argv[i], HEAP_RESCAN_INTERVAL_OPTION))
+		{
+			if(!(i + 1 < argc))
+			{
+				printf("\nYou need to specify also the number of events. Bye!\n");
+				exit(EXIT_FAILURE);
+			}
+			modern_bpf_params.heap_rescan_interval = atoi(argv[++i]);
+		}
+		/* This should be used only with scap files */
+		if(!strcmp(argv[i], PREFETCH_OPTION))
+		{
+			if(!(i + 1 < argc))
+			{
+				printf("\nYou need to specify also the number of blocks! Bye!\n");
+				exit(EXIT_FAILURE);
+			}
+			savefile_params.prefetch_blocks = strtoul(argv[++i], NULL, 10);
+		}
 
 		if(!strcmp(argv[i], DROP_FAILED))
 		{
@@ -463,6 +463,22 @@ static int32_t scap_get_cgroup_self_v1_cgroupns(struct mntent* de, struct scap_c
 	return SCAP_SUCCESS;
 }
 
+static inline void scap_cgroup_cache_lock(struct scap_cgroup_interface* cgi)
+{
+	if(cgi->m_cache_lock != NULL)
+	{
+		pthread_mutex_lock(cgi->m_cache_lock);
+	}
+}
+
+static inline void scap_cgroup_cache_unlock(struct scap_cgroup_interface* cgi)
+{
+	if(cgi->m_cache_lock != NULL)
+	{
+		pthread_mutex_unlock(cgi->m_cache_lock);
+	}
+}
+
 // Get all subsystem names for the v2 cgroup at `cgroup_mount`
 //
 // This is achieved by simply reading the contents of cgroup.controllers
@@ -482,11 +498,16 @@ static int32_t get_cgroup_subsystems_v2(struct scap_cgroup_interface* cgi, struc
 	if(cgi->m_use_cache)
 	{
 		struct scap_cgroup_cache* cached;
+		scap_cgroup_cache_lock(cgi);
 		HASH_FIND_STR(cgi->m_cache, cgroup_mount, cached);
-
 		if(cached != NULL)
 		{
 			*subsystems = cached->subsystems;
+		}
+		scap_cgroup_cache_unlock(cgi);
+
+		if(cached != NULL)
+		{
 			return SCAP_SUCCESS;
 		}
 	}
@@ -540,11 +561,20 @@ static int32_t get_cgroup_subsystems_v2(struct scap_cgroup_interface* cgi, struc
 		if(cached)
 		{
 			int uth_status = SCAP_SUCCESS;
+			struct scap_cgroup_cache* found;
 			snprintf(cached->path, sizeof(cached->path), "%s", cgroup_mount);
 			memcpy(&cached->subsystems, subsystems, sizeof(cached->subsystems));
 
-			HASH_ADD_STR(cgi->m_cache, path, cached);
-			if(uth_status != SCAP_SUCCESS)
+			// another thread may have cached the same directory meanwhile
+			scap_cgroup_cache_lock(cgi);
+			HASH_FIND_STR(cgi->m_cache, cgroup_mount, found);
+			if(found == NULL)
+			{
+				HASH_ADD_STR(cgi->m_cache, path, cached);
+			}
+			scap_cgroup_cache_unlock(cgi);
+
+			if(found != NULL || uth_status != SCAP_SUCCESS)
 			{
 				free(cached);
 			}
@@ -638,6 +668,7 @@ int32_t scap_cgroup_interface_init(struct scap_cgroup_interface* cgi, const char
 
 	cgi->m_use_cache = true;
 	cgi->m_cache = NULL;
+	cgi->m_cache_lock = NULL;
 	cgi->m_subsystems_v1.len = 0;
 	cgi->m_subsystems_v2.len = 0;
 	cgi->m_mounts_v1.len = 0;
@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -46,6 +47,8 @@ extern "C"
 
 		bool m_use_cache;
 		struct scap_cgroup_cache* m_cache;
+		// protects m_cache when threads resolve cgroups concurrently, may be NULL
+		pthread_mutex_t* m_cache_lock;
 
 		// the cgroups of the current process, as seen from the host cgroupns
 		// empty if:
@@ -36,6 +36,7 @@ limitations under the License.
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <string.h>
+#include <pthread.h>
 
 #include <errno.h>
 #include <netinet/tcp.h>
@@ -356,49 +357,115 @@ int32_t scap_fd_handle_regular_file(struct scap_proclist *proclist, char *fname,
 	return scap_add_fd_to_proc_table(proclist, tinfo, fdi, error);
 }
 
-int32_t scap_fd_handle_socket(struct scap_proclist *proclist, char *fname, scap_threadinfo *tinfo, scap_fdinfo *fdi, char* procdir, uint64_t net_ns, struct scap_ns_socket_list **sockets_by_ns, char *error)
+//
+// Find the socket table of a network namespace, reading it from procdir
+// the first time the namespace is seen.
+//
+// During a parallel /proc scan the tables are shared by the workers, and
+// sockets_lock only protects the lookups and insertions: the table itself
+// is read without holding it, so workers in different namespaces don't
+// wait for each other. Two workers that see a new namespace at the same
+// time may both read it, and the second one drops its copy.
+//
+static int32_t scap_fd_get_ns_sockets(char* procdir, uint64_t net_ns, struct scap_ns_socket_list **sockets_by_ns, pthread_mutex_t *sockets_lock, struct scap_ns_socket_list **sockets_ret, char *error)
+{
+	struct scap_ns_socket_list* sockets = NULL;
+	struct scap_ns_socket_list* found = NULL;
+	int32_t uth_status = SCAP_SUCCESS;
+	int32_t res;
+
+	if(sockets_lock != NULL)
+	{
+		pthread_mutex_lock(sockets_lock);
+	}
+	HASH_FIND_INT64(*sockets_by_ns, &net_ns, found);
+	if(sockets_lock != NULL)
+	{
+		pthread_mutex_unlock(sockets_lock);
+	}
+
+	*sockets_ret = found;
+	if(found != NULL)
+	{
+		return SCAP_SUCCESS;
+	}
+
+	sockets = malloc(sizeof(struct scap_ns_socket_list));
+	if(sockets == NULL)
+	{
+		snprintf(error, SCAP_LASTERR_SIZE, "sockets allocation error");
+		return SCAP_FAILURE;
+	}
+	sockets->net_ns = net_ns;
+	sockets->sockets = NULL;
+	char fd_error[SCAP_LASTERR_SIZE];
+
+	// a table that can't be read is still added, empty, so that it's
+	// not read again for every socket of the namespace
+	res = scap_fd_read_sockets(procdir, sockets, fd_error);
+	if(res == SCAP_FAILURE)
+	{
+		sockets->sockets = NULL;
+	}
+
+	if(sockets_lock != NULL)
+	{
+		pthread_mutex_lock(sockets_lock);
+	}
+	HASH_FIND_INT64(*sockets_by_ns, &net_ns, found);
+	if(found == NULL)
+	{
+		HASH_ADD_INT64(*sockets_by_ns, net_ns, sockets);
+	}
+	if(sockets_lock != NULL)
+	{
+		pthread_mutex_unlock(sockets_lock);
+	}
+
+	if(found != NULL)
+	{
+		scap_fd_free_table(&sockets->sockets);
+		free(sockets);
+		*sockets_ret = found;
+		return SCAP_SUCCESS;
+	}
+
+	if(uth_status != SCAP_SUCCESS)
+	{
+		snprintf(error, SCAP_LASTERR_SIZE, "socket list allocation error");
+		scap_fd_free_table(&sockets->sockets);
+		free(sockets);
+		return SCAP_FAILURE;
+	}
+
+	*sockets_ret = sockets;
+	if(res == SCAP_FAILURE)
+	{
+		snprintf(error, SCAP_LASTERR_SIZE, "Cannot read sockets (%s)", fd_error);
+		return SCAP_FAILURE;
+	}
+
+	return SCAP_SUCCESS;
+}
+
+int32_t scap_fd_handle_socket(struct scap_proclist *proclist, char *fname, scap_threadinfo *tinfo, scap_fdinfo *fdi, char* procdir, uint64_t net_ns, struct scap_ns_socket_list **sockets_by_ns, pthread_mutex_t *sockets_lock, char *error)
 {
 	char link_name[SCAP_MAX_PATH_SIZE];
 	ssize_t r;
 	scap_fdinfo *tfdi;
 	uint64_t ino;
 	struct scap_ns_socket_list* sockets = NULL;
-	int32_t uth_status = SCAP_SUCCESS;
+	int32_t res;
 
 	if(*sockets_by_ns == (void*)-1)
 	{
 		return SCAP_SUCCESS;
 	}
-	else
-	{
-		HASH_FIND_INT64(*sockets_by_ns, &net_ns, sockets);
-		if(sockets == NULL)
-		{
-			sockets = malloc(sizeof(struct scap_ns_socket_list));
-			if(sockets == NULL)
-			{
-				snprintf(error, SCAP_LASTERR_SIZE, "sockets allocation error");
-				return SCAP_FAILURE;
-			}
-			sockets->net_ns = net_ns;
-			sockets->sockets = NULL;
-			char fd_error[SCAP_LASTERR_SIZE];
 
-			HASH_ADD_INT64(*sockets_by_ns, net_ns, sockets);
-			if(uth_status != SCAP_SUCCESS)
-			{
-				snprintf(error, SCAP_LASTERR_SIZE, "socket list allocation error");
-				free(sockets);
-				return SCAP_FAILURE;
-			}
-
-			if(scap_fd_read_sockets(procdir, sockets, fd_error) == SCAP_FAILURE)
-			{
-				snprintf(error, SCAP_LASTERR_SIZE, "Cannot read sockets (%s)", fd_error);
-				sockets->sockets = NULL;
-				return SCAP_FAILURE;
-			}
-		}
+	res = scap_fd_get_ns_sockets(procdir, net_ns, sockets_by_ns, sockets_lock, &sockets, error);
+	if(res != SCAP_SUCCESS)
+	{
+		return res;
 	}
 
 	r = readlink(fname, link_name, SCAP_MAX_PATH_SIZE - 1);
@@ -1348,7 +1415,7 @@ int32_t scap_fd_scan_fd_dir(struct scap_linux_platform *linux_platform, struct s
 				snprintf(error, SCAP_LASTERR_SIZE, "can't allocate scap fd handle for sock fd %" PRIu64, fd);
 				break;
 			}
-			res = scap_fd_handle_socket(proclist, f_name, tinfo, fdi, procdir, net_ns, sockets_by_ns, error);
+			res = scap_fd_handle_socket(proclist, f_name, tinfo, fdi, procdir, net_ns, sockets_by_ns, linux_platform->m_proc_scan_lock, error);
 			if(proclist->m_proc_callback == NULL)
 			{
 				// we can land here if we've got a netlink socket
@@ -44,6 +44,8 @@ static int32_t scap_linux_close_platform(struct scap_platform* platform)
 
 	scap_cgroup_clear_cache(&linux_platform->m_cgroups);
 
+	scap_proc_free_table(&linux_platform->m_proc_scan_previous);
+
 	return SCAP_SUCCESS;
 }
 
@@ -60,6 +62,8 @@ int32_t scap_linux_init_platform(struct scap_platform* platform, char* lasterr,
 	linux_platform->m_engine = engine;
 	linux_platform->m_proc_scan_timeout_ms = oargs->proc_scan_timeout_ms;
 	linux_platform->m_proc_scan_log_interval_ms = oargs->proc_scan_log_interval_ms;
+	linux_platform->m_proc_scan_threads = oargs->proc_scan_threads;
+	linux_platform->m_proc_scan_incremental = oargs->proc_scan_incremental;
 	linux_platform->m_debug_log_fn = oargs->debug_log_fn;
 
 	if(scap_os_get_machine_info(&platform->m_machine_info, lasterr) != SCAP_SUCCESS)
@@ -112,6 +116,7 @@ static const struct scap_platform_vtable scap_linux_platform = {
 	.get_device_by_mount_id = scap_linux_get_device_by_mount_id,
 	.get_proc = scap_linux_proc_get,
 	.refresh_proc_table = scap_linux_refresh_proc_table,
+	.release_proc_table = scap_linux_release_proc_table,
 	.is_thread_alive = scap_linux_is_thread_alive,
 	.get_global_pid = scap_linux_getpid_global,
 	.get_threadlist = scap_linux_get_threadlist,
@@ -25,6 +25,8 @@ extern "C" {
 #define SCAP_HANDLE_T void
 #endif
 
+#include <pthread.h>
+
 #include "scap_cgroup.h"
 #include "scap_platform_impl.h"
 #include "engine_handle.h"
@@ -92,6 +94,17 @@ struct scap_linux_platform
 	// /proc scan parameters
 	uint64_t m_proc_scan_timeout_ms;
 	uint64_t m_proc_scan_log_interval_ms;
+	uint32_t m_proc_scan_threads;
+	bool m_proc_scan_incremental;
+
+	// In incremental mode, the process table built by the last refresh
+	// after its owner gave it back with release_proc_table (i.e. once
+	// scap_dump_open() wrote it). The next refresh starts from it
+	struct scap_proclist m_proc_scan_previous;
+
+	// Protects the state shared by the workers of a parallel /proc scan,
+	// NULL when the scan runs on a single thread
+	pthread_mutex_t* m_proc_scan_lock;
 
 	// Function which may be called to log a debug event
 	void(*m_debug_log_fn)(const char* msg);
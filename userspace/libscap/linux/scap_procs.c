@@ -28,6 +28,7 @@ limitations under the License.
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include "unixid.h"
 
 #include "scap.h"
@@ -545,6 +546,22 @@ int32_t scap_proc_fill_exe_writable(char* error, struct scap_threadinfo* tinfo,
 	return SCAP_SUCCESS;
 }
 
+static inline void scap_proc_scan_lock(struct scap_linux_platform* linux_platform)
+{
+	if(linux_platform->m_proc_scan_lock != NULL)
+	{
+		pthread_mutex_lock(linux_platform->m_proc_scan_lock);
+	}
+}
+
+static inline void scap_proc_scan_unlock(struct scap_linux_platform* linux_platform)
+{
+	if(linux_platform->m_proc_scan_lock != NULL)
+	{
+		pthread_mutex_unlock(linux_platform->m_proc_scan_lock);
+	}
+}
+
 //
 // Add a process to the list by parsing its entry under /proc
 //
@@ -563,6 +580,7 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	bool free_tinfo = false;
 	int32_t res = SCAP_SUCCESS;
 	struct stat dirstat;
+	char lasterr[SCAP_LASTERR_SIZE];
 
 	snprintf(dir_name, sizeof(dir_name), "%s/%u/", procdirname, tid);
 	snprintf(filename, sizeof(filename), "%sexe", dir_name);
@@ -653,7 +671,10 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	}
 
 	bool suppressed;
-	if ((res = scap_update_suppressed(&linux_platform->m_generic.m_suppress, tinfo->comm, tid, 0, &suppressed)) != SCAP_SUCCESS)
+	scap_proc_scan_lock(linux_platform);
+	res = scap_update_suppressed(&linux_platform->m_generic.m_suppress, tinfo->comm, tid, 0, &suppressed);
+	scap_proc_scan_unlock(linux_platform);
+	if (res != SCAP_SUCCESS)
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't update set of suppressed tids");
@@ -744,21 +765,21 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	//
 	// set the current working directory of the process
 	//
-	if(SCAP_FAILURE == scap_proc_fill_cwd(linux_platform->m_lasterr, dir_name, tinfo))
+	if(SCAP_FAILURE == scap_proc_fill_cwd(lasterr, dir_name, tinfo))
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't fill cwd for %s (%s)",
-			 dir_name, linux_platform->m_lasterr);
+			 dir_name, lasterr);
 	}
 
 	//
 	// extract the user id and ppid from /proc/pid/status
 	//
-	if(SCAP_FAILURE == scap_proc_fill_info_from_stats(linux_platform->m_lasterr, dir_name, tinfo))
+	if(SCAP_FAILURE == scap_proc_fill_info_from_stats(lasterr, dir_name, tinfo))
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't fill uid and pid for %s (%s)",
-			 dir_name, linux_platform->m_lasterr);
+			 dir_name, lasterr);
 	}
 
 	//
@@ -768,17 +789,18 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't fill flimit for %s (%s)",
-			 dir_name, linux_platform->m_lasterr);
+			 dir_name, lasterr);
 	}
 
-	if(scap_cgroup_get_thread(&linux_platform->m_cgroups, dir_name, &tinfo->cgroups, linux_platform->m_lasterr) == SCAP_FAILURE)
+	res = scap_cgroup_get_thread(&linux_platform->m_cgroups, dir_name, &tinfo->cgroups, lasterr);
+	if(res == SCAP_FAILURE)
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't fill cgroups for %s (%s)",
-				      dir_name, linux_platform->m_lasterr);
+				      dir_name, lasterr);
 	}
 
-	if(scap_proc_fill_pidns_start_ts(linux_platform->m_lasterr, tinfo, dir_name) == SCAP_FAILURE)
+	if(scap_proc_fill_pidns_start_ts(lasterr, tinfo, dir_name) == SCAP_FAILURE)
 	{
 		// ignore errors
 		// the thread may not have /proc visible so we shouldn't kill the scan if this fails
@@ -799,21 +821,21 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 	//
 	// set the current root of the process
 	//
-	if(SCAP_FAILURE == scap_proc_fill_root(linux_platform->m_lasterr, tinfo, dir_name))
+	if(SCAP_FAILURE == scap_proc_fill_root(lasterr, tinfo, dir_name))
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't fill root for %s (%s)",
-			 dir_name, linux_platform->m_lasterr);
+			 dir_name, lasterr);
 	}
 
 	//
 	// set the loginuid
 	//
-	if(SCAP_FAILURE == scap_proc_fill_loginuid(linux_platform->m_lasterr, tinfo, dir_name))
+	if(SCAP_FAILURE == scap_proc_fill_loginuid(lasterr, tinfo, dir_name))
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't fill loginuid for %s (%s)",
-			 dir_name, linux_platform->m_lasterr);
+			 dir_name, lasterr);
 	}
 
 	// Container start time for host processes will be equal to when the
@@ -843,18 +865,18 @@ static int32_t scap_proc_add_from_proc(struct scap_linux_platform* linux_platfor
 		tinfo->flags = PPM_CL_CLONE_THREAD | PPM_CL_CLONE_FILES;
 	}
 
-	if(SCAP_FAILURE == scap_proc_fill_exe_ino_ctime_mtime(linux_platform->m_lasterr, tinfo, dir_name, target_name))
+	if(SCAP_FAILURE == scap_proc_fill_exe_ino_ctime_mtime(lasterr, tinfo, dir_name, target_name))
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't fill exe writable access for %s (%s)",
-			 dir_name, linux_platform->m_lasterr);
+			 dir_name, lasterr);
 	}
 
-	if(SCAP_FAILURE == scap_proc_fill_exe_writable(linux_platform->m_lasterr, tinfo, tinfo->uid, tinfo->gid, dir_name, target_name))
+	if(SCAP_FAILURE == scap_proc_fill_exe_writable(lasterr, tinfo, tinfo->uid, tinfo->gid, dir_name, target_name))
 	{
 		free(tinfo);
 		return scap_errprintf(error, 0, "can't fill exe writable access for %s (%s)",
-			 dir_name, linux_platform->m_lasterr);
+			 dir_name, lasterr);
 	}
 
 	//
@@ -932,10 +954,231 @@ int32_t scap_proc_read_thread(struct scap_linux_platform* linux_platform, struct
 	return res;
 }
 
+//
+// Progress tracking of a top-level /proc scan, for the timeout and the
+// periodic log messages
+//
+struct scap_proc_scan_timing
+{
+	bool m_enabled;
+	uint64_t m_monotonic_ts_context;
+	uint64_t m_start_ts_ms;
+	uint64_t m_last_log_ts_ms;
+	uint64_t m_last_proc_ts_ms;
+	uint64_t m_min_proc_time_ms;
+	uint64_t m_max_proc_time_ms;
+	uint64_t m_num_procs_processed;
+	uint64_t m_total_num_fds;
+	uint64_t m_last_tid_processed;
+	bool m_timeout_expired;
+};
+
+static void scap_proc_scan_timing_init(struct scap_linux_platform* linux_platform, struct scap_proc_scan_timing* timing, bool top_level)
+{
+	memset(timing, 0, sizeof(*timing));
+
+	// Do timing tracking only if:
+	// - this is the top-level call
+	// - one or both of the timing parameters is configured to non-zero
+	timing->m_enabled = top_level &&
+	                    ((linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE) ||
+	                     (linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE));
+	timing->m_monotonic_ts_context = SCAP_GET_CUR_TS_MS_CONTEXT_INIT;
+	timing->m_min_proc_time_ms = UINT64_MAX;
+
+	if (timing->m_enabled)
+	{
+		timing->m_start_ts_ms = scap_get_monotonic_ts_ms(&timing->m_monotonic_ts_context);
+		timing->m_last_log_ts_ms = timing->m_start_ts_ms;
+		timing->m_last_proc_ts_ms = timing->m_start_ts_ms;
+	}
+}
+
+//
+// Account for a successfully processed process and return true
+// if the scan timeout has expired
+//
+static bool scap_proc_scan_timing_update(struct scap_linux_platform* linux_platform, struct scap_proc_scan_timing* timing, uint64_t tid, uint64_t num_fds)
+{
+	timing->m_last_tid_processed = tid;
+	timing->m_num_procs_processed++;
+	timing->m_total_num_fds += num_fds;
+
+	if (!timing->m_enabled)
+	{
+		return false;
+	}
+
+	uint64_t cur_ts_ms = scap_get_monotonic_ts_ms(&timing->m_monotonic_ts_context);
+	uint64_t total_elapsed_time_ms = cur_ts_ms - timing->m_start_ts_ms;
+
+	uint64_t this_proc_elapsed_time_ms = cur_ts_ms - timing->m_last_proc_ts_ms;
+	timing->m_last_proc_ts_ms = cur_ts_ms;
+
+	if (this_proc_elapsed_time_ms < timing->m_min_proc_time_ms)
+	{
+		timing->m_min_proc_time_ms = this_proc_elapsed_time_ms;
+	}
+	if (this_proc_elapsed_time_ms > timing->m_max_proc_time_ms)
+	{
+		timing->m_max_proc_time_ms = this_proc_elapsed_time_ms;
+	}
+
+	if (linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE)
+	{
+		uint64_t log_elapsed_time_ms = cur_ts_ms - timing->m_last_log_ts_ms;
+		if (log_elapsed_time_ms >= linux_platform->m_proc_scan_log_interval_ms)
+		{
+			scap_debug_log(linux_platform,
+				"scap_proc_scan: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
+				timing->m_num_procs_processed,
+				total_elapsed_time_ms,
+				(total_elapsed_time_ms / (uint64_t)timing->m_num_procs_processed),
+				timing->m_min_proc_time_ms,
+				timing->m_max_proc_time_ms,
+				timing->m_last_tid_processed,
+				timing->m_total_num_fds);
+			timing->m_last_log_ts_ms = cur_ts_ms;
+		}
+	}
+
+	if (linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE)
+	{
+		if (total_elapsed_time_ms >= linux_platform->m_proc_scan_timeout_ms)
+		{
+			timing->m_timeout_expired = true;
+		}
+	}
+
+	return timing->m_timeout_expired;
+}
+
+static void scap_proc_scan_timing_done(struct scap_linux_platform* linux_platform, struct scap_proc_scan_timing* timing)
+{
+	if (!timing->m_enabled)
+	{
+		return;
+	}
+
+	uint64_t cur_ts_ms = scap_get_monotonic_ts_ms(&timing->m_monotonic_ts_context);
+	uint64_t total_elapsed_time_ms = cur_ts_ms - timing->m_start_ts_ms;
+	uint64_t avg_proc_time_ms = (timing->m_num_procs_processed != 0) ?
+		(total_elapsed_time_ms / timing->m_num_procs_processed) : 0;
+
+	if (timing->m_timeout_expired)
+	{
+		scap_debug_log(linux_platform,
+			"scap_proc_scan TIMEOUT (%ld ms): %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
+			linux_platform->m_proc_scan_timeout_ms,
+			timing->m_num_procs_processed,
+			total_elapsed_time_ms,
+			avg_proc_time_ms,
+			timing->m_min_proc_time_ms,
+			timing->m_max_proc_time_ms,
+			timing->m_last_tid_processed,
+			timing->m_total_num_fds);
+	}
+	else if ((linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) &&
+		(timing->m_num_procs_processed != 0))
+	{
+		scap_debug_log(linux_platform,
+			"scap_proc_scan DONE: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
+			timing->m_num_procs_processed,
+			total_elapsed_time_ms,
+			avg_proc_time_ms,
+			timing->m_min_proc_time_ms,
+			timing->m_max_proc_time_ms,
+			timing->m_last_tid_processed,
+			timing->m_total_num_fds);
+	}
+}
+
+static bool scap_proc_is_tid_dir(const char* name)
+{
+	return strspn(name, "0123456789") == strlen(name);
+}
+
+//
+// Return true if the entry of an earlier scan still describes the process
+// running with its tid, i.e. if its start time (the ctime of cmdline, see
+// clone_ts in scap_proc_add_from_proc()) and its executable are unchanged
+//
+static bool scap_proc_is_unchanged(const char* procdirname, const scap_threadinfo* tinfo)
+{
+	char filename[SCAP_MAX_PATH_SIZE];
+	char target_name[SCAP_MAX_PATH_SIZE];
+	int target_res;
+	struct stat targetstat;
+
+	snprintf(filename, sizeof(filename), "%s/%" PRId64 "/cmdline", procdirname, tinfo->tid);
+	if(tinfo->clone_ts == 0 ||
+	   stat(filename, &targetstat) != 0 ||
+	   targetstat.st_ctim.tv_sec * SECOND_TO_NS + targetstat.st_ctim.tv_nsec != tinfo->clone_ts)
+	{
+		return false;
+	}
+
+	snprintf(filename, sizeof(filename), "%s/%" PRId64 "/exe", procdirname, tinfo->tid);
+	target_res = readlink(filename, target_name, sizeof(target_name) - 1);
+	if(target_res <= 0)
+	{
+		return false;
+	}
+	target_name[target_res] = 0;
+
+	return strcmp(target_name, tinfo->exepath) == 0 &&
+	       stat(target_name, &targetstat) == 0 &&
+	       targetstat.st_ino == tinfo->exe_ino &&
+	       targetstat.st_ctim.tv_sec * SECOND_TO_NS + targetstat.st_ctim.tv_nsec == tinfo->exe_ino_ctime &&
+	       targetstat.st_mtim.tv_sec * SECOND_TO_NS + targetstat.st_mtim.tv_nsec == tinfo->exe_ino_mtime;
+}
+
+//
+// Move the entry of tid from the table of a previous scan to proclist, fds
+// included, if the process didn't change since then. Return false if the
+// tid must be read again from /proc. The workers of a parallel scan share
+// previous, so it's only accessed under linux_platform->m_proc_scan_lock.
+//
+static bool scap_proc_reuse_previous(struct scap_linux_platform* linux_platform, struct scap_proclist* previous, struct scap_proclist* proclist, const char* procdirname, uint64_t tid)
+{
+	int32_t uth_status = SCAP_SUCCESS;
+	scap_threadinfo* tinfo;
+
+	scap_proc_scan_lock(linux_platform);
+	HASH_FIND_INT64(previous->m_proclist, &tid, tinfo);
+	if(tinfo != NULL)
+	{
+		HASH_DEL(previous->m_proclist, tinfo);
+	}
+	scap_proc_scan_unlock(linux_platform);
+
+	if(tinfo == NULL)
+	{
+		return false;
+	}
+
+	if(scap_proc_is_unchanged(procdirname, tinfo))
+	{
+		HASH_ADD_INT64(proclist->m_proclist, tid, tinfo);
+		if(uth_status == SCAP_SUCCESS)
+		{
+			return true;
+		}
+	}
+
+	scap_fd_free_proc_fd_table(tinfo);
+	free(tinfo);
+	return false;
+}
+
 //
 // Scan a directory containing multiple processes under /proc
 //
-static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_platform, struct scap_proclist* proclist, char* procdirname, int parenttid, char *error)
+// If previous is not NULL, it holds the table of an earlier scan: the entries
+// of the processes that didn't change are moved to proclist as they are,
+// fds included, instead of being read again
+//
+static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_platform, struct scap_proclist* proclist, char* procdirname, int parenttid, struct scap_proclist* previous, char *error)
 {
 	DIR *dir_p;
 	struct dirent *dir_entry_p;
@@ -943,11 +1186,8 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 	uint64_t tid;
 	int32_t res = SCAP_SUCCESS;
 	char childdir[SCAP_MAX_PATH_SIZE];
-
-	uint64_t num_procs_processed = 0;
-	uint64_t total_num_fds = 0;
-	uint64_t last_tid_processed = 0;
 	struct scap_ns_socket_list* sockets_by_ns = NULL;
+	struct scap_proc_scan_timing timing;
 
 	dir_p = opendir(procdirname);
 
@@ -957,29 +1197,9 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 		return SCAP_NOTFOUND;
 	}
 
-	// Do timing tracking only if:
-	// - this is the top-level call (parenttid == -1)
-	// - one or both of the timing parameters is configured to non-zero
-	bool do_timing = (parenttid == -1) &&
-	                 ((linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE) ||
-	                  (linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE));
-	uint64_t monotonic_ts_context = SCAP_GET_CUR_TS_MS_CONTEXT_INIT;
-	uint64_t start_ts_ms = 0;
-	uint64_t last_log_ts_ms = 0;
-	uint64_t last_proc_ts_ms = 0;
-	uint64_t cur_ts_ms = 0;
-	uint64_t min_proc_time_ms = UINT64_MAX;
-	uint64_t max_proc_time_ms = 0;
-
-	if (do_timing)
-	{
-		start_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-		last_log_ts_ms = start_ts_ms;
-		last_proc_ts_ms = start_ts_ms;
-	}
+	scap_proc_scan_timing_init(linux_platform, &timing, parenttid == -1);
 
-	bool timeout_expired = false;
-	while (!timeout_expired)
+	while (!timing.m_timeout_expired)
 	{
 		dir_entry_p = readdir(dir_p);
 		if (dir_entry_p == NULL)
@@ -987,7 +1207,7 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 			break;
 		}
 
-		if(strspn(dir_entry_p->d_name, "0123456789") != strlen(dir_entry_p->d_name))
+		if(!scap_proc_is_tid_dir(dir_entry_p->d_name))
 		{
 			continue;
 		}
@@ -1024,8 +1244,15 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 		//
 		// We have a process that needs to be explored
 		//
-		uint64_t num_fds_this_proc;
-		res = scap_proc_add_from_proc(linux_platform, proclist, tid, procdirname, &sockets_by_ns, NULL, &num_fds_this_proc, add_error);
+		uint64_t num_fds_this_proc = 0;
+		if(previous != NULL && scap_proc_reuse_previous(linux_platform, previous, proclist, procdirname, tid))
+		{
+			res = SCAP_SUCCESS;
+		}
+		else
+		{
+			res = scap_proc_add_from_proc(linux_platform, proclist, tid, procdirname, &sockets_by_ns, NULL, &num_fds_this_proc, add_error);
+		}
 		if(res != SCAP_SUCCESS)
 		{
 			//
@@ -1051,7 +1278,7 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 		if(parenttid == -1 && !linux_platform->m_minimal_scan)
 		{
 			snprintf(childdir, sizeof(childdir), "%s/%u/task", procdirname, (int)tid);
-			if(_scap_proc_scan_proc_dir_impl(linux_platform, proclist, childdir, tid, error) == SCAP_FAILURE)
+			if(_scap_proc_scan_proc_dir_impl(linux_platform, proclist, childdir, tid, previous, error) == SCAP_FAILURE)
 			{
 				res = SCAP_FAILURE;
 				break;
@@ -1059,96 +1286,415 @@ static int32_t _scap_proc_scan_proc_dir_impl(struct scap_linux_platform* linux_p
 		}
 
 		// TID successfully processed.
-		last_tid_processed = tid;
-		num_procs_processed++;
-		total_num_fds += num_fds_this_proc;
-
 		// After successful processing of a process at the top level,
 		// perform timing processing if configured.
-		if (do_timing)
-		{
-			cur_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-			uint64_t total_elapsed_time_ms = cur_ts_ms - start_ts_ms;
+		scap_proc_scan_timing_update(linux_platform, &timing, tid, num_fds_this_proc);
+	}
 
-			uint64_t this_proc_elapsed_time_ms = cur_ts_ms - last_proc_ts_ms;
-			last_proc_ts_ms = cur_ts_ms;
+	scap_proc_scan_timing_done(linux_platform, &timing);
 
-			if (this_proc_elapsed_time_ms < min_proc_time_ms)
-			{
-				min_proc_time_ms = this_proc_elapsed_time_ms;
-			}
-			if (this_proc_elapsed_time_ms > max_proc_time_ms)
-			{
-				max_proc_time_ms = this_proc_elapsed_time_ms;
-			}
+	closedir(dir_p);
+	if(sockets_by_ns != NULL && sockets_by_ns != (void*)-1)
+	{
+		scap_fd_free_ns_sockets_list(&sockets_by_ns);
+	}
+	return res;
+}
+
+//
+// Parallel /proc scan
+//
+// The processes found under /proc are split among a pool of workers, each
+// one reading a process, its fds and its threads into a private list.
+// The main thread merges the private lists into the process list in the
+// order of /proc, so that the process list and the sequence of callbacks
+// are the same as the ones of the serial scan. The socket tables of the
+// network namespaces, the cgroup cache and the set of suppressed tids are
+// shared by the workers: linux_platform->m_proc_scan_lock only guards
+// their lookups and updates, the files under /proc are read without it.
+//
+struct scap_proc_scan_job
+{
+	uint64_t m_tid;
+	int32_t m_res;
+	uint64_t m_num_fds;
+	scap_threadinfo** m_tinfos; // the process first, then its threads
+	uint64_t m_n_tinfos;
+	bool m_done;
+};
+
+struct scap_proc_scan_pool
+{
+	struct scap_linux_platform* m_linux_platform;
+	char* m_procdirname;
+	struct scap_ns_socket_list* m_sockets_by_ns;
+	struct scap_proclist* m_previous;
+
+	struct scap_proc_scan_job* m_jobs;
+	uint64_t m_n_jobs;
+
+	// protects the fields below
+	pthread_mutex_t m_lock;
+	pthread_cond_t m_job_done;
+	uint64_t m_next_job;
+	bool m_stop;
+};
+
+static void scap_proc_scan_free_tinfos(scap_threadinfo** tinfos, uint64_t n_tinfos)
+{
+	uint64_t i;
+
+	for(i = 0; i < n_tinfos; i++)
+	{
+		scap_fd_free_proc_fd_table(tinfos[i]);
+		free(tinfos[i]);
+	}
+}
+
+//
+// Move the threads of a private list into the job, in insertion order
+//
+static void scap_proc_scan_job_collect(struct scap_proc_scan_job* job, struct scap_proclist* local)
+{
+	scap_threadinfo* tinfo;
+	scap_threadinfo* ttinfo;
+	uint64_t n_tinfos = HASH_COUNT(local->m_proclist);
 
-			if (linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE)
+	job->m_tinfos = NULL;
+	job->m_n_tinfos = 0;
+	if(n_tinfos == 0)
+	{
+		return;
+	}
+
+	job->m_tinfos = malloc(n_tinfos * sizeof(scap_threadinfo*));
+	if(job->m_tinfos == NULL)
+	{
+		// drop the process, as when reading it fails
+		scap_proc_free_table(local);
+		job->m_res = SCAP_FAILURE;
+		return;
+	}
+
+	HASH_ITER(hh, local->m_proclist, tinfo, ttinfo)
+	{
+		HASH_DEL(local->m_proclist, tinfo);
+		job->m_tinfos[job->m_n_tinfos++] = tinfo;
+	}
+}
+
+static void scap_proc_scan_job_run(struct scap_proc_scan_pool* pool, struct scap_proc_scan_job* job)
+{
+	struct scap_linux_platform* linux_platform = pool->m_linux_platform;
+	struct scap_proclist local = {0};
+	char add_error[SCAP_LASTERR_SIZE];
+	char childdir[SCAP_MAX_PATH_SIZE];
+	DIR *dir_p;
+	struct dirent *dir_entry_p;
+
+	job->m_num_fds = 0;
+	if(pool->m_previous != NULL && scap_proc_reuse_previous(linux_platform, pool->m_previous, &local, pool->m_procdirname, job->m_tid))
+	{
+		job->m_res = SCAP_SUCCESS;
+	}
+	else
+	{
+		job->m_res = scap_proc_add_from_proc(linux_platform, &local, job->m_tid, pool->m_procdirname, &pool->m_sockets_by_ns, NULL, &job->m_num_fds, add_error);
+	}
+
+	//
+	// Add the tasks of the process, as the recursive call of the serial scan does
+	//
+	if(job->m_res == SCAP_SUCCESS && !linux_platform->m_minimal_scan)
+	{
+		snprintf(childdir, sizeof(childdir), "%s/%u/task", pool->m_procdirname, (int)job->m_tid);
+		dir_p = opendir(childdir);
+		if(dir_p != NULL)
+		{
+			while((dir_entry_p = readdir(dir_p)) != NULL)
 			{
-				uint64_t log_elapsed_time_ms = cur_ts_ms - last_log_ts_ms;
-				if (log_elapsed_time_ms >= linux_platform->m_proc_scan_log_interval_ms)
+				if(!scap_proc_is_tid_dir(dir_entry_p->d_name))
 				{
-					scap_debug_log(linux_platform,
-						"scap_proc_scan: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
-						num_procs_processed,
-						total_elapsed_time_ms,
-						(total_elapsed_time_ms / (uint64_t)num_procs_processed),
-						min_proc_time_ms,
-						max_proc_time_ms,
-						last_tid_processed,
-						total_num_fds);
-					last_log_ts_ms = cur_ts_ms;
+					continue;
 				}
-			}
 
-			if (linux_platform->m_proc_scan_timeout_ms != SCAP_PROC_SCAN_TIMEOUT_NONE)
-			{
-				if (total_elapsed_time_ms >= linux_platform->m_proc_scan_timeout_ms)
+				uint64_t tid = atoi(dir_entry_p->d_name);
+				if(tid == job->m_tid)
+				{
+					continue;
+				}
+
+				uint64_t num_fds;
+				if(pool->m_previous == NULL || !scap_proc_reuse_previous(linux_platform, pool->m_previous, &local, childdir, tid))
 				{
-					timeout_expired = true;
+					scap_proc_add_from_proc(linux_platform, &local, tid, childdir, &pool->m_sockets_by_ns, NULL, &num_fds, add_error);
 				}
 			}
+			closedir(dir_p);
 		}
 	}
 
-	if (do_timing)
-	{
-		cur_ts_ms = scap_get_monotonic_ts_ms(&monotonic_ts_context);
-		uint64_t total_elapsed_time_ms = cur_ts_ms - start_ts_ms;
-		uint64_t avg_proc_time_ms = (num_procs_processed != 0) ?
-			(total_elapsed_time_ms / num_procs_processed) : 0;
+	scap_proc_scan_job_collect(job, &local);
+}
+
+static void* scap_proc_scan_worker(void* arg)
+{
+	struct scap_proc_scan_pool* pool = (struct scap_proc_scan_pool*)arg;
 
-		if (timeout_expired)
+	while(true)
+	{
+		pthread_mutex_lock(&pool->m_lock);
+		if(pool->m_stop || pool->m_next_job == pool->m_n_jobs)
 		{
-			scap_debug_log(linux_platform,
-				"scap_proc_scan TIMEOUT (%ld ms): %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
-				linux_platform->m_proc_scan_timeout_ms,
-				num_procs_processed,
-				total_elapsed_time_ms,
-				avg_proc_time_ms,
-				min_proc_time_ms,
-				max_proc_time_ms,
-				last_tid_processed,
-				total_num_fds);
+			pthread_mutex_unlock(&pool->m_lock);
+			break;
 		}
-		else if ((linux_platform->m_proc_scan_log_interval_ms != SCAP_PROC_SCAN_LOG_NONE) &&
-			(num_procs_processed != 0))
+		struct scap_proc_scan_job* job = &pool->m_jobs[pool->m_next_job++];
+		pthread_mutex_unlock(&pool->m_lock);
+
+		scap_proc_scan_job_run(pool, job);
+
+		pthread_mutex_lock(&pool->m_lock);
+		job->m_done = true;
+		pthread_cond_broadcast(&pool->m_job_done);
+		pthread_mutex_unlock(&pool->m_lock);
+	}
+
+	return NULL;
+}
+
+//
+// Add a thread read by a worker to the process table, or fire the
+// notification callbacks for it and its fds
+//
+static int32_t scap_proc_scan_merge_tinfo(struct scap_proclist* proclist, scap_threadinfo* tinfo, char* error)
+{
+	int32_t uth_status = SCAP_SUCCESS;
+	scap_threadinfo* dup;
+	scap_fdinfo* fdlist;
+	scap_fdinfo* fdi;
+	scap_fdinfo* tfdi;
+
+	HASH_FIND_INT64(proclist->m_proclist, &tinfo->tid, dup);
+	if(dup != NULL)
+	{
+		ASSERT(false);
+		scap_errprintf(error, 0, "duplicate process %"PRIu64, tinfo->tid);
+		scap_fd_free_proc_fd_table(tinfo);
+		free(tinfo);
+		return SCAP_FAILURE;
+	}
+
+	if(proclist->m_proc_callback == NULL)
+	{
+		HASH_ADD_INT64(proclist->m_proclist, tid, tinfo);
+		if(uth_status != SCAP_SUCCESS)
 		{
-			scap_debug_log(linux_platform,
-				"scap_proc_scan DONE: %ld proc in %ld ms, avg=%ld/min=%ld/max=%ld, last pid %ld, num_fds %ld",
-				num_procs_processed,
-				total_elapsed_time_ms,
-				avg_proc_time_ms,
-				min_proc_time_ms,
-				max_proc_time_ms,
-				last_tid_processed,
-				total_num_fds);
+			scap_fd_free_proc_fd_table(tinfo);
+			free(tinfo);
+			return scap_errprintf(error, 0, "process table allocation error (2)");
 		}
+		return SCAP_SUCCESS;
+	}
+
+	//
+	// The serial scan notifies the thread before reading its fds,
+	// so the callbacks never see them in the fd list
+	//
+	fdlist = tinfo->fdlist;
+	tinfo->fdlist = NULL;
+	proclist->m_proc_callback(proclist->m_proc_callback_context, tinfo->tid, tinfo, NULL);
+	HASH_ITER(hh, fdlist, fdi, tfdi)
+	{
+		proclist->m_proc_callback(proclist->m_proc_callback_context, tinfo->tid, tinfo, fdi);
+	}
+	scap_fd_free_table(&fdlist);
+	free(tinfo);
+	return SCAP_SUCCESS;
+}
+
+//
+// Read the tids of the processes under procdirname, in directory order
+//
+static int32_t scap_proc_scan_list_jobs(char* procdirname, struct scap_proc_scan_job** jobs_ret, uint64_t* n_jobs_ret, char* error)
+{
+	DIR *dir_p;
+	struct dirent *dir_entry_p;
+	struct scap_proc_scan_job* jobs = NULL;
+	uint64_t n_jobs = 0;
+	uint64_t capacity = 0;
+
+	dir_p = opendir(procdirname);
+	if(dir_p == NULL)
+	{
+		scap_errprintf(error, errno, "error opening the %s directory", procdirname);
+		return SCAP_NOTFOUND;
 	}
 
+	while((dir_entry_p = readdir(dir_p)) != NULL)
+	{
+		if(!scap_proc_is_tid_dir(dir_entry_p->d_name))
+		{
+			continue;
+		}
+
+		if(n_jobs == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 1024;
+			struct scap_proc_scan_job* tmp = realloc(jobs, capacity * sizeof(*jobs));
+			if(tmp == NULL)
+			{
+				free(jobs);
+				closedir(dir_p);
+				return scap_errprintf(error, errno, "can't allocate the /proc scan jobs");
+			}
+			jobs = tmp;
+		}
+
+		memset(&jobs[n_jobs], 0, sizeof(*jobs));
+		jobs[n_jobs].m_tid = atoi(dir_entry_p->d_name);
+		n_jobs++;
+	}
 	closedir(dir_p);
-	if(sockets_by_ns != NULL && sockets_by_ns != (void*)-1)
+
+	*jobs_ret = jobs;
+	*n_jobs_ret = n_jobs;
+	return SCAP_SUCCESS;
+}
+
+static int32_t scap_proc_scan_proc_dir_parallel(struct scap_linux_platform* linux_platform, struct scap_proclist* proclist, char* procdirname, struct scap_proclist* previous, char *error)
+{
+	struct scap_proc_scan_pool pool;
+	struct scap_proc_scan_timing timing;
+	pthread_mutex_t scan_lock;
+	pthread_t* workers;
+	uint32_t n_workers = 0;
+	uint64_t i;
+	uint64_t j;
+	int32_t res;
+
+	memset(&pool, 0, sizeof(pool));
+	pool.m_linux_platform = linux_platform;
+	pool.m_procdirname = procdirname;
+	pool.m_previous = previous;
+
+	res = scap_proc_scan_list_jobs(procdirname, &pool.m_jobs, &pool.m_n_jobs, error);
+	if(res != SCAP_SUCCESS)
 	{
-		scap_fd_free_ns_sockets_list(&sockets_by_ns);
+		return res;
+	}
+
+	uint32_t max_workers = linux_platform->m_proc_scan_threads;
+	if(max_workers > pool.m_n_jobs)
+	{
+		max_workers = (uint32_t)pool.m_n_jobs;
+	}
+
+	workers = calloc(max_workers ? max_workers : 1, sizeof(pthread_t));
+	if(workers == NULL)
+	{
+		free(pool.m_jobs);
+		return _scap_proc_scan_proc_dir_impl(linux_platform, proclist, procdirname, -1, previous, error);
+	}
+
+	pthread_mutex_init(&pool.m_lock, NULL);
+	pthread_cond_init(&pool.m_job_done, NULL);
+	pthread_mutex_init(&scan_lock, NULL);
+	linux_platform->m_proc_scan_lock = &scan_lock;
+	linux_platform->m_cgroups.m_cache_lock = &scan_lock;
+
+	for(n_workers = 0; n_workers < max_workers; n_workers++)
+	{
+		if(pthread_create(&workers[n_workers], NULL, scap_proc_scan_worker, &pool) != 0)
+		{
+			break;
+		}
+	}
+
+	if(n_workers == 0 && pool.m_n_jobs != 0)
+	{
+		// no threads available, fall back to the serial scan
+		linux_platform->m_proc_scan_lock = NULL;
+		linux_platform->m_cgroups.m_cache_lock = NULL;
+		pthread_mutex_destroy(&scan_lock);
+		pthread_cond_destroy(&pool.m_job_done);
+		pthread_mutex_destroy(&pool.m_lock);
+		free(workers);
+		free(pool.m_jobs);
+		return _scap_proc_scan_proc_dir_impl(linux_platform, proclist, procdirname, -1, previous, error);
+	}
+
+	scap_proc_scan_timing_init(linux_platform, &timing, true);
+
+	//
+	// Merge the jobs in order, as they complete
+	//
+	for(i = 0; i < pool.m_n_jobs && res == SCAP_SUCCESS && !timing.m_timeout_expired; i++)
+	{
+		struct scap_proc_scan_job* job = &pool.m_jobs[i];
+
+		pthread_mutex_lock(&pool.m_lock);
+		while(!job->m_done)
+		{
+			pthread_cond_wait(&pool.m_job_done, &pool.m_lock);
+		}
+		pthread_mutex_unlock(&pool.m_lock);
+
+		for(j = 0; j < job->m_n_tinfos; j++)
+		{
+			res = scap_proc_scan_merge_tinfo(proclist, job->m_tinfos[j], error);
+			if(res != SCAP_SUCCESS)
+			{
+				// the threads left are freed with the job
+				j++;
+				break;
+			}
+		}
+
+		// the merged threads now belong to the process list
+		scap_proc_scan_free_tinfos(job->m_tinfos + j, job->m_n_tinfos - j);
+		free(job->m_tinfos);
+		job->m_tinfos = NULL;
+		job->m_n_tinfos = 0;
+		if(res != SCAP_SUCCESS)
+		{
+			break;
+		}
+
+		if(job->m_res == SCAP_SUCCESS)
+		{
+			scap_proc_scan_timing_update(linux_platform, &timing, job->m_tid, job->m_num_fds);
+		}
+	}
+
+	pthread_mutex_lock(&pool.m_lock);
+	pool.m_stop = true;
+	pthread_mutex_unlock(&pool.m_lock);
+
+	for(i = 0; i < n_workers; i++)
+	{
+		pthread_join(workers[i], NULL);
+	}
+
+	scap_proc_scan_timing_done(linux_platform, &timing);
+
+	// results of the jobs that were not merged, after a timeout or an error
+	for(i = 0; i < pool.m_n_jobs; i++)
+	{
+		scap_proc_scan_free_tinfos(pool.m_jobs[i].m_tinfos, pool.m_jobs[i].m_n_tinfos);
+		free(pool.m_jobs[i].m_tinfos);
+	}
+
+	linux_platform->m_proc_scan_lock = NULL;
+	linux_platform->m_cgroups.m_cache_lock = NULL;
+	pthread_mutex_destroy(&scan_lock);
+	pthread_cond_destroy(&pool.m_job_done);
+	pthread_mutex_destroy(&pool.m_lock);
+	free(workers);
+	free(pool.m_jobs);
+	if(pool.m_sockets_by_ns != NULL)
+	{
+		scap_fd_free_ns_sockets_list(&pool.m_sockets_by_ns);
 	}
 	return res;
 }
@@ -1249,6 +1795,27 @@ int32_t scap_linux_refresh_proc_table(struct scap_platform* platform, struct sca
 {
 	char procdirname[SCAP_MAX_PATH_SIZE];
 	struct scap_linux_platform* linux_platform = (struct scap_linux_platform*)platform;
+	struct scap_proclist previous = {0};
+
+	//
+	// In incremental mode, start from the table of the last refresh, whether
+	// the caller still holds it or gave it back with release_proc_table.
+	// The callbacks must see every process, so they always get a full scan.
+	//
+	if(linux_platform->m_proc_scan_incremental && proclist->m_proc_callback == NULL)
+	{
+		if(proclist->m_proclist != NULL)
+		{
+			previous.m_proclist = proclist->m_proclist;
+			proclist->m_proclist = NULL;
+			scap_proc_free_table(&linux_platform->m_proc_scan_previous);
+		}
+		else
+		{
+			previous.m_proclist = linux_platform->m_proc_scan_previous.m_proclist;
+			linux_platform->m_proc_scan_previous.m_proclist = NULL;
+		}
+	}
 
 	if(proclist->m_proclist)
 	{
@@ -1258,11 +1825,37 @@ int32_t scap_linux_refresh_proc_table(struct scap_platform* platform, struct sca
 
 	snprintf(procdirname, sizeof(procdirname), "%s/proc", scap_get_host_root());
 	scap_cgroup_enable_cache(&linux_platform->m_cgroups);
-	int32_t ret = _scap_proc_scan_proc_dir_impl(linux_platform, proclist, procdirname, -1, linux_platform->m_lasterr);
+	int32_t ret;
+	if(linux_platform->m_proc_scan_threads > 1)
+	{
+		ret = scap_proc_scan_proc_dir_parallel(linux_platform, proclist, procdirname, previous.m_proclist ? &previous : NULL, linux_platform->m_lasterr);
+	}
+	else
+	{
+		ret = _scap_proc_scan_proc_dir_impl(linux_platform, proclist, procdirname, -1, previous.m_proclist ? &previous : NULL, linux_platform->m_lasterr);
+	}
 	scap_cgroup_clear_cache(&linux_platform->m_cgroups);
+	// the processes that are gone, or that changed and were read again
+	scap_proc_free_table(&previous);
 	return ret;
 }
 
+void scap_linux_release_proc_table(struct scap_platform* platform, struct scap_proclist* proclist)
+{
+	struct scap_linux_platform* linux_platform = (struct scap_linux_platform*)platform;
+
+	if(!linux_platform->m_proc_scan_incremental || proclist->m_proclist == NULL)
+	{
+		scap_proc_free_table(proclist);
+		return;
+	}
+
+	// keep the table for the next refresh
+	scap_proc_free_table(&linux_platform->m_proc_scan_previous);
+	linux_platform->m_proc_scan_previous.m_proclist = proclist->m_proclist;
+	proclist->m_proclist = NULL;
+}
+
 int32_t scap_linux_get_threadlist(struct scap_platform* platform, struct ppm_proclist_info **procinfo_p, char *lasterr)
 {
 	struct scap_linux_platform* linux_platform = (struct scap_linux_platform*)platform;
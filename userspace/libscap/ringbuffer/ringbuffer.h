@@ -196,21 +196,13 @@ static inline void ringbuffer_advance_to_evt(scap_device* dev, scap_evt *event)
 }
 #endif
 
-/* The flow here is:
- * - For every buffer, read how many data are available and save the pointer + its length. (this is what we call a block)
- * - Consume from all these blocks the event with the lowest timestamp. (repeat until all the blocks are empty!)
- *   When we have read all the data from a buffer block, update the consumer position for that buffer, and wait
- *   for all the other buffer blocks to be read.
- * - When we have consumed all the blocks we are ready to read again a new block for every buffer
- * 
- * Possible pain points:
- * - if the buffers are not full enough we sleep and this could be dangerous in this situation!
- * - we increase the consumer position only when we have consumed the entire block, but if the block
- *   is huge we could cause several drops.
- * - before refilling a buffer we have to consume all the others!
- * - we perform a lot of cycles but we have to be super fast here!
+/* Search the event with the lowest timestamp in the blocks we have already read.
+ * Return `false` if all the blocks are empty or in case of buffer corruption (`*pres` is set to `SCAP_FAILURE`).
+ *
+ * `advance_tail` tells if we can move the consumer position of the buffers whose block is fully consumed.
+ * This is not possible when the caller still holds events that point into those blocks.
  */
-static inline int32_t ringbuffer_next(struct scap_device_set *devset, OUT scap_evt** pevent, OUT uint16_t* pcpuid)
+static inline bool ringbuffer_select_next(struct scap_device_set *devset, OUT scap_evt** pevent, OUT uint16_t* pcpuid, bool advance_tail, OUT int32_t* pres)
 {
 	uint32_t j;
 	uint64_t min_ts = 0xffffffffffffffffLL;
@@ -218,6 +210,7 @@ static inline int32_t ringbuffer_next(struct scap_device_set *devset, OUT scap_e
 	uint32_t ndevs = devset->m_ndevs;
 
 	*pcpuid = 65535;
+	*pres = SCAP_SUCCESS;
 
 	for(j = 0; j < ndevs; j++)
 	{
@@ -250,7 +243,7 @@ static inline int32_t ringbuffer_next(struct scap_device_set *devset, OUT scap_e
 			 * `dev->m_lastreadsize` this contains the full length of the entire 
 			 * block we have just consumed.
 			 */
-			if(dev->m_lastreadsize > 0)
+			if(advance_tail && dev->m_lastreadsize > 0)
 			{
 				ADVANCE_TAIL(dev);
 			}
@@ -271,7 +264,8 @@ static inline int32_t ringbuffer_next(struct scap_device_set *devset, OUT scap_e
 
 				/* if you get the following assertion, first recompile the driver and `libscap` */
 				ASSERT(false);
-				return SCAP_FAILURE;
+				*pres = SCAP_FAILURE;
+				return false;
 			}
 
 			*pevent = pe;
@@ -280,23 +274,81 @@ static inline int32_t ringbuffer_next(struct scap_device_set *devset, OUT scap_e
 		}
 	}
 
+	if(*pcpuid == 65535)
+	{
+		return false;
+	}
 
-	if(*pcpuid != 65535)
+	/* Check from which buffer we have read and move the position inside
+	 * the block with `ADVANCE_TO_EVT`
+	 */
+	struct scap_device *dev = &devset->m_devs[*pcpuid];
+	ADVANCE_TO_EVT(dev, (*pevent));
+	return true;
+}
+
+/* The flow here is:
+ * - For every buffer, read how many data are available and save the pointer + its length. (this is what we call a block)
+ * - Consume from all these blocks the event with the lowest timestamp. (repeat until all the blocks are empty!)
+ *   When we have read all the data from a buffer block, update the consumer position for that buffer, and wait
+ *   for all the other buffer blocks to be read.
+ * - When we have consumed all the blocks we are ready to read again a new block for every buffer
+ * 
+ * Possible pain points:
+ * - if the buffers are not full enough we sleep and this could be dangerous in this situation!
+ * - we increase the consumer position only when we have consumed the entire block, but if the block
+ *   is huge we could cause several drops.
+ * - before refilling a buffer we have to consume all the others!
+ * - we perform a lot of cycles but we have to be super fast here!
+ */
+static inline int32_t ringbuffer_next(struct scap_device_set *devset, OUT scap_evt** pevent, OUT uint16_t* pcpuid)
+{
+	int32_t res;
+
+	if(ringbuffer_select_next(devset, pevent, pcpuid, true, &res))
 	{
-		/* Check from which buffer we have read and move the position inside
-	 	 * the block with `ADVANCE_TO_EVT`
-	 	 */
-		struct scap_device *dev = &devset->m_devs[*pcpuid];
-		ADVANCE_TO_EVT(dev, (*pevent));
 		return SCAP_SUCCESS;
 	}
-	else
+
+	if(res != SCAP_SUCCESS)
 	{
-		/* If there are enough new data read again one block for every buffer
-		 * otherwise sleep!
-		 */
-		return refill_read_buffers(devset);
+		return res;
 	}
+
+	/* If there are enough new data read again one block for every buffer
+	 * otherwise sleep!
+	 */
+	return refill_read_buffers(devset);
+}
+
+/* Same as `ringbuffer_next` but returns up to `max_evts` events ordered by timestamp.
+ * All the returned events point into the blocks we have already read, so while we fill
+ * the batch we never move the consumer positions: the blocks fully consumed are released
+ * by the next call. The batch stops early when all the blocks are empty, the refill
+ * happens in the next call.
+ */
+static inline int32_t ringbuffer_next_batch(struct scap_device_set *devset, uint32_t max_evts, OUT scap_evt** pevents, OUT uint16_t* pcpuids, OUT uint32_t* nevts)
+{
+	int32_t res;
+
+	*nevts = 0;
+	res = ringbuffer_next(devset, &pevents[0], &pcpuids[0]);
+	if(res != SCAP_SUCCESS)
+	{
+		return res;
+	}
+	*nevts = 1;
+
+	while(*nevts < max_evts &&
+	      ringbuffer_select_next(devset, &pevents[*nevts], &pcpuids[*nevts], false, &res))
+	{
+		(*nevts)++;
+	}
+
+	/* In case of corruption the events already in the batch are still valid,
+	 * the error will be returned again by the next call.
+	 */
+	return SCAP_SUCCESS;
 }
 
 static inline uint64_t ringbuffer_get_max_buf_used(struct scap_device_set *devset)
@@ -53,6 +53,10 @@ struct scap
 
 	uint64_t m_evtcnt;
 
+	// Error hit by scap_next_batch after some events of the batch were
+	// already returned, reported by the following call
+	int32_t m_next_batch_res;
+
 	// Function which may be called to log a debug event
 	void(*m_debug_log_fn)(const char* msg);
 };
@@ -353,6 +353,93 @@ int32_t scap_next(scap_t* handle, OUT scap_evt** pevent, OUT uint16_t* pdevid)
 	return res;
 }
 
+int32_t scap_next_batch(scap_t* handle, uint32_t max_evts, OUT scap_evt** pevents, OUT uint16_t* pdevids, OUT uint32_t* nevts)
+{
+	int32_t res = SCAP_FAILURE;
+	uint32_t j;
+	uint32_t n_read = 0;
+
+	*nevts = 0;
+	if(max_evts == 0)
+	{
+		return SCAP_FAILURE;
+	}
+
+	if(handle->m_vtable == NULL)
+	{
+		ASSERT(false);
+		return SCAP_FAILURE;
+	}
+
+	if(handle->m_next_batch_res != SCAP_SUCCESS)
+	{
+		res = handle->m_next_batch_res;
+		handle->m_next_batch_res = SCAP_SUCCESS;
+		return res;
+	}
+
+	//
+	// Engines that cannot keep more than one event alive
+	// return batches of a single event
+	//
+	if(handle->m_vtable->next_batch == NULL || max_evts == 1)
+	{
+		res = scap_next(handle, pevents, pdevids);
+		if(res == SCAP_SUCCESS)
+		{
+			*nevts = 1;
+		}
+		return res;
+	}
+
+	res = handle->m_vtable->next_batch(handle->m_engine, max_evts, pevents, pdevids, &n_read);
+	if(res != SCAP_SUCCESS)
+	{
+		return res;
+	}
+
+	//
+	// Drop the events coming from suppressed tids, compacting the batch
+	//
+	for(j = 0; j < n_read; j++)
+	{
+		bool suppressed;
+
+		if((res = scap_check_suppressed(&handle->m_platform->m_suppress, pevents[j], pdevids[j], &suppressed, handle->m_lasterr)) != SCAP_SUCCESS)
+		{
+			if(*nevts == 0)
+			{
+				return res;
+			}
+
+			//
+			// Don't lose the events already taken from the buffers,
+			// the error is returned by the next call
+			//
+			handle->m_next_batch_res = res;
+			break;
+		}
+
+		if(suppressed)
+		{
+			handle->m_platform->m_suppress.m_num_suppressed_evts++;
+			continue;
+		}
+
+		pevents[*nevts] = pevents[j];
+		pdevids[*nevts] = pdevids[j];
+		(*nevts)++;
+	}
+
+	if(*nevts == 0)
+	{
+		return SCAP_FILTERED_EVENT;
+	}
+
+	handle->m_evtcnt += *nevts;
+	return SCAP_SUCCESS;
+}
+
 //
 // Return the number of dropped events for the given handle.
 //
@@ -516,6 +603,19 @@ int64_t scap_get_readfile_offset(scap_t* handle)
 	}
 }
 
+int32_t scap_seek_ts(scap_t* handle, uint64_t ts, uint64_t* evtnum)
+{
+	if(handle->m_vtable->savefile_ops)
+	{
+		return handle->m_vtable->savefile_ops->seek_ts_capture(handle->m_engine, ts, evtnum);
+	}
+	else
+	{
+		snprintf(handle->m_lasterr, SCAP_LASTERR_SIZE, "scap_seek_ts only works on captures");
+		return SCAP_FAILURE;
+	}
+}
+
 int32_t scap_set_ppm_sc(scap_t* handle, ppm_sc_code ppm_sc, bool enabled)
 {
 	if (handle == NULL)
@@ -576,6 +576,26 @@ uint64_t scap_max_buf_used(scap_t* handle);
 */
 int32_t scap_next(scap_t* handle, OUT scap_evt** pevent, OUT uint16_t* pcpuid);
 
+/*!
+  \brief Get up to max_evts events, ordered by timestamp, from the given capture instance
+
+  \param handle Handle to the capture instance.
+  \param max_evts Maximum number of events to return.
+  \param pevents User-provided array of at least max_evts event pointers that will be initialized with the addresses of the events.
+  \param pcpuids User-provided array of at least max_evts ids that will be initialized with the IDs of the CPUs
+    where the events were captured.
+  \param nevts User-provided pointer that will be initialized with the number of returned events.
+
+  \return The same values of \ref scap_next. On SCAP_SUCCESS at least one event is returned.
+   All the returned events remain valid until the next call to \ref scap_next or \ref scap_next_batch.
+   If an error happens after some events of the batch were taken, those events are returned with
+   SCAP_SUCCESS and the error is returned by the following call.
+
+  \note Only the engines that can keep more than one event alive return more than one event per call
+   (kmod, bpf and modern_bpf), the other ones behave like \ref scap_next.
+*/
+int32_t scap_next_batch(scap_t* handle, uint32_t max_evts, OUT scap_evt** pevents, OUT uint16_t* pcpuids, OUT uint32_t* nevts);
+
 /*!
   \brief Get the length of an event
 
@@ -630,6 +650,22 @@ uint32_t scap_event_get_dump_flags(scap_t* handle);
 */
 int64_t scap_get_readfile_offset(scap_t* handle);
 
+/*!
+  \brief Move the read position of a capture file to the first event with
+  a timestamp greater or equal than ts. If the file was written with a time
+  index (see scap_dump_enable_index), reading starts from the closest indexed
+  position, otherwise the events are scanned from the beginning of the file.
+
+  \param handle Handle to the capture instance.
+  \param ts The timestamp to seek to, in nanoseconds.
+  \param evtnum Filled with the number of events in the file that precede
+   the new read position.
+
+  \return SCAP_SUCCESS if the call is successful. If there are no events after
+   ts, the next call to scap_next returns SCAP_EOF.
+*/
+int32_t scap_seek_ts(scap_t* handle, uint64_t ts, uint64_t* evtnum);
+
 /*!
   \brief Return the capture statistics for the given capture handle.
 
@@ -92,6 +92,8 @@ extern "C"
 		void(*debug_log_fn)(const char* msg); //< Function which SCAP may use to log a debug message
 		uint64_t proc_scan_timeout_ms; //< Timeout in msec, after which so-far-successful scan of /proc should be cut short with success return
 		uint64_t proc_scan_log_interval_ms; //< Interval for logging progress messages from /proc scan
+		uint32_t proc_scan_threads; //< Number of threads scanning /proc at startup, 0 or 1 for a serial scan
+		bool proc_scan_incremental; //< Keep the process table across refreshes (and across scap_dump_open() calls) and move the entries of the processes that didn't change (same start time and executable) to the new table, fds included, instead of reading them again
 		void* engine_params;			   ///< engine-specific params.
 	} scap_open_args;
 
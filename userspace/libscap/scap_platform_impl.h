@@ -61,6 +61,11 @@ struct scap_platform_vtable
 	struct scap_threadinfo* (*get_proc)(struct scap_platform*, struct scap_proclist* proclist, int64_t tid, bool scan_sockets);
 
 	int32_t (*refresh_proc_table)(struct scap_platform*, struct scap_proclist* proclist);
+
+	// free the process table built by refresh_proc_table once the caller
+	// is done with it. The platform may keep it for the next refresh
+	void (*release_proc_table)(struct scap_platform*, struct scap_proclist* proclist);
+
 	bool (*is_thread_alive)(struct scap_platform*, int64_t pid, int64_t tid, const char* comm);
 	int32_t (*get_global_pid)(struct scap_platform*, int64_t *pid, char *error);
 	int32_t (*get_threadlist)(struct scap_platform* platform, struct ppm_proclist_info **procinfo_p, char *lasterr);
@@ -36,6 +36,13 @@ struct iovec {
 #include "scap_savefile.h"
 #include "strl.h"
 
+#ifdef HAS_LZ4
+#include <lz4.h>
+#endif
+#ifdef HAS_ZSTD
+#include <zstd.h>
+#endif
+
 const char* scap_dump_getlasterr(scap_dumper_t* d)
 {
 	return d ? d->m_lasterr : "null dumper";
@@ -47,6 +54,168 @@ const char* scap_dump_getlasterr(scap_dumper_t* d)
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+#ifndef _WIN32
+static inline uint32_t scap_normalize_block_len(uint32_t blocklen)
+#else
+static uint32_t scap_normalize_block_len(uint32_t blocklen)
+#endif
+{
+	return ((blocklen + 3) >> 2) << 2;
+}
+
+//
+// Compress the pending data of a dumper using block compression
+// and write it as a compressed block
+//
+static int32_t scap_dump_flush_cblock(scap_dumper_t *d)
+{
+	block_header bh;
+	compressed_block_header cbh;
+	uint32_t bt;
+	int32_t val = 0;
+	int clen = 0;
+
+	if(d->m_cblock_len == 0)
+	{
+		return SCAP_SUCCESS;
+	}
+
+	switch(d->m_cblock_type)
+	{
+#ifdef HAS_LZ4
+	case CB_BLOCK_TYPE_LZ4:
+		clen = LZ4_compress_default((const char*)d->m_cblock_buf, (char*)d->m_cblock_out, d->m_cblock_len, d->m_cblock_out_size);
+		break;
+#endif
+#ifdef HAS_ZSTD
+	case CB_BLOCK_TYPE_ZSTD:
+	{
+		size_t zres = ZSTD_compressCCtx((ZSTD_CCtx*)d->m_cblock_ctx, d->m_cblock_out, d->m_cblock_out_size, d->m_cblock_buf, d->m_cblock_len, 1);
+		clen = ZSTD_isError(zres) ? 0 : (int)zres;
+		break;
+	}
+#endif
+	default:
+		break;
+	}
+
+	if(clen <= 0)
+	{
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error compressing block");
+		return SCAP_FAILURE;
+	}
+
+	cbh.uncompressed_length = d->m_cblock_len;
+	cbh.compressed_length = (uint32_t)clen;
+	bh.block_type = d->m_cblock_type;
+	bh.block_total_length = scap_normalize_block_len(sizeof(block_header) + sizeof(cbh) + clen + 4);
+	bt = bh.block_total_length;
+
+	if(gzwrite(d->m_f, &bh, sizeof(bh)) != sizeof(bh) ||
+		gzwrite(d->m_f, &cbh, sizeof(cbh)) != sizeof(cbh) ||
+		gzwrite(d->m_f, d->m_cblock_out, clen) != clen ||
+		gzwrite(d->m_f, &val, bt - sizeof(bh) - sizeof(cbh) - clen - 4) != (int)(bt - sizeof(bh) - sizeof(cbh) - clen - 4) ||
+		gzwrite(d->m_f, &bt, sizeof(bt)) != sizeof(bt))
+	{
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error writing to file (CB1)");
+		return SCAP_FAILURE;
+	}
+
+	d->m_cblock_pos += d->m_cblock_len;
+	d->m_cblock_len = 0;
+	return SCAP_SUCCESS;
+}
+
+static int scap_dump_write_cblock(scap_dumper_t *d, void* buf, unsigned len)
+{
+	uint8_t* src = (uint8_t*)buf;
+	unsigned towrite = len;
+
+	while(towrite > 0)
+	{
+		uint32_t size = PPM_DUMPER_COMPRESSED_BLOCK_SIZE - d->m_cblock_len;
+		if(size > towrite)
+		{
+			size = towrite;
+		}
+		memcpy(d->m_cblock_buf + d->m_cblock_len, src, size);
+		d->m_cblock_len += size;
+		src += size;
+		towrite -= size;
+
+		if(d->m_cblock_len == PPM_DUMPER_COMPRESSED_BLOCK_SIZE &&
+			scap_dump_flush_cblock(d) != SCAP_SUCCESS)
+		{
+			return -1;
+		}
+	}
+
+	return len;
+}
+
+//
+// Set up block compression, everything written from now on
+// will be stored in compressed blocks
+//
+static int32_t scap_dump_init_cblock(scap_dumper_t *d, compression_mode compress)
+{
+	size_t out_size = 0;
+
+	switch(compress)
+	{
+#ifdef HAS_LZ4
+	case SCAP_COMPRESSION_LZ4:
+		d->m_cblock_type = CB_BLOCK_TYPE_LZ4;
+		out_size = LZ4_compressBound(PPM_DUMPER_COMPRESSED_BLOCK_SIZE);
+		break;
+#endif
+#ifdef HAS_ZSTD
+	case SCAP_COMPRESSION_ZSTD:
+		d->m_cblock_type = CB_BLOCK_TYPE_ZSTD;
+		out_size = ZSTD_compressBound(PPM_DUMPER_COMPRESSED_BLOCK_SIZE);
+		d->m_cblock_ctx = ZSTD_createCCtx();
+		if(d->m_cblock_ctx == NULL)
+		{
+			snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error creating the zstd compression context");
+			return SCAP_FAILURE;
+		}
+		break;
+#endif
+	default:
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "compression mode %d is not supported by this build", (int)compress);
+		return SCAP_FAILURE;
+	}
+
+	d->m_cblock_buf = (uint8_t*)malloc(PPM_DUMPER_COMPRESSED_BLOCK_SIZE);
+	d->m_cblock_out = (uint8_t*)malloc(out_size);
+	d->m_cblock_out_size = (uint32_t)out_size;
+	d->m_cblock_len = 0;
+	d->m_cblock_pos = gztell(d->m_f);
+	if(d->m_cblock_buf == NULL || d->m_cblock_out == NULL)
+	{
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error allocating the compression buffers");
+		return SCAP_FAILURE;
+	}
+
+	return SCAP_SUCCESS;
+}
+
+static void scap_dump_free_cblock(scap_dumper_t *d)
+{
+#ifdef HAS_ZSTD
+	if(d->m_cblock_type == CB_BLOCK_TYPE_ZSTD && d->m_cblock_ctx != NULL)
+	{
+		ZSTD_freeCCtx((ZSTD_CCtx*)d->m_cblock_ctx);
+	}
+#endif
+	free(d->m_cblock_buf);
+	free(d->m_cblock_out);
+	d->m_cblock_type = 0;
+	d->m_cblock_buf = NULL;
+	d->m_cblock_out = NULL;
+	d->m_cblock_ctx = NULL;
+}
+
 //
 // Write data into a dump file
 //
@@ -54,6 +223,10 @@ static int scap_dump_write(scap_dumper_t *d, void* buf, unsigned len)
 {
 	if(d->m_type == DT_FILE)
 	{
+		if(d->m_cblock_buf != NULL)
+		{
+			return scap_dump_write_cblock(d, buf, len);
+		}
 		return gzwrite(d->m_f, buf, len);
 	}
 	else
@@ -113,15 +286,6 @@ uint8_t* scap_get_memorydumper_curpos(scap_dumper_t *d)
 	return d->m_targetbufcurpos;
 }
 
-#ifndef _WIN32
-static inline uint32_t scap_normalize_block_len(uint32_t blocklen)
-#else
-static uint32_t scap_normalize_block_len(uint32_t blocklen)
-#endif
-{
-	return ((blocklen + 3) >> 2) << 2;
-}
-
 static int32_t scap_write_padding(scap_dumper_t *d, uint32_t blocklen)
 {
 	int32_t val = 0;
@@ -1038,7 +1202,7 @@ static int32_t scap_write_userlist(scap_dumper_t* d, struct scap_userlist *userl
 //
 // Create the dump file headers and add the tables
 //
-static int32_t scap_setup_dump(scap_dumper_t* d, struct scap_platform *platform, const char *fname)
+static int32_t scap_setup_dump(scap_dumper_t* d, struct scap_platform *platform, const char *fname, compression_mode compress)
 {
 	block_header bh;
 	section_header_block sh;
@@ -1065,6 +1229,18 @@ static int32_t scap_setup_dump(scap_dumper_t* d, struct scap_platform *platform,
 		return SCAP_FAILURE;
 	}
 
+	//
+	// With block compression, everything that follows the section
+	// header is written in compressed blocks
+	//
+	if(compress == SCAP_COMPRESSION_LZ4 || compress == SCAP_COMPRESSION_ZSTD)
+	{
+		if(scap_dump_init_cblock(d, compress) != SCAP_SUCCESS)
+		{
+			return SCAP_FAILURE;
+		}
+	}
+
 	if(platform)
 	{
 		//
@@ -1129,19 +1305,37 @@ static inline int32_t scap_dump_rescan_proc(struct scap_platform* platform)
 	return ret;
 }
 
+//
+// Give the process table back to the platform, which may keep it for the
+// next rescan, or free it
+//
+static inline void scap_dump_release_proc(struct scap_platform* platform)
+{
+	if(platform->m_vtable && platform->m_vtable->release_proc_table)
+	{
+		platform->m_vtable->release_proc_table(platform, &platform->m_proclist);
+	}
+	else
+	{
+		scap_proc_free_table(&platform->m_proclist);
+	}
+}
+
 // fname is only used for log messages in scap_setup_dump
-static scap_dumper_t *scap_dump_open_gzfile(struct scap_platform* platform, gzFile gzfile, const char *fname, char* lasterr)
+static scap_dumper_t *scap_dump_open_gzfile(struct scap_platform* platform, gzFile gzfile, const char *fname, compression_mode compress, char* lasterr)
 {
-	scap_dumper_t* res = (scap_dumper_t*)malloc(sizeof(scap_dumper_t));
+	scap_dumper_t* res = (scap_dumper_t*)calloc(1, sizeof(scap_dumper_t));
 	res->m_f = gzfile;
 	res->m_type = DT_FILE;
+	res->m_gzip = (compress == SCAP_COMPRESSION_GZIP);
 	res->m_targetbuf = NULL;
 	res->m_targetbufcurpos = NULL;
 	res->m_targetbufend = NULL;
 
-	if(scap_setup_dump(res, platform, fname) != SCAP_SUCCESS)
+	if(scap_setup_dump(res, platform, fname, compress) != SCAP_SUCCESS)
 	{
 		strlcpy(lasterr, res->m_lasterr, SCAP_LASTERR_SIZE);
+		scap_dump_free_cblock(res);
 		free(res);
 		res = NULL;
 	}
@@ -1165,6 +1359,8 @@ scap_dumper_t *scap_dump_open(struct scap_platform* platform, const char *fname,
 		mode = "wb";
 		break;
 	case SCAP_COMPRESSION_NONE:
+	case SCAP_COMPRESSION_LZ4:
+	case SCAP_COMPRESSION_ZSTD:
 		mode = "wbT";
 		break;
 	default:
@@ -1217,13 +1413,13 @@ scap_dumper_t *scap_dump_open(struct scap_platform* platform, const char *fname,
 		}
 	}
 
-	res = scap_dump_open_gzfile(platform, f, fname, lasterr);
+	res = scap_dump_open_gzfile(platform, f, fname, compress, lasterr);
 	//
 	// If the user doesn't need the thread table, free it
 	//
 	if(platform->m_proclist.m_proc_callback != NULL)
 	{
-		scap_proc_free_table(&platform->m_proclist);
+		scap_dump_release_proc(platform);
 	}
 
 	return res;
@@ -1242,6 +1438,8 @@ scap_dumper_t* scap_dump_open_fd(struct scap_platform* platform, int fd, compres
 		f = gzdopen(fd, "wb");
 		break;
 	case SCAP_COMPRESSION_NONE:
+	case SCAP_COMPRESSION_LZ4:
+	case SCAP_COMPRESSION_ZSTD:
 		f = gzdopen(fd, "wbT");
 		break;
 	default:
@@ -1269,14 +1467,14 @@ scap_dumper_t* scap_dump_open_fd(struct scap_platform* platform, int fd, compres
 		}
 	}
 
-	res = scap_dump_open_gzfile(platform, f, "", lasterr);
+	res = scap_dump_open_gzfile(platform, f, "", compress, lasterr);
 
 	//
 	// If the user doesn't need the thread table, free it
 	//
 	if(platform->m_proclist.m_proc_callback != NULL)
 	{
-		scap_proc_free_table(&platform->m_proclist);
+		scap_dump_release_proc(platform);
 	}
 	return res;
 }
@@ -1286,7 +1484,7 @@ scap_dumper_t* scap_dump_open_fd(struct scap_platform* platform, int fd, compres
 //
 scap_dumper_t *scap_memory_dump_open(struct scap_platform* platform, uint8_t* targetbuf, uint64_t targetbufsize, char* lasterr)
 {
-	scap_dumper_t* res = (scap_dumper_t*)malloc(sizeof(scap_dumper_t));
+	scap_dumper_t* res = (scap_dumper_t*)calloc(1, sizeof(scap_dumper_t));
 	if(res == NULL)
 	{
 		snprintf(lasterr, SCAP_LASTERR_SIZE, "scap_dump_memory_open memory allocation failure (1)");
@@ -1299,7 +1497,7 @@ scap_dumper_t *scap_memory_dump_open(struct scap_platform* platform, uint8_t* ta
 	res->m_targetbufcurpos = targetbuf;
 	res->m_targetbufend = targetbuf + targetbufsize;
 
-	if(scap_setup_dump(res, platform, "") != SCAP_SUCCESS)
+	if(scap_setup_dump(res, platform, "", SCAP_COMPRESSION_NONE) != SCAP_SUCCESS)
 	{
 		strlcpy(lasterr, res->m_lasterr, SCAP_LASTERR_SIZE);
 		free(res);
@@ -1314,7 +1512,7 @@ scap_dumper_t *scap_memory_dump_open(struct scap_platform* platform, uint8_t* ta
 //
 scap_dumper_t *scap_managedbuf_dump_create()
 {
-	scap_dumper_t *res = (scap_dumper_t *)malloc(sizeof(scap_dumper_t));
+	scap_dumper_t *res = (scap_dumper_t *)calloc(1, sizeof(scap_dumper_t));
 	if(res == NULL)
 	{
 		return NULL;
@@ -1330,13 +1528,64 @@ scap_dumper_t *scap_managedbuf_dump_create()
 }
 
 //
-// Close a "savefile" opened with scap_dump_open
+// Write the time index as the last block of the file. The index is written
+// directly to the file even with block compression, so that readers can
+// find it without decompressing anything.
 //
-void scap_dump_close(scap_dumper_t *d)
+static int32_t scap_dump_write_index(scap_dumper_t *d)
 {
+	block_header bh;
+	index_block_header ih;
+	uint32_t entries_len = d->m_index_len * sizeof(index_block_entry);
+	uint32_t bt;
+
+	bh.block_type = IDX_BLOCK_TYPE;
+	bh.block_total_length = sizeof(block_header) + sizeof(ih) + entries_len + 4;
+	bt = bh.block_total_length;
+
+	ih.entry_len = sizeof(index_block_entry);
+	ih.offset = gztell(d->m_f);
+
+	if(gzwrite(d->m_f, &bh, sizeof(bh)) != sizeof(bh) ||
+		gzwrite(d->m_f, &ih, sizeof(ih)) != sizeof(ih) ||
+		gzwrite(d->m_f, d->m_index, entries_len) != (int)entries_len ||
+		gzwrite(d->m_f, &bt, sizeof(bt)) != sizeof(bt))
+	{
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error writing to file (IDX1)");
+		return SCAP_FAILURE;
+	}
+	return SCAP_SUCCESS;
+}
+
+//
+// Close a "savefile" opened with scap_dump_open. The last compressed block
+// and the time index are written here, the handle is freed even if that
+// fails. Callers that need the error message must call scap_dump_flush
+// first, which leaves only the index to be written here.
+//
+int32_t scap_dump_close(scap_dumper_t *d)
+{
+	int32_t res = SCAP_SUCCESS;
+
 	if(d->m_type == DT_FILE)
 	{
-		gzclose(d->m_f);
+		if(d->m_cblock_buf != NULL)
+		{
+			if(scap_dump_flush_cblock(d) != SCAP_SUCCESS)
+			{
+				res = SCAP_FAILURE;
+			}
+			scap_dump_free_cblock(d);
+		}
+		if(d->m_index_len > 0 && scap_dump_write_index(d) != SCAP_SUCCESS)
+		{
+			res = SCAP_FAILURE;
+		}
+		free(d->m_index);
+		if(gzclose(d->m_f) != Z_OK)
+		{
+			res = SCAP_FAILURE;
+		}
 	}
 	else if (d->m_type == DT_MANAGED_BUF)
 	{
@@ -1344,6 +1593,7 @@ void scap_dump_close(scap_dumper_t *d)
 	}
 
 	free(d);
+	return res;
 }
 
 //
@@ -1365,6 +1615,10 @@ int64_t scap_dump_ftell(scap_dumper_t *d)
 {
 	if(d->m_type == DT_FILE)
 	{
+		if(d->m_cblock_buf != NULL)
+		{
+			return d->m_cblock_pos + d->m_cblock_len;
+		}
 		return gztell(d->m_f);
 	}
 	else
@@ -1373,12 +1627,69 @@ int64_t scap_dump_ftell(scap_dumper_t *d)
 	}
 }
 
-void scap_dump_flush(scap_dumper_t *d)
+int32_t scap_dump_flush(scap_dumper_t *d)
 {
 	if(d->m_type == DT_FILE)
 	{
-		gzflush(d->m_f, Z_FULL_FLUSH);
+		if(d->m_cblock_buf != NULL && scap_dump_flush_cblock(d) != SCAP_SUCCESS)
+		{
+			return SCAP_FAILURE;
+		}
+		if(gzflush(d->m_f, Z_FULL_FLUSH) != Z_OK)
+		{
+			snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error flushing the file");
+			return SCAP_FAILURE;
+		}
+	}
+	return SCAP_SUCCESS;
+}
+
+int32_t scap_dump_enable_index(scap_dumper_t *d, uint64_t interval_ns)
+{
+	if(d->m_type != DT_FILE || d->m_gzip)
+	{
+		snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "the time index is only supported for files without gzip compression");
+		return SCAP_NOT_SUPPORTED;
 	}
+
+	d->m_index_interval_ns = interval_ns > 0 ? interval_ns : PPM_DUMPER_INDEX_INTERVAL_NS;
+	return SCAP_SUCCESS;
+}
+
+//
+// Record the position of the next event in the time index. With block
+// compression, the pending data is flushed first so that the event
+// is at the beginning of a compressed block.
+//
+static int32_t scap_dump_add_index_entry(scap_dumper_t *d, uint64_t ts)
+{
+	index_block_entry* entry;
+
+	if(d->m_cblock_buf != NULL && scap_dump_flush_cblock(d) != SCAP_SUCCESS)
+	{
+		return SCAP_FAILURE;
+	}
+
+	if(d->m_index_len == d->m_index_cap)
+	{
+		uint32_t cap = d->m_index_cap > 0 ? d->m_index_cap * 2 : 64;
+		index_block_entry* tmp = (index_block_entry*)realloc(d->m_index, cap * sizeof(index_block_entry));
+		if(tmp == NULL)
+		{
+			snprintf(d->m_lasterr, SCAP_LASTERR_SIZE, "error allocating the time index");
+			return SCAP_FAILURE;
+		}
+		d->m_index = tmp;
+		d->m_index_cap = cap;
+	}
+
+	entry = &d->m_index[d->m_index_len];
+	entry->ts = ts;
+	entry->evtnum = d->m_nevts;
+	entry->pos = scap_dump_ftell(d);
+	entry->raw_offset = gztell(d->m_f);
+	d->m_index_len++;
+	return SCAP_SUCCESS;
 }
 
 //
@@ -1390,6 +1701,13 @@ int32_t scap_dump(scap_dumper_t *d, scap_evt *e, uint16_t cpuid, uint32_t flags)
 	uint32_t bt;
 	bool large_payload = flags & SCAP_DF_LARGE;
 
+	if(d->m_index_interval_ns != 0 &&
+		(d->m_index_len == 0 || e->ts >= d->m_index[d->m_index_len - 1].ts + d->m_index_interval_ns) &&
+		scap_dump_add_index_entry(d, e->ts) != SCAP_SUCCESS)
+	{
+		return SCAP_FAILURE;
+	}
+
 	flags &= ~SCAP_DF_LARGE;
 	if(flags == 0)
 	{
@@ -1438,5 +1756,6 @@ int32_t scap_dump(scap_dumper_t *d, scap_evt *e, uint16_t cpuid, uint32_t flags)
 	fflush(f);
 #endif
 
+	d->m_nevts++;
 	return SCAP_SUCCESS;
 }
@@ -152,4 +152,45 @@ typedef struct _section_header_block
 
 #define EVF_BLOCK_TYPE_V2_LARGE		0x222
 
+///////////////////////////////////////////////////////////////////////////////
+// COMPRESSED BLOCK
+///////////////////////////////////////////////////////////////////////////////
+// When a file is written with block compression, everything that follows the
+// section header block is stored as a sequence of compressed blocks. Each of
+// them can be decompressed independently and holds the next chunk of the
+// uncompressed data, which is the same as the one of an uncompressed file.
+// The chunk boundaries don't need to match the ones of the blocks they contain.
+#define CB_BLOCK_TYPE_LZ4		0x223
+#define CB_BLOCK_TYPE_ZSTD		0x224
+
+typedef struct _compressed_block_header
+{
+	uint32_t uncompressed_length;
+	uint32_t compressed_length;
+}compressed_block_header;
+
+///////////////////////////////////////////////////////////////////////////////
+// INDEX BLOCK
+///////////////////////////////////////////////////////////////////////////////
+// Optional block written as the last block of the file, which maps event
+// timestamps to positions from which the file can be read independently.
+// It contains an index_block_header, followed by the entries sorted by
+// timestamp. It's never compressed, so that it can be located through the
+// trailing block length at the end of the file.
+#define IDX_BLOCK_TYPE			0x225
+
+typedef struct _index_block_header
+{
+	uint32_t entry_len; // Size of each entry. New fields must be appended to the entries
+	uint64_t offset; // File offset of the index block, to detect files that have been concatenated
+}index_block_header;
+
+typedef struct _index_block_entry
+{
+	uint64_t ts; // Timestamp of the first event at this position
+	uint64_t evtnum; // Number of events written before this position
+	uint64_t pos; // Position of the event in the uncompressed data
+	uint64_t raw_offset; // File offset of the compressed block starting at pos, or pos if not compressed
+}index_block_entry;
+
 #pragma pack(pop)
@@ -38,6 +38,12 @@ typedef enum ppm_dumper_type
 
 #define PPM_DUMPER_MANAGED_BUF_SIZE (3 * 1024 * 1024)
 #define PPM_DUMPER_MANAGED_BUF_RESIZE_FACTOR (1.25)
+// Size of the uncompressed chunks stored in each compressed block
+#define PPM_DUMPER_COMPRESSED_BLOCK_SIZE (256 * 1024)
+// Default interval between the entries of the time index
+#define PPM_DUMPER_INDEX_INTERVAL_NS (1000000000ULL)
+
+struct _index_block_entry;
 
 typedef struct scap_dumper
 {
@@ -47,6 +53,19 @@ typedef struct scap_dumper
 	uint8_t* m_targetbufcurpos;
 	uint8_t* m_targetbufend;
 	char m_lasterr[SCAP_LASTERR_SIZE];
+	uint32_t m_cblock_type; ///< The CB_BLOCK_TYPE_* used with block compression, 0 otherwise
+	uint8_t* m_cblock_buf; ///< Uncompressed data waiting for the next compressed block
+	uint32_t m_cblock_len; ///< The number of bytes used in m_cblock_buf
+	uint8_t* m_cblock_out; ///< The output buffer of the compressor
+	uint32_t m_cblock_out_size; ///< The size of m_cblock_out
+	int64_t m_cblock_pos; ///< The uncompressed position of m_cblock_buf[0]
+	void* m_cblock_ctx; ///< The compressor context, if the codec needs one
+	bool m_gzip; ///< True if the file is gzip compressed
+	uint64_t m_nevts; ///< The number of events written so far
+	uint64_t m_index_interval_ns; ///< The minimum time between two index entries, 0 if the index is disabled
+	struct _index_block_entry* m_index; ///< The entries of the time index
+	uint32_t m_index_len; ///< The number of entries in m_index
+	uint32_t m_index_cap; ///< The physical size of m_index
 } scap_dumper_t;
 
 struct scap_threadinfo;
@@ -59,7 +78,9 @@ struct iovec;
 typedef enum compression_mode
 {
 	SCAP_COMPRESSION_NONE = 0,
-	SCAP_COMPRESSION_GZIP = 1
+	SCAP_COMPRESSION_GZIP = 1,
+	SCAP_COMPRESSION_LZ4 = 2, ///< LZ4 compressed blocks, requires a build with LZ4 support
+	SCAP_COMPRESSION_ZSTD = 3 ///< Zstandard compressed blocks, requires a build with zstd support
 } compression_mode;
 
 uint8_t* scap_get_memorydumper_curpos(scap_dumper_t *d);
@@ -106,8 +127,11 @@ scap_dumper_t* scap_dump_open_fd(struct scap_platform* platform, int fd, compres
   \brief Close a trace file.
 
   \param d The dump handle, returned by \ref scap_dump_open
+  \return SCAP_SUCCESS if the pending output and the time index were written.
+   On Failure, SCAP_FAILURE is returned. The handle is freed in both cases,
+   so call \ref scap_dump_flush first to get the error of the pending output.
 */
-void scap_dump_close(scap_dumper_t *d);
+int32_t scap_dump_close(scap_dumper_t *d);
 
 /*!
   \brief Return the current size of a trace file.
@@ -130,8 +154,29 @@ int64_t scap_dump_ftell(scap_dumper_t *d);
   \brief Flush all pending output into the file.
 
   \param d The dump handle, returned by \ref scap_dump_open
+  \return SCAP_SUCCESS if the call is successful.
+   On Failure, SCAP_FAILURE is returned and scap_dump_getlasterr() can be used to obtain
+   the cause of the error.
+*/
+int32_t scap_dump_flush(scap_dumper_t *d);
+
+/*!
+  \brief Enable the time index of a trace file.
+   Every interval_ns nanoseconds of captured events, the position of the
+   next event is recorded, and the list is written as the last block of
+   the file when it gets closed. This allows readers to quickly seek to a
+   timestamp, see \ref scap_seek_ts. With block compression, every entry
+   starts a new compressed block so that it can be decompressed directly.
+
+  \param d The dump handle, returned by \ref scap_dump_open
+  \param interval_ns The minimum time between two entries, 0 to use
+   PPM_DUMPER_INDEX_INTERVAL_NS.
+
+  \return SCAP_SUCCESS if the call is successful. The index is not
+   supported for gzip compressed files and memory dumpers, in that case
+   SCAP_NOT_SUPPORTED is returned.
 */
-void scap_dump_flush(scap_dumper_t *d);
+int32_t scap_dump_enable_index(scap_dumper_t *d, uint64_t interval_ns);
 
 /*!
   \brief Write an event to a trace file
@@ -102,6 +102,15 @@ struct scap_savefile_vtable {
 	 */
 	void (*fseek_capture)(struct scap_engine_handle engine, uint64_t off);
 
+	/**
+	 * @brief seek to the first event with a timestamp greater or equal than ts
+	 * @param engine the handle to the engine
+	 * @param ts the timestamp to seek to
+	 * @param evtnum filled with the number of events that precede the new position
+	 * @return SCAP_SUCCESS or a failure code
+	 */
+	int32_t (*seek_ts_capture)(struct scap_engine_handle engine, uint64_t ts, uint64_t* evtnum);
+
 	/**
 	 * @brief restart a capture from the current offset
 	 * @param handle the full scap_t handle
@@ -187,6 +196,21 @@ struct scap_vtable {
 	 */
 	int32_t (*next)(struct scap_engine_handle engine, scap_evt **pevent, uint16_t *pcpuid);
 
+	/**
+	 * @brief fetch up to max_evts events, ordered by timestamp
+	 * @param engine wraps the pointer to the engine-specific handle
+	 * @param max_evts the maximum number of events to return
+	 * @param pevents [out] array of at least max_evts pointers where the events get stored
+	 * @param pcpuids [out] array of at least max_evts CPU ids
+	 * @param nevts [out] the number of returned events
+	 * @return SCAP_SUCCESS (with *nevts >= 1) or a failure code, like next()
+	 *
+	 * All the returned events must remain valid at least until the next call
+	 * to next() or next_batch(). This is optional: engines that cannot keep more
+	 * than one event alive leave it NULL and scap_next_batch() falls back to next()
+	 */
+	int32_t (*next_batch)(struct scap_engine_handle engine, uint32_t max_evts, scap_evt **pevents, uint16_t *pcpuids, uint32_t *nevts);
+
 	/**
 	 * @brief start a capture
 	 * @param engine
@@ -25,6 +25,7 @@ limitations under the License.
 #include <stdio.h>
 #define	gzFile FILE*
 #define gzflush(X, Y) fflush(X)
+#define Z_OK 0
 #define gzopen fopen
 #define	gzdopen(fd, mode) fdopen(fd, mode)
 #define gzclose fclose
@@ -34,4 +35,5 @@ limitations under the License.
 #define gztell(F) ftell(F)
 inline static const char *gzerror(FILE *F, int *E) {*E = ferror(F); return "error reading file descriptor";}
 #define gzseek fseek
+#define gzdirect(F) 1
 #endif
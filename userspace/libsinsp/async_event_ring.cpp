@@ -0,0 +1,170 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <new>
+
+#include "async_event_ring.h"
+
+using namespace libsinsp;
+
+//
+// Each slot has a sequence number that tells who owns it. For the slot at
+// position pos of the ring (pos counts from the creation of the ring):
+//  - seq == pos: the slot is free, the producer that moves the head past
+//    pos owns it
+//  - seq == pos + 1: the event is ready, the consumer owns the slot
+//  - seq == pos + capacity: the consumer released the slot, which is free
+//    for position pos + capacity
+//
+async_event_ring::async_event_ring(size_t capacity):
+	m_mask(0),
+	m_head(0),
+	m_pushed(0),
+	m_dropped(0),
+	m_tail(0),
+	m_held(false),
+	m_popped(0)
+{
+	size_t size = 1;
+	while(size < capacity && size < MAX_CAPACITY)
+	{
+		size <<= 1;
+	}
+	m_mask = size - 1;
+
+	m_slots.reset(new slot[size]);
+	for(size_t i = 0; i < size; i++)
+	{
+		m_slots[i].m_seq.store(i, std::memory_order_relaxed);
+		m_slots[i].m_data.reset(new uint8_t[SLOT_SIZE]);
+		m_slots[i].m_size = SLOT_SIZE;
+		m_slots[i].m_len = 0;
+	}
+}
+
+async_event_ring::~async_event_ring() = default;
+
+async_event_ring::slot* async_event_ring::acquire(size_t len)
+{
+	uint64_t pos = m_head.load(std::memory_order_relaxed);
+	slot* s;
+	while(true)
+	{
+		s = &m_slots[pos & m_mask];
+		uint64_t seq = s->m_seq.load(std::memory_order_acquire);
+		int64_t diff = (int64_t)(seq - pos);
+		if(diff == 0)
+		{
+			if(m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if(diff < 0)
+		{
+			// the consumer didn't release the slot of the previous round yet
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		else
+		{
+			pos = m_head.load(std::memory_order_relaxed);
+		}
+	}
+
+	// the slot is ours until commit(), so its buffer can be replaced
+	if(len > s->m_size)
+	{
+		try
+		{
+			s->m_data.reset(new uint8_t[len]);
+			s->m_size = len;
+		}
+		catch(...)
+		{
+			s->m_data.reset(new (std::nothrow) uint8_t[SLOT_SIZE]);
+			s->m_size = s->m_data ? SLOT_SIZE : 0;
+			s->m_len = 0;
+			commit(s);
+			throw;
+		}
+	}
+	s->m_len = len;
+	return s;
+}
+
+void async_event_ring::commit(slot* s)
+{
+	if(s->m_len != 0)
+	{
+		m_pushed.fetch_add(1, std::memory_order_relaxed);
+	}
+	uint64_t pos = s->m_seq.load(std::memory_order_relaxed);
+	s->m_seq.store(pos + 1, std::memory_order_release);
+}
+
+void async_event_ring::release_held()
+{
+	if(m_held)
+	{
+		// don't let a burst of large events pin their memory, the slot
+		// grows again on demand if the allocation fails here
+		slot* s = &m_slots[m_tail & m_mask];
+		if(s->m_size > MAX_KEPT_SLOT_SIZE)
+		{
+			s->m_data.reset(new (std::nothrow) uint8_t[SLOT_SIZE]);
+			s->m_size = s->m_data ? SLOT_SIZE : 0;
+		}
+		s->m_seq.store(m_tail + m_mask + 1, std::memory_order_release);
+		m_tail++;
+		m_held = false;
+	}
+}
+
+scap_evt* async_event_ring::pop()
+{
+	release_held();
+	while(true)
+	{
+		slot* s = &m_slots[m_tail & m_mask];
+		if(s->m_seq.load(std::memory_order_acquire) != m_tail + 1)
+		{
+			return nullptr;
+		}
+
+		m_held = true;
+		if(s->m_len == 0)
+		{
+			// the producer failed to fill the slot
+			release_held();
+			continue;
+		}
+
+		m_popped.fetch_add(1, std::memory_order_relaxed);
+		return reinterpret_cast<scap_evt*>(s->m_data.get());
+	}
+}
+
+async_event_ring::stats async_event_ring::get_stats() const
+{
+	stats res;
+	res.m_capacity = capacity();
+	res.m_pushed = m_pushed.load(std::memory_order_relaxed);
+	res.m_dropped = m_dropped.load(std::memory_order_relaxed);
+	res.m_popped = m_popped.load(std::memory_order_relaxed);
+	return res;
+}
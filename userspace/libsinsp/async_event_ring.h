@@ -0,0 +1,136 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+typedef struct ppm_evt_hdr scap_evt;
+
+namespace libsinsp
+{
+
+//
+// Bounded multi-producer single-consumer queue of raw events, used for the
+// async events that plugins send from their own threads. The events are
+// copied in a ring of slots whose buffers are allocated once and reused,
+// so that the steady state doesn't allocate at all. A slot buffer only
+// grows when an event doesn't fit in it, and goes back to SLOT_SIZE once
+// the consumer is done with an event larger than MAX_KEPT_SLOT_SIZE.
+//
+// The producers never wait: when the ring is full the event is dropped
+// and counted, and push() returns false so that the caller can report it.
+// The event returned by pop() stays valid until the next call to pop().
+//
+class async_event_ring
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 1024;
+	static constexpr size_t MAX_CAPACITY = 1 << 20;
+	static constexpr size_t SLOT_SIZE = 512;
+	static constexpr size_t MAX_KEPT_SLOT_SIZE = 8 * SLOT_SIZE;
+
+	//
+	// Counters of the ring since its creation
+	//
+	struct stats
+	{
+		uint64_t m_capacity;
+		uint64_t m_pushed; ///< events queued
+		uint64_t m_dropped; ///< events rejected because the ring was full
+		uint64_t m_popped; ///< events handed to the consumer
+	};
+
+	//
+	// The capacity is rounded up to a power of two, up to MAX_CAPACITY
+	//
+	explicit async_event_ring(size_t capacity = DEFAULT_CAPACITY);
+	~async_event_ring();
+	async_event_ring(const async_event_ring&) = delete;
+	async_event_ring& operator=(const async_event_ring&) = delete;
+
+	//
+	// Reserve a slot of len bytes and let fill write the event in it.
+	// Thread safe. Returns false, without calling fill, if the ring is full.
+	// If fill throws, the slot is skipped by the consumer.
+	//
+	template<typename F>
+	bool push(size_t len, F&& fill)
+	{
+		slot* s = acquire(len);
+		if(s == nullptr)
+		{
+			return false;
+		}
+		try
+		{
+			fill(reinterpret_cast<scap_evt*>(s->m_data.get()));
+		}
+		catch(...)
+		{
+			s->m_len = 0;
+			commit(s);
+			throw;
+		}
+		commit(s);
+		return true;
+	}
+
+	//
+	// Release the previous event and return the next one, or NULL if the
+	// ring is empty. Must be called by one thread at a time.
+	//
+	scap_evt* pop();
+
+	size_t capacity() const
+	{
+		return m_mask + 1;
+	}
+
+	stats get_stats() const;
+
+private:
+	struct alignas(64) slot
+	{
+		std::atomic<uint64_t> m_seq;
+		std::unique_ptr<uint8_t[]> m_data;
+		size_t m_size;
+		size_t m_len;
+	};
+
+	slot* acquire(size_t len);
+	void commit(slot* s);
+	void release_held();
+
+	std::unique_ptr<slot[]> m_slots;
+	uint64_t m_mask;
+
+	// Written by the producers
+	alignas(64) std::atomic<uint64_t> m_head;
+	std::atomic<uint64_t> m_pushed;
+	std::atomic<uint64_t> m_dropped;
+
+	// Written by the consumer
+	alignas(64) uint64_t m_tail;
+	bool m_held;
+	std::atomic<uint64_t> m_popped;
+};
+
+}
@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <sinsp_with_test_input.h>
+
+// Exposes the test input framework of the unit tests to the benchmarks.
+// Every instance owns an inspector, so it should be created outside of
+// the timed sections.
+class bench_input : public sinsp_with_test_input
+{
+public:
+	bench_input()
+	{
+		SetUp();
+	}
+
+	~bench_input()
+	{
+		TearDown();
+	}
+
+	void TestBody() override {}
+
+	using sinsp_with_test_input::m_inspector;
+	using sinsp_with_test_input::open_inspector;
+	using sinsp_with_test_input::add_event;
+	using sinsp_with_test_input::add_event_advance_ts;
+	using sinsp_with_test_input::add_default_init_thread;
+	using sinsp_with_test_input::add_simple_thread;
+	using sinsp_with_test_input::increasing_ts;
+	using sinsp_with_test_input::next_event;
+
+	// Adds an open and a close of a file with the given fd
+	void add_open_close(int64_t tid, int64_t fd, const char* name)
+	{
+		add_event(increasing_ts(), tid, PPME_SYSCALL_OPEN_E, 3, name, (uint32_t)PPM_O_RDWR, (uint32_t)0);
+		add_event(increasing_ts(), tid, PPME_SYSCALL_OPEN_X, 6, (uint64_t)fd, name, (uint32_t)PPM_O_RDWR, (uint32_t)0, (uint32_t)5, (uint64_t)123);
+		add_event(increasing_ts(), tid, PPME_SYSCALL_CLOSE_E, 1, fd);
+		add_event(increasing_ts(), tid, PPME_SYSCALL_CLOSE_X, 1, (int64_t)0);
+	}
+
+	// Returns an open exit event on a file, after setting up the init thread
+	sinsp_evt* open_file_event()
+	{
+		add_default_init_thread();
+		open_inspector();
+		add_event_advance_ts(increasing_ts(), INIT_TID, PPME_SYSCALL_OPEN_E, 3, "/etc/passwd", (uint32_t)PPM_O_RDONLY, (uint32_t)0);
+		return add_event_advance_ts(increasing_ts(), INIT_TID, PPME_SYSCALL_OPEN_X, 6, (uint64_t)3, "/etc/passwd", (uint32_t)PPM_O_RDONLY, (uint32_t)0, (uint32_t)5, (uint64_t)123);
+	}
+};
@@ -0,0 +1,108 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "bench_input.h"
+#include <filter.h>
+#include <filter_ruleset.h>
+
+static const char* s_filter =
+	"evt.type in (open, openat, openat2) and evt.dir = < "
+	"and fd.name startswith /etc and not proc.name in (sshd, systemd, cron) "
+	"and fd.directory != /etc/ssl";
+
+static void BM_filter_compile(benchmark::State& state)
+{
+	sinsp inspector;
+	for(auto _ : state)
+	{
+		sinsp_filter_compiler compiler(&inspector, s_filter);
+		std::unique_ptr<sinsp_filter> filter(compiler.compile());
+		benchmark::DoNotOptimize(filter.get());
+	}
+}
+BENCHMARK(BM_filter_compile);
+
+static void BM_filter_eval(benchmark::State& state)
+{
+	bench_input input;
+	sinsp_evt* evt = input.open_file_event();
+	sinsp_filter_compiler compiler(&input.m_inspector, s_filter);
+	std::unique_ptr<sinsp_filter> filter(compiler.compile());
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(filter->run(evt));
+	}
+}
+BENCHMARK(BM_filter_eval);
+
+// A ruleset like Falco's, whose rules are spread across event types and
+// repeat the same checks
+static std::vector<std::string> ruleset_filters(size_t num_rules)
+{
+	static const char* evttypes[] = {
+		"open", "openat", "execve", "connect", "accept", "chmod",
+		"unlink", "rename", "mkdir", "setuid", "ptrace", "mount",
+	};
+	std::vector<std::string> filters;
+	for(size_t i = 0; i < num_rules; i++)
+	{
+		filters.push_back(std::string("evt.type = ")
+			+ evttypes[i % (sizeof(evttypes) / sizeof(evttypes[0]))]
+			+ " and proc.name != sshd and fd.name startswith /rule" + std::to_string(i));
+	}
+	return filters;
+}
+
+static void BM_filter_eval_separate(benchmark::State& state)
+{
+	bench_input input;
+	sinsp_evt* evt = input.open_file_event();
+	std::vector<std::unique_ptr<sinsp_filter>> filters;
+	for(const auto& f : ruleset_filters(state.range(0)))
+	{
+		sinsp_filter_compiler compiler(&input.m_inspector, f);
+		filters.emplace_back(compiler.compile());
+	}
+	for(auto _ : state)
+	{
+		for(auto& f : filters)
+		{
+			benchmark::DoNotOptimize(f->run(evt));
+		}
+	}
+}
+BENCHMARK(BM_filter_eval_separate)->Arg(100)->Arg(400);
+
+static void BM_filter_eval_ruleset(benchmark::State& state)
+{
+	bench_input input;
+	sinsp_evt* evt = input.open_file_event();
+	sinsp_filter_ruleset ruleset;
+	auto filters = ruleset_filters(state.range(0));
+	for(size_t i = 0; i < filters.size(); i++)
+	{
+		sinsp_filter_compiler compiler(&input.m_inspector, filters[i]);
+		compiler.set_cache(ruleset.cache());
+		ruleset.add(i, std::unique_ptr<sinsp_filter>(compiler.compile()));
+	}
+	std::vector<uint32_t> matched;
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(ruleset.run(evt, matched));
+	}
+}
+BENCHMARK(BM_filter_eval_ruleset)->Arg(100)->Arg(400);
@@ -0,0 +1,39 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "bench_input.h"
+#include <eventformatter.h>
+
+static void BM_formatter_tostring(benchmark::State& state)
+{
+	auto of = (gen_event_formatter::output_format)state.range(0);
+	bench_input input;
+	sinsp_evt* evt = input.open_file_event();
+	sinsp_evt_formatter formatter(&input.m_inspector,
+		"%evt.num %evt.time %evt.cpu %proc.name (%thread.tid) %evt.dir %evt.type %evt.args "
+		"user=%user.name fd=%fd.num name=%fd.name");
+	std::string output;
+	for(auto _ : state)
+	{
+		formatter.tostring_withformat(evt, output, of);
+		benchmark::DoNotOptimize(output.data());
+	}
+	state.SetLabel(of == gen_event_formatter::OF_JSON ? "json" : "text");
+}
+BENCHMARK(BM_formatter_tostring)
+	->Arg(gen_event_formatter::OF_NORMAL)
+	->Arg(gen_event_formatter::OF_JSON);
@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "bench_input.h"
+
+#include <cstring>
+#include <async_event_ring.h>
+#include <tbb/concurrent_queue.h>
+
+// Event throughput of sinsp::next() on syscall events that update the
+// thread and fd tables
+static void BM_sinsp_next(benchmark::State& state)
+{
+	const int64_t nfiles = state.range(0);
+	for(auto _ : state)
+	{
+		state.PauseTiming();
+		auto input = std::make_unique<bench_input>();
+		input->add_default_init_thread();
+		for(int64_t i = 0; i < nfiles; i++)
+		{
+			input->add_open_close(INIT_TID, 3 + (i % 64), "/tmp/the_file");
+		}
+		input->open_inspector();
+		state.ResumeTiming();
+
+		while(input->next_event() != nullptr)
+		{
+		}
+
+		state.PauseTiming();
+		input.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * nfiles * 4);
+}
+BENCHMARK(BM_sinsp_next)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Queueing and dequeueing of a plugin async event, as it was done with a
+// heap allocated event in a concurrent queue, and as it is done now with
+// the preallocated slots of the async event ring
+static std::vector<uint8_t> make_async_event(size_t datalen)
+{
+	std::vector<uint8_t> buf(sizeof(scap_evt) + datalen, 'x');
+	scap_evt* e = (scap_evt*)buf.data();
+	e->type = PPME_ASYNCEVENT_E;
+	e->len = buf.size();
+	e->nparams = 0;
+	e->tid = -1;
+	e->ts = -1;
+	return buf;
+}
+
+static void BM_sinsp_async_evt_queue(benchmark::State& state)
+{
+	auto buf = make_async_event(state.range(0));
+	const scap_evt* src = (const scap_evt*)buf.data();
+	tbb::concurrent_queue<std::shared_ptr<sinsp_evt>> queue;
+	std::shared_ptr<sinsp_evt> cur;
+	for(auto _ : state)
+	{
+		auto evt = std::unique_ptr<sinsp_evt>(new sinsp_evt());
+		evt->m_pevt_storage = new char[src->len];
+		memcpy(evt->m_pevt_storage, src, src->len);
+		evt->m_pevt = (scap_evt*)evt->m_pevt_storage;
+		evt->init();
+		queue.push(std::move(evt));
+		queue.try_pop(cur);
+		benchmark::DoNotOptimize(cur->m_pevt);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_sinsp_async_evt_queue)->Arg(64)->Arg(1024);
+
+static void BM_sinsp_async_evt_ring(benchmark::State& state)
+{
+	auto buf = make_async_event(state.range(0));
+	const scap_evt* src = (const scap_evt*)buf.data();
+	libsinsp::async_event_ring ring;
+	sinsp_evt evt;
+	for(auto _ : state)
+	{
+		ring.push(src->len, [src](scap_evt* dest) { memcpy(dest, src, src->len); });
+		evt.m_pevt = ring.pop();
+		evt.init();
+		benchmark::DoNotOptimize(evt.m_pevt);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_sinsp_async_evt_ring)->Arg(64)->Arg(1024);
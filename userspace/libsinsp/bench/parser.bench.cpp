@@ -0,0 +1,89 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "bench_input.h"
+
+#include <unistd.h>
+
+// The scap-files are downloaded when configuring the unit tests
+static const std::string s_sample_scap = RESOURCE_DIR "/sample.scap";
+static const std::string s_kexec_x86_scap = LIBSINSP_TEST_SCAP_FILES_DIR + std::string("kexec_x86.scap");
+static const std::string s_kexec_arm64_scap = LIBSINSP_TEST_SCAP_FILES_DIR + std::string("kexec_arm64.scap");
+
+// Reads all the events of the given capture file with libscap only, as a
+// baseline for BM_parser_process_event
+static void BM_parser_scap_next(benchmark::State& state, const std::string& path)
+{
+	if(access(path.c_str(), R_OK) != 0)
+	{
+		state.SkipWithError(("cannot read " + path).c_str());
+		return;
+	}
+
+	int64_t nevts = 0;
+	for(auto _ : state)
+	{
+		sinsp inspector;
+		inspector.open_savefile(path);
+		scap_evt* pevt;
+		uint16_t cpuid;
+		int32_t res;
+		while((res = scap_next(inspector.m_h, &pevt, &cpuid)) != SCAP_EOF)
+		{
+			if(res == SCAP_FAILURE)
+			{
+				state.SkipWithError(scap_getlasterr(inspector.m_h));
+				return;
+			}
+			nevts += (res == SCAP_SUCCESS);
+		}
+		inspector.close();
+	}
+	state.SetItemsProcessed(nevts);
+}
+BENCHMARK_CAPTURE(BM_parser_scap_next, sample, s_sample_scap)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_parser_scap_next, kexec_x86, s_kexec_x86_scap)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_parser_scap_next, kexec_arm64, s_kexec_arm64_scap)->Unit(benchmark::kMillisecond);
+
+// Reads all the events of the given capture file through sinsp::next(),
+// which runs them through sinsp_parser::process_event(). The per-event
+// cost of the parser is the difference with BM_parser_scap_next.
+static void BM_parser_process_event(benchmark::State& state, const std::string& path)
+{
+	if(access(path.c_str(), R_OK) != 0)
+	{
+		state.SkipWithError(("cannot read " + path).c_str());
+		return;
+	}
+
+	int64_t nevts = 0;
+	for(auto _ : state)
+	{
+		sinsp inspector;
+		inspector.open_savefile(path);
+		sinsp_evt* evt;
+		while(inspector.next(&evt) != SCAP_EOF)
+		{
+			nevts++;
+		}
+		inspector.close();
+	}
+	state.SetItemsProcessed(nevts);
+}
+BENCHMARK_CAPTURE(BM_parser_process_event, sample, s_sample_scap)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_parser_process_event, kexec_x86, s_kexec_x86_scap)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_parser_process_event, kexec_arm64, s_kexec_arm64_scap)->Unit(benchmark::kMillisecond);
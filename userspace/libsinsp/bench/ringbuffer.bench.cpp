@@ -0,0 +1,152 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+extern "C"
+{
+#include <libpman.h>
+#include <ppm_events_public.h>
+#include "state.h"
+#include "ringbuffer_definitions.h"
+}
+
+// Consumer of the modern probe ring buffers, fed with synthetic ring buffers
+// in userspace memory so that no probe is needed: g_state is set up as
+// pman_init_state() and the ring buffer manager would do. Only the first
+// n_busy rings get events, the others stay empty as the rings of idle CPUs.
+class synthetic_rings
+{
+public:
+	static constexpr unsigned long RING_SIZE = 64 * 1024;
+	static constexpr uint64_t EVENTS_PER_RING = 1024;
+
+	synthetic_rings(uint16_t n_rings, uint16_t n_busy, bool heap_consumer):
+		m_rings(n_rings),
+		m_data(n_rings, std::vector<uint8_t>(RING_SIZE)),
+		m_cons(n_rings, 0),
+		m_prod(n_rings, 0),
+		m_cons_pos(n_rings, 0),
+		m_prod_pos(n_rings, 0),
+		m_heap(n_rings),
+		m_ring_in_heap(new bool[n_rings]())
+	{
+		for(uint16_t i = 0; i < n_rings; i++)
+		{
+			m_rings[i].data = m_data[i].data();
+			m_rings[i].mask = RING_SIZE - 1;
+			m_rings[i].consumer_pos = &m_cons[i];
+			m_rings[i].producer_pos = &m_prod[i];
+		}
+		m_rb.rings = m_rings.data();
+		m_rb.ring_cnt = n_rings;
+
+		// the events of the busy rings interleave
+		for(uint64_t i = 0; i < EVENTS_PER_RING * n_busy; i++)
+		{
+			write_event(i % n_busy, i);
+		}
+
+		pman_clear_state();
+		g_state.rb_manager = &m_rb;
+		g_state.n_required_buffers = n_rings;
+		g_state.cons_pos = m_cons_pos.data();
+		g_state.prod_pos = m_prod_pos.data();
+		g_state.heap_consumer = heap_consumer;
+		g_state.heap = m_heap.data();
+		g_state.ring_in_heap = m_ring_in_heap.get();
+		g_state.heap_rescan_interval = DEFAULT_HEAP_RESCAN_INTERVAL;
+		rewind();
+	}
+
+	~synthetic_rings()
+	{
+		pman_clear_state();
+	}
+
+	// Make all the events readable again, the producer positions are
+	// already known as they would be after the first read
+	void rewind()
+	{
+		std::fill(m_cons.begin(), m_cons.end(), 0);
+		std::fill(m_cons_pos.begin(), m_cons_pos.end(), 0);
+		std::copy(m_prod.begin(), m_prod.end(), m_prod_pos.begin());
+		memset(m_ring_in_heap.get(), 0, m_rings.size() * sizeof(bool));
+		g_state.last_ring_read = -1;
+		g_state.last_event_size = 0;
+		g_state.heap_size = 0;
+		g_state.heap_pops = 0;
+	}
+
+private:
+	void write_event(uint16_t ring, uint64_t ts)
+	{
+		uint32_t len = sizeof(struct ppm_evt_hdr);
+		uint8_t* hdr = m_data[ring].data() + (m_prod[ring] & (RING_SIZE - 1));
+		struct ppm_evt_hdr* evt = (struct ppm_evt_hdr*)(hdr + BPF_RINGBUF_HDR_SZ);
+		evt->ts = ts;
+		evt->tid = ring;
+		evt->len = len;
+		evt->type = PPME_SYSCALL_CLOSE_E;
+		evt->nparams = 0;
+		*(uint32_t*)hdr = len;
+		m_prod[ring] += roundup_len(len);
+	}
+
+	struct ring_buffer m_rb = {};
+	std::vector<struct ring> m_rings;
+	std::vector<std::vector<uint8_t>> m_data;
+	std::vector<unsigned long> m_cons;
+	std::vector<unsigned long> m_prod;
+	std::vector<unsigned long> m_cons_pos;
+	std::vector<unsigned long> m_prod_pos;
+	std::vector<struct ring_head> m_heap;
+	std::unique_ptr<bool[]> m_ring_in_heap;
+};
+
+// Args: number of rings, number of rings with events, heap consumer
+static void BM_ringbuffer_consume(benchmark::State& state)
+{
+	synthetic_rings rings(state.range(0), state.range(1), state.range(2));
+	void* evt;
+	int16_t buffer_id;
+	uint64_t n_events = 0;
+	for(auto _ : state)
+	{
+		pman_consume_first_event(&evt, &buffer_id);
+		if(evt == NULL)
+		{
+			state.PauseTiming();
+			rings.rewind();
+			state.ResumeTiming();
+			continue;
+		}
+		n_events++;
+	}
+	state.SetItemsProcessed(n_events);
+	state.SetLabel(state.range(2) ? "heap" : "linear");
+}
+BENCHMARK(BM_ringbuffer_consume)
+	->ArgsProduct({{8, 64, 256}, {8}, {0, 1}})
+	->ArgsProduct({{64, 256}, {64}, {0, 1}})
+	->Args({256, 256, 0})
+	->Args({256, 256, 1});
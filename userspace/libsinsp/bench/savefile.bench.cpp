@@ -0,0 +1,95 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "bench_input.h"
+#include <dumper.h>
+
+#include <unistd.h>
+
+static const char* s_sample_scap = RESOURCE_DIR "/sample.scap";
+
+// Reads all the events of the given capture file
+static void BM_savefile_read(benchmark::State& state, const std::string& path)
+{
+	if(access(path.c_str(), R_OK) != 0)
+	{
+		state.SkipWithError(("cannot read " + path).c_str());
+		return;
+	}
+
+	int64_t nevts = 0;
+	for(auto _ : state)
+	{
+		sinsp inspector;
+		inspector.open_savefile(path);
+		sinsp_evt* evt;
+		while(inspector.next(&evt) != SCAP_EOF)
+		{
+			nevts++;
+		}
+		inspector.close();
+	}
+	state.SetItemsProcessed(nevts);
+}
+BENCHMARK_CAPTURE(BM_savefile_read, sample, std::string(s_sample_scap))
+	->Unit(benchmark::kMillisecond);
+// The scap-files are downloaded when configuring the unit tests
+BENCHMARK_CAPTURE(BM_savefile_read, kexec_x86, LIBSINSP_TEST_SCAP_FILES_DIR + std::string("kexec_x86.scap"))
+	->Unit(benchmark::kMillisecond);
+
+// Reads all the events of the sample capture file and writes them to a
+// new file with the given compression. The cost of the writes is the
+// difference with BM_savefile_read/sample.
+static void BM_savefile_write(benchmark::State& state)
+{
+	auto compress = (compression_mode)state.range(0);
+	std::string filename = "libsinsp_bench_" + std::to_string(state.range(0)) + ".scap";
+
+	int64_t nevts = 0;
+	for(auto _ : state)
+	{
+		sinsp inspector;
+		inspector.open_savefile(s_sample_scap);
+		sinsp_dumper dumper;
+		try
+		{
+			dumper.open(&inspector, filename, compress);
+		}
+		catch(const sinsp_exception& e)
+		{
+			state.SkipWithError(e.what());
+			break;
+		}
+
+		sinsp_evt* evt;
+		while(inspector.next(&evt) != SCAP_EOF)
+		{
+			dumper.dump(evt);
+			nevts++;
+		}
+		dumper.close();
+		inspector.close();
+	}
+	state.SetItemsProcessed(nevts);
+	unlink(filename.c_str());
+}
+BENCHMARK(BM_savefile_write)
+	->Arg(SCAP_COMPRESSION_NONE)
+	->Arg(SCAP_COMPRESSION_GZIP)
+	->Arg(SCAP_COMPRESSION_LZ4)
+	->Arg(SCAP_COMPRESSION_ZSTD)
+	->Unit(benchmark::kMillisecond);
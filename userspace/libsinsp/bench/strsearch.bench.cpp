@@ -0,0 +1,100 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "bench_input.h"
+
+#include <cstring>
+#include <strings.h>
+#include <filter.h>
+#include <strsearch.h>
+
+// Haystacks like the ones the filters see in proc.cmdline and fd.name,
+// with needles that are not found so that the whole string is scanned
+static const char* s_haystacks[] = {
+	"/usr/bin/java -Xmx2g -Dlog4j.configurationFile=/etc/app/log4j2.xml "
+	"-cp /opt/app/lib/*:/opt/app/classes com.example.server.Main --port 8080 "
+	"--config /etc/app/config.yaml",
+	"/var/lib/docker/overlay2/4f0c1e2b3a/merged/usr/lib/python3.11/site-packages/requests/adapters.py",
+	"/etc/passwd",
+};
+static const char* s_needle = "--password";
+static const char* s_ineedle = "SITE-PACKAGES/PIP";
+
+static void BM_strsearch_strstr(benchmark::State& state)
+{
+	const char* haystack = s_haystacks[state.range(0)];
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(strstr(haystack, s_needle));
+	}
+}
+BENCHMARK(BM_strsearch_strstr)->DenseRange(0, 2);
+
+static void BM_strsearch_find(benchmark::State& state)
+{
+	const char* haystack = s_haystacks[state.range(0)];
+	size_t needle_len = strlen(s_needle);
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(libsinsp::strsearch::find(haystack, strlen(haystack), s_needle, needle_len));
+	}
+	state.SetLabel(libsinsp::strsearch::implementation());
+}
+BENCHMARK(BM_strsearch_find)->DenseRange(0, 2);
+
+static void BM_strsearch_strcasestr(benchmark::State& state)
+{
+	const char* haystack = s_haystacks[state.range(0)];
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(strcasestr(haystack, s_ineedle));
+	}
+}
+BENCHMARK(BM_strsearch_strcasestr)->DenseRange(0, 2);
+
+static void BM_strsearch_ifind(benchmark::State& state)
+{
+	const char* haystack = s_haystacks[state.range(0)];
+	size_t needle_len = strlen(s_ineedle);
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(libsinsp::strsearch::ifind(haystack, strlen(haystack), s_ineedle, needle_len));
+	}
+	state.SetLabel(libsinsp::strsearch::implementation());
+}
+BENCHMARK(BM_strsearch_ifind)->DenseRange(0, 2);
+
+// End to end, through the filter operators
+static void BM_strsearch_filter_eval(benchmark::State& state)
+{
+	static const char* filters[] = {
+		"fd.name contains /shadow",
+		"fd.name icontains /SHADOW",
+		"fd.name startswith /etc/sha",
+		"fd.name endswith /shadow",
+	};
+	bench_input input;
+	sinsp_evt* evt = input.open_file_event();
+	sinsp_filter_compiler compiler(&input.m_inspector, filters[state.range(0)]);
+	std::unique_ptr<sinsp_filter> filter(compiler.compile());
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(filter->run(evt));
+	}
+	state.SetLabel(filters[state.range(0)]);
+}
+BENCHMARK(BM_strsearch_filter_eval)->DenseRange(0, 3);
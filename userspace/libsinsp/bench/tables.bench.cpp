@@ -0,0 +1,206 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "bench_input.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <random>
+#include <unistd.h>
+
+// Lookups of random existing tids in a thread table of the given size
+static void BM_thread_table_get(benchmark::State& state)
+{
+	const int64_t nthreads = state.range(0);
+	threadinfo_map_t table;
+	for(int64_t tid = 1; tid <= nthreads; tid++)
+	{
+		auto tinfo = std::make_shared<sinsp_threadinfo>();
+		tinfo->m_tid = tid;
+		table.put(tinfo);
+	}
+
+	std::mt19937_64 rng(42);
+	std::vector<int64_t> tids(4096);
+	for(auto& tid : tids)
+	{
+		tid = 1 + (int64_t)(rng() % nthreads);
+	}
+
+	size_t i = 0;
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(table.get(tids[i++ % tids.size()]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_thread_table_get)->Arg(1000)->Arg(100000);
+
+// Same as above, through the thread manager and its lookup cache
+static void BM_thread_manager_get_thread_ref(benchmark::State& state)
+{
+	const int64_t nthreads = state.range(0);
+	bench_input input;
+	input.add_default_init_thread();
+	for(int64_t tid = 2; tid <= nthreads; tid++)
+	{
+		input.add_simple_thread(tid, tid, INIT_TID);
+	}
+	input.open_inspector();
+
+	std::mt19937_64 rng(42);
+	std::vector<int64_t> tids(4096);
+	for(auto& tid : tids)
+	{
+		tid = 1 + (int64_t)(rng() % nthreads);
+	}
+
+	size_t i = 0;
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(input.m_inspector.get_thread_ref(tids[i++ % tids.size()]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_thread_manager_get_thread_ref)->Arg(1000)->Arg(100000);
+
+// Lookups of random existing fds in an fd table of the given size
+static void BM_fd_table_find(benchmark::State& state)
+{
+	const int64_t nfds = state.range(0);
+	sinsp inspector;
+	sinsp_fdtable table(&inspector);
+	sinsp_fdinfo_t fdinfo;
+	for(int64_t fd = 0; fd < nfds; fd++)
+	{
+		table.add(fd, &fdinfo);
+	}
+
+	std::mt19937_64 rng(42);
+	std::vector<int64_t> fds(4096);
+	for(auto& fd : fds)
+	{
+		fd = (int64_t)(rng() % nfds);
+	}
+
+	size_t i = 0;
+	for(auto _ : state)
+	{
+		benchmark::DoNotOptimize(table.find(fds[i++ % fds.size()]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_fd_table_find)->Arg(16)->Arg(1024)->Arg(8192);
+
+// Reads and writes of dynamic fields of random threads, like the ones
+// that plugins define on the thread table
+static void BM_thread_dynamic_fields(benchmark::State& state)
+{
+	const int64_t nthreads = state.range(0);
+	sinsp inspector;
+	auto fields = inspector.m_thread_manager->dynamic_fields();
+	auto acc_count = fields->add_field<uint64_t>("bench_count").new_accessor<uint64_t>();
+	auto acc_flags = fields->add_field<uint32_t>("bench_flags").new_accessor<uint32_t>();
+	auto acc_name = fields->add_field<std::string>("bench_name").new_accessor<std::string>();
+	auto acc_ts = fields->add_field<uint64_t>("bench_ts").new_accessor<uint64_t>();
+
+	std::vector<std::unique_ptr<sinsp_threadinfo>> threads;
+	for(int64_t tid = 1; tid <= nthreads; tid++)
+	{
+		threads.emplace_back(inspector.build_threadinfo());
+		threads.back()->set_dynamic_field(acc_name, std::string("thread"));
+	}
+
+	std::mt19937_64 rng(42);
+	std::vector<size_t> idx(4096);
+	for(auto& i : idx)
+	{
+		i = (size_t)(rng() % nthreads);
+	}
+
+	size_t i = 0;
+	uint64_t count;
+	uint32_t flags;
+	const char* name;
+	for(auto _ : state)
+	{
+		auto& tinfo = threads[idx[i++ % idx.size()]];
+		tinfo->get_dynamic_field(acc_count, count);
+		tinfo->set_dynamic_field(acc_count, count + 1);
+		tinfo->get_dynamic_field(acc_flags, flags);
+		tinfo->set_dynamic_field(acc_ts, (uint64_t)i);
+		tinfo->get_dynamic_field(acc_name, name);
+		benchmark::DoNotOptimize(name);
+		benchmark::DoNotOptimize(flags);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_thread_dynamic_fields)->Arg(1000)->Arg(100000);
+
+static uint64_t rss_kb()
+{
+	uint64_t size = 0, resident = 0;
+	FILE* f = fopen("/proc/self/statm", "r");
+	if(f != nullptr)
+	{
+		if(fscanf(f, "%" SCNu64 " %" SCNu64, &size, &resident) != 2)
+		{
+			resident = 0;
+		}
+		fclose(f);
+	}
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Memory taken by threads of the same pod, which have the same args, env
+// and cgroups. Reported as the rss growth after creating them.
+static void BM_thread_table_memory(benchmark::State& state)
+{
+	const int64_t nthreads = state.range(0);
+
+	std::string env;
+	for(int i = 0; i < 64; i++)
+	{
+		env += "KUBERNETES_SERVICE_VARIABLE_" + std::to_string(i) + "=10.96.0." + std::to_string(i) + '\0';
+	}
+	std::string args = std::string("--config") + '\0' + "/etc/app/config.yaml" + '\0';
+	std::string cgroups;
+	for(const char* subsys : {"cpuset", "cpu", "cpuacct", "blkio", "memory", "devices", "freezer", "net_cls", "perf_event", "pids"})
+	{
+		cgroups += std::string(subsys) + "=/kubepods/besteffort/pod5a1a2b3c-0d4e-4f5a-8b6c-7d8e9f0a1b2c/0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef" + '\0';
+	}
+
+	for(auto _ : state)
+	{
+		sinsp inspector;
+		std::vector<std::unique_ptr<sinsp_threadinfo>> threads;
+		threads.reserve(nthreads);
+		uint64_t rss_before = rss_kb();
+		for(int64_t tid = 1; tid <= nthreads; tid++)
+		{
+			std::unique_ptr<sinsp_threadinfo> tinfo(inspector.build_threadinfo());
+			tinfo->m_tid = tid;
+			tinfo->m_pid = tid;
+			tinfo->set_args(args.data(), args.size());
+			tinfo->set_env(env.data(), env.size());
+			tinfo->set_cgroups(cgroups.data(), cgroups.size());
+			threads.emplace_back(std::move(tinfo));
+		}
+		state.counters["rss_kb"] = (double)(rss_kb() - rss_before);
+	}
+}
+BENCHMARK(BM_thread_table_memory)->Arg(100000)->Iterations(1)->Unit(benchmark::kMillisecond);
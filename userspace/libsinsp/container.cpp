@@ -41,8 +41,22 @@ limitations under the License.
 
 using namespace libsinsp;
 
+// The versions of the container maps are unique across all the managers, so
+// that the cache of a reader thread can't mistake a map for another one
+static std::atomic<uint64_t> s_containers_version{0};
+
+struct containers_snapshot
+{
+	uint64_t m_version = 0;
+	sinsp_container_manager::map_ptr_t m_containers;
+};
+
+static thread_local containers_snapshot t_containers_snapshot;
+
 sinsp_container_manager::sinsp_container_manager(sinsp* inspector, bool static_container, const std::string static_id, const std::string static_name, const std::string static_image) :
 	m_inspector(inspector),
+	m_containers(std::make_shared<const map_t>()),
+	m_containers_version(++s_containers_version),
 	m_last_flush_time_ns(0),
 	m_static_container(static_container),
 	m_static_id(static_id),
@@ -54,6 +68,11 @@ sinsp_container_manager::sinsp_container_manager(sinsp* inspector, bool static_c
 
 sinsp_container_manager::~sinsp_container_manager()
 {
+	// the caches of the other threads hold the map until their next lookup
+	if(t_containers_snapshot.m_containers == m_containers)
+	{
+		t_containers_snapshot = containers_snapshot();
+	}
 }
 
 bool sinsp_container_manager::remove_inactive_containers()
@@ -86,33 +105,60 @@ bool sinsp_container_manager::remove_inactive_containers()
 			return true;
 		});
 
-		auto containers = m_containers.lock();
-		for(auto it = containers->begin(); it != containers->end();)
+		update_containers([&](map_t& containers)
 		{
-			if(containers_in_use.find(it->first) == containers_in_use.end())
+			for(auto it = containers.begin(); it != containers.end();)
 			{
-				sinsp_container_info::ptr_t container = it->second;
-				for(const auto &remove_cb : m_remove_callbacks)
+				if(containers_in_use.find(it->first) == containers_in_use.end())
 				{
-					remove_cb(*container);
+					sinsp_container_info::ptr_t container = it->second;
+					for(const auto &remove_cb : m_remove_callbacks)
+					{
+						remove_cb(*container);
+					}
+					containers.erase(it++);
+				}
+				else
+				{
+					++it;
 				}
-				containers->erase(it++);
-			}
-			else
-			{
-				++it;
 			}
-		}
+		});
 	}
 
 	return res;
 }
 
+const sinsp_container_manager::map_t& sinsp_container_manager::snapshot() const
+{
+	containers_snapshot& cache = t_containers_snapshot;
+	uint64_t version = m_containers_version.load(std::memory_order_acquire);
+	if(cache.m_version != version)
+	{
+		// the map is published before its version, so this is the map of
+		// that version or a later one, which is reloaded on the next call
+		cache.m_containers = std::atomic_load(&m_containers);
+		cache.m_version = version;
+	}
+	return *cache.m_containers;
+}
+
+void sinsp_container_manager::update_containers(const std::function<void(map_t&)>& update)
+{
+	std::lock_guard<std::mutex> write_lock(m_containers_write_mutex);
+
+	auto containers = std::make_shared<map_t>(*std::atomic_load(&m_containers));
+	update(*containers);
+
+	std::atomic_store(&m_containers, map_ptr_t(std::move(containers)));
+	m_containers_version.store(++s_containers_version, std::memory_order_release);
+}
+
 sinsp_container_info::ptr_t sinsp_container_manager::get_container(const std::string& container_id) const
 {
-	auto containers = m_containers.lock();
-	auto it = containers->find(container_id);
-	if(it != containers->end())
+	const map_t& containers = snapshot();
+	auto it = containers.find(container_id);
+	if(it != containers.end())
 	{
 		return it->second;
 	}
@@ -285,17 +331,17 @@ bool sinsp_container_manager::container_to_sinsp_event(const std::string& json,
 
 sinsp_container_manager::map_ptr_t sinsp_container_manager::get_containers() const
 {
-	return m_containers.lock();
+	return std::atomic_load(&m_containers);
 }
 
 void sinsp_container_manager::add_container(const sinsp_container_info::ptr_t& container_info, sinsp_threadinfo *thread)
 {
 	set_lookup_status(container_info->m_id, container_info->m_type, container_info->get_lookup_status());
 
+	update_containers([&](map_t& containers)
 	{
-		auto containers = m_containers.lock();
-		(*containers)[container_info->m_id] = container_info;
-	}
+		containers[container_info->m_id] = container_info;
+	});
 
 	for(const auto& new_cb : m_new_callbacks)
 	{
@@ -305,9 +351,11 @@ void sinsp_container_manager::add_container(const sinsp_container_info::ptr_t& c
 
 void sinsp_container_manager::replace_container(const sinsp_container_info::ptr_t& container_info)
 {
-	auto containers = m_containers.lock();
-	ASSERT(containers->find(container_info->m_id) != containers->end());
-	(*containers)[container_info->m_id] = container_info;
+	update_containers([&](map_t& containers)
+	{
+		ASSERT(containers.find(container_info->m_id) != containers.end());
+		containers[container_info->m_id] = container_info;
+	});
 }
 
 void sinsp_container_manager::notify_new_container(const sinsp_container_info& container_info, sinsp_threadinfo *tinfo)
@@ -384,7 +432,7 @@ bool sinsp_container_manager::async_allowed() const
 
 void sinsp_container_manager::dump_containers(sinsp_dumper& dumper)
 {
-	for(const auto& it : (*m_containers.lock()))
+	for(const auto& it : *get_containers())
 	{
 		sinsp_evt evt;
 		if(container_to_sinsp_event(container_to_json(*it.second), &evt, it.second->get_tinfo(m_inspector)))
@@ -17,8 +17,10 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "scap.h"
@@ -35,7 +37,6 @@ limitations under the License.
 #include "container_engine/container_cache_interface.h"
 #include "container_engine/container_engine_base.h"
 #include "container_engine/sinsp_container_type.h"
-#include "mutex.h"
 
 class sinsp_dumper;
 
@@ -43,7 +44,8 @@ class sinsp_container_manager :
 	public libsinsp::container_engine::container_cache_interface
 {
 public:
-	using map_ptr_t = libsinsp::ConstMutexGuard<std::unordered_map<std::string, sinsp_container_info::ptr_t>>;
+	using map_t = std::unordered_map<std::string, sinsp_container_info::ptr_t>;
+	using map_ptr_t = std::shared_ptr<const map_t>;
 
 	/**
 	 * Due to how the container manager is architected, it makes it difficult
@@ -62,7 +64,8 @@ public:
 
 	/**
 	 * @brief Get the whole container map (read-only)
-	 * @return the map of container_id -> shared_ptr<container_info>
+	 * @return a snapshot of the map of container_id -> shared_ptr<container_info>,
+	 * which is not affected by the later updates of the manager
 	 */
 	map_ptr_t get_containers() const;
 	bool remove_inactive_containers();
@@ -130,8 +133,8 @@ public:
 	void identify_category(sinsp_threadinfo *tinfo);
 
 	bool container_exists(const std::string& container_id) const override{
-		auto containers = m_containers.lock();
-		return containers->find(container_id) != containers->end() ||
+		const map_t& containers = snapshot();
+		return containers.find(container_id) != containers.end() ||
 			m_lookups.find(container_id) != m_lookups.end();
 	}
 
@@ -222,7 +225,24 @@ private:
 	std::map<sinsp_container_type, std::shared_ptr<libsinsp::container_engine::container_engine_base>> m_container_engine_by_type;
 
 	sinsp* m_inspector;
-	libsinsp::Mutex<std::unordered_map<std::string, std::shared_ptr<const sinsp_container_info>>> m_containers;
+	/**
+	 * The container map is never modified in place. The writers, e.g. the
+	 * async lookups of the container engines, publish an updated copy of it,
+	 * and each reader thread keeps the last snapshot it has seen until the
+	 * version changes. The map is published with std::atomic_store and read
+	 * with std::atomic_load, so readers never take a lock, and a lookup
+	 * costs an atomic load of the version and a hash probe.
+	 *
+	 * The snapshot cached by a thread keeps the map alive until that thread
+	 * looks up the containers of any manager again: destroying a manager
+	 * only releases the snapshot cached by the destroying thread.
+	 */
+	const map_t& snapshot() const; ///< valid until the next call on the same thread
+	void update_containers(const std::function<void(map_t&)>& update);
+
+	map_ptr_t m_containers; ///< only accessed with std::atomic_load/std::atomic_store
+	std::mutex m_containers_write_mutex; ///< serializes the writers
+	std::atomic<uint64_t> m_containers_version; ///< unique across all the managers
 	std::unordered_map<std::string, std::unordered_map<sinsp_container_type, sinsp_container_lookup::state>> m_lookups;
 	uint64_t m_last_flush_time_ns;
 	std::list<new_container_cb> m_new_callbacks;
@@ -47,7 +47,7 @@ bool rkt::match(container_cache_interface *cache, sinsp_threadinfo *tinfo, sinsp
 						return false;
 					}
 				}
-				for(const auto& arg : ptinfo->m_args)
+				for(const auto& arg : ptinfo->get_args())
 				{
 					if(arg.find(SYSTEMD_UUID_ARG) != std::string::npos)
 					{
@@ -40,11 +40,24 @@ sinsp_dumper::~sinsp_dumper()
 {
 	if(m_dumper != NULL)
 	{
-		scap_dump_close(m_dumper);
+		if(scap_dump_flush(m_dumper) != SCAP_SUCCESS)
+		{
+			g_logger.format(sinsp_logger::SEV_ERROR, "error closing the dump file: %s",
+					scap_dump_getlasterr(m_dumper));
+		}
+		if(scap_dump_close(m_dumper) != SCAP_SUCCESS)
+		{
+			g_logger.format(sinsp_logger::SEV_ERROR, "error writing the end of the dump file");
+		}
 	}
 }
 
 void sinsp_dumper::open(sinsp* inspector, const std::string& filename, bool compress, bool threads_from_sinsp)
+{
+	open(inspector, filename, compress ? SCAP_COMPRESSION_GZIP : SCAP_COMPRESSION_NONE, threads_from_sinsp);
+}
+
+void sinsp_dumper::open(sinsp* inspector, const std::string& filename, compression_mode compress, bool threads_from_sinsp)
 {
 	char error[SCAP_LASTERR_SIZE];
 	if(inspector->m_h == NULL)
@@ -58,8 +71,7 @@ void sinsp_dumper::open(sinsp* inspector, const std::string& filename, bool comp
 	}
 	else
 	{
-		auto compress_mode = compress ? SCAP_COMPRESSION_GZIP : SCAP_COMPRESSION_NONE;
-		m_dumper = scap_dump_open(inspector->m_h->m_platform, filename.c_str(), compress_mode, threads_from_sinsp, error);
+		m_dumper = scap_dump_open(inspector->m_h->m_platform, filename.c_str(), compress, threads_from_sinsp, error);
 	}
 
 	if(m_dumper == nullptr)
@@ -80,6 +92,11 @@ void sinsp_dumper::open(sinsp* inspector, const std::string& filename, bool comp
 }
 
 void sinsp_dumper::fdopen(sinsp* inspector, int fd, bool compress, bool threads_from_sinsp)
+{
+	fdopen(inspector, fd, compress ? SCAP_COMPRESSION_GZIP : SCAP_COMPRESSION_NONE, threads_from_sinsp);
+}
+
+void sinsp_dumper::fdopen(sinsp* inspector, int fd, compression_mode compress, bool threads_from_sinsp)
 {
 	char error[SCAP_LASTERR_SIZE];
 	if(inspector->m_h == NULL)
@@ -87,8 +104,7 @@ void sinsp_dumper::fdopen(sinsp* inspector, int fd, bool compress, bool threads_
 		throw sinsp_exception("can't start event dump, inspector not opened yet");
 	}
 
-	auto compress_mode = compress ? SCAP_COMPRESSION_GZIP : SCAP_COMPRESSION_NONE;
-	m_dumper = scap_dump_open_fd(inspector->m_h->m_platform, fd, compress_mode, threads_from_sinsp, error);
+	m_dumper = scap_dump_open_fd(inspector->m_h->m_platform, fd, compress, threads_from_sinsp, error);
 
 	if(m_dumper == nullptr)
 	{
@@ -107,12 +123,36 @@ void sinsp_dumper::fdopen(sinsp* inspector, int fd, bool compress, bool threads_
 	m_nevts = 0;
 }
 
+void sinsp_dumper::enable_time_index(uint64_t interval_ns)
+{
+	if(m_dumper == NULL)
+	{
+		throw sinsp_exception("dumper not opened yet");
+	}
+
+	if(scap_dump_enable_index(m_dumper, interval_ns) != SCAP_SUCCESS)
+	{
+		throw sinsp_exception(scap_dump_getlasterr(m_dumper));
+	}
+}
+
 void sinsp_dumper::close()
 {
 	if(m_dumper != NULL)
 	{
-		scap_dump_close(m_dumper);
+		// the last data is written at close, check it before losing the error
+		bool flushed = scap_dump_flush(m_dumper) == SCAP_SUCCESS;
+		std::string error = flushed ? "" : scap_dump_getlasterr(m_dumper);
+		bool closed = scap_dump_close(m_dumper) == SCAP_SUCCESS;
 		m_dumper = NULL;
+		if(!flushed)
+		{
+			throw sinsp_exception(error);
+		}
+		if(!closed)
+		{
+			throw sinsp_exception("error writing the end of the dump file");
+		}
 	}
 }
 
@@ -192,5 +232,8 @@ void sinsp_dumper::flush()
 		throw sinsp_exception("dumper not opened yet");
 	}
 
-	scap_dump_flush(m_dumper);
+	if(scap_dump_flush(m_dumper) != SCAP_SUCCESS)
+	{
+		throw sinsp_exception(scap_dump_getlasterr(m_dumper));
+	}
 }
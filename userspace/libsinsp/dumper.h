@@ -74,13 +74,43 @@ public:
 		bool compress,
 		bool threads_from_sinsp=false);
 
+	/*!
+	  \brief Opens the dump file with the given compression mode.
+	  \param compress The compression of the trace file. Modes using block
+	   compression (SCAP_COMPRESSION_LZ4, SCAP_COMPRESSION_ZSTD) are much
+	   cheaper to write than gzip, but require a build with their support.
+	*/
+	void open(sinsp* inspector,
+		const std::string& filename,
+		compression_mode compress,
+		bool threads_from_sinsp=false);
+
 	void fdopen(sinsp* inspector,
 		int fd,
 		bool compress,
 		bool threads_from_sinsp=false);
 
+	void fdopen(sinsp* inspector,
+		int fd,
+		compression_mode compress,
+		bool threads_from_sinsp=false);
+
+	/*!
+	  \brief Writes a time index at the end of the dump file, which allows
+	   readers to quickly seek to a timestamp with sinsp::seek_ts. Must be
+	   called after opening the file, and is not supported for gzip
+	   compressed files.
+
+	  \param interval_ns The minimum time between two index entries, 0 for
+	   the default of one second.
+	*/
+	void enable_time_index(uint64_t interval_ns = 0);
+
 	/*!
 	  \brief Closes the dump file.
+
+	  \note Throws a sinsp_exception if the pending output or the time
+	  index can't be written, the file is closed anyway.
 	*/
 	void close();
 
@@ -112,7 +142,8 @@ public:
 	uint64_t next_write_position() const;
 
 	/*!
-	  \brief Flush all pending output into the file.
+	  \brief Flush all pending output into the file. Throws a
+	  sinsp_exception on failure.
 	*/
 	void flush();
 
@@ -31,6 +31,7 @@ limitations under the License.
 #include <string>
 #include <optional>
 #include <functional>
+#include <stdexcept>
 
 #include "sinsp.h"
 #include "sinsp_int.h"
@@ -140,7 +141,7 @@ uint32_t sinsp_evt::get_num_params()
 		m_flags |= (uint32_t)sinsp_evt::SINSP_EF_PARAMS_LOADED;
 	}
 
-	return (uint32_t)m_params.size();
+	return m_nparams;
 }
 
 sinsp_evt_param *sinsp_evt::get_param(uint32_t id)
@@ -151,9 +152,12 @@ sinsp_evt_param *sinsp_evt::get_param(uint32_t id)
 		m_flags |= (uint32_t)sinsp_evt::SINSP_EF_PARAMS_LOADED;
 	}
 
-	ASSERT(id < m_params.size());
+	if(id >= m_nparams)
+	{
+		throw std::out_of_range("sinsp_evt::get_param: invalid parameter " + std::to_string(id));
+	}
 
-	return &(m_params.at(id));
+	return materialize_param(id);
 }
 
 const char *sinsp_evt::get_param_name(uint32_t id)
@@ -2436,7 +2440,7 @@ const sinsp_evt_param *sinsp_evt::get_param_value_raw(const char *name)
 	{
 		if(strcmp(name, get_param_name(j)) == 0)
 		{
-			return &(m_params[j]);
+			return materialize_param(j);
 		}
 	}
 
@@ -2647,7 +2651,9 @@ bool sinsp_evt::clone_event(sinsp_evt &dest, const sinsp_evt &src)
 	// scalars
 	dest.m_cpuid = src.m_cpuid;
 	dest.m_evtnum = src.m_evtnum;
-	dest.m_flags = src.m_flags;
+	// the params of src point into its own event buffer, so the
+	// copy decodes them again from dest.m_pevt when needed
+	dest.m_flags = src.m_flags & ~(uint32_t)sinsp_evt::SINSP_EF_PARAMS_LOADED;
 	dest.m_params_loaded = src.m_params_loaded;
 
 	dest.m_iosize = src.m_iosize;
@@ -2656,7 +2662,6 @@ bool sinsp_evt::clone_event(sinsp_evt &dest, const sinsp_evt &src)
 	dest.m_filtered_out = src.m_filtered_out;
 
 	// vectors
-	dest.m_params = src.m_params;
 	dest.m_paramstr_storage = src.m_paramstr_storage;
 	dest.m_resolved_paramstr_storage = src.m_resolved_paramstr_storage;
 
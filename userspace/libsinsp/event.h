@@ -184,6 +184,14 @@ public:
 		return m_evtnum;
 	}
 
+	/*!
+	  \brief Get the raw event data.
+	*/
+	inline const scap_evt* get_scap_evt() const
+	{
+		return m_pevt;
+	}
+
 	/*!
 	  \brief Get the number of the CPU where this event was captured.
 	*/
@@ -479,83 +487,91 @@ private:
 		m_info = ppm_event;
 		m_errorcode = errorcode;
 	}
+	//
+	// Decodes the length table of the event, without touching the
+	// parameters themselves. Each parameter is materialized on its first
+	// access through get_param().
+	//
 	inline void load_params()
 	{
-		uint32_t j;
-		sinsp_evt_param par;
-		struct scap_sized_buffer params[PPM_MAX_EVENT_PARAMS];
+		m_nparams = scap_event_decode_params(m_pevt, m_raw_params);
+		m_materialized_params = 0;
+	}
 
-		m_params.clear();
+	inline sinsp_evt_param* materialize_param(uint32_t id)
+	{
+		sinsp_evt_param* par = &m_params[id];
+		if(m_materialized_params & (1u << id))
+		{
+			return par;
+		}
 
-		uint32_t nparams = scap_event_decode_params(m_pevt, params);
+		char* buf = (char*)m_raw_params[id].buf;
+		uint32_t size = (uint32_t)m_raw_params[id].size;
+
+		/* Here we need to manage a particular case:
+		* 
+		*    - PT_CHARBUF
+		*    - PT_FSRELPATH
+		*    - PT_BYTEBUF
+		*    - PT_BYTEBUF
+		* 
+		* In the past these params could be `<NA>` or `(NULL)` or empty.
+		* Now they can be only empty! The ideal solution would be:
+		* 	params[i].buf = NULL;
+		*	params[i].size = 0;
+		* 
+		* The problem is that userspace is not
+		* able to manage `NULL` pointers... but it manages `<NA>` so we
+		* convert all these cases to `<NA>` when they are empty!
+		* 
+		* If we read scap-files we could face `(NULL)` params, so also in
+		* this case we convert them to `<NA>`.
+		* 
+		* To be honest there could be another corner case, but right now
+		* we don't have to manage it:
+		*    
+		*    - PT_SOCKADDR
+		*    - PT_SOCKTUPLE
+		*    - PT_FDLIST
+		* 
+		* Could be empty, so we will have:
+		* 	params[i].buf = "pointer to the next param";
+		*	params[i].size = 0;
+		* 
+		* However, as we said in the previous case, the ideal outcome would be:
+		* 	params[i].buf = NULL;
+		*	params[i].size = 0;
+		* 
+		* The difference with the previous case is that the userspace can manage
+		* these params when they have `params[i].size == 0`, so we don't have
+		* to use the `<NA>` workaround! We could also introduce the `NULL` and so
+		* put in place the ideal solution for this parameter, but before doing this
+		* we need to be sure that the userspace never tries to deference the pointer
+		* otherwise it will trigger a segmentation fault at run-time. So as a first
+		* step we would keep them as they are.
+		*/
 
 		/* We need the event info to overwrite some parameters if necessary. */
-		const struct ppm_event_info* event_info = &m_event_info_table[m_pevt->type];
-		int param_type = 0;
-		
-		for(j = 0; j < nparams; j++)
+		int param_type = m_event_info_table[m_pevt->type].params[id].type;
+
+		if((param_type == PT_CHARBUF ||
+			param_type == PT_FSRELPATH ||
+			param_type == PT_FSPATH)
+			&&
+			(size == 0 ||
+			(size == 7 && strncmp(buf, "(NULL)", 7) == 0)))
 		{
-			/* Here we need to manage a particular case:
-			* 
-			*    - PT_CHARBUF
-			*    - PT_FSRELPATH
-			*    - PT_BYTEBUF
-			*    - PT_BYTEBUF
-			* 
-			* In the past these params could be `<NA>` or `(NULL)` or empty.
-			* Now they can be only empty! The ideal solution would be:
-			* 	params[i].buf = NULL;
-			*	params[i].size = 0;
-			* 
-			* The problem is that userspace is not
-			* able to manage `NULL` pointers... but it manages `<NA>` so we
-			* convert all these cases to `<NA>` when they are empty!
-			* 
-			* If we read scap-files we could face `(NULL)` params, so also in
-			* this case we convert them to `<NA>`.
-			* 
-			* To be honest there could be another corner case, but right now
-			* we don't have to manage it:
-			*    
-			*    - PT_SOCKADDR
-			*    - PT_SOCKTUPLE
-			*    - PT_FDLIST
-			* 
-			* Could be empty, so we will have:
-			* 	params[i].buf = "pointer to the next param";
-			*	params[i].size = 0;
-			* 
-			* However, as we said in the previous case, the ideal outcome would be:
-			* 	params[i].buf = NULL;
-			*	params[i].size = 0;
-			* 
-			* The difference with the previous case is that the userspace can manage
-			* these params when they have `params[i].size == 0`, so we don't have
-			* to use the `<NA>` workaround! We could also introduce the `NULL` and so
-			* put in place the ideal solution for this parameter, but before doing this
-			* we need to be sure that the userspace never tries to deference the pointer
-			* otherwise it will trigger a segmentation fault at run-time. So as a first
-			* step we would keep them as they are.
+			/* Overwrite the value and the size of the param.
+			* 5 = strlen("<NA>") + `\0`.
 			*/
-			param_type = event_info->params[j].type;
-			
-			if((param_type == PT_CHARBUF ||
-				param_type == PT_FSRELPATH ||
-				param_type == PT_FSPATH)
-				&&
-				(params[j].size == 0 ||
-				(params[j].size == 7 && strncmp((char*)params[j].buf, "(NULL)", 7) == 0)))
-			{
-				/* Overwrite the value and the size of the param.
-				* 5 = strlen("<NA>") + `\0`.
-				*/
-				params[j].buf = (void*)"<NA>";
-				params[j].size = 5;
-			}
-
-			par.init((char*)params[j].buf, (int)params[j].size);
-			m_params.push_back(par);
+			buf = (char*)"<NA>";
+			size = 5;
 		}
+
+		par->init(buf, size);
+		m_materialized_params |= (1u << id);
+		return par;
 	}
 	std::string get_param_value_str(uint32_t id, bool resolved);
 	std::string get_param_value_str(const char* name, bool resolved = true);
@@ -587,7 +603,15 @@ VISIBILITY_PRIVATE
 	uint32_t m_flags;
 	bool m_params_loaded;
 	const struct ppm_event_info* m_info;
-	std::vector<sinsp_evt_param> m_params;
+
+	// Parameters of the current event, valid when SINSP_EF_PARAMS_LOADED
+	// is set. m_raw_params holds the decoded length table, m_params the
+	// parameters returned so far, as tracked by m_materialized_params.
+	uint32_t m_nparams;
+	uint32_t m_materialized_params;
+	struct scap_sized_buffer m_raw_params[PPM_MAX_EVENT_PARAMS];
+	sinsp_evt_param m_params[PPM_MAX_EVENT_PARAMS];
+	static_assert(PPM_MAX_EVENT_PARAMS <= 32, "m_materialized_params is a 32 bit mask");
 
 	std::vector<char> m_paramstr_storage;
 	std::vector<char> m_resolved_paramstr_storage;
@@ -20,6 +20,7 @@ limitations under the License.
 #include "filter.h"
 #include "filterchecks.h"
 #include "eventformatter.h"
+#include "json_writer.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 // rawstring_check implementation
@@ -95,6 +96,8 @@ void sinsp_evt_formatter::set_format(gen_event_formatter::output_format of, cons
 	const char* cfmt = lfmt.c_str();
 
 	m_tokens.clear();
+	m_program.clear();
+	m_literals.clear();
 	uint32_t lfmtlen = (uint32_t)lfmt.length();
 
 	for(j = 0; j < lfmtlen; j++)
@@ -105,10 +108,7 @@ void sinsp_evt_formatter::set_format(gen_event_formatter::output_format of, cons
 
 			if(last_nontoken_str_start != j)
 			{
-				rawstring_check* newtkn = new rawstring_check(lfmt.substr(last_nontoken_str_start, j - last_nontoken_str_start));
-				m_tokens.emplace_back(std::make_pair("", newtkn));
-				m_tokenlens.push_back(0);
-				m_chks_to_free.push_back(newtkn);
+				add_literal(cfmt + last_nontoken_str_start, j - last_nontoken_str_start);
 			}
 
 			if(j == lfmtlen - 1)
@@ -165,7 +165,13 @@ void sinsp_evt_formatter::set_format(gen_event_formatter::output_format of, cons
 			ASSERT(j <= lfmt.length());
 
 			m_tokens.emplace_back(std::make_pair(std::string(fstart, fsize), chk));
-			m_tokenlens.push_back(toklen);
+
+			format_op op;
+			op.m_code = toklen != 0 ? format_op::PADDED_FIELD : format_op::FIELD;
+			op.m_check = chk;
+			op.m_offset = 0;
+			op.m_len = (uint32_t)toklen;
+			m_program.push_back(op);
 
 			last_nontoken_str_start = j + 1;
 		}
@@ -173,11 +179,43 @@ void sinsp_evt_formatter::set_format(gen_event_formatter::output_format of, cons
 
 	if(last_nontoken_str_start != j)
 	{
-		sinsp_filter_check * chk = new rawstring_check(lfmt.substr(last_nontoken_str_start, j - last_nontoken_str_start));
-		m_tokens.emplace_back(std::make_pair("", chk));
-		m_chks_to_free.push_back(chk);
-		m_tokenlens.push_back(0);
+		add_literal(cfmt + last_nontoken_str_start, j - last_nontoken_str_start);
+	}
+
+	//
+	// A later token with the same name overrides the previous ones, as
+	// when assigning the members of a Json::Value
+	//
+	std::map<std::string, sinsp_filter_check*> json_fields;
+	for(j = 0; j < m_tokens.size(); j++)
+	{
+		if(m_tokens[j].second->get_field_info())
+		{
+			json_fields[m_tokens[j].first] = m_tokens[j].second;
+		}
 	}
+
+	m_json_fields.clear();
+	for(const auto& f : json_fields)
+	{
+		json_field field;
+		field.m_prefix = m_json_fields.empty() ? "{" : ",";
+		libsinsp::json_writer::append_string(field.m_prefix, f.first.c_str(), f.first.size());
+		field.m_prefix += ':';
+		field.m_check = f.second;
+		m_json_fields.push_back(std::move(field));
+	}
+}
+
+void sinsp_evt_formatter::add_literal(const char* text, size_t len)
+{
+	format_op op;
+	op.m_code = format_op::LITERAL;
+	op.m_check = NULL;
+	op.m_offset = (uint32_t)m_literals.size();
+	op.m_len = (uint32_t)len;
+	m_program.push_back(op);
+	m_literals.append(text, len);
 }
 
 bool sinsp_evt_formatter::on_capture_end(OUT std::string* res)
@@ -192,8 +230,6 @@ bool sinsp_evt_formatter::resolve_tokens(sinsp_evt *evt, std::map<std::string,st
 	const filtercheck_field_info* fi;
 	uint32_t j = 0;
 
-	ASSERT(m_tokenlens.size() == m_tokens.size());
-
 	for(j = 0; j < m_tokens.size(); j++)
 	{
 		char* str = m_tokens[j].second->tostring(evt);
@@ -248,82 +284,82 @@ gen_event_formatter::output_format sinsp_evt_formatter::get_output_format()
 
 bool sinsp_evt_formatter::tostring_withformat(gen_event* gevt, std::string &output, gen_event_formatter::output_format of)
 {
-	bool retval = true;
-	const filtercheck_field_info* fi;
-
 	sinsp_evt *evt = static_cast<sinsp_evt *>(gevt);
 
-	uint32_t j = 0;
 	output.clear();
 
-	ASSERT(m_tokenlens.size() == m_tokens.size());
+	if(of == OF_JSON)
+	{
+		return tostring_json(evt, output);
+	}
 
-	for(j = 0; j < m_tokens.size(); j++)
+	return tostring_text(evt, output);
+}
+
+bool sinsp_evt_formatter::tostring_text(sinsp_evt* evt, std::string &output)
+{
+	for(const auto& op : m_program)
 	{
-		if(of == OF_JSON)
+		if(op.m_code == format_op::LITERAL)
 		{
-			Json::Value json_value = m_tokens[j].second->tojson(evt);
+			output.append(m_literals, op.m_offset, op.m_len);
+			continue;
+		}
 
-			if(retval == false)
-			{
-				continue;
-			}
+		const char* str = op.m_check->tostring(evt);
 
-			if(json_value == Json::nullValue && m_require_all_values)
+		if(str == NULL)
+		{
+			if(m_require_all_values)
 			{
-				retval = false;
-				continue;
+				return false;
 			}
+			str = "<NA>";
+		}
 
-			fi = m_tokens[j].second->get_field_info();
-
-			if(fi)
-			{
-				m_root[m_tokens[j].first] = m_tokens[j].second->tojson(evt);
-			}
+		if(op.m_code == format_op::PADDED_FIELD)
+		{
+			// truncate or pad the value to the requested width
+			size_t len = strnlen(str, op.m_len);
+			output.append(str, len);
+			output.append(op.m_len - len, ' ');
 		}
 		else
 		{
-			char* str = m_tokens[j].second->tostring(evt);
+			output += str;
+		}
+	}
 
-			if(retval == false)
-			{
-				continue;
-			}
+	return true;
+}
 
-			if(str == NULL)
-			{
-				if(m_require_all_values)
-				{
-					retval = false;
-					continue;
-				}
-				else
-				{
-					str = (char*)"<NA>";
-				}
-			}
+bool sinsp_evt_formatter::tostring_json(sinsp_evt* evt, std::string &output)
+{
+	bool retval = true;
 
-			uint32_t tks = m_tokenlens[j];
+	//
+	// The values are written straight into the output, in the same
+	// format Json::FastWriter would use for an object holding them
+	//
+	if(m_json_fields.empty())
+	{
+		libsinsp::json_writer::append_null(output);
+		return retval;
+	}
 
-			if(tks != 0)
-			{
-				std::string sstr(str);
-				sstr.resize(tks, ' ');
-				output += sstr;
-			}
-			else
+	for(const auto& f : m_json_fields)
+	{
+		output += f.m_prefix;
+		if(!f.m_check->tojson(evt, output))
+		{
+			libsinsp::json_writer::append_null(output);
+			if(m_require_all_values)
 			{
-				output += str;
+				retval = false;
 			}
 		}
 	}
-
-	if(of == OF_JSON)
-	{
-		output = m_writer.write(m_root);
-		output = output.substr(0, output.size() - 1);
-	}
+	output += '}';
 
 	return retval;
 }
@@ -349,13 +385,11 @@ sinsp_evt_formatter_cache::~sinsp_evt_formatter_cache()
 
 std::shared_ptr<sinsp_evt_formatter>& sinsp_evt_formatter_cache::get_cached_formatter(std::string &format)
 {
-	auto it = m_formatter_cache.lower_bound(format);
+	auto it = m_formatter_cache.find(format);
 
-	if(it == m_formatter_cache.end() ||
-	   it->first != format)
+	if(it == m_formatter_cache.end())
 	{
-		it = m_formatter_cache.emplace_hint(it,
-						    std::make_pair(format, std::make_shared<sinsp_evt_formatter>(m_inspector, format)));
+		it = m_formatter_cache.emplace(format, std::make_shared<sinsp_evt_formatter>(m_inspector, format)).first;
 	}
 
 	return it->second;
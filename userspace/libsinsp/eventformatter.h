@@ -17,8 +17,10 @@ limitations under the License.
 
 #pragma once
 #include <map>
+#include <unordered_map>
 #include <utility>
 #include <string>
+#include <vector>
 #include <json/json.h>
 
 #include "filter_check_list.h"
@@ -101,19 +103,48 @@ public:
 	bool on_capture_end(OUT std::string* res);
 
 private:
+	void add_literal(const char* text, size_t len);
+	bool tostring_text(sinsp_evt* evt, std::string &output);
+	bool tostring_json(sinsp_evt* evt, std::string &output);
+
 	gen_event_formatter::output_format m_output_format;
 
-	// vector of (full string of the token, filtercheck) pairs
+	// vector of (full string of the field, filtercheck) pairs
 	// e.g. ("proc.aname[2], ptr to sinsp_filter_check_thread)
 	std::vector<std::pair<std::string, sinsp_filter_check*>> m_tokens;
-	std::vector<uint32_t> m_tokenlens;
+
+	// The text output, compiled once into a flat list of instructions
+	// that render the literal text and the fields in order
+	struct format_op
+	{
+		enum code
+		{
+			LITERAL, ///< m_len bytes of m_literals starting at m_offset
+			FIELD, ///< the value of m_check
+			PADDED_FIELD, ///< the value of m_check, truncated or padded to m_len
+		};
+
+		code m_code;
+		sinsp_filter_check* m_check;
+		uint32_t m_offset;
+		uint32_t m_len;
+	};
+	std::vector<format_op> m_program;
+	std::string m_literals;
 	sinsp* m_inspector;
 	filter_check_list &m_available_checks;
 	bool m_require_all_values;
 	std::vector<sinsp_filter_check*> m_chks_to_free;
 
-	Json::Value m_root;
-	Json::FastWriter m_writer;
+	// The fields of the JSON output, sorted by name as jsoncpp does with
+	// the members of an object. The prefix holds what precedes the value,
+	// e.g. ,"proc.name":
+	struct json_field
+	{
+		std::string m_prefix;
+		sinsp_filter_check* m_check;
+	};
+	std::vector<json_field> m_json_fields;
 };
 
 /*!
@@ -143,7 +174,7 @@ private:
 	// sinsp_evt_formatter object if necessary.
 	std::shared_ptr<sinsp_evt_formatter>& get_cached_formatter(std::string &format);
 
-	std::map<std::string,std::shared_ptr<sinsp_evt_formatter>> m_formatter_cache;
+	std::unordered_map<std::string,std::shared_ptr<sinsp_evt_formatter>> m_formatter_cache;
 	sinsp *m_inspector;
 };
 /*@}*/
@@ -161,7 +192,7 @@ public:
 protected:
 
 	// Maps from output string to formatter
-	std::map<std::string, std::shared_ptr<gen_event_formatter>> m_formatters;
+	std::unordered_map<std::string, std::shared_ptr<gen_event_formatter>> m_formatters;
 
 	sinsp *m_inspector;
 	filter_check_list &m_available_checks;
@@ -0,0 +1,305 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "evt_buffer_arena.h"
+#include "sinsp_int.h"
+
+using namespace libsinsp;
+
+struct evt_buffer_arena::slab
+{
+	evt_buffer_arena* m_arena; // NULL once the arena is gone
+	slab* m_prev;
+	slab* m_next;
+	uint8_t* m_free; // free chunks, each one stores the pointer to the next
+	uint32_t m_class;
+	uint32_t m_chunk_size;
+	uint32_t m_capacity;
+	uint32_t m_used;
+	uint32_t m_untouched; // chunks at the end of the slab never reserved yet
+};
+
+// Chunks start after the slab header, aligned to a cache line
+static constexpr size_t s_slab_header_size = (sizeof(void*) * 4 + sizeof(uint32_t) * 5 + 63) & ~(size_t)63;
+
+static void* slab_alloc()
+{
+#ifdef _WIN32
+	return _aligned_malloc(evt_buffer_arena::SLAB_SIZE, evt_buffer_arena::SLAB_SIZE);
+#else
+	void* ptr = NULL;
+	if(posix_memalign(&ptr, evt_buffer_arena::SLAB_SIZE, evt_buffer_arena::SLAB_SIZE) != 0)
+	{
+		return NULL;
+	}
+	return ptr;
+#endif
+}
+
+static void slab_free(void* ptr)
+{
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+evt_buffer_arena::evt_buffer_arena()
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+	for(size_t cls = 0; cls < NUM_CLASSES; cls++)
+	{
+		m_head[cls] = NULL;
+		m_tail[cls] = NULL;
+		m_empty_slabs[cls] = 0;
+		m_stats.m_class_chunk_size[cls] = MIN_CHUNK_SIZE << cls;
+	}
+}
+
+evt_buffer_arena::~evt_buffer_arena()
+{
+	for(size_t cls = 0; cls < NUM_CLASSES; cls++)
+	{
+		slab* s = m_head[cls];
+		while(s != NULL)
+		{
+			slab* next = s->m_next;
+			if(s->m_used == 0)
+			{
+				slab_free(s);
+			}
+			else
+			{
+				s->m_arena = NULL;
+			}
+			s = next;
+		}
+	}
+}
+
+size_t evt_buffer_arena::size_class(size_t size)
+{
+	size_t cls = 0;
+	while((MIN_CHUNK_SIZE << cls) < size)
+	{
+		cls++;
+	}
+	return cls;
+}
+
+evt_buffer_arena::slab* evt_buffer_arena::slab_of(const uint8_t* ptr)
+{
+	return (slab*)((uintptr_t)ptr & ~(uintptr_t)(SLAB_SIZE - 1));
+}
+
+size_t evt_buffer_arena::capacity(const uint8_t* ptr)
+{
+	return slab_of(ptr)->m_chunk_size;
+}
+
+evt_buffer_arena::slab* evt_buffer_arena::new_slab(size_t cls)
+{
+	static_assert(sizeof(slab) <= s_slab_header_size, "slab header doesn't fit");
+
+	slab* s = (slab*)slab_alloc();
+	if(s == NULL)
+	{
+		return NULL;
+	}
+
+	s->m_arena = this;
+	s->m_free = NULL;
+	s->m_class = (uint32_t)cls;
+	s->m_chunk_size = (uint32_t)(MIN_CHUNK_SIZE << cls);
+	s->m_capacity = (uint32_t)((SLAB_SIZE - s_slab_header_size) / s->m_chunk_size);
+	s->m_used = 0;
+	s->m_untouched = s->m_capacity;
+
+	// the new slab only has free chunks, so it goes first
+	s->m_prev = NULL;
+	s->m_next = m_head[cls];
+	if(m_head[cls] != NULL)
+	{
+		m_head[cls]->m_prev = s;
+	}
+	else
+	{
+		m_tail[cls] = s;
+	}
+	m_head[cls] = s;
+
+	m_empty_slabs[cls]++;
+	m_stats.m_slabs++;
+	m_stats.m_reserved_bytes += SLAB_SIZE;
+	m_stats.m_class_slabs[cls]++;
+	return s;
+}
+
+void evt_buffer_arena::free_slab(slab* s)
+{
+	size_t cls = s->m_class;
+	if(s->m_prev != NULL)
+	{
+		s->m_prev->m_next = s->m_next;
+	}
+	else
+	{
+		m_head[cls] = s->m_next;
+	}
+	if(s->m_next != NULL)
+	{
+		s->m_next->m_prev = s->m_prev;
+	}
+	else
+	{
+		m_tail[cls] = s->m_prev;
+	}
+
+	m_stats.m_slabs--;
+	m_stats.m_reserved_bytes -= SLAB_SIZE;
+	m_stats.m_class_slabs[cls]--;
+	slab_free(s);
+}
+
+uint8_t* evt_buffer_arena::reserve(size_t size)
+{
+	if(size > SP_EVT_BUF_SIZE)
+	{
+		return NULL;
+	}
+
+	size_t cls = size_class(size);
+	slab* s = m_head[cls];
+	if(s == NULL || s->m_used == s->m_capacity)
+	{
+		s = new_slab(cls);
+		if(s == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	uint8_t* ptr;
+	if(s->m_free != NULL)
+	{
+		ptr = s->m_free;
+		memcpy(&s->m_free, ptr, sizeof(uint8_t*));
+	}
+	else
+	{
+		ASSERT(s->m_untouched > 0);
+		ptr = (uint8_t*)s + s_slab_header_size + (size_t)(s->m_capacity - s->m_untouched) * s->m_chunk_size;
+		s->m_untouched--;
+	}
+
+	if(s->m_used++ == 0)
+	{
+		m_empty_slabs[cls]--;
+	}
+
+	// full slabs go last, so that the first one always has free chunks if any does
+	if(s->m_used == s->m_capacity && s != m_tail[cls])
+	{
+		m_head[cls] = s->m_next;
+		m_head[cls]->m_prev = NULL;
+		s->m_next = NULL;
+		s->m_prev = m_tail[cls];
+		m_tail[cls]->m_next = s;
+		m_tail[cls] = s;
+	}
+
+	m_stats.m_used_chunks++;
+	m_stats.m_used_bytes += s->m_chunk_size;
+	m_stats.m_class_used_chunks[cls]++;
+	return ptr;
+}
+
+void evt_buffer_arena::release(uint8_t* ptr)
+{
+	if(ptr == NULL)
+	{
+		return;
+	}
+
+	slab* s = slab_of(ptr);
+	if(s->m_arena != NULL)
+	{
+		s->m_arena->release_to(s, ptr);
+		return;
+	}
+
+	// the arena is gone, the slab only waits for its chunks to be released
+	if(--s->m_used == 0)
+	{
+		slab_free(s);
+	}
+}
+
+void evt_buffer_arena::release_to(slab* s, uint8_t* ptr)
+{
+	size_t cls = s->m_class;
+	bool was_full = s->m_used == s->m_capacity;
+
+	memcpy(ptr, &s->m_free, sizeof(uint8_t*));
+	s->m_free = ptr;
+	s->m_used--;
+
+	m_stats.m_used_chunks--;
+	m_stats.m_used_bytes -= s->m_chunk_size;
+	m_stats.m_class_used_chunks[cls]--;
+
+	if(s->m_used == 0)
+	{
+		// keep a single empty slab per class to absorb bursts
+		if(m_empty_slabs[cls] > 0)
+		{
+			free_slab(s);
+			return;
+		}
+		m_empty_slabs[cls]++;
+	}
+
+	// the slab has free chunks again, so it goes first
+	if(was_full && s != m_head[cls])
+	{
+		s->m_prev->m_next = s->m_next;
+		if(s->m_next != NULL)
+		{
+			s->m_next->m_prev = s->m_prev;
+		}
+		else
+		{
+			m_tail[cls] = s->m_prev;
+		}
+		s->m_prev = NULL;
+		s->m_next = m_head[cls];
+		m_head[cls]->m_prev = s;
+		m_head[cls] = s;
+	}
+}
+
+evt_buffer_arena::stats evt_buffer_arena::get_stats() const
+{
+	return m_stats;
+}
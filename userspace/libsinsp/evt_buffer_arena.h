@@ -0,0 +1,102 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "settings.h"
+
+namespace libsinsp
+{
+
+//
+// Size-classed slab allocator for the enter events that the parser stores
+// in the threads until their exit event arrives. Chunks are powers of two
+// between MIN_CHUNK_SIZE and SP_EVT_BUF_SIZE, carved out of SLAB_SIZE
+// slabs that are aligned to their own size, so that the slab of a chunk
+// can be found from its address alone.
+//
+// For this reason release() doesn't need the arena: threads can outlive
+// the parser that stored their event. The slabs that still have chunks in
+// use when the arena is destroyed are freed by the release() of their last
+// chunk. The arena is not thread safe.
+//
+class evt_buffer_arena
+{
+public:
+	static constexpr size_t SLAB_SIZE = 64 * 1024;
+	static constexpr size_t MIN_CHUNK_SIZE = 128;
+	static constexpr size_t NUM_CLASSES = 6;
+	static_assert((MIN_CHUNK_SIZE << (NUM_CLASSES - 1)) == SP_EVT_BUF_SIZE,
+		"the largest chunk must fit SP_EVT_BUF_SIZE");
+
+	//
+	// Occupancy of the arena, overall and for each chunk size
+	//
+	struct stats
+	{
+		uint64_t m_slabs;
+		uint64_t m_reserved_bytes; ///< memory taken by the slabs
+		uint64_t m_used_bytes; ///< memory taken by the chunks in use
+		uint64_t m_used_chunks;
+		uint64_t m_class_chunk_size[NUM_CLASSES];
+		uint64_t m_class_slabs[NUM_CLASSES];
+		uint64_t m_class_used_chunks[NUM_CLASSES];
+	};
+
+	evt_buffer_arena();
+	~evt_buffer_arena();
+	evt_buffer_arena(const evt_buffer_arena&) = delete;
+	evt_buffer_arena& operator=(const evt_buffer_arena&) = delete;
+
+	//
+	// Return a chunk of at least size bytes, or NULL if size is larger
+	// than SP_EVT_BUF_SIZE or if memory is exhausted
+	//
+	uint8_t* reserve(size_t size);
+
+	//
+	// Give a chunk back to the slab it comes from
+	//
+	static void release(uint8_t* ptr);
+
+	//
+	// Return the usable size of a chunk
+	//
+	static size_t capacity(const uint8_t* ptr);
+
+	stats get_stats() const;
+
+private:
+	struct slab;
+
+	static size_t size_class(size_t size);
+	static slab* slab_of(const uint8_t* ptr);
+	slab* new_slab(size_t cls);
+	void free_slab(slab* s);
+	void release_to(slab* s, uint8_t* ptr);
+
+	// Slabs of each class, the ones with free chunks first
+	slab* m_head[NUM_CLASSES];
+	slab* m_tail[NUM_CLASSES];
+	uint32_t m_empty_slabs[NUM_CLASSES];
+	stats m_stats;
+};
+
+}
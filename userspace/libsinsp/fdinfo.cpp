@@ -341,24 +341,64 @@ template<> void sinsp_fdinfo_t::unregister_event_callback(sinsp_pd_callback_type
 sinsp_fdtable::sinsp_fdtable(sinsp* inspector)
 {
 	m_inspector = inspector;
+	m_tid = 0;
+	m_direct_count = 0;
 	reset_cache();
 }
 
+sinsp_fdtable::sinsp_fdtable(const sinsp_fdtable& other):
+	m_inspector(other.m_inspector),
+	m_tid(other.m_tid),
+	m_direct_count(0)
+{
+	reset_cache();
+	*this = other;
+}
+
+sinsp_fdtable& sinsp_fdtable::operator=(const sinsp_fdtable& other)
+{
+	if(this == &other)
+	{
+		return *this;
+	}
+
+	m_inspector = other.m_inspector;
+	m_tid = other.m_tid;
+
+	//
+	// The fdinfos are owned by the table, so they are copied one by one.
+	// The cache must not point to the other table.
+	//
+	m_direct.clear();
+	m_direct.resize(other.m_direct.size());
+	for(size_t fd = 0; fd < other.m_direct.size(); fd++)
+	{
+		if(other.m_direct[fd])
+		{
+			m_direct[fd] = std::make_unique<sinsp_fdinfo_t>(*other.m_direct[fd]);
+		}
+	}
+	m_direct_count = other.m_direct_count;
+	m_sparse = other.m_sparse;
+	reset_cache();
+	return *this;
+}
+
 sinsp_fdinfo_t* sinsp_fdtable::add(int64_t fd, sinsp_fdinfo_t* fdinfo)
 {
 	//
 	// Look for the FD in the table
 	//
-	auto it = m_table.find(fd);
+	sinsp_fdinfo_t* existing = get(fd);
 
 	// Three possible exits here:
 	// 1. fd is not on the table
 	//   a. the table size is under the limit so create a new entry
 	//   b. table size is over the limit, discard the fd
 	// 2. fd is already in the table, replace it
-	if(it == m_table.end())
+	if(existing == NULL)
 	{
-		if(m_table.size() < m_inspector->m_max_fdtable_size)
+		if(size() < m_inspector->m_max_fdtable_size)
 		{
 			//
 			// No entry in the table, this is the normal case
@@ -367,8 +407,18 @@ sinsp_fdinfo_t* sinsp_fdtable::add(int64_t fd, sinsp_fdinfo_t* fdinfo)
 #ifdef GATHER_INTERNAL_STATS
 			m_inspector->m_stats->m_n_added_fds++;
 #endif
-			std::pair<std::unordered_map<int64_t, sinsp_fdinfo_t>::iterator, bool> insert_res = m_table.emplace(fd, *fdinfo);
-			return &(insert_res.first->second);
+			if((uint64_t)fd < (uint64_t)DIRECT_FD_LIMIT)
+			{
+				if((uint64_t)fd >= m_direct.size())
+				{
+					m_direct.resize(fd + 1);
+				}
+				m_direct[fd] = std::make_unique<sinsp_fdinfo_t>(*fdinfo);
+				m_direct_count++;
+				return m_direct[fd].get();
+			}
+
+			return &(m_sparse.emplace(fd, *fdinfo).first->second);
 		}
 		else
 		{
@@ -380,7 +430,7 @@ sinsp_fdinfo_t* sinsp_fdtable::add(int64_t fd, sinsp_fdinfo_t* fdinfo)
 		//
 		// the fd is already in the table.
 		//
-		if(it->second.m_flags & sinsp_fdinfo_t::FLAGS_CLOSE_IN_PROGRESS)
+		if(existing->m_flags & sinsp_fdinfo_t::FLAGS_CLOSE_IN_PROGRESS)
 		{
 			//
 			// Sometimes an FD-creating syscall can be called on an FD that is being closed (i.e
@@ -391,7 +441,7 @@ sinsp_fdinfo_t* sinsp_fdtable::add(int64_t fd, sinsp_fdinfo_t* fdinfo)
 			fdinfo->m_flags &= ~sinsp_fdinfo_t::FLAGS_CLOSE_IN_PROGRESS;
 			fdinfo->m_flags |= sinsp_fdinfo_t::FLAGS_CLOSE_CANCELED;
 
-			m_table[CANCELED_FD_NUMBER] = it->second;
+			m_sparse[CANCELED_FD_NUMBER] = *existing;
 		}
 		else
 		{
@@ -411,21 +461,47 @@ sinsp_fdinfo_t* sinsp_fdtable::add(int64_t fd, sinsp_fdinfo_t* fdinfo)
 		//
 		// Replace the fd as a struct copy
 		//
-		it->second.copy(*fdinfo, true);
-		return &(it->second);
+		existing->copy(*fdinfo, true);
+		return existing;
 	}
 }
 
 void sinsp_fdtable::erase(int64_t fd)
 {
-	std::unordered_map<int64_t, sinsp_fdinfo_t>::iterator fdit = m_table.find(fd);
-
 	if(fd == m_last_accessed_fd)
 	{
 		m_last_accessed_fd = -1;
 	}
 
-	if(fdit == m_table.end())
+	bool found = false;
+	if((uint64_t)fd < (uint64_t)DIRECT_FD_LIMIT)
+	{
+		if((uint64_t)fd < m_direct.size() && m_direct[fd])
+		{
+			found = true;
+			m_direct[fd].reset();
+			m_direct_count--;
+
+			//
+			// Give back the memory of the unused tail, so that a process
+			// that briefly used a high fd doesn't keep a large vector
+			//
+			while(!m_direct.empty() && !m_direct.back())
+			{
+				m_direct.pop_back();
+			}
+			if(m_direct.size() < m_direct.capacity() / 4)
+			{
+				m_direct.shrink_to_fit();
+			}
+		}
+	}
+	else
+	{
+		found = (m_sparse.erase(fd) != 0);
+	}
+
+	if(!found)
 	{
 		//
 		// Looks like there's no fd to remove.
@@ -440,7 +516,6 @@ void sinsp_fdtable::erase(int64_t fd)
 	}
 	else
 	{
-		m_table.erase(fdit);
 #ifdef GATHER_INTERNAL_STATS
 		m_inspector->m_stats->m_n_noncached_fd_lookups++;
 		m_inspector->m_stats->m_n_removed_fds++;
@@ -450,12 +525,15 @@ void sinsp_fdtable::erase(int64_t fd)
 
 void sinsp_fdtable::clear()
 {
-	m_table.clear();
+	std::vector<std::unique_ptr<sinsp_fdinfo_t>>().swap(m_direct);
+	m_direct_count = 0;
+	m_sparse.clear();
+	reset_cache();
 }
 
 size_t sinsp_fdtable::size()
 {
-	return m_table.size();
+	return m_direct_count + m_sparse.size();
 }
 
 void sinsp_fdtable::reset_cache()
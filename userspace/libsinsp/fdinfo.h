@@ -17,6 +17,8 @@ limitations under the License.
 
 #pragma once
 #include "sinsp_pd_callback_type.h"
+#include <functional>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -526,15 +528,27 @@ public:
 ///////////////////////////////////////////////////////////////////////////////
 // fd info table
 ///////////////////////////////////////////////////////////////////////////////
+//
+// Processes mostly use small and dense fd numbers, so the fds below
+// DIRECT_FD_LIMIT are stored in a vector indexed by fd number, which can
+// be looked up without hashing. The remaining fds, including the negative
+// ones and CANCELED_FD_NUMBER, are stored in a hash table.
+// The fdinfo pointers returned by the table stay valid until the fd is
+// erased, regardless of the other insertions.
+//
 class sinsp_fdtable
 {
 public:
+	static constexpr int64_t DIRECT_FD_LIMIT = 4096;
+
 	sinsp_fdtable(sinsp* inspector);
+	sinsp_fdtable(const sinsp_fdtable& other);
+	sinsp_fdtable(sinsp_fdtable&& other) = default;
+	sinsp_fdtable& operator=(const sinsp_fdtable& other);
+	sinsp_fdtable& operator=(sinsp_fdtable&& other) = default;
 
 	inline sinsp_fdinfo_t* find(int64_t fd)
 	{
-		std::unordered_map<int64_t, sinsp_fdinfo_t>::iterator fdit;
-
 		//
 		// Try looking up in our simple cache
 		//
@@ -549,9 +563,9 @@ public:
 		//
 		// Caching failed, do a real lookup
 		//
-		fdit = m_table.find(fd);
+		sinsp_fdinfo_t* fdinfo = get(fd);
 
-		if(fdit == m_table.end())
+		if(fdinfo == NULL)
 		{
 	#ifdef GATHER_INTERNAL_STATS
 			m_inspector->m_stats->m_n_failed_fd_lookups++;
@@ -564,9 +578,9 @@ public:
 			m_inspector->m_stats->m_n_noncached_fd_lookups++;
 	#endif
 			m_last_accessed_fd = fd;
-			m_last_accessed_fdinfo = &(fdit->second);
-			lookup_device(&(fdit->second), fd);
-			return &(fdit->second);
+			m_last_accessed_fdinfo = fdinfo;
+			lookup_device(fdinfo, fd);
+			return fdinfo;
 		}
 	}
 	
@@ -574,10 +588,40 @@ public:
 	sinsp_fdinfo_t* add(int64_t fd, sinsp_fdinfo_t* fdinfo);
 
 	typedef std::function<bool(int64_t, const sinsp_fdinfo_t&)> fdtable_visitor_t;
+	typedef std::function<bool(int64_t, sinsp_fdinfo_t&)> fdtable_mutable_visitor_t;
 
+	// The fds are visited in increasing order, except for the ones
+	// stored in the hash table, which are visited last.
+	// The table must not be modified while looping.
 	bool loop(const fdtable_visitor_t callback) const
 	{
-		for(auto it = m_table.begin(); it != m_table.end(); ++it)
+		for(size_t fd = 0; fd < m_direct.size(); fd++)
+		{
+			if(m_direct[fd] && !callback(fd, *m_direct[fd]))
+			{
+				return false;
+			}
+		}
+		for(auto it = m_sparse.begin(); it != m_sparse.end(); ++it)
+		{
+			if (!callback(it->first, it->second))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool mutable_loop(const fdtable_mutable_visitor_t callback)
+	{
+		for(size_t fd = 0; fd < m_direct.size(); fd++)
+		{
+			if(m_direct[fd] && !callback(fd, *m_direct[fd]))
+			{
+				return false;
+			}
+		}
+		for(auto it = m_sparse.begin(); it != m_sparse.end(); ++it)
 		{
 			if (!callback(it->first, it->second))
 			{
@@ -594,7 +638,6 @@ public:
 	void reset_cache();
 
 	sinsp* m_inspector;
-	std::unordered_map<int64_t, sinsp_fdinfo_t> m_table;
 
 	//
 	// Simple fd cache
@@ -604,5 +647,21 @@ public:
 	uint64_t m_tid;
 
 private:
+	// Returns the fdinfo of fd, without going through the cache
+	inline sinsp_fdinfo_t* get(int64_t fd) const
+	{
+		if((uint64_t)fd < (uint64_t)DIRECT_FD_LIMIT)
+		{
+			return (uint64_t)fd < m_direct.size() ? m_direct[fd].get() : NULL;
+		}
+
+		auto it = m_sparse.find(fd);
+		return it == m_sparse.end() ? NULL : const_cast<sinsp_fdinfo_t*>(&it->second);
+	}
+
 	void lookup_device(sinsp_fdinfo_t* fdi, uint64_t fd);
+
+	std::vector<std::unique_ptr<sinsp_fdinfo_t>> m_direct;
+	size_t m_direct_count;
+	std::unordered_map<int64_t, sinsp_fdinfo_t> m_sparse;
 };
@@ -30,6 +30,7 @@ limitations under the License.
 #endif
 
 #include <algorithm>
+#include <map>
 
 #include "sinsp.h"
 #include "sinsp_int.h"
@@ -39,19 +40,15 @@ limitations under the License.
 
 #include "filter.h"
 #include "filterchecks.h"
+#include "json_writer.h"
 #include "value_parser.h"
 #include "filter/parser.h"
+#include "filter/ppm_codes.h"
+#include "strsearch.h"
 #ifndef _WIN32
 #include "arpa/inet.h"
 #endif
 
-#ifndef _GNU_SOURCE
-//
-// Fallback implementation of memmem
-//
-void *memmem(const void *haystack, size_t haystacklen, const void *needle, size_t needlelen);
-#endif
-
 #ifdef _WIN32
 #pragma comment(lib, "Ws2_32.lib")
 #include <WinSock2.h>
@@ -149,7 +146,14 @@ bool flt_compare_int64(cmpop op, int64_t operand1, int64_t operand2)
 	}
 }
 
-bool flt_compare_string(cmpop op, char* operand1, char* operand2)
+// The length of a filter value is known once it's been parsed, but the
+// callers that don't have it pass 0
+static inline uint32_t filter_value_len(const char* value, uint32_t len)
+{
+	return len != 0 ? len : strlen(value);
+}
+
+bool flt_compare_string(cmpop op, char* operand1, char* operand2, uint32_t op2_len)
 {
 	switch(op)
 	{
@@ -158,27 +162,17 @@ bool flt_compare_string(cmpop op, char* operand1, char* operand2)
 	case CO_NE:
 		return (strcmp(operand1, operand2) != 0);
 	case CO_CONTAINS:
-		return (strstr(operand1, operand2) != NULL);
-    case CO_ICONTAINS:
-#ifdef _WIN32
-	{
-		std::string s1(operand1);
-		std::string s2(operand2);
-		std::transform(s1.begin(), s1.end(), s1.begin(), [](unsigned char c){ return std::tolower(c); });
-		std::transform(s2.begin(), s2.end(), s2.begin(), [](unsigned char c){ return std::tolower(c); });
-		return (strstr(s1.c_str(), s2.c_str()) != NULL);
-	}
-#else
-		return (strcasestr(operand1, operand2) != NULL);
-#endif
+		return (libsinsp::strsearch::find(operand1, strlen(operand1), operand2, filter_value_len(operand2, op2_len)) != NULL);
+	case CO_ICONTAINS:
+		return (libsinsp::strsearch::ifind(operand1, strlen(operand1), operand2, filter_value_len(operand2, op2_len)) != NULL);
 	case CO_BCONTAINS:
 		throw sinsp_exception("'bcontains' not supported for string filters");
 	case CO_STARTSWITH:
-		return (strncmp(operand1, operand2, strlen(operand2)) == 0);
+		return (strncmp(operand1, operand2, filter_value_len(operand2, op2_len)) == 0);
 	case CO_BSTARTSWITH:
 		throw sinsp_exception("'bstartswith' not supported for string filters");
 	case CO_ENDSWITH:
-		return (sinsp_utils::endswith(operand1, operand2));
+		return (sinsp_utils::endswith(operand1, operand2, strlen(operand1), filter_value_len(operand2, op2_len)));
 	case CO_GLOB:
 		return sinsp_utils::glob_match(operand2, operand1);
 	case CO_LT:
@@ -205,11 +199,11 @@ bool flt_compare_buffer(cmpop op, char* operand1, char* operand2, uint32_t op1_l
 	case CO_NE:
 		return op1_len != op2_len || (memcmp(operand1, operand2, op1_len) != 0);
 	case CO_CONTAINS:
-		return (memmem(operand1, op1_len, operand2, op2_len) != NULL);
+		return (libsinsp::strsearch::find(operand1, op1_len, operand2, op2_len) != NULL);
 	case CO_ICONTAINS:
 		throw sinsp_exception("'icontains' not supported for buffer filters");
 	case CO_BCONTAINS:
-		return (memmem(operand1, op1_len, operand2, op2_len) != NULL);
+		return (libsinsp::strsearch::find(operand1, op1_len, operand2, op2_len) != NULL);
 	case CO_STARTSWITH:
 		return op2_len <= op1_len && (memcmp(operand1, operand2, op2_len) == 0);
 	case CO_BSTARTSWITH:
@@ -458,7 +452,7 @@ bool flt_compare(cmpop op, ppm_param_type type, void* operand1, void* operand2,
 	case PT_CHARBUF:
 	case PT_FSPATH:
 	case PT_FSRELPATH:
-		return flt_compare_string(op, (char*)operand1, (char*)operand2);
+		return flt_compare_string(op, (char*)operand1, (char*)operand2, op2_len);
 	case PT_BYTEBUF:
 		return flt_compare_buffer(op, (char*)operand1, (char*)operand2, op1_len, op2_len);
 	case PT_DOUBLE:
@@ -781,6 +775,129 @@ Json::Value sinsp_filter_check::rawval_to_json(uint8_t* rawval,
 	}
 }
 
+void sinsp_filter_check::rawval_to_json(uint8_t* rawval,
+					ppm_param_type ptype,
+					ppm_print_format print_format,
+					uint32_t len,
+					std::string& out)
+{
+	ASSERT(rawval != NULL);
+
+	// Mirrors the Json::Value version above, writing the values instead
+	bool as_number = print_format == PF_DEC || print_format == PF_ID;
+	bool as_string;
+
+	switch(ptype)
+	{
+		case PT_INT8:
+		case PT_INT16:
+		case PT_INT32:
+		case PT_L4PROTO:
+		case PT_UINT8:
+		case PT_PORT:
+		case PT_UINT16:
+		case PT_UINT32:
+			as_string = print_format == PF_OCT || print_format == PF_HEX;
+			break;
+		case PT_INT64:
+		case PT_PID:
+		case PT_FD:
+			as_string = !as_number;
+			break;
+		case PT_UINT64:
+		case PT_RELTIME:
+		case PT_ABSTIME:
+			as_string = print_format == PF_10_PADDED_DEC ||
+				print_format == PF_OCT ||
+				print_format == PF_HEX;
+			break;
+		case PT_DOUBLE:
+			if(print_format == PF_DEC)
+			{
+				libsinsp::json_writer::append_int(out, (int64_t)*(double*)rawval);
+			}
+			else
+			{
+				libsinsp::json_writer::append_double(out, *(double*)rawval);
+			}
+			return;
+		case PT_SOCKADDR:
+		case PT_SOCKFAMILY:
+			ASSERT(false);
+			libsinsp::json_writer::append_null(out);
+			return;
+		case PT_BOOL:
+			libsinsp::json_writer::append_bool(out, *(uint32_t*)rawval != 0);
+			return;
+		case PT_CHARBUF:
+		case PT_FSPATH:
+		case PT_BYTEBUF:
+		case PT_IPV4ADDR:
+		case PT_IPV6ADDR:
+		case PT_IPADDR:
+		case PT_IPNET:
+		case PT_FSRELPATH:
+			as_number = false;
+			as_string = true;
+			break;
+		default:
+			ASSERT(false);
+			throw sinsp_exception("wrong param type " + std::to_string((long long) ptype));
+	}
+
+	if(as_number)
+	{
+		switch(ptype)
+		{
+			case PT_INT8:
+				libsinsp::json_writer::append_int(out, *(int8_t*)rawval);
+				break;
+			case PT_INT16:
+				libsinsp::json_writer::append_int(out, *(int16_t*)rawval);
+				break;
+			case PT_INT32:
+				libsinsp::json_writer::append_int(out, *(int32_t*)rawval);
+				break;
+			case PT_INT64:
+			case PT_PID:
+			case PT_FD:
+				libsinsp::json_writer::append_int(out, *(int64_t*)rawval);
+				break;
+			case PT_L4PROTO:
+			case PT_UINT8:
+				libsinsp::json_writer::append_uint(out, *(uint8_t*)rawval);
+				break;
+			case PT_PORT:
+			case PT_UINT16:
+				libsinsp::json_writer::append_uint(out, *(uint16_t*)rawval);
+				break;
+			case PT_UINT32:
+				libsinsp::json_writer::append_uint(out, *(uint32_t*)rawval);
+				break;
+			default:
+				libsinsp::json_writer::append_uint(out, *(uint64_t*)rawval);
+				break;
+		}
+	}
+	else if(as_string)
+	{
+		const char* str = rawval_to_string(rawval, ptype, print_format, len);
+		if(str != NULL)
+		{
+			libsinsp::json_writer::append_string(out, str, strlen(str));
+		}
+		else
+		{
+			libsinsp::json_writer::append_null(out);
+		}
+	}
+	else
+	{
+		ASSERT(false);
+		libsinsp::json_writer::append_null(out);
+	}
+}
+
 char* sinsp_filter_check::rawval_to_string(uint8_t* rawval,
 					   ppm_param_type ptype,
 					   ppm_print_format print_format,
@@ -1140,6 +1257,47 @@ Json::Value sinsp_filter_check::tojson(sinsp_evt* evt)
 	return jsonval;
 }
 
+bool sinsp_filter_check::tojson(sinsp_evt* evt, std::string& out)
+{
+	uint32_t len;
+	Json::Value jsonval = extract_as_js(evt, &len);
+
+	if(jsonval != Json::nullValue)
+	{
+		libsinsp::json_writer::append_value(out, jsonval);
+		return true;
+	}
+
+	m_extracted_values.clear();
+	if(!extract_cached(evt, m_extracted_values))
+	{
+		return false;
+	}
+
+	if (m_field->m_flags & EPF_IS_LIST)
+	{
+		// an empty list is a null value, as for tojson()
+		if(m_extracted_values.empty())
+		{
+			return false;
+		}
+
+		out += '[';
+		for (size_t i = 0; i < m_extracted_values.size(); i++)
+		{
+			if(i > 0)
+			{
+				out += ',';
+			}
+			rawval_to_json(m_extracted_values[i].ptr, m_field->m_type, m_field->m_print_format, m_extracted_values[i].len, out);
+		}
+		out += ']';
+		return true;
+	}
+	rawval_to_json(m_extracted_values[0].ptr, m_field->m_type, m_field->m_print_format, m_extracted_values[0].len, out);
+	return true;
+}
+
 int32_t sinsp_filter_check::parse_field_name(const char* str, bool alloc_state, bool needed_for_filtering)
 {
 	int32_t j;
@@ -1217,6 +1375,11 @@ void sinsp_filter_check::add_filter_value(const char* str, uint32_t len, uint32_
 	}
 }
 
+void sinsp_filter_check::set_string_matcher(std::unique_ptr<libsinsp::filter::string_matcher> matcher)
+{
+	m_string_matcher = std::move(matcher);
+}
+
 size_t sinsp_filter_check::parse_filter_value(const char* str, uint32_t len, uint8_t *storage, uint32_t storage_len)
 {
 	size_t parsed_len;
@@ -1366,6 +1529,12 @@ bool sinsp_filter_check::flt_compare(cmpop op, ppm_param_type type, std::vector<
 
 bool sinsp_filter_check::flt_compare(cmpop op, ppm_param_type type, void* operand1, uint32_t op1_len, uint32_t op2_len)
 {
+	if (m_string_matcher != nullptr
+		&& (type == PT_CHARBUF || type == PT_FSPATH || type == PT_FSRELPATH))
+	{
+		return m_string_matcher->match((const char *) operand1);
+	}
+
 	if (op == CO_IN || op == CO_PMATCH || op == CO_INTERSECTS)
 	{
 		// Certain filterchecks can't be done as a set
@@ -1432,6 +1601,12 @@ bool sinsp_filter_check::flt_compare(cmpop op, ppm_param_type type, void* operan
 	}
 	else
 	{
+		// the callers only pass the length of the filter value for byte buffers
+		if(op2_len == 0 && !m_vals.empty())
+		{
+			op2_len = m_vals[0].second;
+		}
+
 		return (::flt_compare(op,
 				      type,
 				      operand1,
@@ -1465,6 +1640,31 @@ uint8_t* sinsp_filter_check::extract(sinsp_evt *evt, OUT uint32_t* len, bool san
 	return NULL;
 }
 
+//
+// The cache entries are keyed by the event number and by the raw event.
+// The filters sharing a cache run on the events of a single inspector (see
+// sinsp_filter_cache), so the event number is unique. The synthetic events
+// (container, user and group events, proc meta events, async events) all
+// have number 0 until sinsp::next() delivers them, so they are never served
+// from the cache.
+//
+static inline bool is_cacheable(const sinsp_evt* evt)
+{
+	return evt->get_num() != 0;
+}
+
+template<typename T>
+static inline bool refresh_cache_key(T* entry, const sinsp_evt* evt)
+{
+	if(entry->m_evtnum == evt->get_num() && entry->m_pevt == evt->get_scap_evt())
+	{
+		return false;
+	}
+	entry->m_evtnum = evt->get_num();
+	entry->m_pevt = evt->get_scap_evt();
+	return true;
+}
+
 bool sinsp_filter_check::extract_cached(sinsp_evt *evt, OUT std::vector<extract_value_t>& values, bool sanitize_strings)
 {
 	if(m_cache_metrics != NULL)
@@ -1472,14 +1672,17 @@ bool sinsp_filter_check::extract_cached(sinsp_evt *evt, OUT std::vector<extract_
 		m_cache_metrics->m_num_extract++;
 	}
 
-	if(m_extraction_cache_entry != NULL)
+	if(m_extraction_cache_entry != NULL && is_cacheable(evt))
 	{
-		uint64_t en = ((sinsp_evt *)evt)->get_num();
-
-		if(en != m_extraction_cache_entry->m_evtnum)
+		if(refresh_cache_key(m_extraction_cache_entry, evt))
 		{
-			m_extraction_cache_entry->m_evtnum = en;
-			extract(evt, m_extraction_cache_entry->m_res, sanitize_strings);
+			// some checks fail without clearing the values, which would
+			// otherwise be served for this event
+			m_extraction_cache_entry->m_ok = extract(evt, m_extraction_cache_entry->m_res, sanitize_strings);
+			if(!m_extraction_cache_entry->m_ok)
+			{
+				m_extraction_cache_entry->m_res.clear();
+			}
 		}
 		else
 		{
@@ -1492,7 +1695,7 @@ bool sinsp_filter_check::extract_cached(sinsp_evt *evt, OUT std::vector<extract_
 		// Shallow-copy the m_cached values to values
 		values = m_extraction_cache_entry->m_res;
 
-		return !m_extraction_cache_entry->m_res.empty();
+		return m_extraction_cache_entry->m_ok;
 	}
 	else
 	{
@@ -1508,13 +1711,10 @@ bool sinsp_filter_check::compare(gen_event *evt)
 		m_cache_metrics->m_num_eval++;
 	}
 
-	if(m_eval_cache_entry != NULL)
+	if(m_eval_cache_entry != NULL && is_cacheable((sinsp_evt *) evt))
 	{
-		uint64_t en = ((sinsp_evt *)evt)->get_num();
-
-		if(en != m_eval_cache_entry->m_evtnum)
+		if(refresh_cache_key(m_eval_cache_entry, (sinsp_evt *) evt))
 		{
-			m_eval_cache_entry->m_evtnum = en;
 			m_eval_cache_entry->m_res = compare((sinsp_evt *) evt);
 		}
 		else
@@ -1568,6 +1768,43 @@ sinsp_filter::~sinsp_filter()
 {
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// sinsp_filter_cache implementation
+///////////////////////////////////////////////////////////////////////////////
+sinsp_filter_cache::sinsp_filter_cache():
+	m_metrics(new check_cache_metrics()) // value-initialized to zero
+{
+}
+
+sinsp_filter_cache::~sinsp_filter_cache()
+{
+}
+
+check_extraction_cache_entry* sinsp_filter_cache::extraction_entry(const std::string& field)
+{
+	auto& entry = m_extraction_entries[field];
+	if (entry == nullptr)
+	{
+		entry.reset(new check_extraction_cache_entry());
+	}
+	return entry.get();
+}
+
+check_eval_cache_entry* sinsp_filter_cache::eval_entry(const std::string& key)
+{
+	auto& entry = m_eval_entries[key];
+	if (entry == nullptr)
+	{
+		entry.reset(new check_eval_cache_entry());
+	}
+	return entry.get();
+}
+
+check_cache_metrics& sinsp_filter_cache::metrics()
+{
+	return *m_metrics;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // sinsp_filter_compiler implementation
 ///////////////////////////////////////////////////////////////////////////////
@@ -1606,6 +1843,26 @@ sinsp_filter_compiler::sinsp_filter_compiler(
 	m_ttable_only = ttable_only;
 }
 
+//
+// Builds the dispatch table of a filter, telling for each event type whether
+// the filter can be true. An empty table is returned if the filter can be
+// true for any event type.
+//
+static std::vector<uint8_t> event_type_table(const libsinsp::filter::ast::expr* e)
+{
+	auto codes = libsinsp::filter::ast::ppm_event_codes(e);
+
+	// the evt.type of async events is encoded in the event itself,
+	// so they can match any evt.type check and must be always evaluated
+	codes.insert(PPME_ASYNCEVENT_E);
+
+	if(codes.size() == PPM_EVENT_MAX)
+	{
+		return {};
+	}
+	return std::vector<uint8_t>(codes.data(), codes.data() + PPM_EVENT_MAX);
+}
+
 sinsp_filter* sinsp_filter_compiler::compile()
 {
 	// parse filter string on-the-fly if not pre-parsed AST is provided
@@ -1636,6 +1893,7 @@ sinsp_filter* sinsp_filter_compiler::compile()
 
 	// setup compiler state and start compilation
 	m_filter = new_sinsp_filter;
+	m_filter->m_cache = m_cache;
 	m_last_boolop = BO_NONE;
 	m_expect_values = false;
 	try
@@ -1649,6 +1907,9 @@ sinsp_filter* sinsp_filter_compiler::compile()
 		throw e;
 	}
 
+	// events whose type can never match are rejected with a table lookup
+	new_sinsp_filter->set_event_type_table(event_type_table(m_flt_ast));
+
 	// return compiled filter
 	m_filter = NULL;
 	return new_sinsp_filter;
@@ -1674,6 +1935,27 @@ void sinsp_filter_compiler::visit(const libsinsp::filter::ast::and_expr* e)
 	}
 }
 
+//
+// Returns the check if it compares a field with a single string pattern
+// that a libsinsp::filter::string_matcher can match
+//
+static const libsinsp::filter::ast::binary_check_expr* as_string_check(const libsinsp::filter::ast::expr* e)
+{
+	auto check = dynamic_cast<const libsinsp::filter::ast::binary_check_expr*>(e);
+	if (check == nullptr
+		|| dynamic_cast<const libsinsp::filter::ast::value_expr*>(check->value.get()) == nullptr)
+	{
+		return nullptr;
+	}
+	if (check->op == "contains" || check->op == "icontains"
+		|| check->op == "startswith" || check->op == "endswith"
+		|| check->op == "glob")
+	{
+		return check;
+	}
+	return nullptr;
+}
+
 void sinsp_filter_compiler::visit(const libsinsp::filter::ast::or_expr* e)
 {
 	m_pos = e->get_pos();
@@ -1683,8 +1965,37 @@ void sinsp_filter_compiler::visit(const libsinsp::filter::ast::or_expr* e)
 		m_filter->push_expression(m_last_boolop);
 		m_last_boolop = BO_NONE;
 	}
+
+	// the string checks on the same field are candidates to be merged
+	std::map<std::string, std::vector<const libsinsp::filter::ast::binary_check_expr*>> string_checks;
 	for (auto &c : e->children)
 	{
+		auto check = as_string_check(c.get());
+		if (check != nullptr)
+		{
+			string_checks[create_filtercheck_name(check->field, check->arg)].push_back(check);
+		}
+	}
+
+	std::set<const libsinsp::filter::ast::expr*> merged;
+	for (auto &c : e->children)
+	{
+		if (merged.find(c.get()) != merged.end())
+		{
+			continue;
+		}
+		auto check = as_string_check(c.get());
+		if (check != nullptr)
+		{
+			auto field = create_filtercheck_name(check->field, check->arg);
+			auto& siblings = string_checks[field];
+			if (siblings.size() > 1 && compile_string_checks(field, siblings))
+			{
+				merged.insert(siblings.begin(), siblings.end());
+				m_last_boolop = BO_OR;
+				continue;
+			}
+		}
 		c->accept(this);
 		m_last_boolop = BO_OR;
 	}
@@ -1704,6 +2015,17 @@ void sinsp_filter_compiler::visit(const libsinsp::filter::ast::not_expr* e)
 	m_filter->pop_expression();
 }
 
+//
+// Appends a component to the key of a check in the evaluation cache. Each
+// component is prefixed by its length, so different checks can't collide.
+//
+static void append_cache_key(std::string& key, const std::string& component)
+{
+	key += std::to_string(component.size());
+	key += ':';
+	key += component;
+}
+
 void sinsp_filter_compiler::visit(const libsinsp::filter::ast::unary_check_expr* e)
 {
 	m_pos = e->get_pos();
@@ -1714,6 +2036,11 @@ void sinsp_filter_compiler::visit(const libsinsp::filter::ast::unary_check_expr*
 	check->m_cmpop = str_to_cmpop(e->op);
 	check->m_boolop = m_last_boolop;
 	check->parse_field_name(field.c_str(), true, true);
+
+	std::string eval_key;
+	append_cache_key(eval_key, field);
+	append_cache_key(eval_key, e->op);
+	set_check_cache(check, field, eval_key);
 }
 
 static void add_filtercheck_value(gen_event_filter_check *chk, size_t idx, const std::string& value)
@@ -1754,10 +2081,104 @@ void sinsp_filter_compiler::visit(const libsinsp::filter::ast::binary_check_expr
 	m_expect_values = true;
 	e->value->accept(this);
 	m_expect_values = false;
+	std::string eval_key;
+	append_cache_key(eval_key, field);
+	append_cache_key(eval_key, e->op);
 	for (size_t i = 0; i < m_field_values.size(); i++)
 	{
 		add_filtercheck_value(check, i, m_field_values[i]);
+		append_cache_key(eval_key, m_field_values[i]);
+	}
+	set_check_cache(check, field, eval_key);
+}
+
+bool sinsp_filter_compiler::compile_string_checks(
+	std::string& field,
+	const std::vector<const libsinsp::filter::ast::binary_check_expr*>& checks)
+{
+	m_pos = checks[0]->get_pos();
+	gen_event_filter_check *check = create_filtercheck(field);
+	check->m_cmpop = str_to_cmpop(checks[0]->op);
+	check->m_boolop = m_last_boolop;
+	try
+	{
+		check->parse_field_name(field.c_str(), true, true);
+	}
+	catch (...)
+	{
+		delete check;
+		throw;
+	}
+
+	// only the fields compared as plain strings by sinsp_filter_check
+	// can use the matcher
+	auto sinsp_check = dynamic_cast<sinsp_filter_check*>(check);
+	const filtercheck_field_info* info = sinsp_check != nullptr ? sinsp_check->get_field_info() : nullptr;
+	if (info == nullptr
+		|| (info->m_type != PT_CHARBUF && info->m_type != PT_FSPATH && info->m_type != PT_FSRELPATH)
+		|| (info->m_flags & EPF_IS_LIST))
+	{
+		delete check;
+		return false;
+	}
+
+	m_filter->add_check(check);
+	check_ttable_only(field, check);
+
+	std::string eval_key;
+	append_cache_key(eval_key, field);
+	std::unique_ptr<libsinsp::filter::string_matcher> matcher(new libsinsp::filter::string_matcher());
+	for (size_t i = 0; i < checks.size(); i++)
+	{
+		m_pos = checks[i]->get_pos();
+		auto& value = static_cast<const libsinsp::filter::ast::value_expr*>(checks[i]->value.get())->value;
+		add_filtercheck_value(check, i, value);
+		append_cache_key(eval_key, checks[i]->op);
+		append_cache_key(eval_key, value);
+
+		// the filter values are compared as C strings
+		std::string pattern(value.c_str());
+		switch (str_to_cmpop(checks[i]->op))
+		{
+			case CO_CONTAINS:
+				matcher->add_contains(pattern);
+				break;
+			case CO_ICONTAINS:
+				matcher->add_icontains(pattern);
+				break;
+			case CO_STARTSWITH:
+				matcher->add_startswith(pattern);
+				break;
+			case CO_ENDSWITH:
+				matcher->add_endswith(pattern);
+				break;
+			case CO_GLOB:
+				matcher->add_glob(pattern);
+				break;
+			default:
+				ASSERT(false);
+				throw sinsp_exception("filter error: unexpected operator " + checks[i]->op);
+		}
+	}
+	matcher->compile();
+	sinsp_check->set_string_matcher(std::move(matcher));
+	set_check_cache(check, field, eval_key);
+	return true;
+}
+
+void sinsp_filter_compiler::set_check_cache(
+	gen_event_filter_check* check,
+	const std::string& field,
+	const std::string& eval_key)
+{
+	auto sinsp_check = dynamic_cast<sinsp_filter_check*>(check);
+	if (m_cache == nullptr || sinsp_check == nullptr)
+	{
+		return;
 	}
+	sinsp_check->m_extraction_cache_entry = m_cache->extraction_entry(field);
+	sinsp_check->m_eval_cache_entry = m_cache->eval_entry(eval_key);
+	sinsp_check->m_cache_metrics = &m_cache->metrics();
 }
 
 void sinsp_filter_compiler::visit(const libsinsp::filter::ast::value_expr* e)
@@ -17,8 +17,10 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -31,6 +33,59 @@ limitations under the License.
  *  @{
  */
 
+class check_extraction_cache_entry;
+class check_eval_cache_entry;
+class check_cache_metrics;
+
+/*!
+  \brief Caches shared by all the filters compiled with it. The checks that
+  extract the same field share the extracted values, and the checks that
+  compare the same field with the same operator and values share the result,
+  so that each of them is computed once per event no matter how many filters
+  contain it.
+
+  \note The filters sharing a cache must be compiled with the same factory
+  and run on the events of a single inspector: the entries are keyed by the
+  number of the event, which is only unique within one inspector.
+
+  \note A cache is not thread-safe: the filters sharing it must all run on
+  the same thread.
+*/
+class SINSP_PUBLIC sinsp_filter_cache
+{
+public:
+	sinsp_filter_cache();
+	~sinsp_filter_cache();
+
+	/*!
+		\brief Returns the extraction cache entry of a field
+	*/
+	check_extraction_cache_entry* extraction_entry(const std::string& field);
+
+	/*!
+		\brief Returns the evaluation cache entry of a check, identified
+		by a key that encodes its field, operator and values
+	*/
+	check_eval_cache_entry* eval_entry(const std::string& key);
+
+	/*!
+		\brief Returns the number of extractions and evaluations of the
+		cached checks, and how many of them used a cached value
+	*/
+	check_cache_metrics& metrics();
+
+	/*!
+		\brief Returns the number of distinct fields and checks cached
+	*/
+	size_t num_extraction_entries() const { return m_extraction_entries.size(); }
+	size_t num_eval_entries() const { return m_eval_entries.size(); }
+
+private:
+	std::unordered_map<std::string, std::unique_ptr<check_extraction_cache_entry>> m_extraction_entries;
+	std::unordered_map<std::string, std::unique_ptr<check_eval_cache_entry>> m_eval_entries;
+	std::unique_ptr<check_cache_metrics> m_metrics;
+};
+
 /*!
   \brief This is the class that runs the filters.
 */
@@ -43,7 +98,11 @@ public:
 private:
 	sinsp* m_inspector;
 
+	// keeps the cache alive as long as the checks point to its entries
+	std::shared_ptr<sinsp_filter_cache> m_cache;
+
 	friend class sinsp_evt_formatter;
+	friend class sinsp_filter_compiler;
 };
 
 
@@ -105,6 +164,15 @@ public:
 	*/
 	sinsp_filter* compile();
 
+	/*!
+		\brief Makes the filters compiled from now on share the
+		extraction and evaluation caches of all the other filters compiled
+		with the same cache. This is meant for sets of filters that are
+		all run on each event, such as rulesets, whose checks are largely
+		repeated.
+	*/
+	void set_cache(std::shared_ptr<sinsp_filter_cache> cache) { m_cache = cache; }
+
 	std::shared_ptr<libsinsp::filter::ast::expr> get_filter_ast() { return m_internal_flt_ast; }
 
 	const libsinsp::filter::ast::pos_info& get_pos() const { return m_pos; }
@@ -121,6 +189,13 @@ private:
 	cmpop str_to_cmpop(const std::string& str);
 	std::string create_filtercheck_name(const std::string& name, const std::string& arg);
 	gen_event_filter_check* create_filtercheck(std::string& field);
+	bool compile_string_checks(
+		std::string& field,
+		const std::vector<const libsinsp::filter::ast::binary_check_expr*>& checks);
+	void set_check_cache(
+		gen_event_filter_check* check,
+		const std::string& field,
+		const std::string& eval_key);
 
 	libsinsp::filter::ast::pos_info m_pos;
 	bool m_ttable_only;
@@ -132,6 +207,7 @@ private:
 	std::shared_ptr<libsinsp::filter::ast::expr> m_internal_flt_ast;
 	const libsinsp::filter::ast::expr* m_flt_ast;
 	std::shared_ptr<gen_event_filter_factory> m_factory;
+	std::shared_ptr<sinsp_filter_cache> m_cache;
 
 	friend class sinsp_evt_formatter;
 };
@@ -0,0 +1,354 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <cstring>
+#include "string_matcher.h"
+#include "../utils.h"
+#include "../sinsp_exception.h"
+
+using namespace libsinsp::filter;
+
+static constexpr uint32_t s_no_state = UINT32_MAX;
+
+// the folding of strcasestr in the C locale
+static inline uint8_t fold(uint8_t c)
+{
+	return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+void string_matcher::automaton::build(
+	const std::vector<std::pair<std::string, uint8_t>>& patterns,
+	bool fold_case,
+	bool anchored)
+{
+	// every byte that appears in the patterns gets its own class, all the
+	// other ones share class 0 as they can only lead out of the patterns
+	bool used[256] = {};
+	memset(m_class, 0, sizeof(m_class));
+	m_num_classes = 1;
+	for(const auto& p : patterns)
+	{
+		for(uint8_t c : p.first)
+		{
+			c = fold_case ? fold(c) : c;
+			if(!used[c])
+			{
+				used[c] = true;
+				m_class[c] = m_num_classes++;
+			}
+		}
+	}
+	if(fold_case)
+	{
+		for(uint32_t c = 'A'; c <= 'Z'; c++)
+		{
+			m_class[c] = m_class[fold(c)];
+		}
+	}
+
+	// trie of the patterns
+	m_next.assign(m_num_classes, s_no_state);
+	m_accept.assign(1, 0);
+	for(const auto& p : patterns)
+	{
+		uint32_t state = 0;
+		for(uint8_t c : p.first)
+		{
+			uint32_t& next = m_next[state * m_num_classes + m_class[c]];
+			if(next == s_no_state)
+			{
+				next = m_accept.size();
+				m_next.resize(m_next.size() + m_num_classes, s_no_state);
+				m_accept.push_back(0);
+			}
+			// m_next might have been reallocated
+			state = m_next[state * m_num_classes + m_class[c]];
+		}
+		m_accept[state] |= p.second;
+	}
+
+	if(anchored)
+	{
+		// leaving the trie means that no pattern can match anymore
+		m_dead = m_accept.size();
+		m_next.resize(m_next.size() + m_num_classes, s_no_state);
+		m_accept.push_back(0);
+		for(auto& next : m_next)
+		{
+			if(next == s_no_state)
+			{
+				next = m_dead;
+			}
+		}
+		return;
+	}
+
+	// Aho-Corasick: the missing transitions of a state are the ones of its
+	// failure state, i.e. the longest proper suffix of it found in the trie
+	m_dead = s_no_state;
+	std::vector<uint32_t> fail(m_accept.size(), 0);
+	std::vector<uint32_t> queue;
+	queue.reserve(m_accept.size());
+	for(uint32_t c = 0; c < m_num_classes; c++)
+	{
+		uint32_t& next = m_next[c];
+		if(next == s_no_state)
+		{
+			next = 0;
+		}
+		else
+		{
+			queue.push_back(next);
+		}
+	}
+	for(size_t i = 0; i < queue.size(); i++)
+	{
+		uint32_t state = queue[i];
+		m_accept[state] |= m_accept[fail[state]];
+		for(uint32_t c = 0; c < m_num_classes; c++)
+		{
+			uint32_t fallback = m_next[fail[state] * m_num_classes + c];
+			uint32_t& next = m_next[state * m_num_classes + c];
+			if(next == s_no_state)
+			{
+				next = fallback;
+			}
+			else
+			{
+				fail[next] = fallback;
+				queue.push_back(next);
+			}
+		}
+	}
+}
+
+string_matcher::string_matcher():
+	m_compiled(false),
+	m_match_all(false)
+{
+}
+
+void string_matcher::add_contains(const std::string& pattern)
+{
+	if(pattern.empty())
+	{
+		m_match_all = true;
+		return;
+	}
+	m_contains.emplace_back(pattern, automaton::ACCEPT_ANY);
+}
+
+void string_matcher::add_icontains(const std::string& pattern)
+{
+	if(pattern.empty())
+	{
+		m_match_all = true;
+		return;
+	}
+	std::string folded = pattern;
+	for(auto& c : folded)
+	{
+		c = fold(c);
+	}
+	m_icontains.emplace_back(folded, automaton::ACCEPT_ANY);
+}
+
+void string_matcher::add_startswith(const std::string& pattern)
+{
+	if(pattern.empty())
+	{
+		m_match_all = true;
+		return;
+	}
+	m_prefixes.emplace_back(pattern, automaton::ACCEPT_ANY);
+}
+
+void string_matcher::add_endswith(const std::string& pattern)
+{
+	if(pattern.empty())
+	{
+		m_match_all = true;
+		return;
+	}
+	m_suffixes.emplace_back(std::string(pattern.rbegin(), pattern.rend()), automaton::ACCEPT_ANY);
+}
+
+void string_matcher::add_glob(const std::string& pattern)
+{
+#ifndef _WIN32
+	// '*' also matches '/' with the flags of sinsp_utils::glob_match(),
+	// so a literal surrounded by stars is just a substring, prefix or suffix
+	size_t first = pattern.find_first_not_of('*');
+	if(first == std::string::npos)
+	{
+		if(pattern.empty())
+		{
+			m_prefixes.emplace_back(pattern, automaton::ACCEPT_END);
+		}
+		else
+		{
+			m_match_all = true;
+		}
+		return;
+	}
+
+	size_t last = pattern.find_last_not_of('*');
+	std::string literal = pattern.substr(first, last - first + 1);
+	if(literal.find_first_of("*?[\\") == std::string::npos)
+	{
+		bool leading_star = first > 0;
+		bool trailing_star = last + 1 < pattern.size();
+		if(leading_star && trailing_star)
+		{
+			add_contains(literal);
+		}
+		else if(leading_star)
+		{
+			add_endswith(literal);
+		}
+		else if(trailing_star)
+		{
+			add_startswith(literal);
+		}
+		else
+		{
+			m_prefixes.emplace_back(literal, automaton::ACCEPT_END);
+		}
+		return;
+	}
+#endif
+	m_globs.push_back(pattern);
+}
+
+void string_matcher::compile()
+{
+	if(m_compiled)
+	{
+		throw sinsp_exception("string matcher already compiled");
+	}
+	if(!m_contains.empty())
+	{
+		m_contains_dfa.build(m_contains, false, false);
+	}
+	if(!m_icontains.empty())
+	{
+		m_icontains_dfa.build(m_icontains, true, false);
+	}
+	if(!m_prefixes.empty())
+	{
+		m_prefix_dfa.build(m_prefixes, false, true);
+	}
+	if(!m_suffixes.empty())
+	{
+		m_suffix_dfa.build(m_suffixes, false, true);
+	}
+	m_compiled = true;
+}
+
+bool string_matcher::match(const char* str) const
+{
+	if(m_match_all)
+	{
+		return true;
+	}
+
+	if(!m_prefixes.empty())
+	{
+		const automaton& dfa = m_prefix_dfa;
+		uint32_t state = 0;
+		for(const char* p = str; ; p++)
+		{
+			if(dfa.m_accept[state] & automaton::ACCEPT_ANY)
+			{
+				return true;
+			}
+			if(*p == '\0')
+			{
+				if(dfa.m_accept[state] & automaton::ACCEPT_END)
+				{
+					return true;
+				}
+				break;
+			}
+			state = dfa.next(state, *p);
+			if(state == dfa.m_dead)
+			{
+				break;
+			}
+		}
+	}
+
+	if(!m_suffixes.empty())
+	{
+		const automaton& dfa = m_suffix_dfa;
+		uint32_t state = 0;
+		for(size_t i = strlen(str); ; )
+		{
+			if(dfa.m_accept[state] & automaton::ACCEPT_ANY)
+			{
+				return true;
+			}
+			if(i == 0)
+			{
+				break;
+			}
+			state = dfa.next(state, str[--i]);
+			if(state == dfa.m_dead)
+			{
+				break;
+			}
+		}
+	}
+
+	if(!m_contains.empty())
+	{
+		const automaton& dfa = m_contains_dfa;
+		uint32_t state = 0;
+		for(const char* p = str; *p != '\0'; p++)
+		{
+			state = dfa.next(state, *p);
+			if(dfa.m_accept[state])
+			{
+				return true;
+			}
+		}
+	}
+
+	if(!m_icontains.empty())
+	{
+		const automaton& dfa = m_icontains_dfa;
+		uint32_t state = 0;
+		for(const char* p = str; *p != '\0'; p++)
+		{
+			state = dfa.next(state, *p);
+			if(dfa.m_accept[state])
+			{
+				return true;
+			}
+		}
+	}
+
+	for(const auto& g : m_globs)
+	{
+		if(sinsp_utils::glob_match(g.c_str(), str))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
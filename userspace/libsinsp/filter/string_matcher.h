@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libsinsp {
+namespace filter {
+
+/*!
+	\brief Matches a string against a set of patterns at once, with the
+	semantics of the 'contains', 'icontains', 'startswith', 'endswith' and
+	'glob' filter operators. The result is true if any pattern matches.
+
+	All the 'contains' patterns are merged into one Aho-Corasick automaton,
+	the 'icontains' ones into a case-folded one, and the 'startswith' and
+	'endswith' ones into anchored tries that are walked from the start and
+	from the end of the string respectively. Globs made of a literal
+	optionally surrounded by '*' are rewritten into one of those, the other
+	ones are evaluated one by one with sinsp_utils::glob_match().
+
+	\note Patterns can't be added after compile() has been called.
+*/
+class string_matcher
+{
+public:
+	string_matcher();
+	virtual ~string_matcher() = default;
+	string_matcher(string_matcher&&) = default;
+	string_matcher& operator = (string_matcher&&) = default;
+	string_matcher(const string_matcher&) = delete;
+	string_matcher& operator = (const string_matcher&) = delete;
+
+	void add_contains(const std::string& pattern);
+	void add_icontains(const std::string& pattern);
+	void add_startswith(const std::string& pattern);
+	void add_endswith(const std::string& pattern);
+	void add_glob(const std::string& pattern);
+
+	/*!
+		\brief Builds the automata out of the added patterns
+	*/
+	void compile();
+
+	/*!
+		\brief Returns true if str matches any of the patterns
+	*/
+	bool match(const char* str) const;
+
+private:
+	// Dense DFA over classes of bytes. State 0 is the start state.
+	struct automaton
+	{
+		enum accept_flags : uint8_t
+		{
+			ACCEPT_ANY = 1 << 0, ///< the string matches once this state is reached
+			ACCEPT_END = 1 << 1, ///< the string matches if it ends in this state
+		};
+
+		uint16_t m_class[256];
+		uint32_t m_num_classes = 0;
+		uint32_t m_dead = UINT32_MAX; ///< state with no way out, if any
+		std::vector<uint32_t> m_next;
+		std::vector<uint8_t> m_accept;
+
+		void build(const std::vector<std::pair<std::string, uint8_t>>& patterns, bool fold_case, bool anchored);
+		inline uint32_t next(uint32_t state, uint8_t c) const
+		{
+			return m_next[state * m_num_classes + m_class[c]];
+		}
+	};
+
+	bool m_compiled;
+	bool m_match_all;
+	std::vector<std::pair<std::string, uint8_t>> m_contains;
+	std::vector<std::pair<std::string, uint8_t>> m_icontains;
+	std::vector<std::pair<std::string, uint8_t>> m_prefixes;
+	std::vector<std::pair<std::string, uint8_t>> m_suffixes;
+	std::vector<std::string> m_globs;
+	automaton m_contains_dfa;
+	automaton m_icontains_dfa;
+	automaton m_prefix_dfa;
+	automaton m_suffix_dfa;
+};
+
+}
+}
@@ -0,0 +1,98 @@
+/*
+Copyright (C) 2021 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <algorithm>
+
+#include "filter_ruleset.h"
+#include "sinsp.h"
+#include "sinsp_int.h"
+
+sinsp_filter_ruleset::sinsp_filter_ruleset():
+	m_buckets(PPM_EVENT_MAX),
+	m_cache(std::make_shared<sinsp_filter_cache>())
+{
+}
+
+sinsp_filter_ruleset::~sinsp_filter_ruleset()
+{
+}
+
+void sinsp_filter_ruleset::add(uint32_t id, std::unique_ptr<sinsp_filter> filter)
+{
+	if (filter == nullptr)
+	{
+		throw sinsp_exception("filter ruleset error: null filter for rule ID " + std::to_string(id));
+	}
+	if (m_filters.find(id) != m_filters.end())
+	{
+		throw sinsp_exception("filter ruleset error: duplicate rule ID " + std::to_string(id));
+	}
+
+	// an empty table means that the filter can be true for any event type,
+	// while the types past the end of the table are always evaluated
+	bucket_entry entry = {id, filter.get()};
+	const auto& table = filter->get_event_type_table();
+	for (size_t etype = 0; etype < m_buckets.size(); etype++)
+	{
+		if (etype >= table.size() || table[etype] != 0)
+		{
+			m_buckets[etype].push_back(entry);
+		}
+	}
+	m_all.push_back(entry);
+	m_filters[id] = std::move(filter);
+}
+
+bool sinsp_filter_ruleset::remove(uint32_t id)
+{
+	auto it = m_filters.find(id);
+	if (it == m_filters.end())
+	{
+		return false;
+	}
+
+	auto has_id = [id](const bucket_entry& e) { return e.id == id; };
+	for (auto& bucket : m_buckets)
+	{
+		bucket.erase(std::remove_if(bucket.begin(), bucket.end(), has_id), bucket.end());
+	}
+	m_all.erase(std::remove_if(m_all.begin(), m_all.end(), has_id), m_all.end());
+	m_filters.erase(it);
+	return true;
+}
+
+void sinsp_filter_ruleset::clear()
+{
+	for (auto& bucket : m_buckets)
+	{
+		bucket.clear();
+	}
+	m_all.clear();
+	m_filters.clear();
+}
+
+bool sinsp_filter_ruleset::run(sinsp_evt* evt, std::vector<uint32_t>& matched)
+{
+	matched.clear();
+	for (const auto& e : bucket(evt->get_type()))
+	{
+		if (e.filter->run(evt))
+		{
+			matched.push_back(e.id);
+		}
+	}
+	return !matched.empty();
+}
@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2021 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "filter.h"
+
+class sinsp_evt;
+
+/*!
+  \brief A set of compiled filters, each identified by a rule ID, that are
+  all run on each event. The filters are grouped in buckets by the event
+  types for which they can be true, as told by their event type tables, so
+  that each event only runs the filters of its own type and the cost per
+  event does not grow with the filters that can't match it.
+*/
+class SINSP_PUBLIC sinsp_filter_ruleset
+{
+public:
+	sinsp_filter_ruleset();
+	~sinsp_filter_ruleset();
+	sinsp_filter_ruleset(const sinsp_filter_ruleset&) = delete;
+	sinsp_filter_ruleset& operator = (const sinsp_filter_ruleset&) = delete;
+
+	/*!
+		\brief Adds a filter to the ruleset, which takes its ownership.
+		The filters of each bucket are run in the order they are added.
+		\note Throws a sinsp_exception if the ID is already in use
+	*/
+	void add(uint32_t id, std::unique_ptr<sinsp_filter> filter);
+
+	/*!
+		\brief Removes the filter with the given ID, if any
+		\return true if the filter was found
+	*/
+	bool remove(uint32_t id);
+
+	/*!
+		\brief Removes all the filters
+	*/
+	void clear();
+
+	/*!
+		\brief Returns the number of filters in the ruleset
+	*/
+	size_t size() const { return m_filters.size(); }
+
+	/*!
+		\brief Returns the number of filters that run for the events of
+		the given type
+	*/
+	size_t num_filters(uint16_t evttype) const { return bucket(evttype).size(); }
+
+	/*!
+		\brief Runs the filters that can be true for the type of the event
+		\param evt The event to be filtered
+		\param matched Filled with the IDs of the filters that accepted the
+		event, in the order they were added
+		\return true if at least one filter accepted the event
+	*/
+	bool run(sinsp_evt* evt, std::vector<uint32_t>& matched);
+
+	/*!
+		\brief Returns a cache to be set on the compilers of the filters
+		of this ruleset, so that the checks repeated across the filters are
+		extracted and evaluated once per event
+	*/
+	const std::shared_ptr<sinsp_filter_cache>& cache() const { return m_cache; }
+
+private:
+	struct bucket_entry
+	{
+		uint32_t id;
+		sinsp_filter* filter;
+	};
+
+	const std::vector<bucket_entry>& bucket(uint16_t evttype) const
+	{
+		// the events with a type past the end of the tables run all filters
+		return evttype < m_buckets.size() ? m_buckets[evttype] : m_all;
+	}
+
+	std::unordered_map<uint32_t, std::unique_ptr<sinsp_filter>> m_filters;
+	std::vector<std::vector<bucket_entry>> m_buckets;
+	std::vector<bucket_entry> m_all;
+	std::shared_ptr<sinsp_filter_cache> m_cache;
+};
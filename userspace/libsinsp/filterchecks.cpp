@@ -926,6 +926,12 @@ bool sinsp_filter_check_fd::extract(sinsp_evt *evt, OUT std::vector<extract_valu
 
 		m_tinfo->loop_fds(fd_type_gather);
 
+		// Don't depend on the order in which the fd table is visited
+		std::sort(values.begin(), values.end(), [](const extract_value_t& a, const extract_value_t& b)
+		{
+			return strcmp((const char*)a.ptr, (const char*)b.ptr) < 0;
+		});
+
 		return true;
 	}
 
@@ -3039,11 +3045,11 @@ uint8_t* sinsp_filter_check_thread::extract(sinsp_evt *evt, OUT uint32_t* len, b
 			m_tstr.clear();
 
 			uint32_t j;
-			uint32_t nargs = (uint32_t)tinfo->m_args.size();
+			uint32_t nargs = (uint32_t)tinfo->get_args().size();
 
 			for(j = 0; j < nargs; j++)
 			{
-				m_tstr += tinfo->m_args[j];
+				m_tstr += tinfo->get_args()[j];
 				if(j < nargs -1)
 				{
 					m_tstr += ' ';
@@ -3081,11 +3087,11 @@ uint8_t* sinsp_filter_check_thread::extract(sinsp_evt *evt, OUT uint32_t* len, b
 			m_tstr = tinfo->get_exe() + " ";
 
 			uint32_t j;
-			uint32_t nargs = (uint32_t)tinfo->m_args.size();
+			uint32_t nargs = (uint32_t)tinfo->get_args().size();
 
 			for(j = 0; j < nargs; j++)
 			{
-				m_tstr += tinfo->m_args[j];
+				m_tstr += tinfo->get_args()[j];
 				if(j < nargs -1)
 				{
 					m_tstr += ' ';
@@ -3535,7 +3541,7 @@ uint8_t* sinsp_filter_check_thread::extract(sinsp_evt *evt, OUT uint32_t* len, b
 	case TYPE_CGROUPS:
 		{
 			m_tstr.clear();
-			auto cgroups = tinfo->cgroups();
+			const auto& cgroups = tinfo->cgroups();
 
 			uint32_t j;
 			uint32_t nargs = (uint32_t)cgroups.size();
@@ -3680,18 +3686,18 @@ uint8_t* sinsp_filter_check_thread::extract(sinsp_evt *evt, OUT uint32_t* len, b
 		RETURN_EXTRACT_STRING(m_tstr);
 	case TYPE_CMDNARGS:
 		{
-			m_u64val = (uint32_t)tinfo->m_args.size();
+			m_u64val = (uint32_t)tinfo->get_args().size();
 			RETURN_EXTRACT_VAR(m_u64val);
 		}
 	case TYPE_CMDLENARGS:
 		{
 			m_u64val = 0;
 			uint32_t j;
-			uint32_t nargs = (uint32_t)tinfo->m_args.size();
+			uint32_t nargs = (uint32_t)tinfo->get_args().size();
 
 			for(j = 0; j < nargs; j++)
 			{
-				m_u64val += tinfo->m_args[j].length();
+				m_u64val += tinfo->get_args()[j].length();
 
 			}
 			RETURN_EXTRACT_VAR(m_u64val);
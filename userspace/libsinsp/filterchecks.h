@@ -23,6 +23,7 @@ limitations under the License.
 #include <set>
 #include "filter_value.h"
 #include "prefix_search.h"
+#include "filter/string_matcher.h"
 #if !defined(CYGWING_AGENT) && !defined(MINIMAL_BUILD) && !defined(__EMSCRIPTEN__)
 #include "k8s.h"
 #include "mesos.h"
@@ -54,6 +55,8 @@ class check_extraction_cache_entry
 {
 public:
 	uint64_t m_evtnum = UINT64_MAX;
+	const scap_evt* m_pevt = NULL;
+	bool m_ok = false;
 	std::vector<extract_value_t> m_res;
 };
 
@@ -61,6 +64,7 @@ class check_eval_cache_entry
 {
 public:
 	uint64_t m_evtnum = UINT64_MAX;
+	const scap_evt* m_pevt = NULL;
 	bool m_res;
 };
 
@@ -123,6 +127,13 @@ public:
 	void add_filter_value(const char* str, uint32_t len, uint32_t i = 0 );
 	virtual size_t parse_filter_value(const char* str, uint32_t len, uint8_t *storage, uint32_t storage_len);
 
+	//
+	// Compare the extracted strings with a set of patterns rather than with
+	// the filter value. This is how the compiler merges sibling string checks
+	// on the same field.
+	//
+	void set_string_matcher(std::unique_ptr<libsinsp::filter::string_matcher> matcher);
+
 	//
 	// Called after parsing for optional validation of the filter value
 	//
@@ -178,6 +189,13 @@ public:
 	//
 	virtual Json::Value tojson(sinsp_evt* evt);
 
+	//
+	// Same as tojson(), but append the serialized value to out instead of
+	// building a Json::Value. Return false, appending nothing, if the
+	// value can't be extracted
+	//
+	virtual bool tojson(sinsp_evt* evt, std::string& out);
+
 	sinsp* m_inspector;
 	bool m_needs_state_tracking = false;
 	check_eval_cache_entry* m_eval_cache_entry = NULL;
@@ -199,6 +217,7 @@ protected:
 			       ppm_print_format print_format,
 			       uint32_t len);
 	Json::Value rawval_to_json(uint8_t* rawval, ppm_param_type ptype, ppm_print_format print_format, uint32_t len);
+	void rawval_to_json(uint8_t* rawval, ppm_param_type ptype, ppm_print_format print_format, uint32_t len, std::string& out);
 	void string_to_rawval(const char* str, uint32_t len, ppm_param_type ptype);
 
 	char m_getpropertystr_storage[1024];
@@ -214,6 +233,8 @@ protected:
 
 	path_prefix_search m_val_storages_paths;
 
+	std::unique_ptr<libsinsp::filter::string_matcher> m_string_matcher;
+
 	uint32_t m_val_storages_min_size;
 	uint32_t m_val_storages_max_size;
 
@@ -259,9 +259,22 @@ void gen_event_filter::pop_expression()
 
 bool gen_event_filter::run(gen_event *evt)
 {
+	if(!m_event_type_table.empty())
+	{
+		uint16_t etype = evt->get_type();
+		if(etype < m_event_type_table.size() && m_event_type_table[etype] == 0)
+		{
+			return false;
+		}
+	}
 	return m_filter->compare(evt);
 }
 
+void gen_event_filter::set_event_type_table(std::vector<uint8_t> table)
+{
+	m_event_type_table = std::move(table);
+}
+
 void gen_event_filter::add_check(gen_event_filter_check* chk)
 {
 	m_curexpr->add_check((gen_event_filter_check *) chk);
@@ -183,10 +183,25 @@ public:
 	void pop_expression();
 	void add_check(gen_event_filter_check* chk);
 
+	/*!
+	  \brief Sets the table of the event types for which the filter can be
+	  true, indexed by event type. run() rejects the events whose entry is
+	  zero without evaluating the filter, while the events with a type past
+	  the end of the table are always evaluated. An empty table (the default)
+	  means that all events are evaluated.
+	*/
+	void set_event_type_table(std::vector<uint8_t> table);
+
+	inline const std::vector<uint8_t>& get_event_type_table() const
+	{
+		return m_event_type_table;
+	}
+
 	gen_event_filter_expression* m_filter;
 
 protected:
 	gen_event_filter_expression* m_curexpr;
+	std::vector<uint8_t> m_event_type_table;
 
 	friend class sinsp_filter_compiler;
 	friend class sinsp_filter_optimizer;
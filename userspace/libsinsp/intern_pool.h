@@ -0,0 +1,118 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace libsinsp
+{
+
+/**
+ * Pool of immutable, ref-counted values keyed by the raw bytes they are
+ * parsed from (e.g. the environment block of an execve event). Interning
+ * the same bytes twice returns the same value, so threads with identical
+ * state share a single copy of it.
+ *
+ * The pool only keeps weak references: a value is freed as soon as the
+ * last holder releases it, and its slot is reclaimed by a later intern().
+ * The pool is not thread safe.
+ */
+template<typename T>
+class intern_pool
+{
+public:
+	using ptr_t = std::shared_ptr<const T>;
+
+	/**
+	 * Return the value interned for the given key, calling parse(key) to
+	 * build it if there is none yet.
+	 */
+	template<typename Parse>
+	ptr_t intern(std::string_view key, Parse parse)
+	{
+		size_t hash = std::hash<std::string_view>()(key);
+		auto range = m_entries.equal_range(hash);
+		for(auto it = range.first; it != range.second; ++it)
+		{
+			if(it->second.m_key == key)
+			{
+				if(auto value = it->second.m_value.lock())
+				{
+					return value;
+				}
+				ptr_t value = std::make_shared<const T>(parse(key));
+				it->second.m_value = value;
+				return value;
+			}
+		}
+
+		if(m_entries.size() >= m_purge_threshold)
+		{
+			purge();
+		}
+
+		ptr_t value = std::make_shared<const T>(parse(key));
+		m_entries.emplace(hash, entry{std::string(key), value});
+		return value;
+	}
+
+	/**
+	 * Number of keys in the pool, including the ones whose value has
+	 * already been freed but not yet reclaimed.
+	 */
+	size_t size() const
+	{
+		return m_entries.size();
+	}
+
+private:
+	static constexpr size_t MIN_PURGE_THRESHOLD = 256;
+
+	struct entry
+	{
+		std::string m_key;
+		std::weak_ptr<const T> m_value;
+	};
+
+	void purge()
+	{
+		for(auto it = m_entries.begin(); it != m_entries.end();)
+		{
+			if(it->second.m_value.expired())
+			{
+				it = m_entries.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		// amortize the purges over the inserts, as all the keys might be alive
+		m_purge_threshold = std::max(MIN_PURGE_THRESHOLD, m_entries.size() * 2);
+	}
+
+	std::unordered_multimap<size_t, entry> m_entries;
+	size_t m_purge_threshold = MIN_PURGE_THRESHOLD;
+};
+
+}
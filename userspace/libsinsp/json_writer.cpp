@@ -0,0 +1,280 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "json_writer.h"
+
+using namespace libsinsp;
+
+static const uint32_t s_replacement_char = 0xFFFD;
+
+static inline bool needs_escaping(const char* str, size_t len)
+{
+	for(size_t j = 0; j < len; j++)
+	{
+		unsigned char c = (unsigned char)str[j];
+		if(c == '\\' || c == '"' || c < 0x20 || c > 0x7F)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static inline void append_hex16(std::string& out, uint32_t val)
+{
+	static const char digits[] = "0123456789abcdef";
+	char buf[6] = {'\\', 'u',
+		digits[(val >> 12) & 0xF],
+		digits[(val >> 8) & 0xF],
+		digits[(val >> 4) & 0xF],
+		digits[val & 0xF]};
+	out.append(buf, sizeof(buf));
+}
+
+//
+// Decode the UTF-8 sequence starting at *str and move *str to its last
+// byte. Invalid or truncated sequences decode to U+FFFD, as in jsoncpp.
+//
+static inline uint32_t decode_utf8(const char*& str, const char* end)
+{
+	uint32_t first = (unsigned char)str[0];
+	if(first < 0x80)
+	{
+		return first;
+	}
+
+	if(first < 0xE0)
+	{
+		if(end - str < 2)
+		{
+			return s_replacement_char;
+		}
+		uint32_t cp = ((first & 0x1F) << 6) | ((uint32_t)str[1] & 0x3F);
+		str += 1;
+		return cp < 0x80 ? s_replacement_char : cp;
+	}
+
+	if(first < 0xF0)
+	{
+		if(end - str < 3)
+		{
+			return s_replacement_char;
+		}
+		uint32_t cp = ((first & 0x0F) << 12) | (((uint32_t)str[1] & 0x3F) << 6) | ((uint32_t)str[2] & 0x3F);
+		str += 2;
+		if(cp >= 0xD800 && cp <= 0xDFFF)
+		{
+			return s_replacement_char;
+		}
+		return cp < 0x800 ? s_replacement_char : cp;
+	}
+
+	if(first < 0xF8)
+	{
+		if(end - str < 4)
+		{
+			return s_replacement_char;
+		}
+		uint32_t cp = ((first & 0x07) << 18) | (((uint32_t)str[1] & 0x3F) << 12) |
+			(((uint32_t)str[2] & 0x3F) << 6) | ((uint32_t)str[3] & 0x3F);
+		str += 3;
+		return cp < 0x10000 ? s_replacement_char : cp;
+	}
+
+	return s_replacement_char;
+}
+
+void json_writer::append_string(std::string& out, const char* str, size_t len)
+{
+	out += '"';
+
+	if(!needs_escaping(str, len))
+	{
+		out.append(str, len);
+		out += '"';
+		return;
+	}
+
+	const char* end = str + len;
+	for(const char* c = str; c != end; ++c)
+	{
+		// copy the runs that need no escaping at once
+		const char* run = c;
+		while(c != end && *c != '"' && *c != '\\' &&
+		      (unsigned char)*c >= 0x20 && (unsigned char)*c < 0x80)
+		{
+			++c;
+		}
+		out.append(run, c - run);
+		if(c == end)
+		{
+			break;
+		}
+
+		switch(*c)
+		{
+		case '"':
+			out += "\\\"";
+			break;
+		case '\\':
+			out += "\\\\";
+			break;
+		case '\b':
+			out += "\\b";
+			break;
+		case '\f':
+			out += "\\f";
+			break;
+		case '\n':
+			out += "\\n";
+			break;
+		case '\r':
+			out += "\\r";
+			break;
+		case '\t':
+			out += "\\t";
+			break;
+		default:
+		{
+			uint32_t cp = decode_utf8(c, end);
+			if(cp < 0x20 || (cp >= 0x80 && cp < 0x10000))
+			{
+				append_hex16(out, cp);
+			}
+			else if(cp >= 0x10000)
+			{
+				// encode the 20 bits as a surrogate pair
+				cp -= 0x10000;
+				append_hex16(out, 0xD800 + ((cp >> 10) & 0x3FF));
+				append_hex16(out, 0xDC00 + (cp & 0x3FF));
+			}
+			else
+			{
+				out += (char)cp;
+			}
+			break;
+		}
+		}
+	}
+
+	out += '"';
+}
+
+void json_writer::append_int(std::string& out, int64_t val)
+{
+	char buf[24];
+	auto res = std::to_chars(buf, buf + sizeof(buf), val);
+	out.append(buf, res.ptr - buf);
+}
+
+void json_writer::append_uint(std::string& out, uint64_t val)
+{
+	char buf[24];
+	auto res = std::to_chars(buf, buf + sizeof(buf), val);
+	out.append(buf, res.ptr - buf);
+}
+
+void json_writer::append_double(std::string& out, double val)
+{
+	if(!std::isfinite(val))
+	{
+		out += std::isnan(val) ? "null" : (val < 0 ? "-1e+9999" : "1e+9999");
+		return;
+	}
+
+	char buf[40];
+	int len = snprintf(buf, sizeof(buf), "%.17g", val);
+	if(len < 0 || (size_t)len >= sizeof(buf))
+	{
+		out += "null";
+		return;
+	}
+
+	// keep the output independent from the locale, and make sure it
+	// still reads as a double
+	bool has_dot = false;
+	for(int j = 0; j < len; j++)
+	{
+		if(buf[j] == ',')
+		{
+			buf[j] = '.';
+		}
+		if(buf[j] == '.' || buf[j] == 'e')
+		{
+			has_dot = true;
+		}
+	}
+	out.append(buf, len);
+	if(!has_dot)
+	{
+		out += ".0";
+	}
+}
+
+void json_writer::append_bool(std::string& out, bool val)
+{
+	out += val ? "true" : "false";
+}
+
+void json_writer::append_null(std::string& out)
+{
+	out += "null";
+}
+
+void json_writer::append_value(std::string& out, const Json::Value& val)
+{
+	switch(val.type())
+	{
+	case Json::nullValue:
+		append_null(out);
+		break;
+	case Json::intValue:
+		append_int(out, val.asLargestInt());
+		break;
+	case Json::uintValue:
+		append_uint(out, val.asLargestUInt());
+		break;
+	case Json::realValue:
+		append_double(out, val.asDouble());
+		break;
+	case Json::booleanValue:
+		append_bool(out, val.asBool());
+		break;
+	case Json::stringValue:
+	{
+		const char* begin;
+		const char* end;
+		if(val.getString(&begin, &end))
+		{
+			append_string(out, begin, end - begin);
+		}
+		break;
+	}
+	default:
+	{
+		Json::FastWriter writer;
+		std::string doc = writer.write(val);
+		out.append(doc, 0, doc.size() - 1);
+		break;
+	}
+	}
+}
@@ -0,0 +1,54 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <json/json.h>
+
+namespace libsinsp
+{
+
+//
+// Helpers that append JSON values to an existing buffer, so that a
+// document can be written without building a Json::Value tree first.
+// The output is byte for byte the one of Json::FastWriter: strings are
+// escaped the same way (non-ASCII characters included) and doubles use
+// the same representation.
+//
+namespace json_writer
+{
+
+void append_string(std::string& out, const char* str, size_t len);
+void append_int(std::string& out, int64_t val);
+void append_uint(std::string& out, uint64_t val);
+void append_double(std::string& out, double val);
+void append_bool(std::string& out, bool val);
+void append_null(std::string& out);
+
+//
+// Append a Json::Value. Scalars are written directly, while arrays and
+// objects go through Json::FastWriter.
+//
+void append_value(std::string& out, const Json::Value& val);
+
+}
+
+}
@@ -69,6 +69,8 @@ sinsp_parser::sinsp_parser(sinsp *inspector) :
 
 	init_metaevt(m_k8s_metaevents_state, PPME_K8S_E, SP_EVT_BUF_SIZE);
 	init_metaevt(m_mesos_metaevents_state, PPME_MESOS_E, SP_EVT_BUF_SIZE);
+
+	init_event_dispatch();
 }
 
 sinsp_parser::~sinsp_parser()
@@ -78,12 +80,6 @@ sinsp_parser::~sinsp_parser()
 		delete m_protodecoders[j];
 	}
 
-	while(!m_tmp_events_buffer.empty())
-	{
-		auto ptr = m_tmp_events_buffer.top();
-		free(ptr);
-		m_tmp_events_buffer.pop();
-	}
 	m_protodecoders.clear();
 
 	free(m_k8s_metaevents_state.m_piscapevt);
@@ -95,6 +91,248 @@ sinsp_parser::~sinsp_parser()
 	}
 }
 
+void sinsp_parser::add_event_parser(std::initializer_list<ppm_event_code> etypes, parse_fn parser)
+{
+	for(ppm_event_code etype : etypes)
+	{
+		auto& parsers = m_event_dispatch[etype].m_parsers;
+		size_t j = 0;
+		while(parsers[j] != nullptr)
+		{
+			j++;
+			ASSERT(j < MAX_EVENT_PARSERS);
+		}
+		parsers[j] = parser;
+	}
+}
+
+void sinsp_parser::init_event_dispatch()
+{
+	for(size_t etype = 0; etype < PPM_EVENT_MAX; etype++)
+	{
+		const ppm_event_info& info = g_infotables.m_event_info[etype];
+		event_dispatch& dispatch = m_event_dispatch[etype];
+
+		dispatch.m_reset_flags = 0;
+		for(size_t j = 0; j < MAX_EVENT_PARSERS; j++)
+		{
+			dispatch.m_parsers[j] = nullptr;
+		}
+
+		if(info.flags & EF_SKIPPARSERESET)
+		{
+			dispatch.m_reset_flags |= RESET_SKIP;
+		}
+		if(info.flags & EF_USES_FD)
+		{
+			dispatch.m_reset_flags |= RESET_USES_FD;
+		}
+		if(info.nparams != 0 &&
+		   (strcmp(info.params[0].name, "res") == 0 || strcmp(info.params[0].name, "fd") == 0))
+		{
+			dispatch.m_reset_flags |= RESET_ERROR_PARAM;
+		}
+	}
+
+	//
+	// If we're exiting a clone or if we have a scheduler event
+	// (many kernel thread), we don't look for /proc
+	//
+	const std::initializer_list<ppm_event_code> clone_exits = {
+		PPME_SYSCALL_CLONE_11_X,
+		PPME_SYSCALL_CLONE_16_X,
+		PPME_SYSCALL_CLONE_17_X,
+		PPME_SYSCALL_CLONE_20_X,
+		PPME_SYSCALL_FORK_X,
+		PPME_SYSCALL_FORK_17_X,
+		PPME_SYSCALL_FORK_20_X,
+		PPME_SYSCALL_VFORK_X,
+		PPME_SYSCALL_VFORK_17_X,
+		PPME_SYSCALL_VFORK_20_X,
+		PPME_SYSCALL_CLONE3_X};
+	for(ppm_event_code etype : clone_exits)
+	{
+		m_event_dispatch[etype].m_reset_flags |= RESET_NO_QUERY_OS | RESET_CLONE_EXIT;
+	}
+	m_event_dispatch[PPME_SCHEDSWITCH_6_E].m_reset_flags |= RESET_NO_QUERY_OS;
+	// If we received a `procexit` event it means that the process
+	// is dead in the kernel, `query_os==true` would just generate fake entries.
+	m_event_dispatch[PPME_PROCEXIT_E].m_reset_flags |= RESET_NO_QUERY_OS;
+	m_event_dispatch[PPME_PROCEXIT_1_E].m_reset_flags |= RESET_NO_QUERY_OS;
+
+	// todo(jasondellaluce): should we do this for all meta-events in general? (mesos and k8s too?)
+	for(ppm_event_code etype : {PPME_CONTAINER_JSON_E,
+				    PPME_CONTAINER_JSON_2_E,
+				    PPME_USER_ADDED_E,
+				    PPME_USER_DELETED_E,
+				    PPME_GROUP_ADDED_E,
+				    PPME_GROUP_DELETED_E,
+				    PPME_PLUGINEVENT_E,
+				    PPME_ASYNCEVENT_E})
+	{
+		m_event_dispatch[etype].m_reset_flags |= RESET_NO_THREAD;
+	}
+
+	//
+	// Parsers, in the order they run for the same event
+	//
+	add_event_parser({PPME_SOCKET_SENDTO_E}, &sinsp_parser::parse_sendto_enter);
+	add_event_parser({PPME_SOCKET_SENDTO_E,
+			  PPME_SYSCALL_OPEN_E,
+			  PPME_SYSCALL_CREAT_E,
+			  PPME_SYSCALL_OPENAT_E,
+			  PPME_SYSCALL_OPENAT_2_E,
+			  PPME_SYSCALL_OPENAT2_E,
+			  PPME_SOCKET_SOCKET_E,
+			  PPME_SYSCALL_EVENTFD_E,
+			  PPME_SYSCALL_EVENTFD2_E,
+			  PPME_SYSCALL_CHDIR_E,
+			  PPME_SYSCALL_FCHDIR_E,
+			  PPME_SYSCALL_LINK_E,
+			  PPME_SYSCALL_LINKAT_E,
+			  PPME_SYSCALL_MKDIR_E,
+			  PPME_SYSCALL_RMDIR_E,
+			  PPME_SOCKET_SHUTDOWN_E,
+			  PPME_SYSCALL_GETRLIMIT_E,
+			  PPME_SYSCALL_SETRLIMIT_E,
+			  PPME_SYSCALL_PRLIMIT_E,
+			  PPME_SOCKET_SENDMSG_E,
+			  PPME_SYSCALL_SENDFILE_E,
+			  PPME_SYSCALL_SETRESUID_E,
+			  PPME_SYSCALL_SETRESGID_E,
+			  PPME_SYSCALL_SETUID_E,
+			  PPME_SYSCALL_SETGID_E,
+			  PPME_SYSCALL_SETPGID_E,
+			  PPME_SYSCALL_UNLINK_E,
+			  PPME_SYSCALL_UNLINKAT_E,
+			  PPME_SYSCALL_EXECVE_18_E,
+			  PPME_SYSCALL_EXECVE_19_E,
+			  PPME_SYSCALL_EXECVEAT_E,
+			  PPME_SYSCALL_UNSHARE_E,
+			  PPME_SYSCALL_SETNS_E},
+			 &sinsp_parser::store_event);
+	add_event_parser({PPME_SYSCALL_MKDIR_X,
+			  PPME_SYSCALL_RMDIR_X,
+			  PPME_SYSCALL_LINK_X,
+			  PPME_SYSCALL_LINKAT_X,
+			  PPME_SYSCALL_UNLINK_X,
+			  PPME_SYSCALL_UNLINKAT_X,
+			  PPME_SYSCALL_OPENAT_X},
+			 &sinsp_parser::parse_fspath_related_exit);
+	add_event_parser({PPME_SYSCALL_READ_X,
+			  PPME_SYSCALL_WRITE_X,
+			  PPME_SOCKET_RECV_X,
+			  PPME_SOCKET_SEND_X,
+			  PPME_SOCKET_RECVFROM_X,
+			  PPME_SOCKET_RECVMSG_X,
+			  PPME_SOCKET_SENDTO_X,
+			  PPME_SOCKET_SENDMSG_X,
+			  PPME_SYSCALL_READV_X,
+			  PPME_SYSCALL_WRITEV_X,
+			  PPME_SYSCALL_PREAD_X,
+			  PPME_SYSCALL_PWRITE_X,
+			  PPME_SYSCALL_PREADV_X,
+			  PPME_SYSCALL_PWRITEV_X},
+			 &sinsp_parser::parse_rw_exit);
+	add_event_parser({PPME_SYSCALL_SENDFILE_X}, &sinsp_parser::parse_sendfile_exit);
+	add_event_parser({PPME_SYSCALL_OPEN_X,
+			  PPME_SYSCALL_CREAT_X,
+			  PPME_SYSCALL_OPENAT_X,
+			  PPME_SYSCALL_OPENAT_2_X,
+			  PPME_SYSCALL_OPENAT2_X,
+			  PPME_SYSCALL_OPEN_BY_HANDLE_AT_X},
+			 &sinsp_parser::parse_open_openat_creat_exit);
+	add_event_parser({PPME_SYSCALL_FCHMOD_X, PPME_SYSCALL_FCHOWN_X}, &sinsp_parser::parse_fchmod_fchown_exit);
+	add_event_parser({PPME_SYSCALL_SELECT_E,
+			  PPME_SYSCALL_POLL_E,
+			  PPME_SYSCALL_PPOLL_E,
+			  PPME_SYSCALL_EPOLLWAIT_E},
+			 &sinsp_parser::parse_select_poll_epollwait_enter);
+	add_event_parser({PPME_SYSCALL_UNSHARE_X, PPME_SYSCALL_SETNS_X}, &sinsp_parser::parse_unshare_setns_exit);
+	add_event_parser({PPME_SYSCALL_MEMFD_CREATE_X},
+			 &sinsp_parser::parse_fd_type_exit<&sinsp_parser::parse_memfd_create_exit, SCAP_FD_MEMFD>);
+	add_event_parser(clone_exits, &sinsp_parser::parse_clone_exit);
+	add_event_parser({PPME_SYSCALL_PIDFD_OPEN_X}, &sinsp_parser::parse_pidfd_open_exit);
+	add_event_parser({PPME_SYSCALL_PIDFD_GETFD_X}, &sinsp_parser::parse_pidfd_getfd_exit);
+	add_event_parser({PPME_SYSCALL_EXECVE_8_X,
+			  PPME_SYSCALL_EXECVE_13_X,
+			  PPME_SYSCALL_EXECVE_14_X,
+			  PPME_SYSCALL_EXECVE_15_X,
+			  PPME_SYSCALL_EXECVE_16_X,
+			  PPME_SYSCALL_EXECVE_17_X,
+			  PPME_SYSCALL_EXECVE_18_X,
+			  PPME_SYSCALL_EXECVE_19_X,
+			  PPME_SYSCALL_EXECVEAT_X},
+			 &sinsp_parser::parse_execve_exit);
+	add_event_parser({PPME_PROCEXIT_E, PPME_PROCEXIT_1_E}, &sinsp_parser::parse_thread_exit);
+	add_event_parser({PPME_SYSCALL_PIPE_X, PPME_SYSCALL_PIPE2_X}, &sinsp_parser::parse_pipe_exit);
+	add_event_parser({PPME_SOCKET_SOCKET_X}, &sinsp_parser::parse_socket_exit);
+	add_event_parser({PPME_SOCKET_BIND_X}, &sinsp_parser::parse_bind_exit);
+	add_event_parser({PPME_SOCKET_CONNECT_E}, &sinsp_parser::parse_connect_enter);
+	add_event_parser({PPME_SOCKET_CONNECT_X}, &sinsp_parser::parse_connect_exit);
+	add_event_parser({PPME_SOCKET_ACCEPT_X,
+			  PPME_SOCKET_ACCEPT_5_X,
+			  PPME_SOCKET_ACCEPT4_X,
+			  PPME_SOCKET_ACCEPT4_5_X,
+			  PPME_SOCKET_ACCEPT4_6_X},
+			 &sinsp_parser::parse_accept_exit);
+	add_event_parser({PPME_SYSCALL_CLOSE_E}, &sinsp_parser::parse_close_enter);
+	add_event_parser({PPME_SYSCALL_CLOSE_X}, &sinsp_parser::parse_close_exit);
+	add_event_parser({PPME_SYSCALL_FCNTL_E}, &sinsp_parser::parse_fcntl_enter);
+	add_event_parser({PPME_SYSCALL_FCNTL_X}, &sinsp_parser::parse_fcntl_exit);
+	add_event_parser({PPME_SYSCALL_EVENTFD_X, PPME_SYSCALL_EVENTFD2_X}, &sinsp_parser::parse_eventfd_exit);
+	add_event_parser({PPME_SYSCALL_CHDIR_X}, &sinsp_parser::parse_chdir_exit);
+	add_event_parser({PPME_SYSCALL_FCHDIR_X}, &sinsp_parser::parse_fchdir_exit);
+	add_event_parser({PPME_SYSCALL_GETCWD_X}, &sinsp_parser::parse_getcwd_exit);
+	add_event_parser({PPME_SOCKET_SHUTDOWN_X}, &sinsp_parser::parse_shutdown_exit);
+	add_event_parser({PPME_SYSCALL_DUP_X,
+			  PPME_SYSCALL_DUP_1_X,
+			  PPME_SYSCALL_DUP2_X,
+			  PPME_SYSCALL_DUP3_X},
+			 &sinsp_parser::parse_dup_exit);
+	add_event_parser({PPME_SYSCALL_SIGNALFD_X, PPME_SYSCALL_SIGNALFD4_X},
+			 &sinsp_parser::parse_fd_type_exit<&sinsp_parser::parse_single_param_fd_exit, SCAP_FD_SIGNALFD>);
+	add_event_parser({PPME_SYSCALL_TIMERFD_CREATE_X},
+			 &sinsp_parser::parse_fd_type_exit<&sinsp_parser::parse_single_param_fd_exit, SCAP_FD_TIMERFD>);
+	add_event_parser({PPME_SYSCALL_INOTIFY_INIT_X, PPME_SYSCALL_INOTIFY_INIT1_X},
+			 &sinsp_parser::parse_fd_type_exit<&sinsp_parser::parse_single_param_fd_exit, SCAP_FD_INOTIFY>);
+	add_event_parser({PPME_SYSCALL_BPF_2_X},
+			 &sinsp_parser::parse_fd_type_exit<&sinsp_parser::parse_single_param_fd_exit, SCAP_FD_BPF>);
+	add_event_parser({PPME_SYSCALL_USERFAULTFD_X},
+			 &sinsp_parser::parse_fd_type_exit<&sinsp_parser::parse_single_param_fd_exit, SCAP_FD_USERFAULTFD>);
+	add_event_parser({PPME_SYSCALL_IO_URING_SETUP_X},
+			 &sinsp_parser::parse_fd_type_exit<&sinsp_parser::parse_single_param_fd_exit, SCAP_FD_IOURING>);
+	add_event_parser({PPME_SYSCALL_EPOLL_CREATE_X, PPME_SYSCALL_EPOLL_CREATE1_X},
+			 &sinsp_parser::parse_fd_type_exit<&sinsp_parser::parse_single_param_fd_exit, SCAP_FD_EVENTPOLL>);
+	add_event_parser({PPME_SYSCALL_GETRLIMIT_X, PPME_SYSCALL_SETRLIMIT_X}, &sinsp_parser::parse_getrlimit_setrlimit_exit);
+	add_event_parser({PPME_SYSCALL_PRLIMIT_X}, &sinsp_parser::parse_prlimit_exit);
+	add_event_parser({PPME_SOCKET_SOCKETPAIR_X}, &sinsp_parser::parse_socketpair_exit);
+	add_event_parser({PPME_SCHEDSWITCH_1_E, PPME_SCHEDSWITCH_6_E}, &sinsp_parser::parse_context_switch);
+	add_event_parser({PPME_SYSCALL_BRK_4_X,
+			  PPME_SYSCALL_MMAP_X,
+			  PPME_SYSCALL_MMAP2_X,
+			  PPME_SYSCALL_MUNMAP_X},
+			 &sinsp_parser::parse_brk_munmap_mmap_exit);
+	add_event_parser({PPME_SYSCALL_SETRESUID_X}, &sinsp_parser::parse_setresuid_exit);
+	add_event_parser({PPME_SYSCALL_SETRESGID_X}, &sinsp_parser::parse_setresgid_exit);
+	add_event_parser({PPME_SYSCALL_SETUID_X}, &sinsp_parser::parse_setuid_exit);
+	add_event_parser({PPME_SYSCALL_SETGID_X}, &sinsp_parser::parse_setgid_exit);
+	add_event_parser({PPME_CONTAINER_E}, &sinsp_parser::parse_container_evt); // deprecated, only here for backwards compatibility
+	add_event_parser({PPME_CONTAINER_JSON_E, PPME_CONTAINER_JSON_2_E}, &sinsp_parser::parse_container_json_evt);
+	add_event_parser({PPME_CPU_HOTPLUG_E}, &sinsp_parser::parse_cpu_hotplug_enter);
+#if !defined(CYGWING_AGENT) && !defined(MINIMAL_BUILD) && !defined(__EMSCRIPTEN__)
+	add_event_parser({PPME_K8S_E}, &sinsp_parser::parse_k8s_evt);
+	add_event_parser({PPME_MESOS_E}, &sinsp_parser::parse_mesos_evt);
+#endif // #if !defined(CYGWING_AGENT) && !defined(MINIMAL_BUILD)
+	add_event_parser({PPME_SYSCALL_CHROOT_X}, &sinsp_parser::parse_chroot_exit);
+	add_event_parser({PPME_SYSCALL_SETSID_X}, &sinsp_parser::parse_setsid_exit);
+	add_event_parser({PPME_SOCKET_GETSOCKOPT_X}, &sinsp_parser::parse_getsockopt_exit);
+	add_event_parser({PPME_SYSCALL_CAPSET_X}, &sinsp_parser::parse_capset_exit);
+	add_event_parser({PPME_USER_ADDED_E, PPME_USER_DELETED_E}, &sinsp_parser::parse_user_evt);
+	add_event_parser({PPME_GROUP_ADDED_E, PPME_GROUP_DELETED_E}, &sinsp_parser::parse_group_evt);
+	add_event_parser({PPME_SYSCALL_PRCTL_X}, &sinsp_parser::parse_prctl_exit_event);
+}
+
 void sinsp_parser::init_scapevt(metaevents_state& evt_state, uint16_t evt_type, uint16_t buf_size)
 {
 	scap_evt *new_piscapevt = (scap_evt*) realloc(evt_state.m_piscapevt, buf_size);
@@ -223,322 +461,31 @@ void sinsp_parser::process_event(sinsp_evt *evt)
 	evt->m_filtered_out = false;
 
 	//
-	// Route the event to the proper function
+	// Writes to the tracer fds are consumed by the tracers
 	//
-	switch(etype)
+	if(etype == PPME_SYSCALL_WRITE_E && !m_inspector->m_is_dumping && evt->m_tinfo != nullptr)
 	{
-	case PPME_SOCKET_SENDTO_E:
-		if((evt->m_fdinfo == nullptr) && (evt->m_tinfo != nullptr))
-		{
-			infer_sendto_fdinfo(evt);
-		}
-
-		// FALLTHRU
-	case PPME_SYSCALL_OPEN_E:
-	case PPME_SYSCALL_CREAT_E:
-	case PPME_SYSCALL_OPENAT_E:
-	case PPME_SYSCALL_OPENAT_2_E:
-	case PPME_SYSCALL_OPENAT2_E:
-	case PPME_SOCKET_SOCKET_E:
-	case PPME_SYSCALL_EVENTFD_E:
-	case PPME_SYSCALL_EVENTFD2_E:
-	case PPME_SYSCALL_CHDIR_E:
-	case PPME_SYSCALL_FCHDIR_E:
-	case PPME_SYSCALL_LINK_E:
-	case PPME_SYSCALL_LINKAT_E:
-	case PPME_SYSCALL_MKDIR_E:
-	case PPME_SYSCALL_RMDIR_E:
-	case PPME_SOCKET_SHUTDOWN_E:
-	case PPME_SYSCALL_GETRLIMIT_E:
-	case PPME_SYSCALL_SETRLIMIT_E:
-	case PPME_SYSCALL_PRLIMIT_E:
-	case PPME_SOCKET_SENDMSG_E:
-	case PPME_SYSCALL_SENDFILE_E:
-	case PPME_SYSCALL_SETRESUID_E:
-	case PPME_SYSCALL_SETRESGID_E:
-	case PPME_SYSCALL_SETUID_E:
-	case PPME_SYSCALL_SETGID_E:
-	case PPME_SYSCALL_SETPGID_E:
-	case PPME_SYSCALL_UNLINK_E:
-	case PPME_SYSCALL_UNLINKAT_E:
-	case PPME_SYSCALL_EXECVE_18_E:
-	case PPME_SYSCALL_EXECVE_19_E:
-	case PPME_SYSCALL_EXECVEAT_E:
-		store_event(evt);
-		break;
-	case PPME_SYSCALL_WRITE_E:
-		if(!m_inspector->m_is_dumping && evt->m_tinfo != nullptr)
+		evt->m_fdinfo = evt->m_tinfo->get_fd(evt->m_tinfo->m_lastevent_fd);
+		if(evt->m_fdinfo)
 		{
-			evt->m_fdinfo = evt->m_tinfo->get_fd(evt->m_tinfo->m_lastevent_fd);
-			if(evt->m_fdinfo)
+			if(evt->m_fdinfo->m_flags & sinsp_fdinfo_t::FLAGS_IS_TRACER_FD)
 			{
-				if(evt->m_fdinfo->m_flags & sinsp_fdinfo_t::FLAGS_IS_TRACER_FD)
-				{
-					evt->m_filtered_out = true;
-					return;
-				}
+				evt->m_filtered_out = true;
+				return;
 			}
 		}
-		break;
-	case PPME_SYSCALL_MKDIR_X:
-	case PPME_SYSCALL_RMDIR_X:
-	case PPME_SYSCALL_LINK_X:
-	case PPME_SYSCALL_LINKAT_X:
-	case PPME_SYSCALL_UNLINK_X:
-	case PPME_SYSCALL_UNLINKAT_X:
-		parse_fspath_related_exit(evt);
-		break;
-	case PPME_SYSCALL_READ_X:
-	case PPME_SYSCALL_WRITE_X:
-	case PPME_SOCKET_RECV_X:
-	case PPME_SOCKET_SEND_X:
-	case PPME_SOCKET_RECVFROM_X:
-	case PPME_SOCKET_RECVMSG_X:
-	case PPME_SOCKET_SENDTO_X:
-	case PPME_SOCKET_SENDMSG_X:
-	case PPME_SYSCALL_READV_X:
-	case PPME_SYSCALL_WRITEV_X:
-	case PPME_SYSCALL_PREAD_X:
-	case PPME_SYSCALL_PWRITE_X:
-	case PPME_SYSCALL_PREADV_X:
-	case PPME_SYSCALL_PWRITEV_X:
-		parse_rw_exit(evt);
-		break;
-	case PPME_SYSCALL_SENDFILE_X:
-		parse_sendfile_exit(evt);
-		break;
-	case PPME_SYSCALL_OPEN_X:
-	case PPME_SYSCALL_CREAT_X:
-	case PPME_SYSCALL_OPENAT_2_X:
-	case PPME_SYSCALL_OPENAT2_X:
-	case PPME_SYSCALL_OPEN_BY_HANDLE_AT_X:
-		parse_open_openat_creat_exit(evt);
-		break;
-	case PPME_SYSCALL_FCHMOD_X:
-	case PPME_SYSCALL_FCHOWN_X:
-		parse_fchmod_fchown_exit(evt);
-		break;
-	case PPME_SYSCALL_OPENAT_X:
-		parse_fspath_related_exit(evt);
-		parse_open_openat_creat_exit(evt);
-		break;
-	case PPME_SYSCALL_SELECT_E:
-	case PPME_SYSCALL_POLL_E:
-	case PPME_SYSCALL_PPOLL_E:
-	case PPME_SYSCALL_EPOLLWAIT_E:
-		parse_select_poll_epollwait_enter(evt);
-		break;
-	case PPME_SYSCALL_UNSHARE_E:
-	case PPME_SYSCALL_SETNS_E:
-		store_event(evt);
-		break;
-	case PPME_SYSCALL_UNSHARE_X:
-	case PPME_SYSCALL_SETNS_X:
-		parse_unshare_setns_exit(evt);
-		break;
-	case PPME_SYSCALL_MEMFD_CREATE_X:
-		parse_memfd_create_exit(evt, SCAP_FD_MEMFD);
-		break;
-	case PPME_SYSCALL_CLONE_11_X:
-	case PPME_SYSCALL_CLONE_16_X:
-	case PPME_SYSCALL_CLONE_17_X:
-	case PPME_SYSCALL_CLONE_20_X:
-	case PPME_SYSCALL_FORK_X:
-	case PPME_SYSCALL_FORK_17_X:
-	case PPME_SYSCALL_FORK_20_X:
-	case PPME_SYSCALL_VFORK_X:
-	case PPME_SYSCALL_VFORK_17_X:
-	case PPME_SYSCALL_VFORK_20_X:
-	case PPME_SYSCALL_CLONE3_X:
-		parse_clone_exit(evt);
-		break;
-	case PPME_SYSCALL_PIDFD_OPEN_X:
-		parse_pidfd_open_exit(evt);
-		break;
-	case PPME_SYSCALL_PIDFD_GETFD_X:
-		parse_pidfd_getfd_exit(evt);
-		break;
-	case PPME_SYSCALL_EXECVE_8_X:
-	case PPME_SYSCALL_EXECVE_13_X:
-	case PPME_SYSCALL_EXECVE_14_X:
-	case PPME_SYSCALL_EXECVE_15_X:
-	case PPME_SYSCALL_EXECVE_16_X:
-	case PPME_SYSCALL_EXECVE_17_X:
-	case PPME_SYSCALL_EXECVE_18_X:
-	case PPME_SYSCALL_EXECVE_19_X:
-    case PPME_SYSCALL_EXECVEAT_X:
-		parse_execve_exit(evt);
-		break;
-	case PPME_PROCEXIT_E:
-	case PPME_PROCEXIT_1_E:
-		parse_thread_exit(evt);
-		break;
-	case PPME_SYSCALL_PIPE_X:
-	case PPME_SYSCALL_PIPE2_X:
-		parse_pipe_exit(evt);
-		break;
+	}
 
-	case PPME_SOCKET_SOCKET_X:
-		parse_socket_exit(evt);
-		break;
-	case PPME_SOCKET_BIND_X:
-		parse_bind_exit(evt);
-		break;
-	case PPME_SOCKET_CONNECT_E:
-		parse_connect_enter(evt);
-		break;
-	case PPME_SOCKET_CONNECT_X:
-		parse_connect_exit(evt);
-		break;
-	case PPME_SOCKET_ACCEPT_X:
-	case PPME_SOCKET_ACCEPT_5_X:
-	case PPME_SOCKET_ACCEPT4_X:
-	case PPME_SOCKET_ACCEPT4_5_X:
-	case PPME_SOCKET_ACCEPT4_6_X:
-		parse_accept_exit(evt);
-		break;
-	case PPME_SYSCALL_CLOSE_E:
-		parse_close_enter(evt);
-		break;
-	case PPME_SYSCALL_CLOSE_X:
-		parse_close_exit(evt);
-		break;
-	case PPME_SYSCALL_FCNTL_E:
-		parse_fcntl_enter(evt);
-		break;
-	case PPME_SYSCALL_FCNTL_X:
-		parse_fcntl_exit(evt);
-		break;
-	case PPME_SYSCALL_EVENTFD_X:
-	case PPME_SYSCALL_EVENTFD2_X:
-		parse_eventfd_exit(evt);
-		break;
-	case PPME_SYSCALL_CHDIR_X:
-		parse_chdir_exit(evt);
-		break;
-	case PPME_SYSCALL_FCHDIR_X:
-		parse_fchdir_exit(evt);
-		break;
-	case PPME_SYSCALL_GETCWD_X:
-		parse_getcwd_exit(evt);
-		break;
-	case PPME_SOCKET_SHUTDOWN_X:
-		parse_shutdown_exit(evt);
-		break;
-	case PPME_SYSCALL_DUP_X:
-	case PPME_SYSCALL_DUP_1_X:
-	case PPME_SYSCALL_DUP2_X:
-	case PPME_SYSCALL_DUP3_X:
-		parse_dup_exit(evt);
-		break;
-	case PPME_SYSCALL_SIGNALFD_X:
-	case PPME_SYSCALL_SIGNALFD4_X:
-		parse_single_param_fd_exit(evt, SCAP_FD_SIGNALFD);
-		break;
-	case PPME_SYSCALL_TIMERFD_CREATE_X:
-		parse_single_param_fd_exit(evt, SCAP_FD_TIMERFD);
-		break;
-	case PPME_SYSCALL_INOTIFY_INIT_X:
-	case PPME_SYSCALL_INOTIFY_INIT1_X:
-		parse_single_param_fd_exit(evt, SCAP_FD_INOTIFY);
-		break;
-	case PPME_SYSCALL_BPF_2_X:
-		parse_single_param_fd_exit(evt, SCAP_FD_BPF);
-		break;
-	case PPME_SYSCALL_USERFAULTFD_X:
-		parse_single_param_fd_exit(evt, SCAP_FD_USERFAULTFD);
-		break;
-	case PPME_SYSCALL_IO_URING_SETUP_X:
-		parse_single_param_fd_exit(evt, SCAP_FD_IOURING);
-		break;
-	case PPME_SYSCALL_EPOLL_CREATE_X:
-	case PPME_SYSCALL_EPOLL_CREATE1_X:
-		parse_single_param_fd_exit(evt, SCAP_FD_EVENTPOLL);
-		break;
-	case PPME_SYSCALL_GETRLIMIT_X:
-	case PPME_SYSCALL_SETRLIMIT_X:
-		parse_getrlimit_setrlimit_exit(evt);
-		break;
-	case PPME_SYSCALL_PRLIMIT_X:
-		parse_prlimit_exit(evt);
-		break;
-	case PPME_SOCKET_SOCKETPAIR_X:
-		parse_socketpair_exit(evt);
-		break;
-	case PPME_SCHEDSWITCH_1_E:
-	case PPME_SCHEDSWITCH_6_E:
-		parse_context_switch(evt);
-		break;
-	case PPME_SYSCALL_BRK_4_X:
-	case PPME_SYSCALL_MMAP_X:
-	case PPME_SYSCALL_MMAP2_X:
-	case PPME_SYSCALL_MUNMAP_X:
-		parse_brk_munmap_mmap_exit(evt);
-		break;
-	case PPME_SYSCALL_SETRESUID_X:
-		parse_setresuid_exit(evt);
-		break;
-	case PPME_SYSCALL_SETRESGID_X:
-		parse_setresgid_exit(evt);
-		break;
-	case PPME_SYSCALL_SETUID_X:
-		parse_setuid_exit(evt);
-		break;
-	case PPME_SYSCALL_SETGID_X:
-		parse_setgid_exit(evt);
-		break;
-	case PPME_CONTAINER_E:
-		parse_container_evt(evt); // deprecated, only here for backwards compatibility
-		break;
-	case PPME_CONTAINER_JSON_E:
-	case PPME_CONTAINER_JSON_2_E:
-		parse_container_json_evt(evt);
-		break;
-	case PPME_CPU_HOTPLUG_E:
-		parse_cpu_hotplug_enter(evt);
-		break;
-#if !defined(CYGWING_AGENT) && !defined(MINIMAL_BUILD) && !defined(__EMSCRIPTEN__)
-	case PPME_K8S_E:
-		if(m_inspector->is_capture())
-		{
-			parse_k8s_evt(evt);
-		}
-		break;
-	case PPME_MESOS_E:
-		if(m_inspector->is_capture())
-		{
-			parse_mesos_evt(evt);
-		}
-		break;
-#endif // #if !defined(CYGWING_AGENT) && !defined(MINIMAL_BUILD)
-	case PPME_SYSCALL_CHROOT_X:
-		parse_chroot_exit(evt);
-		break;
-	case PPME_SYSCALL_SETSID_X:
-		parse_setsid_exit(evt);
-		break;
-	case PPME_SOCKET_GETSOCKOPT_X:
-		if(evt->get_num_params() > 0)
+	//
+	// Route the event to the proper functions
+	//
+	for(parse_fn parser : m_event_dispatch[etype].m_parsers)
+	{
+		if(parser == nullptr)
 		{
-			parse_getsockopt_exit(evt);
+			break;
 		}
-		break;
-	case PPME_SYSCALL_CAPSET_X:
-		parse_capset_exit(evt);
-		break;
-	case PPME_USER_ADDED_E:
-	case PPME_USER_DELETED_E:
-		parse_user_evt(evt);
-		break;
-	case PPME_GROUP_ADDED_E:
-	case PPME_GROUP_DELETED_E:
-		parse_group_evt(evt);
-		break;
-	case PPME_SYSCALL_PRCTL_X:
-		parse_prctl_exit_event(evt);
-		break;		
-	default:
-		break;
+		(this->*parser)(evt);
 	}
 
 	//
@@ -686,7 +633,7 @@ bool sinsp_parser::reset(sinsp_evt *evt)
 		return true;
 	}
 
-	ppm_event_flags eflags = evt->get_info_flags();
+	const uint32_t reset_flags = m_event_dispatch[etype].m_reset_flags;
 
 	evt->m_fdinfo = NULL;
 	evt->m_errorcode = 0;
@@ -694,7 +641,7 @@ bool sinsp_parser::reset(sinsp_evt *evt)
 	//
 	// Ignore scheduler events
 	//
-	if(eflags & EF_SKIPPARSERESET)
+	if(reset_flags & RESET_SKIP)
 	{
 		if(etype == PPME_PROCINFO_E)
 		{
@@ -711,54 +658,14 @@ bool sinsp_parser::reset(sinsp_evt *evt)
 	//
 	// Find the thread info
 	//
-
-	//
-	// If we're exiting a clone or if we have a scheduler event
-	// (many kernel thread), we don't look for /proc
-	//
-	bool query_os;
-	if(etype == PPME_SYSCALL_CLONE_11_X ||
-		etype == PPME_SYSCALL_CLONE_16_X ||
-		etype == PPME_SYSCALL_CLONE_17_X ||
-		etype == PPME_SYSCALL_CLONE_20_X ||
-		etype == PPME_SYSCALL_FORK_X ||
-		etype == PPME_SYSCALL_FORK_17_X ||
-		etype == PPME_SYSCALL_FORK_20_X ||
-		etype == PPME_SYSCALL_VFORK_X ||
-		etype == PPME_SYSCALL_VFORK_17_X ||
-		etype == PPME_SYSCALL_VFORK_20_X ||
-		etype == PPME_SYSCALL_CLONE3_X ||
-		etype == PPME_SCHEDSWITCH_6_E ||
-		/* If we received a `procexit` event it means that the process
-		 * is dead in the kernel, `query_os==true` would just generate fake entries.
-		 */
-		etype == PPME_PROCEXIT_E ||
-		etype == PPME_PROCEXIT_1_E)
-	{
-		query_os = false;
-	}
-	else
-	{
-		query_os = true;
-	}
-
-	// todo(jasondellaluce): should we do this for all meta-events in general? (mesos and k8s too?)
-	if(etype == PPME_CONTAINER_JSON_E ||
-	   etype == PPME_CONTAINER_JSON_2_E ||
-	   etype == PPME_USER_ADDED_E ||
-	   etype == PPME_USER_DELETED_E ||
-	   etype == PPME_GROUP_ADDED_E ||
-	   etype == PPME_GROUP_DELETED_E ||
-	   etype == PPME_PLUGINEVENT_E ||
-	   etype == PPME_ASYNCEVENT_E)
+	if(reset_flags & RESET_NO_THREAD)
 	{
 		evt->m_tinfo = nullptr;
 		return true;
 	}
-	else
-	{
-		evt->m_tinfo = m_inspector->get_thread_ref(evt->m_pevt->tid, query_os, false).get();
-	}
+
+	bool query_os = !(reset_flags & RESET_NO_QUERY_OS);
+	evt->m_tinfo = m_inspector->get_thread_ref(evt->m_pevt->tid, query_os, false).get();
 
 	if(etype == PPME_SCHEDSWITCH_6_E)
 	{
@@ -767,17 +674,7 @@ bool sinsp_parser::reset(sinsp_evt *evt)
 
 	if(!evt->m_tinfo)
 	{
-		if(etype == PPME_SYSCALL_CLONE_11_X ||
-			etype == PPME_SYSCALL_CLONE_16_X ||
-			etype == PPME_SYSCALL_CLONE_17_X ||
-			etype == PPME_SYSCALL_CLONE_20_X ||
-			etype == PPME_SYSCALL_FORK_X ||
-			etype == PPME_SYSCALL_FORK_17_X ||
-			etype == PPME_SYSCALL_FORK_20_X ||
-			etype == PPME_SYSCALL_VFORK_X ||
-			etype == PPME_SYSCALL_VFORK_17_X ||
-			etype == PPME_SYSCALL_VFORK_20_X ||
-			etype == PPME_SYSCALL_CLONE3_X)
+		if(reset_flags & RESET_CLONE_EXIT)
 		{
 #ifdef GATHER_INTERNAL_STATS
 			m_inspector->m_thread_manager->m_failed_lookups->decrement();
@@ -796,7 +693,7 @@ bool sinsp_parser::reset(sinsp_evt *evt)
 		evt->m_tinfo->m_lastevent_fd = -1;
 		evt->m_tinfo->m_lastevent_type = etype;
 
-		if(eflags & EF_USES_FD)
+		if(reset_flags & RESET_USES_FD)
 		{
 			sinsp_evt_param *parinfo;
 
@@ -852,14 +749,7 @@ bool sinsp_parser::reset(sinsp_evt *evt)
 		//
 		// Error detection logic
 		//
-		if(evt->get_num_params() != 0 &&
-			((evt->m_info->params[0].name[0] == 'r' &&
-			  evt->m_info->params[0].name[1] == 'e' &&
-			  evt->m_info->params[0].name[2] == 's' &&
-			  evt->m_info->params[0].name[3] == '\0') ||
-			 (evt->m_info->params[0].name[0] == 'f' &&
-			  evt->m_info->params[0].name[1] == 'd' &&
-			  evt->m_info->params[0].name[2] == '\0')))
+		if((reset_flags & RESET_ERROR_PARAM) && evt->get_num_params() != 0)
 		{
 			sinsp_evt_param *parinfo;
 
@@ -876,7 +766,7 @@ bool sinsp_parser::reset(sinsp_evt *evt)
 		//
 		// Retrieve the fd
 		//
-		if(eflags & EF_USES_FD)
+		if(reset_flags & RESET_USES_FD)
 		{
 			//
 			// The copy_file_range syscall has the peculiarity of using two fds
@@ -963,14 +853,9 @@ void sinsp_parser::store_event(sinsp_evt *evt)
 	// Copy the data
 	//
 	auto tinfo = evt->m_tinfo;
-	if(tinfo->m_lastevent_data == NULL)
+	if(reserve_event_buffer(tinfo, elen) == NULL)
 	{
-		tinfo->m_lastevent_data = reserve_event_buffer();
-		if(tinfo->m_lastevent_data == NULL)
-		{
-			throw sinsp_exception("cannot reserve event buffer in sinsp_parser::store_event.");
-			return;
-		}
+		throw sinsp_exception("cannot reserve event buffer in sinsp_parser::store_event.");
 	}
 	memcpy(tinfo->m_lastevent_data, evt->m_pevt, elen);
 	tinfo->m_lastevent_cpuid = evt->get_cpuid();
@@ -1323,10 +1208,10 @@ void sinsp_parser::parse_clone_exit_caller(sinsp_evt *evt, int64_t child_tid)
 				child_tinfo->m_fdtable = *(fd_table_ptr);
 
 				/* Track down that those are cloned fds */
-				for(auto fdit = child_tinfo->m_fdtable.m_table.begin(); fdit != child_tinfo->m_fdtable.m_table.end(); ++fdit)
-				{
-					fdit->second.set_is_cloned();
-				}
+				child_tinfo->m_fdtable.mutable_loop([](int64_t fd, sinsp_fdinfo_t& fdinfo) {
+					fdinfo.set_is_cloned();
+					return true;
+				});
 
 				/* It's important to reset the cache of the child thread, to prevent it from
 				* referring to an element in the parent's table.
@@ -1946,11 +1831,10 @@ void sinsp_parser::parse_clone_exit_child(sinsp_evt *evt)
 				/* Track down that those are cloned fds.
 				 * This flag `FLAGS_IS_CLONED` seems to be never used...
 				 */
-				for(auto fdit = child_tinfo->m_fdtable.m_table.begin();
-				    fdit != child_tinfo->m_fdtable.m_table.end(); ++fdit)
-				{
-					fdit->second.set_is_cloned();
-				}
+				child_tinfo->m_fdtable.mutable_loop([](int64_t fd, sinsp_fdinfo_t& fdinfo) {
+					fdinfo.set_is_cloned();
+					return true;
+				});
 
 				/* It's important to reset the cache of the child thread, to prevent it from
 				 * referring to an element in the parent's table.
@@ -5566,6 +5450,14 @@ void sinsp_parser::parse_prlimit_exit(sinsp_evt *evt)
 	}
 }
 
+void sinsp_parser::parse_sendto_enter(sinsp_evt *evt)
+{
+	if((evt->m_fdinfo == nullptr) && (evt->m_tinfo != nullptr))
+	{
+		infer_sendto_fdinfo(evt);
+	}
+}
+
 void sinsp_parser::parse_select_poll_epollwait_enter(sinsp_evt *evt)
 {
 	if(evt->m_tinfo == nullptr)
@@ -5574,13 +5466,9 @@ void sinsp_parser::parse_select_poll_epollwait_enter(sinsp_evt *evt)
 		return;
 	}
 
-	if(evt->m_tinfo->m_lastevent_data == NULL)
+	if(reserve_event_buffer(evt->m_tinfo, sizeof(uint64_t)) == NULL)
 	{
-		evt->m_tinfo->m_lastevent_data = reserve_event_buffer();
-		if(evt->m_tinfo->m_lastevent_data == NULL)
-		{
-			throw sinsp_exception("cannot reserve event buffer in sinsp_parser::parse_select_poll_epollwait_enter.");
-		}
+		throw sinsp_exception("cannot reserve event buffer in sinsp_parser::parse_select_poll_epollwait_enter.");
 	}
 	*(uint64_t*)evt->m_tinfo->m_lastevent_data = evt->get_ts();
 }
@@ -6252,18 +6140,23 @@ void sinsp_parser::parse_prctl_exit_event(sinsp_evt *evt)
 }
 
 
-uint8_t* sinsp_parser::reserve_event_buffer()
+//
+// Make sure that the thread has a buffer of at least size bytes for its
+// enter event. The buffer keeps its content only if it was big enough.
+//
+uint8_t* sinsp_parser::reserve_event_buffer(sinsp_threadinfo* tinfo, size_t size)
 {
-	if(m_tmp_events_buffer.empty())
-	{
-		return (uint8_t*)malloc(sizeof(uint8_t)*SP_EVT_BUF_SIZE);
-	}
-	else
+	if(tinfo->m_lastevent_data != NULL)
 	{
-		auto ptr = m_tmp_events_buffer.top();
-		m_tmp_events_buffer.pop();
-		return ptr;
+		if(libsinsp::evt_buffer_arena::capacity(tinfo->m_lastevent_data) >= size)
+		{
+			return tinfo->m_lastevent_data;
+		}
+		free_event_buffer(tinfo->m_lastevent_data);
 	}
+
+	tinfo->m_lastevent_data = m_evt_buffer_arena.reserve(size);
+	return tinfo->m_lastevent_data;
 }
 
 #if !defined(CYGWING_AGENT) && !defined(MINIMAL_BUILD) && !defined(__EMSCRIPTEN__)
@@ -6309,6 +6202,12 @@ int sinsp_parser::get_k8s_version(const std::string& json)
 
 void sinsp_parser::parse_k8s_evt(sinsp_evt *evt)
 {
+	// the k8s state is only replayed from capture files
+	if(!m_inspector->is_capture())
+	{
+		return;
+	}
+
 	sinsp_evt_param *parinfo = evt->get_param(0);
 	ASSERT(parinfo);
 	ASSERT(parinfo->m_len > 0);
@@ -6335,6 +6234,12 @@ void sinsp_parser::parse_k8s_evt(sinsp_evt *evt)
 
 void sinsp_parser::parse_mesos_evt(sinsp_evt *evt)
 {
+	// the mesos state is only replayed from capture files
+	if(!m_inspector->is_capture())
+	{
+		return;
+	}
+
 	sinsp_evt_param *parinfo = evt->get_param(0);
 	ASSERT(parinfo);
 	ASSERT(parinfo->m_len > 0);
@@ -6407,6 +6312,11 @@ void sinsp_parser::parse_getsockopt_exit(sinsp_evt *evt)
 	int64_t fd;
 	int8_t level, optname;
 
+	if(evt->get_num_params() == 0)
+	{
+		return;
+	}
+
 	if(evt->m_tinfo == nullptr)
 	{
 		return;
@@ -6573,14 +6483,7 @@ void sinsp_parser::parse_unshare_setns_exit(sinsp_evt *evt)
 
 void sinsp_parser::free_event_buffer(uint8_t *ptr)
 {
-	if(m_tmp_events_buffer.size() < m_inspector->m_thread_manager->m_threadtable.size())
-	{
-		m_tmp_events_buffer.push(ptr);
-	}
-	else
-	{
-		free(ptr);
-	}
+	libsinsp::evt_buffer_arena::release(ptr);
 }
 
 void sinsp_parser::parse_memfd_create_exit(sinsp_evt *evt, scap_fd_type type)
@@ -20,6 +20,7 @@ limitations under the License.
 ////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "sinsp.h"
+#include "evt_buffer_arena.h"
 
 class metaevents_state
 {
@@ -78,12 +79,41 @@ public:
 	void set_track_connection_status(bool enabled);
 	bool get_track_connection_status() { return m_track_connection_status; }
 
+	const libsinsp::evt_buffer_arena& get_evt_buffer_arena() const { return m_evt_buffer_arena; }
+
 private:
 	//
 	// Initializers
 	//
 	inline void init_metaevt(metaevents_state& evt_state, uint16_t evt_type, uint16_t buf_size);
 
+	//
+	// Per event type dispatch, resolved once in the constructor from the
+	// event table: how reset() looks the thread up and the ordered list of
+	// parsers that process_event() runs
+	//
+	typedef void (sinsp_parser::*parse_fn)(sinsp_evt* evt);
+	static constexpr size_t MAX_EVENT_PARSERS = 2;
+
+	enum reset_flags : uint32_t
+	{
+		RESET_SKIP = 1 << 0, ///< EF_SKIPPARSERESET, no thread lookup
+		RESET_NO_THREAD = 1 << 1, ///< meta-events not related to a thread
+		RESET_NO_QUERY_OS = 1 << 2, ///< don't look the thread up in /proc
+		RESET_CLONE_EXIT = 1 << 3,
+		RESET_USES_FD = 1 << 4, ///< EF_USES_FD
+		RESET_ERROR_PARAM = 1 << 5, ///< the first parameter is res or fd
+	};
+
+	struct event_dispatch
+	{
+		uint32_t m_reset_flags;
+		parse_fn m_parsers[MAX_EVENT_PARSERS];
+	};
+
+	void init_event_dispatch();
+	void add_event_parser(std::initializer_list<ppm_event_code> etypes, parse_fn parser);
+
 	//
 	// Helpers
 	//
@@ -124,8 +154,14 @@ private:
 	void parse_shutdown_exit(sinsp_evt* evt);
 	void parse_dup_exit(sinsp_evt* evt);
 	void parse_single_param_fd_exit(sinsp_evt* evt, scap_fd_type type);
+	template<void (sinsp_parser::*parse)(sinsp_evt*, scap_fd_type), scap_fd_type type>
+	void parse_fd_type_exit(sinsp_evt* evt)
+	{
+		(this->*parse)(evt, type);
+	}
 	void parse_getrlimit_setrlimit_exit(sinsp_evt* evt);
 	void parse_prlimit_exit(sinsp_evt* evt);
+	void parse_sendto_enter(sinsp_evt *evt);
 	void parse_select_poll_epollwait_enter(sinsp_evt *evt);
 	void parse_fcntl_enter(sinsp_evt* evt);
 	void parse_fcntl_exit(sinsp_evt* evt);
@@ -169,7 +205,7 @@ private:
 	bool set_unix_info(sinsp_fdinfo_t* fdinfo, uint8_t* packed_data);
 
 	void swap_addresses(sinsp_fdinfo_t* fdinfo);
-	uint8_t* reserve_event_buffer();
+	uint8_t* reserve_event_buffer(sinsp_threadinfo* tinfo, size_t size);
 	void free_event_buffer(uint8_t*);
 
 	//
@@ -196,10 +232,13 @@ private:
 	int              m_k8s_capture_version = -1;
 	metaevents_state m_mesos_metaevents_state;
 
-	std::stack<uint8_t*> m_tmp_events_buffer;
+	// Storage of the enter events, see sinsp_threadinfo::m_lastevent_data
+	libsinsp::evt_buffer_arena m_evt_buffer_arena;
 
 	// caches the index of the "syscall" event source
 	size_t m_syscall_event_source_idx;
 
+	event_dispatch m_event_dispatch[PPM_EVENT_MAX];
+
 	friend class sinsp_protodecoder;
 };
@@ -846,6 +846,278 @@ bool sinsp_plugin::extract_fields(sinsp_evt* evt, uint32_t num_fields, ss_plugin
 	return m_handle->api.extract_fields(m_state, &ev, &in) == SS_PLUGIN_SUCCESS;
 }
 
+uint32_t sinsp_plugin::add_extract_batch_field(
+		bool output,
+		uint32_t field_id,
+		const char* arg_key,
+		uint64_t arg_index,
+		bool arg_present)
+{
+	ASSERT(field_id < m_fields.size());
+	auto& batch = output ? m_output_extract_batch : m_filter_extract_batch;
+	return batch.add(field_id, arg_key, arg_index, arg_present);
+}
+
+void sinsp_plugin::remove_extract_batch_field(bool output, uint32_t slot)
+{
+	auto& batch = output ? m_output_extract_batch : m_filter_extract_batch;
+	batch.remove(slot);
+}
+
+const ss_plugin_extract_field* sinsp_plugin::extract_batch_field(bool output, sinsp_evt* evt, uint32_t slot)
+{
+	auto& batch = output ? m_output_extract_batch : m_filter_extract_batch;
+	return batch.extract(*this, evt, slot);
+}
+
+uint32_t sinsp_plugin::extract_batch::add(
+		uint32_t field_id,
+		const char* arg_key,
+		uint64_t arg_index,
+		bool arg_present)
+{
+	uint32_t slot = m_entries.size();
+	for (uint32_t i = 0; i < m_entries.size(); i++)
+	{
+		auto& e = m_entries[i];
+		if (e.refs == 0)
+		{
+			// reuse the first released slot, if any
+			if (slot == m_entries.size())
+			{
+				slot = i;
+			}
+			continue;
+		}
+		if (e.field_id == field_id
+			&& e.arg_present == arg_present
+			&& e.arg_index == arg_index
+			&& e.arg_key_present == (arg_key != NULL)
+			&& (arg_key == NULL || e.arg_key == arg_key))
+		{
+			e.refs++;
+			return i;
+		}
+	}
+
+	if (slot == m_entries.size())
+	{
+		m_entries.emplace_back();
+	}
+	auto& e = m_entries[slot];
+	e.field_id = field_id;
+	e.arg_key = arg_key != NULL ? arg_key : "";
+	e.arg_key_present = arg_key != NULL;
+	e.arg_index = arg_index;
+	e.arg_present = arg_present;
+	e.refs = 1;
+	e.pos = UINT32_MAX;
+	e.serial = 0;
+	e.ok = false;
+	m_dirty = true;
+	return slot;
+}
+
+void sinsp_plugin::extract_batch::remove(uint32_t slot)
+{
+	ASSERT(slot < m_entries.size());
+	auto& e = m_entries[slot];
+	ASSERT(e.refs > 0);
+	if (--e.refs == 0)
+	{
+		m_dirty = true;
+	}
+}
+
+ss_plugin_extract_field sinsp_plugin::extract_batch::field_of(const sinsp_plugin& plugin, const entry& e) const
+{
+	const auto& info = plugin.fields()[e.field_id];
+	ss_plugin_extract_field f;
+	f.res.u64 = NULL;
+	f.res_len = 0;
+	f.field_id = e.field_id;
+	f.field = info.m_name;
+	f.arg_key = e.arg_key_present ? e.arg_key.c_str() : NULL;
+	f.arg_index = e.arg_index;
+	f.arg_present = e.arg_present;
+	f.ftype = info.m_type;
+	f.flist = info.m_flags & EPF_IS_LIST;
+	return f;
+}
+
+//
+// Copies the values extracted by the plugin for a field to storage, and
+// points the field to the copies
+//
+static void copy_extract_values(ss_plugin_extract_field& f, std::vector<uint8_t>& storage)
+{
+	size_t len;
+	switch (f.ftype)
+	{
+	case PT_CHARBUF:
+		len = f.res_len * sizeof(const char*);
+		for (uint64_t i = 0; i < f.res_len; i++)
+		{
+			len += strlen(f.res.str[i]) + 1;
+		}
+		break;
+	case PT_IPADDR:
+	case PT_IPNET:
+		len = f.res_len * sizeof(ss_plugin_byte_buffer);
+		for (uint64_t i = 0; i < f.res_len; i++)
+		{
+			len += f.res.buf[i].len;
+		}
+		break;
+	case PT_BOOL:
+		len = f.res_len * sizeof(ss_plugin_bool);
+		break;
+	default:
+		len = f.res_len * sizeof(uint64_t);
+		break;
+	}
+
+	storage.resize(len);
+	uint8_t* p = storage.data();
+	switch (f.ftype)
+	{
+	case PT_CHARBUF:
+	{
+		auto strs = (const char**) p;
+		p += f.res_len * sizeof(const char*);
+		for (uint64_t i = 0; i < f.res_len; i++)
+		{
+			size_t n = strlen(f.res.str[i]) + 1;
+			memcpy(p, f.res.str[i], n);
+			strs[i] = (const char*) p;
+			p += n;
+		}
+		f.res.str = strs;
+		break;
+	}
+	case PT_IPADDR:
+	case PT_IPNET:
+	{
+		auto bufs = (ss_plugin_byte_buffer*) p;
+		p += f.res_len * sizeof(ss_plugin_byte_buffer);
+		for (uint64_t i = 0; i < f.res_len; i++)
+		{
+			memcpy(p, f.res.buf[i].ptr, f.res.buf[i].len);
+			bufs[i].ptr = p;
+			bufs[i].len = f.res.buf[i].len;
+			p += bufs[i].len;
+		}
+		f.res.buf = bufs;
+		break;
+	}
+	case PT_BOOL:
+		memcpy(p, f.res.boolean, len);
+		f.res.boolean = (ss_plugin_bool*) p;
+		break;
+	default:
+		memcpy(p, f.res.u64, len);
+		f.res.u64 = (uint64_t*) p;
+		break;
+	}
+}
+
+void sinsp_plugin::extract_batch::fill(entry& e)
+{
+	e.value = m_fields[e.pos];
+	e.ok = true;
+	e.serial = m_serial;
+	copy_extract_values(e.value, e.storage);
+}
+
+void sinsp_plugin::extract_batch::fill_all()
+{
+	if (!m_ok)
+	{
+		return;
+	}
+	for (auto& e : m_entries)
+	{
+		if (e.refs > 0 && e.pos != UINT32_MAX && e.serial != m_serial)
+		{
+			fill(e);
+		}
+	}
+}
+
+const ss_plugin_extract_field* sinsp_plugin::extract_batch::extract(const sinsp_plugin& plugin, sinsp_evt* evt, uint32_t slot)
+{
+	ASSERT(slot < m_entries.size());
+#ifdef _DEBUG
+	// the values of the batch belong to the last event, so two threads
+	// extracting at once would overwrite each other's
+	bool in_use = m_in_use.exchange(true);
+	ASSERT(!in_use);
+	struct in_use_guard
+	{
+		std::atomic<bool>& in_use;
+		~in_use_guard() { in_use = false; }
+	} guard{m_in_use};
+#endif
+
+	// synthetic events all have number 0, so they are never reused
+	if (evt->get_num() == 0 || evt->get_num() != m_evtnum || evt->m_pevt != m_evt)
+	{
+		// the key argument pointers are refreshed too, because the
+		// entries may have moved since the last rebuild
+		if (m_dirty)
+		{
+			m_fields.clear();
+			for (auto& e : m_entries)
+			{
+				e.pos = UINT32_MAX;
+				if (e.refs > 0)
+				{
+					e.pos = m_fields.size();
+					m_fields.push_back(field_of(plugin, e));
+				}
+			}
+			m_dirty = false;
+		}
+
+		m_evtnum = evt->get_num();
+		m_evt = evt->m_pevt;
+		m_serial++;
+		for (auto& f : m_fields)
+		{
+			f.res_len = 0;
+		}
+		m_ok = m_fields.empty() || plugin.extract_fields(evt, m_fields.size(), m_fields.data());
+	}
+
+	auto& e = m_entries[slot];
+	if (e.serial == m_serial)
+	{
+		return e.ok ? &e.value : NULL;
+	}
+
+	if (m_ok && e.pos != UINT32_MAX)
+	{
+		fill(e);
+		return &e.value;
+	}
+
+	// the field is extracted alone, either because the plugin failed the
+	// batch, which any of its fields might have caused, or because the
+	// field was added after the batch of this event was extracted. This
+	// overwrites the values the plugin returned for the batch, so they
+	// are all copied first.
+	fill_all();
+	e.value = field_of(plugin, e);
+	e.ok = plugin.extract_fields(evt, 1, &e.value);
+	e.serial = m_serial;
+	if (!e.ok)
+	{
+		return NULL;
+	}
+	copy_extract_values(e.value, e.storage);
+	return &e.value;
+}
+
 /** End of Field Extraction CAP **/
 
 /** Event Parsing CAP **/
@@ -930,16 +1202,17 @@ ss_plugin_rc sinsp_plugin::handle_plugin_async_event(ss_plugin_owner_t *o, const
 
 	try
 	{
-		auto evt = std::unique_ptr<sinsp_evt>(new sinsp_evt());
-		ASSERT(evt->m_pevt_storage == nullptr);
-		evt->m_pevt_storage = new char[e->len];
-		memcpy(evt->m_pevt_storage, e, e->len);
-		evt->m_cpuid = 0;
-		evt->m_evtnum = 0;
-		evt->m_pevt = (scap_evt *) evt->m_pevt_storage;
-		evt->init();
-		// note: plugin ID and timestamp will be set by the inspector
-		(*handler)(*p, std::move(evt));
+		// note: the event is copied by the handler, and plugin ID and
+		// timestamp will be set by the inspector
+		if (!(*handler)(*p, e))
+		{
+			if (err)
+			{
+				auto errmsg = "async event queue is full, event dropped: " + p->name();
+				strlcpy(err, errmsg.c_str(), PLUGIN_MAX_ERRLEN);
+			}
+			return SS_PLUGIN_FAILURE;
+		}
 	}
 	catch (const std::exception& _e)
 	{
@@ -111,6 +111,8 @@ public:
 		m_fields(),
 		m_extract_event_sources(),
 		m_extract_event_codes(),
+		m_filter_extract_batch(),
+		m_output_extract_batch(),
 		m_parse_event_sources(),
 		m_parse_event_codes(),
 		m_table_registry(treg),
@@ -193,6 +195,41 @@ public:
 
 	bool extract_fields(sinsp_evt* evt, uint32_t num_fields, ss_plugin_extract_field *fields) const;
 
+	/**
+	 * @brief Adds a field to a batch of fields that are extracted all
+	 * together with a single extract_fields() call for each event, and
+	 * returns its slot in the batch. Identical fields share the same slot.
+	 * arg_key can be NULL if the field has no key argument. The fields
+	 * used for filtering and the ones only used in outputs are kept in two
+	 * separate batches, so that the latter are extracted only for the
+	 * events that get formatted.
+	 */
+	uint32_t add_extract_batch_field(
+		bool output,
+		uint32_t field_id,
+		const char* arg_key,
+		uint64_t arg_index,
+		bool arg_present);
+
+	/**
+	 * @brief Releases a slot returned by add_extract_batch_field().
+	 */
+	void remove_extract_batch_field(bool output, uint32_t slot);
+
+	/**
+	 * @brief Returns the value extracted for the field at the given slot
+	 * of a batch, or NULL if the plugin failed extracting it. All the
+	 * fields of the batch are extracted the first time this is called for
+	 * an event, and the following calls for the same event reuse the
+	 * results, which stay valid until the next event.
+	 *
+	 * @note Unlike extract_fields(), this is not thread-safe: the batches
+	 * hold the values of the last event and are shared by all the filters
+	 * and formatters using the plugin, which must extract from them on
+	 * one thread at a time. Debug builds assert this.
+	 */
+	const ss_plugin_extract_field* extract_batch_field(bool output, sinsp_evt* evt, uint32_t slot);
+
 	/** Event Parsing **/
 	inline const std::unordered_set<std::string>& parse_event_sources() const
 	{
@@ -214,7 +251,19 @@ public:
 		return m_async_event_names;
 	}
 
-	using async_event_handler_t = std::function<void(const sinsp_plugin&, std::unique_ptr<sinsp_evt>)>;
+	/**
+	 * @brief Receives the async events of the plugin, which are only valid
+	 * for the duration of the call. Returns false if the event could not be
+	 * queued because the consumer is lagging behind, in which case the
+	 * event is dropped and the plugin gets a failure.
+	 *
+	 * @note The async events of the plugins are queued in a bounded queue
+	 * (see sinsp::set_async_events_queue_capacity()), so a plugin whose
+	 * events are produced faster than they are consumed now sees its async
+	 * event handler return SS_PLUGIN_FAILURE, with an error saying that the
+	 * queue is full, instead of the event being queued.
+	 */
+	using async_event_handler_t = std::function<bool(const sinsp_plugin&, const ss_plugin_event*)>;
 
 	bool set_async_event_handler(async_event_handler_t handler);
 
@@ -247,6 +296,51 @@ private:
 	std::unordered_set<std::string> m_extract_event_sources;
 	libsinsp::events::set<ppm_event_code> m_extract_event_codes;
 
+	// The fields extracted all together for each event. The set of fields
+	// only changes between two events, so that no field is ever extracted
+	// twice for the same event. The values are copied to storage owned by
+	// the batch, so that they stay valid for the whole event even if other
+	// extractions from the plugin happen in the meantime. A batch must not
+	// be used by several threads at once, see extract_batch_field().
+	class extract_batch
+	{
+	public:
+		uint32_t add(uint32_t field_id, const char* arg_key, uint64_t arg_index, bool arg_present);
+		void remove(uint32_t slot);
+		const ss_plugin_extract_field* extract(const sinsp_plugin& plugin, sinsp_evt* evt, uint32_t slot);
+
+	private:
+		struct entry
+		{
+			uint32_t field_id;
+			std::string arg_key;
+			bool arg_key_present;
+			uint64_t arg_index;
+			bool arg_present;
+			uint32_t refs;
+			uint32_t pos; // index of the field in m_fields, UINT32_MAX if not there yet
+			uint64_t serial; // value of m_serial when value was last filled
+			bool ok;
+			ss_plugin_extract_field value;
+			std::vector<uint8_t> storage;
+		};
+
+		ss_plugin_extract_field field_of(const sinsp_plugin& plugin, const entry& e) const;
+		void fill(entry& e);
+		void fill_all();
+
+		std::vector<entry> m_entries;
+		std::vector<ss_plugin_extract_field> m_fields;
+		bool m_dirty = false;
+		uint64_t m_evtnum = 0;
+		const void* m_evt = nullptr;
+		uint64_t m_serial = 0;
+		bool m_ok = false;
+		std::atomic<bool> m_in_use{false}; // only checked in debug builds
+	};
+	extract_batch m_filter_extract_batch;
+	extract_batch m_output_extract_batch;
+
 	/** Event Parsing **/
 	struct accessed_table_input_deleter { void operator()(ss_plugin_table_input* r); };
 	using owned_table_t = std::unique_ptr<libsinsp::state::base_table>;
@@ -27,6 +27,8 @@ sinsp_filter_check_plugin::sinsp_filter_check_plugin()
 	m_info.m_nfields = 0;
 	m_info.m_flags = filter_check_info::FL_NONE;
 	m_eplugin = nullptr;
+	m_batch_slot = UINT32_MAX;
+	m_batch_output = false;
 }
 
 sinsp_filter_check_plugin::sinsp_filter_check_plugin(std::shared_ptr<sinsp_plugin> plugin)
@@ -41,6 +43,8 @@ sinsp_filter_check_plugin::sinsp_filter_check_plugin(std::shared_ptr<sinsp_plugi
 	m_info.m_fields = &m_eplugin->fields()[0]; // we use a vector so this should be safe
 	m_info.m_nfields = m_eplugin->fields().size();
 	m_info.m_flags = filter_check_info::FL_NONE;
+	m_batch_slot = UINT32_MAX;
+	m_batch_output = false;
 }
 
 sinsp_filter_check_plugin::sinsp_filter_check_plugin(const sinsp_filter_check_plugin &p)
@@ -48,12 +52,29 @@ sinsp_filter_check_plugin::sinsp_filter_check_plugin(const sinsp_filter_check_pl
 	m_eplugin = p.m_eplugin;
 	m_info = p.m_info;
 	m_compatible_plugin_sources_bitmap = p.m_compatible_plugin_sources_bitmap;
+	m_batch_slot = UINT32_MAX;
+	m_batch_output = false;
+}
+
+sinsp_filter_check_plugin::~sinsp_filter_check_plugin()
+{
+	release_batch_slot();
+}
+
+void sinsp_filter_check_plugin::release_batch_slot()
+{
+	if (m_batch_slot != UINT32_MAX)
+	{
+		m_eplugin->remove_extract_batch_field(m_batch_output, m_batch_slot);
+		m_batch_slot = UINT32_MAX;
+	}
 }
 
 int32_t sinsp_filter_check_plugin::parse_field_name(const char* str, bool alloc_state, bool needed_for_filtering)
 {
 	int32_t res = sinsp_filter_check::parse_field_name(str, alloc_state, needed_for_filtering);
 
+	release_batch_slot();
 	m_argstr.clear();
 
 	if(res != -1)
@@ -99,15 +120,28 @@ int32_t sinsp_filter_check_plugin::parse_field_name(const char* str, bool alloc_
 						extract_arg_key();
 					}
 
-					return pos1 + pos2 + 2;
+					res = pos1 + pos2 + 2;
 				}
 			}
-			throw sinsp_exception(string("filter ") + string(str) + string(" ") + m_field->m_name + string(" has a badly-formatted argument"));
+			if(!m_arg_present)
+			{
+				throw sinsp_exception(string("filter ") + string(str) + string(" ") + m_field->m_name + string(" has a badly-formatted argument"));
+			}
 		}
-		if (m_info.m_fields[m_field_id].m_flags & filtercheck_field_flags::EPF_ARG_REQUIRED)
+		else if (m_info.m_fields[m_field_id].m_flags & filtercheck_field_flags::EPF_ARG_REQUIRED)
 		{
 			throw sinsp_exception(string("filter ") + string(str) + string(" ") + m_field->m_name + string(" requires an argument but none provided"));
 		}
+
+		// all the fields of this plugin that are in use are extracted
+		// together, the ones only used in outputs on their own. Checks
+		// parsed only to match a field name never get extracted.
+		if(alloc_state)
+		{
+			m_batch_output = !needed_for_filtering;
+			m_batch_slot = m_eplugin->add_extract_batch_field(
+				m_batch_output, m_field_id, m_arg_key, m_arg_index, m_arg_present);
+		}
 	}
 
 	return res;
@@ -149,23 +183,21 @@ bool sinsp_filter_check_plugin::extract(sinsp_evt *evt, OUT vector<extract_value
 		return false;
 	}
 
-	auto type = m_info.m_fields[m_field_id].m_type;
-	uint32_t num_fields = 1;
-	ss_plugin_extract_field efield;
-	efield.field_id = m_field_id;
-	efield.field = m_info.m_fields[m_field_id].m_name;
-	efield.arg_key = m_arg_key;
-	efield.arg_index = m_arg_index;
-	efield.arg_present = m_arg_present;
-	efield.ftype = type;
-	efield.flist = m_info.m_fields[m_field_id].m_flags & EPF_IS_LIST;
-	if (!m_eplugin->extract_fields(evt, num_fields, &efield) || efield.res_len == 0)
+	// only checks parsed with allocated state are part of a batch
+	if (m_batch_slot == UINT32_MAX)
 	{
 		return false;
 	}
 
+	auto efield = m_eplugin->extract_batch_field(m_batch_output, evt, m_batch_slot);
+	if (efield == NULL || efield->res_len == 0)
+	{
+		return false;
+	}
+
+	auto type = m_info.m_fields[m_field_id].m_type;
 	values.clear();
-	for (uint32_t i = 0; i < efield.res_len; ++i)
+	for (uint32_t i = 0; i < efield->res_len; ++i)
 	{
 		extract_value_t res;
 		switch(type)
@@ -175,26 +207,26 @@ bool sinsp_filter_check_plugin::extract(sinsp_evt *evt, OUT vector<extract_value
 			case PT_ABSTIME:
 			{
 				res.len = sizeof(uint64_t);
-				res.ptr = (uint8_t*) &efield.res.u64[i];
+				res.ptr = (uint8_t*) &efield->res.u64[i];
 				break;
 			}
 			case PT_IPADDR:
 			case PT_IPNET:
 			{
-				res.len = (uint32_t) efield.res.buf[i].len;
-				res.ptr = (uint8_t*) efield.res.buf[i].ptr;
+				res.len = (uint32_t) efield->res.buf[i].len;
+				res.ptr = (uint8_t*) efield->res.buf[i].ptr;
 				break;
 			}
 			case PT_CHARBUF:
 			{
-				res.len = strlen(efield.res.str[i]);
-				res.ptr = (uint8_t*) efield.res.str[i];
+				res.len = strlen(efield->res.str[i]);
+				res.ptr = (uint8_t*) efield->res.str[i];
 				break;
 			}
 			case PT_BOOL:
 			{
 				res.len = sizeof(ss_plugin_bool);
-				res.ptr = (uint8_t*) &efield.res.boolean[i];
+				res.ptr = (uint8_t*) &efield->res.boolean[i];
 				break;
 			}
 			default:
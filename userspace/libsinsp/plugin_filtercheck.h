@@ -38,7 +38,7 @@ public:
 
 	explicit sinsp_filter_check_plugin(const sinsp_filter_check_plugin &p);
 
-	virtual ~sinsp_filter_check_plugin() = default;
+	virtual ~sinsp_filter_check_plugin();
 
 	sinsp_filter_check* allocate_new() override;
 
@@ -60,6 +60,12 @@ private:
 	std::vector<bool> m_compatible_plugin_sources_bitmap;
 	std::shared_ptr<sinsp_plugin> m_eplugin;
 
+	// slot of this field in the extraction batch of the plugin, registered
+	// when the field name is parsed. Fields only used in outputs have
+	// their own batch.
+	uint32_t m_batch_slot;
+	bool m_batch_output;
+
 	// extract_arg_index() extracts a valid index from the argument if 
 	// format is valid, otherwise it throws an exception.
 	// `full_field_name` has the format "field[argument]" and it is necessary
@@ -69,4 +75,6 @@ private:
 	// extract_arg_key() extracts a valid string from the argument. If we pass
 	// a numeric argument, it will be converted to string. 
 	void extract_arg_key();
+
+	void release_batch_slot();
 };
\ No newline at end of file
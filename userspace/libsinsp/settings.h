@@ -23,8 +23,8 @@ limitations under the License.
 #define INCLUDE_UNKNOWN_SOCKET_FDS
 
 //
-// Memory storage size for an entry in the event storage LIFO.
-// Events bigger than SP_EVT_BUF_SIZE won't be be stored in the LIFO.
+// Maximum size of a stored enter event, see libsinsp::evt_buffer_arena.
+// Events bigger than SP_EVT_BUF_SIZE won't be be stored.
 //
 #define SP_EVT_BUF_SIZE 4096
 
@@ -94,6 +94,7 @@ sinsp::sinsp(bool static_container, const std::string &static_id, const std::str
 	m_is_dumping = false;
 	m_metaevt = NULL;
 	m_meinfo.m_piscapevt = NULL;
+	m_async_evt.m_inspector = this;
 	m_parser = new sinsp_parser(this);
 	m_thread_manager = new sinsp_thread_manager(this);
 	m_max_fdtable_size = MAX_FD_TABLE_SIZE;
@@ -142,6 +143,9 @@ sinsp::sinsp(bool static_container, const std::string &static_id, const std::str
 
 	m_proc_scan_timeout_ms = SCAP_PROC_SCAN_TIMEOUT_NONE;
 	m_proc_scan_log_interval_ms = SCAP_PROC_SCAN_LOG_NONE;
+	m_proc_scan_threads = 0;
+	m_proc_scan_incremental = false;
+	m_async_evts_capacity = libsinsp::async_event_ring::DEFAULT_CAPACITY;
 
 	uint32_t evlen = sizeof(scap_evt) + 2 * sizeof(uint16_t) + 2 * sizeof(uint64_t);
 	m_meinfo.m_piscapevt = (scap_evt*)new char[evlen];
@@ -176,6 +180,10 @@ sinsp::sinsp(bool static_container, const std::string &static_id, const std::str
 #endif // !defined(CYGWING_AGENT) && !defined(MINIMAL_BUILD)
 
 	m_replay_scap_evt = NULL;
+	m_scap_batch_size = 1;
+	m_scap_batch_len = 0;
+	m_scap_batch_pos = 0;
+	m_savefile_prefetch_blocks = 0;
 
 	// the "syscall" event source is implemented by sinsp itself
 	// and is always present
@@ -383,9 +391,11 @@ void sinsp::init()
 	// importing the thread table, so that thread table filtering will work with
 	// container filters
 	//
+	m_initialstate_nevts = 0;
 	if(is_capture())
 	{
 		consume_initialstate_events();
+		m_initialstate_nevts = m_nevts;
 	}
 
 	if(is_capture())
@@ -481,6 +491,8 @@ void sinsp::open_common(scap_open_args* oargs)
 	oargs->debug_log_fn = &sinsp_scap_debug_log_fn;
 	oargs->proc_scan_timeout_ms = m_proc_scan_timeout_ms;
 	oargs->proc_scan_log_interval_ms = m_proc_scan_log_interval_ms;
+	oargs->proc_scan_threads = m_proc_scan_threads;
+	oargs->proc_scan_incremental = m_proc_scan_incremental;
 
 	m_h = scap_alloc();
 	if(m_h == NULL)
@@ -516,8 +528,12 @@ void sinsp::open_common(scap_open_args* oargs)
 		{
 			if (p->caps() & CAP_ASYNC)
 			{
+				if (!m_async_evts)
+				{
+					m_async_evts.reset(new libsinsp::async_event_ring(m_async_evts_capacity));
+				}
 				auto res = p->set_async_event_handler([this](auto& p, auto e){
-					this->handle_plugin_async_event(p, std::move(e));
+					return this->handle_plugin_async_event(p, e);
 				});
 				if (!res)
 				{
@@ -659,6 +675,7 @@ void sinsp::open_savefile(const std::string& filename, int fd)
 
 	params.start_offset = 0;
 	params.fbuffer_size = 0;
+	params.prefetch_blocks = m_savefile_prefetch_blocks;
 	oargs.engine_params = &params;
 	open_common(&oargs);
 }
@@ -693,7 +710,7 @@ void sinsp::open_gvisor(const std::string& config_path, const std::string& root_
 	set_get_procs_cpu_from_driver(false);
 }
 
-void sinsp::open_modern_bpf(unsigned long driver_buffer_bytes_dim, uint16_t cpus_for_each_buffer, bool online_only, const libsinsp::events::set<ppm_sc_code> &ppm_sc_of_interest)
+void sinsp::open_modern_bpf(unsigned long driver_buffer_bytes_dim, uint16_t cpus_for_each_buffer, bool online_only, const libsinsp::events::set<ppm_sc_code> &ppm_sc_of_interest, bool heap_consumer, uint32_t heap_rescan_interval)
 {
 	scap_open_args oargs = factory_open_args(MODERN_BPF_ENGINE, SCAP_MODE_LIVE);
 
@@ -705,6 +722,8 @@ void sinsp::open_modern_bpf(unsigned long driver_buffer_bytes_dim, uint16_t cpus
 	params.buffer_bytes_dim = driver_buffer_bytes_dim;
 	params.cpus_for_each_buffer = cpus_for_each_buffer;
 	params.allocate_online_only = online_only;
+	params.heap_consumer = heap_consumer;
+	params.heap_rescan_interval = heap_rescan_interval;
 	params.verbose = g_logger.has_output() && g_logger.is_enabled(sinsp_logger::severity::SEV_DEBUG);
 	oargs.engine_params = &params;
 	open_common(&oargs);
@@ -879,11 +898,18 @@ void sinsp::close()
 //
 void sinsp::deinit_state()
 {
+	m_scap_batch_len = 0;
+	m_scap_batch_pos = 0;
 	m_network_interfaces.clear();
 	m_thread_manager->clear();
 }
 
 void sinsp::autodump_start(const std::string& dump_filename, bool compress)
+{
+	autodump_start(dump_filename, compress ? SCAP_COMPRESSION_GZIP : SCAP_COMPRESSION_NONE);
+}
+
+void sinsp::autodump_start(const std::string& dump_filename, compression_mode compress)
 {
 	if(NULL == m_h)
 	{
@@ -892,14 +918,7 @@ void sinsp::autodump_start(const std::string& dump_filename, bool compress)
 
 	std::unique_ptr<sinsp_dumper> dumper(new sinsp_dumper);
 
-	if(compress)
-	{
-		dumper->open(this, dump_filename.c_str(), SCAP_COMPRESSION_GZIP, false);
-	}
-	else
-	{
-		dumper->open(this, dump_filename.c_str(), SCAP_COMPRESSION_NONE, false);
-	}
+	dumper->open(this, dump_filename.c_str(), compress, false);
 
 	m_is_dumping = true;
 
@@ -1161,6 +1180,56 @@ void sinsp::restart_capture()
 	m_nevts = nevts;
 }
 
+void sinsp::seek_ts(uint64_t ts)
+{
+	if(!is_capture())
+	{
+		throw sinsp_exception("seeking by timestamp is only supported for capture files");
+	}
+
+	uint64_t evtnum;
+	if(scap_seek_ts(m_h, ts, &evtnum) != SCAP_SUCCESS)
+	{
+		throw sinsp_exception(std::string("scap error: ") + scap_getlasterr(m_h));
+	}
+
+	m_replay_scap_evt = NULL;
+	m_scap_batch_len = 0;
+	m_scap_batch_pos = 0;
+
+	//
+	// The state events at the beginning of the file have been consumed
+	// when opening it, so they are skipped together with the events that
+	// follow them and precede ts. The first event to return is replayed
+	// by next(), like consume_initialstate_events() does.
+	//
+	while(true)
+	{
+		scap_evt* pevent;
+		uint16_t pcpuid;
+		int32_t res = scap_next(m_h, &pevent, &pcpuid);
+		if(res == SCAP_EOF)
+		{
+			break;
+		}
+		else if(res != SCAP_SUCCESS)
+		{
+			throw sinsp_exception(std::string("scap error: ") + scap_getlasterr(m_h));
+		}
+
+		if(evtnum < m_initialstate_nevts || pevent->ts < ts)
+		{
+			evtnum++;
+			continue;
+		}
+
+		m_replay_scap_evt = pevent;
+		m_replay_scap_cpuid = pcpuid;
+		break;
+	}
+	m_nevts = evtnum;
+}
+
 uint64_t sinsp::max_buf_used()
 {
 	if(m_h)
@@ -1219,6 +1288,9 @@ int32_t sinsp::next(OUT sinsp_evt **puevt)
 {
 	sinsp_evt* evt;
 	int32_t res;
+	// the periodic housekeeping below runs once per batch of scap
+	// events, and not for the events served from an already fetched one
+	bool batch_start = true;
 
 	//
 	// Check if there are fake cpu events to  events
@@ -1249,6 +1321,17 @@ int32_t sinsp::next(OUT sinsp_evt **puevt)
 		}
 	}
 #endif
+	else if (m_async_evts && (m_async_evt.m_pevt = m_async_evts->pop()) != NULL)
+	{
+		res = SCAP_SUCCESS;
+		evt = &m_async_evt;
+		evt->m_cpuid = 0;
+		evt->m_evtnum = 0;
+		evt->init();
+		// note: async events are always enqueued with a (uint64_t)-1
+		// timestamp, see the note above
+		evt->m_pevt->ts = get_new_ts();
+	}
 	else
 	{
 		evt = &m_evt;
@@ -1278,7 +1361,29 @@ int32_t sinsp::next(OUT sinsp_evt **puevt)
 			evt->m_cpuid = m_replay_scap_cpuid;
 			m_replay_scap_evt = NULL;
 		}
-		else 
+		else if(m_scap_batch_size > 1)
+		{
+			// Serve the events of the last batch, and fetch
+			// a new one only when all of them have been returned
+			if(m_scap_batch_pos == m_scap_batch_len)
+			{
+				m_scap_batch_pos = 0;
+				res = scap_next_batch(m_h, m_scap_batch_size, m_scap_batch_evts.data(), m_scap_batch_cpuids.data(), &m_scap_batch_len);
+			}
+			else
+			{
+				res = SCAP_SUCCESS;
+				batch_start = false;
+			}
+
+			if(res == SCAP_SUCCESS)
+			{
+				evt->m_pevt = m_scap_batch_evts[m_scap_batch_pos];
+				evt->m_cpuid = m_scap_batch_cpuids[m_scap_batch_pos];
+				m_scap_batch_pos++;
+			}
+		}
+		else
 		{
 			// If no last event was saved, invoke
 			// the actual scap_next
@@ -1350,7 +1455,7 @@ int32_t sinsp::next(OUT sinsp_evt **puevt)
 	//
 	// If required, retrieve the processes cpu from the kernel
 	//
-	if(m_get_procs_cpu_from_driver && is_live())
+	if(batch_start && m_get_procs_cpu_from_driver && is_live())
 	{
 		get_procs_cpu_from_driver(ts);
 	}
@@ -1376,7 +1481,7 @@ int32_t sinsp::next(OUT sinsp_evt **puevt)
 			m_tid_to_remove = -1;
 		}
 
-		if(!is_offline())
+		if(batch_start && !is_offline())
 		{
 			m_thread_manager->remove_inactive_threads();
 		}
@@ -1384,7 +1489,7 @@ int32_t sinsp::next(OUT sinsp_evt **puevt)
 
 #ifndef HAS_ANALYZER
 
-	if(is_debug_enabled() && is_live())
+	if(batch_start && is_debug_enabled() && is_live())
 	{
 		if(ts > m_next_stats_print_time_ns)
 		{
@@ -1400,7 +1505,7 @@ int32_t sinsp::next(OUT sinsp_evt **puevt)
 	//
 	// Run the periodic connection, thread and users/groups table cleanup
 	//
-	if(!is_offline())
+	if(batch_start && !is_offline())
 	{
 		m_container_manager.remove_inactive_containers();
 
@@ -1951,6 +2056,20 @@ scap_stats_v2* sinsp::get_sinsp_stats_v2_buffer()
 	return m_sinsp_stats_v2;
 }
 
+libsinsp::evt_buffer_arena::stats sinsp::get_stored_evts_stats() const
+{
+	return m_parser->get_evt_buffer_arena().get_stats();
+}
+
+libsinsp::async_event_ring::stats sinsp::get_async_evts_stats() const
+{
+	if (!m_async_evts)
+	{
+		return libsinsp::async_event_ring::stats{};
+	}
+	return m_async_evts->get_stats();
+}
+
 void sinsp::get_filtercheck_fields_info(OUT std::vector<const filter_check_info*>& list)
 {
 	sinsp_utils::get_filtercheck_fields_info(list);
@@ -2161,6 +2280,11 @@ sinsp_parser* sinsp::get_parser()
 }
 
 bool sinsp::setup_cycle_writer(std::string base_file_name, int rollover_mb, int duration_seconds, int file_limit, unsigned long event_limit, bool compress)
+{
+	return setup_cycle_writer(base_file_name, rollover_mb, duration_seconds, file_limit, event_limit, compress ? SCAP_COMPRESSION_GZIP : SCAP_COMPRESSION_NONE);
+}
+
+bool sinsp::setup_cycle_writer(std::string base_file_name, int rollover_mb, int duration_seconds, int file_limit, unsigned long event_limit, compression_mode compress)
 {
 	m_compress = compress;
 
@@ -2726,6 +2850,25 @@ void sinsp::set_thread_timeout_s(uint32_t val)
 	m_thread_timeout_ns = (uint64_t)val * ONE_SECOND_IN_NS;
 }
 
+void sinsp::set_scap_batch_size(uint32_t val)
+{
+	if(val == 0)
+	{
+		throw sinsp_exception("the scap batch size must be greater than 0");
+	}
+
+	m_scap_batch_size = val;
+	m_scap_batch_evts.resize(val);
+	m_scap_batch_cpuids.resize(val);
+	m_scap_batch_len = 0;
+	m_scap_batch_pos = 0;
+}
+
+void sinsp::set_savefile_prefetch_blocks(uint32_t val)
+{
+	m_savefile_prefetch_blocks = val;
+}
+
 void sinsp::set_proc_scan_timeout_ms(uint64_t val)
 {
 	m_proc_scan_timeout_ms = val;
@@ -2736,6 +2879,30 @@ void sinsp::set_proc_scan_log_interval_ms(uint64_t val)
 	m_proc_scan_log_interval_ms = val;
 }
 
+void sinsp::set_proc_scan_threads(uint32_t val)
+{
+	m_proc_scan_threads = val;
+}
+
+void sinsp::set_proc_scan_incremental(bool val)
+{
+	m_proc_scan_incremental = val;
+}
+
+void sinsp::set_async_events_queue_capacity(size_t capacity)
+{
+	if (m_async_evts)
+	{
+		throw sinsp_exception("the async events queue capacity must be set before opening a plugin with async events");
+	}
+	if (capacity == 0 || capacity > libsinsp::async_event_ring::MAX_CAPACITY)
+	{
+		throw sinsp_exception("invalid async events queue capacity " + std::to_string(capacity)
+			+ ", must be between 1 and " + std::to_string(libsinsp::async_event_ring::MAX_CAPACITY));
+	}
+	m_async_evts_capacity = capacity;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Note: this is defined here so we can inline it in sinso::next
 ///////////////////////////////////////////////////////////////////////////////
@@ -2803,7 +2970,7 @@ libsinsp::event_processor::build_threadinfo(sinsp* inspector)
 	return new sinsp_threadinfo(inspector);
 }
 
-void sinsp::handle_plugin_async_event(const sinsp_plugin& p, std::unique_ptr<sinsp_evt> evt)
+bool sinsp::handle_plugin_async_event(const sinsp_plugin& p, const ss_plugin_event* evt)
 {
 	// note: this function can be invoked from different plugin threads,
 	// so we need to make sure that every variable we read is either constant
@@ -2853,21 +3020,22 @@ void sinsp::handle_plugin_async_event(const sinsp_plugin& p, std::unique_ptr<sin
 
 		// if the async event is generated by a non-syscall event source, then
 		// async events must have no thread associated.
-		if (cur_plugin_id != 0 && evt->m_pevt->tid != (uint64_t) -1)
+		if (cur_plugin_id != 0 && evt->tid != (uint64_t) -1)
 		{
 			throw sinsp_exception("async events of plugin '" + p.name()
 				+ "' can have no thread associated with open event source '" + cur_evtsrc + "'");
 		}
 
-		// write plugin ID and timestamp in the event and kick it in the queue
-		auto plid = (uint32_t*)((uint8_t*) evt->m_pevt + sizeof(scap_evt) + 4+4+4);
-		*plid = cur_plugin_id;
-		evt->inspector(this);
-		evt->m_pevt->ts = (uint64_t) -1;
-#ifndef __EMSCRIPTEN__				
-		m_pending_state_evts.push(std::move(evt));
-#endif
+		// copy the event in the queue, and write plugin ID and timestamp in it
+		return m_async_evts->push(evt->len, [evt, cur_plugin_id](scap_evt* dest)
+		{
+			memcpy(dest, evt, evt->len);
+			auto plid = (uint32_t*)((uint8_t*) dest + sizeof(scap_evt) + 4+4+4);
+			*plid = cur_plugin_id;
+			dest->ts = (uint64_t) -1;
+		});
 	}
+	return true;
 }
 
 bool sinsp::get_track_connection_status()
@@ -77,6 +77,8 @@ limitations under the License.
 #include "user.h"
 #include "utils.h"
 #include "sinsp_resource_utilization.h"
+#include "async_event_ring.h"
+#include "evt_buffer_arena.h"
 
 #ifndef VISIBILITY_PRIVATE
 // Some code defines VISIBILITY_PRIVATE to nothing to get private access to sinsp
@@ -228,17 +230,33 @@ public:
 				 scap_mode_t mode = SCAP_MODE_PLUGIN);
 	virtual void open_gvisor(const std::string &config_path, const std::string &root_path, bool no_events = false, int epoll_timeout = -1);
 	/*[EXPERIMENTAL] This API could change between releases, we are trying to find the right configuration to deploy the modern bpf probe:
-	 * `cpus_for_each_buffer` and `online_only` are the 2 experimental params. The first one allows associating more than one CPU to a single ring buffer.
-	 * The last one allows allocating ring buffers only for online CPUs and not for all system-available CPUs.
+	 * `cpus_for_each_buffer`, `online_only`, `heap_consumer` and `heap_rescan_interval` are the experimental params. The first one allows associating more than one CPU to a single ring buffer.
+	 * The second one allows allocating ring buffers only for online CPUs and not for all system-available CPUs.
+	 * The third one merges the ring buffers through a min-heap instead of scanning all of them for every event.
+	 * The last one bounds how late the heap consumer can return an event written into an empty ring buffer, in number of events (0 for the default).
 	 */
-	virtual void open_modern_bpf(unsigned long driver_buffer_bytes_dim = DEFAULT_DRIVER_BUFFER_BYTES_DIM, uint16_t cpus_for_each_buffer = DEFAULT_CPU_FOR_EACH_BUFFER, bool online_only = true, const libsinsp::events::set<ppm_sc_code> &ppm_sc_of_interest = {});
+	virtual void open_modern_bpf(unsigned long driver_buffer_bytes_dim = DEFAULT_DRIVER_BUFFER_BYTES_DIM, uint16_t cpus_for_each_buffer = DEFAULT_CPU_FOR_EACH_BUFFER, bool online_only = true, const libsinsp::events::set<ppm_sc_code> &ppm_sc_of_interest = {}, bool heap_consumer = false, uint32_t heap_rescan_interval = 0);
 	virtual void open_test_input(scap_test_input_data* data, scap_mode_t mode = SCAP_MODE_TEST);
 
 	void fseek(uint64_t filepos)
 	{
+		m_scap_batch_len = 0;
+		m_scap_batch_pos = 0;
 		scap_fseek(m_h, filepos);
 	}
 
+	/*!
+	  \brief Moves the read position of a capture file to the first event
+	   with a timestamp greater or equal than ts. This is fast for files
+	   written with a time index (see sinsp_dumper::enable_time_index),
+	   otherwise the file is scanned from its first event. Event numbers
+	   keep matching the position of the events in the file, but the state
+	   built from the skipped events is not updated.
+
+	  \param ts The timestamp to seek to, in nanoseconds.
+	*/
+	void seek_ts(uint64_t ts);
+
 	scap_open_args factory_open_args(const char* engine_name, scap_mode_t scap_mode);
 
 	std::string generate_gvisor_config(std::string socket_path);
@@ -434,6 +452,59 @@ public:
 	 */
 	void set_proc_scan_log_interval_ms(uint64_t val);
 
+	/*!
+	 * \brief sets the number of threads that scan /proc at startup. Values
+	 *        above 1 split the scan among a pool of workers, with the same
+	 *        resulting thread table as the serial scan. 0 (default) or 1
+	 *        means scan on the calling thread.
+	 */
+	void set_proc_scan_threads(uint32_t val);
+
+	/*!
+	 * \brief when set, the scap process table written to a capture file
+	 *        opened without skip_proc_scan (i.e. when the dumper doesn't
+	 *        take the threads from sinsp) is kept until the next dump, and
+	 *        the rescan only reads again the new tids and the ones whose
+	 *        start time or executable inode changed. The entries of the
+	 *        other processes, fds included, are written as they were in
+	 *        the previous dump. The sinsp thread table isn't involved: it
+	 *        is built from the callbacks of the first scan, and
+	 *        import_thread_table() only reads the table of a capture file.
+	 */
+	void set_proc_scan_incremental(bool val);
+
+	/*!
+	 * \brief sets the number of async events sent by the plugins that can
+	 *        be queued before sinsp::next() returns them, rounded up to a
+	 *        power of two. When the queue is full the events are dropped,
+	 *        and the plugin gets a SS_PLUGIN_FAILURE from its handler.
+	 *        The queue is created when the first plugin with async events
+	 *        is opened, so this must be called before that. Throws a
+	 *        sinsp_exception if the capacity is 0 or larger than
+	 *        async_event_ring::MAX_CAPACITY.
+	 */
+	void set_async_events_queue_capacity(size_t capacity);
+
+	/*!
+	 * \brief sets the max number of events fetched from libscap with a single
+	 *        scap_next_batch() call. sinsp::next() still returns one event at a
+	 *        time, but the engine is queried once per batch, and the periodic
+	 *        housekeeping (purging of inactive threads and containers, stats,
+	 *        ...) runs once per batch too. A value of 1 (default) means that
+	 *        every event is fetched with scap_next(). This should be called
+	 *        before opening the inspector.
+	 */
+	void set_scap_batch_size(uint32_t val);
+
+	/*!
+	 * \brief sets the number of data blocks that are read and decompressed
+	 *        ahead of the parser on a background thread when opening a
+	 *        capture file. A value of 0 (default) means that the file is
+	 *        read on the same thread that parses the events. This should be
+	 *        called before opening the inspector.
+	 */
+	void set_savefile_prefetch_blocks(uint32_t val);
+
 
 	/*!
 	  \brief Start writing the captured events to file.
@@ -454,6 +525,12 @@ public:
 	*/
 	void autodump_start(const std::string& dump_filename, bool compress);
 
+	/*!
+	  \brief Start writing the captured events to file with the given
+	   compression mode, see \ref sinsp_dumper::open().
+	*/
+	void autodump_start(const std::string& dump_filename, compression_mode compress);
+
  	/*!
 	  \brief Cycles the file pointer to a new capture file
 	*/
@@ -504,6 +581,20 @@ public:
 	*/
 	scap_stats_v2* get_sinsp_stats_v2_buffer();
 
+	/*!
+	  \brief Return the occupancy of the memory that stores the enter events
+	  of the threads until their exit event arrives.
+	*/
+	libsinsp::evt_buffer_arena::stats get_stored_evts_stats() const;
+
+	/*!
+	  \brief Return the counters of the queue of the async events sent by
+	  the plugins, including the events dropped because the queue was full.
+	  The queue only exists once a plugin with async events has been opened,
+	  all the counters are zero before.
+	*/
+	libsinsp::async_event_ring::stats get_async_evts_stats() const;
+
 	/*!
 	  \brief Look up a thread given its tid and return its information,
 	   and optionally go dig into proc if the thread is not in the thread table.
@@ -932,6 +1023,7 @@ public:
 	/*=============================== Engine related ===============================*/
 
 	bool setup_cycle_writer(std::string base_file_name, int rollover_mb, int duration_seconds, int file_limit, unsigned long event_limit, bool compress);
+	bool setup_cycle_writer(std::string base_file_name, int rollover_mb, int duration_seconds, int file_limit, unsigned long event_limit, compression_mode compress);
 	void import_ipv4_interface(const sinsp_ipv4_ifinfo& ifinfo);
 	void add_meta_event(sinsp_evt *metaevt);
 	void add_meta_event_callback(meta_event_callback cback, void* data);
@@ -1000,7 +1092,7 @@ public:
 		return m_plugin_manager;
 	}
 
-	void handle_plugin_async_event(const sinsp_plugin& p, std::unique_ptr<sinsp_evt> evt);
+	bool handle_plugin_async_event(const sinsp_plugin& p, const ss_plugin_event* evt);
 
 	inline const std::vector<std::string>& event_sources() const
 	{
@@ -1100,6 +1192,8 @@ private:
 
 	scap_t* m_h;
 	uint64_t m_nevts;
+	// Number of events consumed by consume_initialstate_events()
+	uint64_t m_initialstate_nevts;
 	int64_t m_filesize;
 	scap_mode_t m_mode = SCAP_MODE_NONE;
 
@@ -1113,7 +1207,7 @@ private:
 	bool m_hostname_and_port_resolution_enabled;
 	char m_output_time_flag;
 	uint32_t m_max_evt_output_len;
-	bool m_compress;
+	compression_mode m_compress;
 	sinsp_evt m_evt;
 	std::string m_lasterr;
 	int64_t m_tid_to_remove;
@@ -1277,7 +1371,8 @@ public:
 	// 	information, read from sinsp::next().
 	// *	user added/removed events
 	// * 	group added/removed events
-	// *    async events produced by sinsp or plugins
+	// *    async events produced by sinsp (the ones of the plugins
+	//      are in m_async_evts below)
 #ifndef __EMSCRIPTEN__
 	tbb::concurrent_queue<std::shared_ptr<sinsp_evt>> m_pending_state_evts;
 #endif
@@ -1285,6 +1380,13 @@ public:
 	// Holds an event dequeued from the above queue
 	std::shared_ptr<sinsp_evt> m_state_evt;
 
+	// Async events sent by the plugins from their own threads, and the
+	// event returned by sinsp::next() for the one dequeued last. The queue
+	// is created when the first plugin with async events is opened.
+	std::unique_ptr<libsinsp::async_event_ring> m_async_evts;
+	size_t m_async_evts_capacity;
+	sinsp_evt m_async_evt;
+
 	//
 	// End of second housekeeping
 	//
@@ -1304,6 +1406,8 @@ public:
 	//
 	uint64_t m_proc_scan_timeout_ms;
 	uint64_t m_proc_scan_log_interval_ms;
+	uint32_t m_proc_scan_threads;
+	bool m_proc_scan_incremental;
 
 	// Any thread with a comm in this set will not have its events
 	// returned in sinsp::next()
@@ -1340,6 +1444,19 @@ public:
 	// information of the replayed scap event.
 	uint16_t m_replay_scap_cpuid;
 	//
+	// Events fetched from libscap with scap_next_batch() and not yet
+	// returned by sinsp::next(). They remain valid until the next
+	// call to scap_next_batch().
+	uint32_t m_scap_batch_size;
+	uint32_t m_scap_batch_len;
+	uint32_t m_scap_batch_pos;
+	std::vector<scap_evt*> m_scap_batch_evts;
+	std::vector<uint16_t> m_scap_batch_cpuids;
+	//
+	// Number of blocks read ahead by the savefile engine, see
+	// set_savefile_prefetch_blocks().
+	uint32_t m_savefile_prefetch_blocks;
+	//
 	// A registry that managers the state tables of this inspector
 	std::shared_ptr<libsinsp::state::table_registry> m_table_registry;
 
@@ -50,12 +50,14 @@ public:
         field_info(const std::string& n, size_t in, const typeinfo& i, void* defsptr, bool r)
             : m_readonly(r),
               m_index(in),
+              m_offset((size_t) -1),
               m_name(n),
               m_info(i),
               m_defsptr(defsptr) {}
         field_info():
             m_readonly(true),
             m_index((size_t) -1),
+            m_offset((size_t) -1),
             m_name(""),
             m_info(typeinfo::of<uint8_t>()),
             m_defsptr(NULL) {}
@@ -143,11 +145,13 @@ public:
     private:
         bool m_readonly;
         size_t m_index;
+        size_t m_offset; // byte offset of the field in the block of each struct
         std::string m_name;
         libsinsp::state::typeinfo m_info;
         void* m_defsptr;
 
         friend class dynamic_struct;
+        friend class field_infos;
     };
 
     /**
@@ -191,7 +195,7 @@ public:
     class field_infos
     {
     public:
-        field_infos() = default;
+        field_infos(): m_definitions(), m_definitions_ordered(), m_block_size(0) { }
         virtual ~field_infos() = default;
         field_infos(field_infos&&) = default;
         field_infos& operator = (field_infos&&) = default;
@@ -232,33 +236,69 @@ protected:
                 }
                 return it->second;
             }
-            m_definitions.insert({ field.name(), field });
-            const auto& def = m_definitions.at(field.name());
-            m_definitions_ordered.push_back(&def);
-            return def;
+            // the fields are laid out in the order they are defined, each
+            // aligned after the previous one
+            auto def = field;
+            size_t align = def.info().alignment();
+            def.m_offset = (m_block_size + align - 1) / align * align;
+            m_block_size = def.m_offset + def.info().size();
+            m_definitions.insert({ field.name(), def });
+            const auto& res = m_definitions.at(field.name());
+            m_definitions_ordered.push_back(&res);
+            return res;
         }
 
         std::unordered_map<std::string, field_info> m_definitions;
         std::vector<const field_info*> m_definitions_ordered;
+        size_t m_block_size; // byte size of the block holding all the fields
         friend class dynamic_struct;
     };
 
     dynamic_struct(const std::shared_ptr<field_infos>& dynamic_fields)
-        : m_fields_len(0), m_fields(), m_dynamic_fields(dynamic_fields) { }
-    dynamic_struct(dynamic_struct&&) = default;
-    dynamic_struct& operator = (dynamic_struct&&) = default;
-    dynamic_struct(const dynamic_struct& s) = default;
-    dynamic_struct& operator = (const dynamic_struct& s) = default;
-    virtual ~dynamic_struct()
+        : m_fields_len(0), m_fields_size(0), m_fields(nullptr), m_dynamic_fields(dynamic_fields) { }
+    dynamic_struct(dynamic_struct&& s)
+        : m_fields_len(s.m_fields_len),
+          m_fields_size(s.m_fields_size),
+          m_fields(s.m_fields),
+          m_dynamic_fields(std::move(s.m_dynamic_fields))
     {
-        if (m_dynamic_fields)
+        s.m_fields_len = 0;
+        s.m_fields_size = 0;
+        s.m_fields = nullptr;
+    }
+    dynamic_struct& operator = (dynamic_struct&& s)
+    {
+        if (this != &s)
         {
-            for (size_t i = 0; i < m_fields.size(); i++)
-            {
-                m_dynamic_fields->m_definitions_ordered[i]->info().destroy(m_fields[i]);
-                free(m_fields[i]);
-            }
+            _destroy_dynamic_fields();
+            m_fields_len = s.m_fields_len;
+            m_fields_size = s.m_fields_size;
+            m_fields = s.m_fields;
+            m_dynamic_fields = std::move(s.m_dynamic_fields);
+            s.m_fields_len = 0;
+            s.m_fields_size = 0;
+            s.m_fields = nullptr;
+        }
+        return *this;
+    }
+    dynamic_struct(const dynamic_struct& s)
+        : m_fields_len(0), m_fields_size(0), m_fields(nullptr), m_dynamic_fields(s.m_dynamic_fields)
+    {
+        _copy_dynamic_fields(s);
+    }
+    dynamic_struct& operator = (const dynamic_struct& s)
+    {
+        if (this != &s)
+        {
+            _destroy_dynamic_fields();
+            m_dynamic_fields = s.m_dynamic_fields;
+            _copy_dynamic_fields(s);
         }
+        return *this;
+    }
+    virtual ~dynamic_struct()
+    {
+        _destroy_dynamic_fields();
     }
 
     /**
@@ -320,7 +360,7 @@ protected:
     */
     virtual void get_dynamic_field(const field_info& i, void* out)
     {
-        const auto* buf = _access_dynamic_field(i.m_index);
+        const auto* buf = _access_dynamic_field(i);
         if (i.info().index() == PT_CHARBUF)
         {
             *((const char**) out) = ((const std::string*) buf)->c_str();
@@ -339,7 +379,7 @@ protected:
     */
     virtual void set_dynamic_field(const field_info& i, const void* in)
     {
-        auto* buf = _access_dynamic_field(i.m_index);
+        auto* buf = _access_dynamic_field(i);
         if (i.info().index() == PT_CHARBUF)
         {
             *((std::string*) buf) = *((const char**) in);
@@ -367,29 +407,91 @@ private:
         }
     }
 
-    inline void* _access_dynamic_field(size_t index)
+    //
+    // All the dynamic fields of a struct live in a single block, at the
+    // offset given by their definition. The fields are constructed in the
+    // block the first time one of them is accessed, and the block grows if
+    // more fields are defined later on.
+    //
+    inline void* _access_dynamic_field(const field_info& i)
+    {
+        if (i.m_index >= m_fields_len)
+        {
+            _construct_dynamic_fields(i.m_index);
+        }
+        return m_fields + i.m_offset;
+    }
+
+    void _construct_dynamic_fields(size_t index)
     {
         if (!m_dynamic_fields)
         {
             throw sinsp_exception("dynamic struct has no field definitions");
         }
-        if (index >= m_dynamic_fields->m_definitions_ordered.size())
+        const auto& defs = m_dynamic_fields->m_definitions_ordered;
+        if (index >= defs.size())
         {
             throw sinsp_exception("dynamic struct access overflow: " + std::to_string(index));
         }
-        while (m_fields_len <= index)
+        if (m_dynamic_fields->m_block_size > m_fields_size)
+        {
+            auto* block = static_cast<uint8_t*>(::operator new(m_dynamic_fields->m_block_size));
+            for (size_t j = 0; j < m_fields_len; j++)
+            {
+                const auto& info = defs[j]->info();
+                info.move_construct(block + defs[j]->m_offset, m_fields + defs[j]->m_offset);
+                info.destroy(m_fields + defs[j]->m_offset);
+            }
+            ::operator delete(m_fields);
+            m_fields = block;
+            m_fields_size = m_dynamic_fields->m_block_size;
+        }
+        for (; m_fields_len < defs.size(); m_fields_len++)
+        {
+            defs[m_fields_len]->info().construct(m_fields + defs[m_fields_len]->m_offset);
+        }
+    }
+
+    void _copy_dynamic_fields(const dynamic_struct& s)
+    {
+        if (s.m_fields_len == 0)
+        {
+            return;
+        }
+        const auto& defs = m_dynamic_fields->m_definitions_ordered;
+        m_fields = static_cast<uint8_t*>(::operator new(s.m_fields_size));
+        m_fields_size = s.m_fields_size;
+        try
+        {
+            for (; m_fields_len < s.m_fields_len; m_fields_len++)
+            {
+                auto offset = defs[m_fields_len]->m_offset;
+                defs[m_fields_len]->info().copy_construct(m_fields + offset, s.m_fields + offset);
+            }
+        }
+        catch (...)
+        {
+            _destroy_dynamic_fields();
+            throw;
+        }
+    }
+
+    void _destroy_dynamic_fields()
+    {
+        for (size_t i = 0; i < m_fields_len; i++)
         {
-            auto def = m_dynamic_fields->m_definitions_ordered[m_fields_len];
-            void* fieldbuf = malloc(def->info().size());
-            def->info().construct(fieldbuf);
-            m_fields.push_back(fieldbuf);
-            m_fields_len++;
+            const auto* def = m_dynamic_fields->m_definitions_ordered[i];
+            def->info().destroy(m_fields + def->m_offset);
         }
-        return m_fields[index];
+        ::operator delete(m_fields);
+        m_fields_len = 0;
+        m_fields_size = 0;
+        m_fields = nullptr;
     }
 
     size_t m_fields_len;
-    std::vector<void*> m_fields;
+    size_t m_fields_size;
+    uint8_t* m_fields;
     std::shared_ptr<field_infos> m_dynamic_fields;
 };
 
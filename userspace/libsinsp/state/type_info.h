@@ -20,6 +20,7 @@ limitations under the License.
 #include "../../driver/ppm_events_public.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace libsinsp {
@@ -92,6 +93,14 @@ public:
         return m_size;
     }
 
+    /**
+     * @brief Returns the alignment requirement of variables of the given type.
+     */
+    inline size_t alignment() const
+    {
+        return m_alignment;
+    }
+
     /**
      * @brief Constructs and initializes the given type in the passed-in
      * memory location, which is expected to be larger or equal than size().
@@ -110,9 +119,32 @@ public:
         if (p && m_destroy) m_destroy(p);
     }
 
+    /**
+     * @brief Constructs the given type in the passed-in memory location
+     * as a copy of the variable at "src".
+     */
+    inline void copy_construct(void* p, const void* src) const
+    {
+        if (p && m_copy_construct) m_copy_construct(p, src);
+    }
+
+    /**
+     * @brief Constructs the given type in the passed-in memory location
+     * by moving the variable at "src", which is left in a valid but
+     * unspecified state and still needs to be destroyed.
+     */
+    inline void move_construct(void* p, void* src) const noexcept
+    {
+        if (p && m_move_construct) m_move_construct(p, src);
+    }
+
 private:
-    inline typeinfo(const char* n, index_t k, size_t s, void (*c)(void*), void (*d)(void*))
-        : m_name(n), m_index(k), m_size(s), m_construct(c), m_destroy(d) { }
+    inline typeinfo(const char* n, index_t k, size_t s, size_t a,
+            void (*c)(void*), void (*d)(void*),
+            void (*cc)(void*, const void*), void (*mc)(void*, void*))
+        : m_name(n), m_index(k), m_size(s), m_alignment(a),
+          m_construct(c), m_destroy(d),
+          m_copy_construct(cc), m_move_construct(mc) { }
 
     template <typename T, typename _Alloc = std::allocator<T>> static inline void _construct(void* p)
     {
@@ -126,16 +158,32 @@ private:
         std::allocator_traits<_Alloc>::destroy(a, reinterpret_cast<T*>(p));
     }
 
+    template <typename T, typename _Alloc = std::allocator<T>> static inline void _copy_construct(void* p, const void* src)
+    {
+        _Alloc a;
+        std::allocator_traits<_Alloc>::construct(a, reinterpret_cast<T*>(p), *reinterpret_cast<const T*>(src));
+    }
+
+    template <typename T, typename _Alloc = std::allocator<T>> static inline void _move_construct(void* p, void* src)
+    {
+        _Alloc a;
+        std::allocator_traits<_Alloc>::construct(a, reinterpret_cast<T*>(p), std::move(*reinterpret_cast<T*>(src)));
+    }
+
     template<typename T> static inline typeinfo _build(const char* n, index_t k)
     {
-        return typeinfo(n, k, sizeof(T), _construct<T>, _destroy<T>);
+        return typeinfo(n, k, sizeof(T), alignof(T),
+            _construct<T>, _destroy<T>, _copy_construct<T>, _move_construct<T>);
     }
 
     const char* m_name;
     index_t m_index;
     size_t m_size;
+    size_t m_alignment;
     void (*m_construct)(void*);
     void (*m_destroy)(void*);
+    void (*m_copy_construct)(void*, const void*);
+    void (*m_move_construct)(void*, void*);
 };
 
 // below is the manually-controlled list of all the supported types
@@ -0,0 +1,266 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <cstdint>
+#include <cstring>
+
+#include "strsearch.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define STRSEARCH_X86_64
+#include <immintrin.h>
+#endif
+
+using namespace libsinsp;
+
+static inline uint8_t to_lower(uint8_t c)
+{
+	return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static inline uint8_t to_upper(uint8_t c)
+{
+	return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+template<bool icase>
+static inline bool equal(const char* a, const char* b, size_t len)
+{
+	if(!icase)
+	{
+		return memcmp(a, b, len) == 0;
+	}
+	for(size_t i = 0; i < len; i++)
+	{
+		if(to_lower(a[i]) != to_lower(b[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//
+// The kernels below expect 1 <= needle_len <= haystack_len
+//
+
+template<bool icase>
+static const char* find_scalar(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+	const char* last = haystack + haystack_len - needle_len;
+	if(!icase)
+	{
+		for(const char* p = haystack; p <= last; p++)
+		{
+			p = (const char*)memchr(p, needle[0], last - p + 1);
+			if(p == NULL)
+			{
+				return NULL;
+			}
+			if(memcmp(p + 1, needle + 1, needle_len - 1) == 0)
+			{
+				return p;
+			}
+		}
+		return NULL;
+	}
+
+	uint8_t first = to_lower(needle[0]);
+	for(const char* p = haystack; p <= last; p++)
+	{
+		if(to_lower(*p) == first && equal<true>(p + 1, needle + 1, needle_len - 1))
+		{
+			return p;
+		}
+	}
+	return NULL;
+}
+
+#ifdef STRSEARCH_X86_64
+
+//
+// Each bit of mask is a position of the block where both the first and the
+// last byte of the needle match, so only the bytes in between are compared
+//
+template<bool icase>
+static inline const char* verify(const char* block, uint32_t mask, const char* needle, size_t needle_len)
+{
+	size_t middle_len = needle_len > 2 ? needle_len - 2 : 0;
+	while(mask != 0)
+	{
+		uint32_t pos = __builtin_ctz(mask);
+		if(equal<icase>(block + pos + 1, needle + 1, middle_len))
+		{
+			return block + pos;
+		}
+		mask &= mask - 1;
+	}
+	return NULL;
+}
+
+//
+// The haystack is scanned in blocks of 16 (or 32) candidate positions. The
+// last block is aligned to the end of the haystack, so it overlaps with the
+// previous one, whose positions are masked out.
+//
+template<bool icase>
+static const char* find_sse2(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+	const size_t last = needle_len - 1;
+	const size_t positions = haystack_len - last;
+	if(positions < 16)
+	{
+		return find_scalar<icase>(haystack, haystack_len, needle, needle_len);
+	}
+
+	const __m128i first_lo = _mm_set1_epi8(icase ? to_lower(needle[0]) : needle[0]);
+	const __m128i first_up = _mm_set1_epi8(icase ? to_upper(needle[0]) : needle[0]);
+	const __m128i last_lo = _mm_set1_epi8(icase ? to_lower(needle[last]) : needle[last]);
+	const __m128i last_up = _mm_set1_epi8(icase ? to_upper(needle[last]) : needle[last]);
+
+	for(size_t i = 0; i < positions; i += 16)
+	{
+		size_t start = i + 16 <= positions ? i : positions - 16;
+		__m128i block_first = _mm_loadu_si128((const __m128i*)(haystack + start));
+		__m128i block_last = _mm_loadu_si128((const __m128i*)(haystack + start + last));
+		__m128i eq_first = _mm_cmpeq_epi8(block_first, first_lo);
+		__m128i eq_last = _mm_cmpeq_epi8(block_last, last_lo);
+		if(icase)
+		{
+			eq_first = _mm_or_si128(eq_first, _mm_cmpeq_epi8(block_first, first_up));
+			eq_last = _mm_or_si128(eq_last, _mm_cmpeq_epi8(block_last, last_up));
+		}
+		uint32_t mask = _mm_movemask_epi8(_mm_and_si128(eq_first, eq_last));
+		mask &= ~0u << (i - start);
+		const char* res = verify<icase>(haystack + start, mask, needle, needle_len);
+		if(res != NULL)
+		{
+			return res;
+		}
+	}
+	return NULL;
+}
+
+// Expects at least 32 candidate positions
+template<bool icase>
+__attribute__((target("avx2")))
+static const char* find_avx2(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+	const size_t last = needle_len - 1;
+	const size_t positions = haystack_len - last;
+
+	const __m256i first_lo = _mm256_set1_epi8(icase ? to_lower(needle[0]) : needle[0]);
+	const __m256i first_up = _mm256_set1_epi8(icase ? to_upper(needle[0]) : needle[0]);
+	const __m256i last_lo = _mm256_set1_epi8(icase ? to_lower(needle[last]) : needle[last]);
+	const __m256i last_up = _mm256_set1_epi8(icase ? to_upper(needle[last]) : needle[last]);
+
+	for(size_t i = 0; i < positions; i += 32)
+	{
+		size_t start = i + 32 <= positions ? i : positions - 32;
+		__m256i block_first = _mm256_loadu_si256((const __m256i*)(haystack + start));
+		__m256i block_last = _mm256_loadu_si256((const __m256i*)(haystack + start + last));
+		__m256i eq_first = _mm256_cmpeq_epi8(block_first, first_lo);
+		__m256i eq_last = _mm256_cmpeq_epi8(block_last, last_lo);
+		if(icase)
+		{
+			eq_first = _mm256_or_si256(eq_first, _mm256_cmpeq_epi8(block_first, first_up));
+			eq_last = _mm256_or_si256(eq_last, _mm256_cmpeq_epi8(block_last, last_up));
+		}
+		uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_last));
+		mask &= ~0u << (i - start);
+		const char* res = verify<icase>(haystack + start, mask, needle, needle_len);
+		if(res != NULL)
+		{
+			return res;
+		}
+	}
+	return NULL;
+}
+
+template<bool icase>
+static const char* find_x86_64(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+	// too few positions to fill a 32 bytes block
+	if(haystack_len - needle_len < 31)
+	{
+		return find_sse2<icase>(haystack, haystack_len, needle, needle_len);
+	}
+	return find_avx2<icase>(haystack, haystack_len, needle, needle_len);
+}
+
+#endif // STRSEARCH_X86_64
+
+typedef const char* (*find_fn)(const char*, size_t, const char*, size_t);
+
+struct kernels
+{
+	find_fn m_find;
+	find_fn m_ifind;
+	const char* m_name;
+};
+
+static kernels select_kernels()
+{
+#ifdef STRSEARCH_X86_64
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+	{
+		return {find_x86_64<false>, find_x86_64<true>, "avx2"};
+	}
+	// SSE2 is part of the x86_64 baseline
+	return {find_sse2<false>, find_sse2<true>, "sse2"};
+#else
+	return {find_scalar<false>, find_scalar<true>, "scalar"};
+#endif
+}
+
+static const kernels& get_kernels()
+{
+	static const kernels k = select_kernels();
+	return k;
+}
+
+const char* strsearch::find(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+	if(needle_len == 0)
+	{
+		return haystack;
+	}
+	if(needle_len > haystack_len)
+	{
+		return NULL;
+	}
+	return get_kernels().m_find(haystack, haystack_len, needle, needle_len);
+}
+
+const char* strsearch::ifind(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
+{
+	if(needle_len == 0)
+	{
+		return haystack;
+	}
+	if(needle_len > haystack_len)
+	{
+		return NULL;
+	}
+	return get_kernels().m_ifind(haystack, haystack_len, needle, needle_len);
+}
+
+const char* strsearch::implementation()
+{
+	return get_kernels().m_name;
+}
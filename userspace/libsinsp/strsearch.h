@@ -0,0 +1,53 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace libsinsp
+{
+namespace strsearch
+{
+
+//
+// Substring search over buffers of known length, used by the filter
+// operators. On x86_64 the candidates are found comparing the first and the
+// last byte of the needle with whole vectors of the haystack, with AVX2 if
+// the CPU supports it and SSE2 otherwise. The other platforms use a
+// portable scalar loop.
+//
+
+//
+// Return the first occurrence of needle in haystack, or NULL if there is
+// none. An empty needle matches at the start of the haystack.
+//
+const char* find(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len);
+
+//
+// Same as find(), but ASCII letters match regardless of their case, like
+// strcasestr() in the C locale
+//
+const char* ifind(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len);
+
+//
+// Name of the implementation picked for this CPU, e.g. "avx2"
+//
+const char* implementation();
+
+}
+}
@@ -0,0 +1,203 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <scap.h>
+#include "async_event_ring.h"
+
+using libsinsp::async_event_ring;
+
+// Queue an event of len bytes whose payload is filled with the tid
+static bool push_event(async_event_ring& ring, uint64_t tid, uint64_t ts, uint32_t len = sizeof(scap_evt) + 16)
+{
+	return ring.push(len, [&](scap_evt* e)
+	{
+		memset((uint8_t*)e + sizeof(scap_evt), (int)tid, len - sizeof(scap_evt));
+		e->ts = ts;
+		e->tid = tid;
+		e->len = len;
+		e->type = PPME_ASYNCEVENT_E;
+		e->nparams = 0;
+	});
+}
+
+static bool payload_matches(const scap_evt* e)
+{
+	const uint8_t* p = (const uint8_t*)e + sizeof(scap_evt);
+	for(uint32_t i = 0; i < e->len - sizeof(scap_evt); i++)
+	{
+		if(p[i] != (uint8_t)e->tid)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST(async_event_ring, push_pop)
+{
+	async_event_ring ring(3);
+	ASSERT_EQ(ring.capacity(), 4);
+	ASSERT_EQ(ring.pop(), nullptr);
+
+	// the events come out in order, and the large ones grow their slot
+	ASSERT_TRUE(push_event(ring, 1, 100));
+	ASSERT_TRUE(push_event(ring, 2, 200, async_event_ring::SLOT_SIZE * 3));
+	ASSERT_TRUE(push_event(ring, 3, 300));
+	for(uint64_t tid = 1; tid <= 3; tid++)
+	{
+		scap_evt* e = ring.pop();
+		ASSERT_NE(e, nullptr);
+		ASSERT_EQ(e->tid, tid);
+		ASSERT_EQ(e->ts, tid * 100);
+		ASSERT_TRUE(payload_matches(e));
+	}
+	ASSERT_EQ(ring.pop(), nullptr);
+
+	auto stats = ring.get_stats();
+	ASSERT_EQ(stats.m_capacity, 4);
+	ASSERT_EQ(stats.m_pushed, 3);
+	ASSERT_EQ(stats.m_popped, 3);
+	ASSERT_EQ(stats.m_dropped, 0);
+}
+
+TEST(async_event_ring, large_events)
+{
+	async_event_ring ring(4);
+	const uint32_t large = async_event_ring::MAX_KEPT_SLOT_SIZE * 2;
+
+	// the slots given back after a large event can still take large ones
+	// (the slot of the last popped event stays held, so two events per
+	// round need more than two slots)
+	for(uint64_t i = 0; i < 4; i++)
+	{
+		ASSERT_TRUE(push_event(ring, i, i, large));
+		ASSERT_TRUE(push_event(ring, i + 100, i));
+		scap_evt* e = ring.pop();
+		ASSERT_EQ(e->tid, i);
+		ASSERT_EQ(e->len, large);
+		ASSERT_TRUE(payload_matches(e));
+		ASSERT_EQ(ring.pop()->tid, i + 100);
+	}
+	ASSERT_EQ(ring.pop(), nullptr);
+	ASSERT_EQ(ring.get_stats().m_popped, 8);
+}
+
+TEST(async_event_ring, full)
+{
+	async_event_ring ring(4);
+	for(uint64_t i = 0; i < 4; i++)
+	{
+		ASSERT_TRUE(push_event(ring, i, i));
+	}
+
+	// the events that don't fit are dropped, without touching the others
+	bool filled = false;
+	ASSERT_FALSE(ring.push(sizeof(scap_evt), [&](scap_evt*) { filled = true; }));
+	ASSERT_FALSE(filled);
+	ASSERT_EQ(ring.get_stats().m_dropped, 1);
+
+	// the slot of the last popped event is only given back by the next pop
+	scap_evt* e = ring.pop();
+	ASSERT_EQ(e->tid, 0);
+	ASSERT_FALSE(push_event(ring, 4, 4));
+	ASSERT_EQ(e->tid, 0);
+	ASSERT_EQ(ring.pop()->tid, 1);
+	ASSERT_TRUE(push_event(ring, 4, 4));
+
+	for(uint64_t tid = 2; tid <= 4; tid++)
+	{
+		ASSERT_EQ(ring.pop()->tid, tid);
+	}
+	ASSERT_EQ(ring.pop(), nullptr);
+
+	auto stats = ring.get_stats();
+	ASSERT_EQ(stats.m_pushed, 5);
+	ASSERT_EQ(stats.m_popped, 5);
+	ASSERT_EQ(stats.m_dropped, 2);
+}
+
+TEST(async_event_ring, failed_fill)
+{
+	async_event_ring ring(4);
+	ASSERT_TRUE(push_event(ring, 1, 1));
+	ASSERT_THROW(ring.push(sizeof(scap_evt), [](scap_evt*) { throw std::runtime_error("fail"); }),
+		     std::runtime_error);
+	ASSERT_TRUE(push_event(ring, 2, 2));
+
+	// the slot of the failed event is skipped
+	ASSERT_EQ(ring.pop()->tid, 1);
+	ASSERT_EQ(ring.pop()->tid, 2);
+	ASSERT_EQ(ring.pop(), nullptr);
+	ASSERT_EQ(ring.get_stats().m_pushed, 2);
+	ASSERT_EQ(ring.get_stats().m_popped, 2);
+}
+
+TEST(async_event_ring, concurrent_producers)
+{
+	constexpr uint64_t num_producers = 4;
+	constexpr uint64_t num_events = 20000;
+	async_event_ring ring(64);
+
+	// each producer retries until its events are queued, in order
+	std::vector<std::thread> producers;
+	for(uint64_t tid = 0; tid < num_producers; tid++)
+	{
+		producers.emplace_back([&ring, tid]()
+		{
+			for(uint64_t i = 0; i < num_events; i++)
+			{
+				uint32_t len = sizeof(scap_evt) + (i % 7 == 0 ? 1000 : 8);
+				while(!push_event(ring, tid, i, len))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	std::vector<uint64_t> next(num_producers, 0);
+	uint64_t popped = 0;
+	while(popped < num_producers * num_events)
+	{
+		scap_evt* e = ring.pop();
+		if(e == nullptr)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		ASSERT_LT(e->tid, num_producers);
+		ASSERT_EQ(e->ts, next[e->tid]);
+		ASSERT_TRUE(payload_matches(e));
+		next[e->tid]++;
+		popped++;
+	}
+	for(auto& p : producers)
+	{
+		p.join();
+	}
+	ASSERT_EQ(ring.pop(), nullptr);
+
+	auto stats = ring.get_stats();
+	ASSERT_EQ(stats.m_pushed, num_producers * num_events);
+	ASSERT_EQ(stats.m_popped, num_producers * num_events);
+}
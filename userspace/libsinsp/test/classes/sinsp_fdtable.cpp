@@ -0,0 +1,125 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+#include <sinsp.h>
+
+static sinsp_fdinfo_t* add_fd(sinsp_fdtable& table, int64_t fd)
+{
+	sinsp_fdinfo_t fdinfo;
+	fdinfo.m_name = std::to_string(fd);
+	return table.add(fd, &fdinfo);
+}
+
+TEST(sinsp_fdtable, add_find_erase)
+{
+	sinsp inspector;
+	sinsp_fdtable table(&inspector);
+
+	/* Dense, sparse and negative fds are stored in different places */
+	std::vector<int64_t> fds = {0, 1, 2, 3, 100, sinsp_fdtable::DIRECT_FD_LIMIT - 1,
+				    sinsp_fdtable::DIRECT_FD_LIMIT, 1000000, -5};
+	for(auto fd : fds)
+	{
+		ASSERT_EQ(table.find(fd), nullptr);
+		ASSERT_NE(add_fd(table, fd), nullptr);
+	}
+	ASSERT_EQ(table.size(), fds.size());
+
+	/* The fdinfo pointers stay valid while other fds are added */
+	sinsp_fdinfo_t* fd3 = table.find(3);
+	for(int64_t fd = 4; fd < 100; fd++)
+	{
+		add_fd(table, fd);
+	}
+	ASSERT_EQ(table.find(3), fd3);
+	ASSERT_EQ(fd3->m_name, "3");
+	for(auto fd : fds)
+	{
+		ASSERT_NE(table.find(fd), nullptr);
+		ASSERT_EQ(table.find(fd)->m_name, std::to_string(fd));
+	}
+
+	/* Adding an existing fd replaces it */
+	size_t size = table.size();
+	sinsp_fdinfo_t replacement;
+	replacement.m_name = "replaced";
+	ASSERT_EQ(table.add(3, &replacement), fd3);
+	ASSERT_EQ(table.find(3)->m_name, "replaced");
+	ASSERT_EQ(table.size(), size);
+
+	/* Dense fds are visited first, in increasing order */
+	int64_t prev = -1;
+	size_t looped = 0;
+	table.loop([&](int64_t fd, const sinsp_fdinfo_t& fdinfo) {
+		if(fd >= 0 && fd < sinsp_fdtable::DIRECT_FD_LIMIT)
+		{
+			EXPECT_GT(fd, prev);
+			prev = fd;
+		}
+		looped++;
+		return true;
+	});
+	ASSERT_EQ(looped, table.size());
+
+	for(auto fd : fds)
+	{
+		table.erase(fd);
+		ASSERT_EQ(table.find(fd), nullptr);
+	}
+	ASSERT_EQ(table.size(), size - fds.size());
+	ASSERT_NE(table.find(50), nullptr);
+
+	table.clear();
+	ASSERT_EQ(table.size(), (size_t)0);
+	ASSERT_EQ(table.find(50), nullptr);
+}
+
+TEST(sinsp_fdtable, copy)
+{
+	sinsp inspector;
+	sinsp_fdtable table(&inspector);
+	add_fd(table, 1);
+	add_fd(table, 100000);
+
+	/* Warm up the cache, the copy must not point to the original entries */
+	sinsp_fdinfo_t* fd1 = table.find(1);
+
+	sinsp_fdtable copy = table;
+	ASSERT_EQ(copy.size(), (size_t)2);
+	ASSERT_NE(copy.find(1), nullptr);
+	ASSERT_NE(copy.find(1), fd1);
+	ASSERT_EQ(copy.find(1)->m_name, "1");
+	ASSERT_EQ(copy.find(100000)->m_name, "100000");
+
+	copy.erase(1);
+	ASSERT_EQ(copy.find(1), nullptr);
+	ASSERT_EQ(table.find(1), fd1);
+}
+
+TEST(sinsp_fdtable, max_size)
+{
+	sinsp inspector;
+	inspector.m_max_fdtable_size = 3;
+	sinsp_fdtable table(&inspector);
+	ASSERT_NE(add_fd(table, 0), nullptr);
+	ASSERT_NE(add_fd(table, 1), nullptr);
+	ASSERT_NE(add_fd(table, 100000), nullptr);
+	ASSERT_EQ(add_fd(table, 2), nullptr);
+	ASSERT_EQ(add_fd(table, 200000), nullptr);
+	ASSERT_EQ(table.size(), (size_t)3);
+}
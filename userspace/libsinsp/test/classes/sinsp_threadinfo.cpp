@@ -17,6 +17,9 @@ limitations under the License.
 
 #include <test/helpers/threads_helpers.h>
 
+#include <filesystem>
+#include <fstream>
+
 TEST(sinsp_threadinfo, get_main_thread)
 {
 	auto tinfo = std::make_shared<sinsp_threadinfo>();
@@ -125,3 +128,106 @@ TEST_F(sinsp_with_test_input, THRD_INFO_assign_children_to_a_nullptr)
 	ASSERT_THREAD_CHILDREN(p2_t1_tid, 0, 0);
 	ASSERT_THREAD_INFO_PIDS(p3_t1_tid, p3_t1_pid, 0);
 }
+
+TEST(sinsp_threadinfo, shared_args_env_cgroups)
+{
+	sinsp inspector;
+	std::unique_ptr<sinsp_threadinfo> tinfo1(inspector.build_threadinfo());
+	std::unique_ptr<sinsp_threadinfo> tinfo2(inspector.build_threadinfo());
+	tinfo1->m_tid = tinfo1->m_pid = 23;
+	tinfo2->m_tid = tinfo2->m_pid = 24;
+
+	const char args[] = "-d\0-v";
+	const char env[] = "A=1\0B=2\0\0\0";
+	const char cgroups[] = "cpuset=/\0perf_event=/\0mem_cgroup=/user.slice";
+
+	tinfo1->set_args(args, sizeof(args));
+	tinfo1->set_env(env, sizeof(env));
+	tinfo1->set_cgroups(cgroups, sizeof(cgroups));
+	ASSERT_EQ(tinfo1->get_args(), std::vector<std::string>({"-d", "-v"}));
+	ASSERT_EQ(tinfo1->get_env(), std::vector<std::string>({"A=1", "B=2"}));
+	ASSERT_EQ(tinfo1->cgroups().size(), 3);
+	ASSERT_EQ(tinfo1->cgroups()[2], std::make_pair(std::string("memory"), std::string("/user.slice")));
+
+	/* The same values are stored only once */
+	tinfo2->set_args(args, sizeof(args));
+	tinfo2->set_env(env, sizeof(env));
+	tinfo2->set_cgroups(cgroups, sizeof(cgroups));
+	ASSERT_EQ(tinfo1->m_args, tinfo2->m_args);
+	ASSERT_EQ(tinfo1->m_env, tinfo2->m_env);
+	ASSERT_EQ(tinfo1->m_cgroups, tinfo2->m_cgroups);
+
+	/* Setting a new value doesn't affect the other threads */
+	const char other_args[] = "-x";
+	tinfo2->set_args(other_args, sizeof(other_args));
+	ASSERT_EQ(tinfo1->get_args(), std::vector<std::string>({"-d", "-v"}));
+	ASSERT_EQ(tinfo2->get_args(), std::vector<std::string>({"-x"}));
+
+	/* Threads without an inspector still own their values */
+	sinsp_threadinfo standalone;
+	standalone.set_args(args, sizeof(args));
+	ASSERT_EQ(standalone.get_args(), tinfo1->get_args());
+	ASSERT_NE(standalone.m_args, tinfo1->m_args);
+}
+
+TEST_F(sinsp_with_test_input, THRD_INFO_env_from_event_and_proc)
+{
+	/* Env blocks with an empty string, each one read from an event and from a fake /proc.
+	 * The block of tids 2 and 3 is seen first from /proc, the one of tids 4 and 5 from an event.
+	 */
+	const std::string env1("A=1\0\0B=2", 9);
+	const std::string env2("C=3\0\0D=4", 9);
+	struct
+	{
+		int64_t tid;
+		const std::string& env;
+		bool from_proc;
+		std::vector<std::string> expected;
+	} threads[] = {
+		{3, env1, true, {"A=1", "B=2"}},
+		{2, env1, false, {"A=1", "", "B=2"}},
+		{4, env2, false, {"C=3", "", "D=4"}},
+		{5, env2, true, {"C=3", "D=4"}},
+	};
+
+	char host_root[] = "/tmp/sinsp_threadinfo_env_XXXXXX";
+	ASSERT_NE(mkdtemp(host_root), nullptr);
+	m_inspector.set_host_root(host_root);
+
+	add_default_init_thread();
+	for(const auto& t : threads)
+	{
+		add_simple_thread(t.tid, t.tid, INIT_TID);
+		if(t.from_proc)
+		{
+			auto proc_dir = std::filesystem::path(host_root) / "proc" / std::to_string(t.tid);
+			std::filesystem::create_directories(proc_dir);
+			std::ofstream(proc_dir / "environ") << t.env;
+		}
+	}
+	open_inspector();
+
+	uint64_t not_relevant_64 = 0;
+	uint32_t not_relevant_32 = 0;
+	scap_const_sized_buffer empty_bytebuf = {/*.buf =*/ nullptr, /*.size =*/ 0};
+	for(const auto& t : threads)
+	{
+		if(t.from_proc)
+		{
+			ASSERT_TRUE(m_inspector.get_thread_ref(t.tid)->set_env_from_proc());
+			continue;
+		}
+
+		scap_const_sized_buffer env_buf = {t.env.data(), t.env.size()};
+		add_event_advance_ts(increasing_ts(), t.tid, PPME_SYSCALL_EXECVE_19_E, 1, "/bin/test-exe");
+		add_event_advance_ts(increasing_ts(), t.tid, PPME_SYSCALL_EXECVE_19_X, 28, (int64_t)0, "/bin/test-exe", empty_bytebuf, t.tid, t.tid, (int64_t)INIT_TID, "", not_relevant_64, not_relevant_64, not_relevant_64, not_relevant_32, not_relevant_32, not_relevant_32, "test-exe", empty_bytebuf, env_buf, not_relevant_32, not_relevant_64, not_relevant_32, not_relevant_32, not_relevant_64, not_relevant_64, not_relevant_64, not_relevant_64, not_relevant_64, not_relevant_64, not_relevant_32, "/bin/test-exe");
+	}
+
+	/* The parsed values don't depend on which thread was seen first */
+	for(const auto& t : threads)
+	{
+		ASSERT_EQ(m_inspector.get_thread_ref(t.tid)->get_env(), t.expected);
+	}
+
+	std::filesystem::remove_all(host_root);
+}
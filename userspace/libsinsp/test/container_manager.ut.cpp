@@ -0,0 +1,116 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include <sinsp.h>
+#include <container.h>
+
+static sinsp_container_info::ptr_t make_container(const std::string& id, const std::string& name)
+{
+	auto info = std::make_shared<sinsp_container_info>();
+	info->m_id = id;
+	info->m_name = name;
+	info->m_type = CT_DOCKER;
+	return info;
+}
+
+TEST(sinsp_container_manager, snapshots)
+{
+	sinsp inspector;
+	sinsp_container_manager manager(&inspector);
+
+	ASSERT_EQ(manager.get_container("aaa"), nullptr);
+	ASSERT_FALSE(manager.container_exists("aaa"));
+
+	manager.add_container(make_container("aaa", "first"), nullptr);
+	auto containers = manager.get_containers();
+	ASSERT_EQ(containers->size(), 1);
+	ASSERT_EQ(manager.get_container("aaa")->m_name, "first");
+	ASSERT_TRUE(manager.container_exists("aaa"));
+
+	// the updates are visible to the lookups, but not to older snapshots
+	manager.add_container(make_container("bbb", "second"), nullptr);
+	manager.replace_container(make_container("aaa", "replaced"));
+	ASSERT_EQ(manager.get_container("aaa")->m_name, "replaced");
+	ASSERT_EQ(manager.get_container("bbb")->m_name, "second");
+	ASSERT_EQ(containers->size(), 1);
+	ASSERT_EQ(containers->at("aaa")->m_name, "first");
+	ASSERT_EQ(manager.get_containers()->size(), 2);
+
+	// each manager has its own table, even on the same reader thread
+	sinsp_container_manager other(&inspector);
+	ASSERT_EQ(other.get_container("aaa"), nullptr);
+	ASSERT_EQ(manager.get_container("aaa")->m_name, "replaced");
+}
+
+TEST(sinsp_container_manager, concurrent_lookups)
+{
+	constexpr int num_containers = 500;
+	sinsp inspector;
+	sinsp_container_manager manager(&inspector);
+
+	// a writer adds the containers in order, while a reader waits for each
+	// of them and checks that it never sees a partially updated entry
+	std::atomic<bool> failed{false};
+	std::thread reader([&]()
+	{
+		for(int i = 0; i < num_containers && !failed; i++)
+		{
+			std::string id = "container-" + std::to_string(i);
+			sinsp_container_info::ptr_t info;
+			while((info = manager.get_container(id)) == nullptr)
+			{
+				std::this_thread::yield();
+			}
+			if(info->m_id != id || info->m_name.rfind("name-" + std::to_string(i), 0) != 0)
+			{
+				failed = true;
+			}
+		}
+	});
+
+	for(int i = 0; i < num_containers; i++)
+	{
+		std::string id = "container-" + std::to_string(i);
+		manager.add_container(make_container(id, "name-" + std::to_string(i)), nullptr);
+		manager.replace_container(make_container(id, "name-" + std::to_string(i) + "-updated"));
+	}
+	reader.join();
+
+	ASSERT_FALSE(failed);
+	ASSERT_EQ(manager.get_containers()->size(), num_containers);
+	ASSERT_EQ(manager.get_container("container-0")->m_name, "name-0-updated");
+}
+
+TEST(sinsp_container_manager, destroy_releases_snapshot)
+{
+	sinsp inspector;
+	std::weak_ptr<const sinsp_container_manager::map_t> containers;
+	{
+		sinsp_container_manager manager(&inspector);
+		manager.add_container(make_container("aaa", "first"), nullptr);
+		ASSERT_NE(manager.get_container("aaa"), nullptr);
+		containers = manager.get_containers();
+	}
+
+	// the snapshot cached by this thread doesn't outlive the manager
+	ASSERT_TRUE(containers.expired());
+}
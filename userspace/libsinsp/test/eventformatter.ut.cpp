@@ -17,12 +17,16 @@ limitations under the License.
 
 #include "sinsp.h"
 #include "eventformatter.h"
+#include "filterchecks.h"
+#include "sinsp_with_test_input.h"
 
 #include <gtest/gtest.h>
+#include <json/json.h>
 
 #include <vector>
 #include <string>
 #include <iostream>
+#include <memory>
 
 using namespace std;
 
@@ -38,4 +42,87 @@ TEST(eventformatter, get_field_names)
 	ASSERT_NE(find(output_fields.begin(), output_fields.end(), "fd.type"), output_fields.end());
 	ASSERT_NE(find(output_fields.begin(), output_fields.end(), "proc.pid"), output_fields.end());
 	delete inspector;
-}
\ No newline at end of file
+}
+
+// Renders the given fields the way the JSON output did before it was
+// streamed, building a Json::Value object and serializing it
+static string json_with_value_tree(sinsp* inspector, sinsp_evt* evt, const vector<string>& fields)
+{
+	Json::Value root;
+	for(const auto& field : fields)
+	{
+		unique_ptr<sinsp_filter_check> chk(g_filterlist.new_filter_check_from_fldname(field, inspector, false));
+		chk->parse_field_name(field.c_str(), true, false);
+		root[field] = chk->tojson(evt);
+	}
+	string output = Json::FastWriter().write(root);
+	return output.substr(0, output.size() - 1);
+}
+
+TEST_F(sinsp_with_test_input, eventformatter_json_output)
+{
+	add_default_init_thread();
+	open_inspector();
+
+	const char* name = "/tmp/\"quoted\"\\dir\n/f\xc3\xa9\xf0\x9f\x90\xa7\x01\xff";
+	add_event_advance_ts(increasing_ts(), INIT_TID, PPME_SYSCALL_OPEN_E, 3, name, (uint32_t)PPM_O_RDWR, (uint32_t)0);
+	sinsp_evt* evt = add_event_advance_ts(increasing_ts(), INIT_TID, PPME_SYSCALL_OPEN_X, 6, (uint64_t)3, name, (uint32_t)PPM_O_RDWR, (uint32_t)0, (uint32_t)5, (uint64_t)123);
+
+	vector<string> fields = {"thread.tid", "evt.num", "evt.time", "evt.rawtime", "evt.count", "evt.type",
+		"evt.is_io", "proc.name", "fd.num", "fd.name", "fd.types", "fd.sip", "evt.arg.flags"};
+	string expected = json_with_value_tree(&m_inspector, evt, fields);
+
+	// fields end up sorted by name, and duplicated ones are written once
+	string format = "*";
+	for(const auto& field : fields)
+	{
+		format += "%" + field + " ";
+	}
+	format += "%fd.num";
+	sinsp_evt_formatter fmt(&m_inspector, format);
+
+	string output;
+	ASSERT_TRUE(fmt.tostring_withformat(evt, output, gen_event_formatter::OF_JSON));
+	ASSERT_EQ(output, expected);
+	ASSERT_NE(output.find("\"fd.sip\":null"), string::npos);
+
+	// the output buffer is reused across calls
+	ASSERT_TRUE(fmt.tostring_withformat(evt, output, gen_event_formatter::OF_JSON));
+	ASSERT_EQ(output, expected);
+
+	// a missing value fails the formatting when all of them are required
+	sinsp_evt_formatter required(&m_inspector, "%proc.name %fd.sip");
+	ASSERT_FALSE(required.tostring_withformat(evt, output, gen_event_formatter::OF_JSON));
+	ASSERT_EQ(output, json_with_value_tree(&m_inspector, evt, {"proc.name", "fd.sip"}));
+
+	// no fields at all
+	sinsp_evt_formatter text_only(&m_inspector, "only text");
+	ASSERT_TRUE(text_only.tostring_withformat(evt, output, gen_event_formatter::OF_JSON));
+	ASSERT_EQ(output, "null");
+}
+
+TEST_F(sinsp_with_test_input, eventformatter_text_output)
+{
+	add_default_init_thread();
+	open_inspector();
+
+	add_event_advance_ts(increasing_ts(), INIT_TID, PPME_SYSCALL_OPEN_E, 3, "/tmp/the_file", (uint32_t)PPM_O_RDWR, (uint32_t)0);
+	sinsp_evt* evt = add_event_advance_ts(increasing_ts(), INIT_TID, PPME_SYSCALL_OPEN_X, 6, (uint64_t)3, "/tmp/the_file", (uint32_t)PPM_O_RDWR, (uint32_t)0, (uint32_t)5, (uint64_t)123);
+
+	string output;
+	sinsp_evt_formatter fmt(&m_inspector, "*open %fd.name by %proc.name|%8proc.name|%3fd.name|ip=%fd.sip end");
+	ASSERT_TRUE(fmt.tostring(evt, &output));
+	ASSERT_EQ(output, "open /tmp/the_file by init|init    |/tm|ip=<NA> end");
+
+	// the text before the missing value is kept
+	sinsp_evt_formatter required(&m_inspector, "%proc.name ip=%fd.sip end");
+	ASSERT_FALSE(required.tostring(evt, &output));
+	ASSERT_EQ(output, "init ip=");
+
+	sinsp_evt_formatter_cache cache(&m_inspector);
+	string format = "%evt.type %fd.name";
+	ASSERT_TRUE(cache.tostring(evt, format, &output));
+	ASSERT_EQ(output, "open /tmp/the_file");
+	ASSERT_TRUE(cache.tostring(evt, format, &output));
+	ASSERT_EQ(output, "open /tmp/the_file");
+}
@@ -86,3 +86,38 @@ TEST_F(sinsp_with_test_input, event_hostname)
 	ASSERT_EQ(0, success2);
 #endif
 }
+
+TEST_F(sinsp_with_test_input, event_scap_batch)
+{
+	add_default_init_thread();
+
+	m_inspector.set_scap_batch_size(4);
+	open_inspector();
+
+	/* Enqueue more events than the batch size before reading them */
+	const char *file_to_run = "/tmp/file_to_run";
+	for(int64_t fd = 3; fd < 8; fd++)
+	{
+		add_event(increasing_ts(), 1, PPME_SYSCALL_OPEN_E, 3, file_to_run, 0, 0);
+		add_event(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, fd, file_to_run, 0, 0, 0, (uint64_t) 0);
+	}
+
+	/* Events are returned one by one and in order, and the state is updated after each of them */
+	uint64_t evtnum = 0;
+	for(int64_t fd = 3; fd < 8; fd++)
+	{
+		sinsp_evt *evt = next_event();
+		ASSERT_NE(evt, nullptr);
+		ASSERT_EQ(evt->get_type(), PPME_SYSCALL_OPEN_E);
+		ASSERT_EQ(evt->get_num(), ++evtnum);
+
+		evt = next_event();
+		ASSERT_NE(evt, nullptr);
+		ASSERT_EQ(evt->get_type(), PPME_SYSCALL_OPEN_X);
+		ASSERT_EQ(evt->get_num(), ++evtnum);
+		ASSERT_EQ(get_field_as_string(evt, "fd.num"), std::to_string(fd));
+		ASSERT_EQ(get_field_as_string(evt, "fd.name"), file_to_run);
+	}
+
+	ASSERT_EQ(next_event(), nullptr);
+}
@@ -368,4 +368,31 @@ TEST_F(sinsp_with_test_input, bitmaskparams)
 	const char *val_str = NULL;
 	evt->get_param_as_str(2, &val_str);
 	ASSERT_STREQ(val_str, "O_RDONLY|O_CLOEXEC");
-}
\ No newline at end of file
+}
+
+/* Params are decoded on demand, accessible both by index and by name,
+ * and a cloned event decodes them again from its own copy of the event.
+ */
+TEST_F(sinsp_with_test_input, lazy_params)
+{
+	add_default_init_thread();
+
+	open_inspector();
+	sinsp_evt* evt = NULL;
+
+	int64_t dirfd = 0;
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPENAT_E, 4, dirfd, "/tmp/foo", PPM_O_RDONLY, 0);
+
+	ASSERT_EQ(evt->get_num_params(), 4);
+	ASSERT_STREQ(evt->get_param(1)->m_val, "/tmp/foo");
+	ASSERT_EQ(evt->get_param_value_raw("name"), evt->get_param(1));
+	ASSERT_EQ(evt->get_param_value_raw("not-a-param"), nullptr);
+	ASSERT_THROW(evt->get_param(4), std::out_of_range);
+
+	sinsp_evt clone;
+	ASSERT_TRUE(sinsp_evt::clone_event(clone, *evt));
+	sinsp_evt_param* param = clone.get_param(1);
+	ASSERT_STREQ(param->m_val, "/tmp/foo");
+	ASSERT_NE(param->m_val, evt->get_param(1)->m_val);
+	ASSERT_EQ(*(uint32_t *)clone.get_param(2)->m_val, PPM_O_RDONLY);
+}
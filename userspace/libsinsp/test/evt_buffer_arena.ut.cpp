@@ -0,0 +1,135 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "evt_buffer_arena.h"
+#include "sinsp_with_test_input.h"
+
+using libsinsp::evt_buffer_arena;
+
+TEST(evt_buffer_arena, size_classes)
+{
+	evt_buffer_arena arena;
+
+	uint8_t* small = arena.reserve(26);
+	uint8_t* medium = arena.reserve(129);
+	uint8_t* large = arena.reserve(SP_EVT_BUF_SIZE);
+	ASSERT_NE(small, nullptr);
+	ASSERT_NE(medium, nullptr);
+	ASSERT_NE(large, nullptr);
+	ASSERT_EQ(arena.reserve(SP_EVT_BUF_SIZE + 1), nullptr);
+
+	ASSERT_EQ(evt_buffer_arena::capacity(small), 128);
+	ASSERT_EQ(evt_buffer_arena::capacity(medium), 256);
+	ASSERT_EQ(evt_buffer_arena::capacity(large), SP_EVT_BUF_SIZE);
+	memset(large, 0xff, SP_EVT_BUF_SIZE);
+
+	auto stats = arena.get_stats();
+	ASSERT_EQ(stats.m_slabs, 3);
+	ASSERT_EQ(stats.m_reserved_bytes, 3 * evt_buffer_arena::SLAB_SIZE);
+	ASSERT_EQ(stats.m_used_chunks, 3);
+	ASSERT_EQ(stats.m_used_bytes, 128 + 256 + SP_EVT_BUF_SIZE);
+	ASSERT_EQ(stats.m_class_used_chunks[0], 1);
+	ASSERT_EQ(stats.m_class_used_chunks[1], 1);
+	ASSERT_EQ(stats.m_class_used_chunks[evt_buffer_arena::NUM_CLASSES - 1], 1);
+
+	evt_buffer_arena::release(small);
+	evt_buffer_arena::release(medium);
+	evt_buffer_arena::release(large);
+	stats = arena.get_stats();
+	ASSERT_EQ(stats.m_used_chunks, 0);
+	ASSERT_EQ(stats.m_used_bytes, 0);
+	// one empty slab per class is kept around
+	ASSERT_EQ(stats.m_slabs, 3);
+
+	// released chunks are reused
+	uint8_t* reused = arena.reserve(100);
+	ASSERT_EQ(reused, small);
+	evt_buffer_arena::release(reused);
+}
+
+TEST(evt_buffer_arena, many_slabs)
+{
+	evt_buffer_arena arena;
+	std::vector<uint8_t*> chunks;
+	for(int i = 0; i < 1000; i++)
+	{
+		uint8_t* ptr = arena.reserve(SP_EVT_BUF_SIZE);
+		ASSERT_NE(ptr, nullptr);
+		memset(ptr, i & 0xff, SP_EVT_BUF_SIZE);
+		chunks.push_back(ptr);
+	}
+	for(int i = 0; i < 1000; i++)
+	{
+		ASSERT_EQ(chunks[i][0], i & 0xff);
+		ASSERT_EQ(chunks[i][SP_EVT_BUF_SIZE - 1], i & 0xff);
+	}
+
+	auto stats = arena.get_stats();
+	ASSERT_GT(stats.m_slabs, 1);
+	ASSERT_EQ(stats.m_used_chunks, 1000);
+
+	// free every other chunk, the slabs are reused before new ones are made
+	for(int i = 0; i < 1000; i += 2)
+	{
+		evt_buffer_arena::release(chunks[i]);
+	}
+	for(int i = 0; i < 1000; i += 2)
+	{
+		chunks[i] = arena.reserve(SP_EVT_BUF_SIZE);
+	}
+	ASSERT_EQ(arena.get_stats().m_slabs, stats.m_slabs);
+
+	for(auto ptr : chunks)
+	{
+		evt_buffer_arena::release(ptr);
+	}
+	stats = arena.get_stats();
+	ASSERT_EQ(stats.m_used_chunks, 0);
+	ASSERT_EQ(stats.m_slabs, 1);
+}
+
+TEST(evt_buffer_arena, release_after_arena)
+{
+	uint8_t* ptr;
+	{
+		evt_buffer_arena arena;
+		ptr = arena.reserve(64);
+		ASSERT_NE(ptr, nullptr);
+	}
+	// the slab is freed with its last chunk
+	ASSERT_EQ(evt_buffer_arena::capacity(ptr), 128);
+	evt_buffer_arena::release(ptr);
+}
+
+TEST_F(sinsp_with_test_input, stored_enter_events)
+{
+	add_default_init_thread();
+	open_inspector();
+
+	add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_E, 3, "/tmp/the_file", 0, 0);
+	auto stats = m_inspector.get_stored_evts_stats();
+	ASSERT_EQ(stats.m_used_chunks, 1);
+	ASSERT_EQ(stats.m_class_used_chunks[0], 1);
+
+	add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, (int64_t)3, "/tmp/the_file", 0, 0, 0, (uint64_t)0);
+	stats = m_inspector.get_stored_evts_stats();
+	ASSERT_EQ(stats.m_used_chunks, 0);
+}
@@ -0,0 +1,166 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <filter.h>
+#include <filterchecks.h>
+#include "sinsp_with_test_input.h"
+
+static std::vector<std::unique_ptr<sinsp_filter>> compile_filters(
+	sinsp* inspector,
+	const std::vector<std::string>& filters,
+	std::shared_ptr<sinsp_filter_cache> cache)
+{
+	std::vector<std::unique_ptr<sinsp_filter>> res;
+	for (const auto& f : filters)
+	{
+		sinsp_filter_compiler compiler(inspector, f);
+		compiler.set_cache(cache);
+		res.emplace_back(compiler.compile());
+	}
+	return res;
+}
+
+TEST_F(sinsp_with_test_input, filter_cache_shared_checks)
+{
+	add_default_init_thread();
+	open_inspector();
+
+	std::vector<std::string> filters = {
+		"proc.name = init and evt.type = open",
+		"proc.name = init",
+		"proc.name in (init, bash)",
+		"fd.name contains /tmp or fd.name endswith .txt",
+		"fd.name contains /tmp or fd.name endswith .txt",
+		"not proc.name = init",
+	};
+	auto cache = std::make_shared<sinsp_filter_cache>();
+	auto compiled = compile_filters(&m_inspector, filters, cache);
+
+	// identical fields and checks share their entries
+	ASSERT_EQ(cache->num_extraction_entries(), 3);
+	ASSERT_EQ(cache->num_eval_entries(), 4);
+
+	sinsp_evt* evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, (int64_t)3,
+					      "/tmp/the_file", (uint32_t)PPM_O_RDWR, (uint32_t)0, (uint32_t)5,
+					      (uint64_t)123);
+	std::vector<bool> expected = {true, true, true, true, true, false};
+	for (size_t i = 0; i < compiled.size(); i++)
+	{
+		ASSERT_EQ(compiled[i]->run(evt), expected[i]) << filters[i];
+	}
+
+	// the repeated "proc.name = init" and fd.name checks reuse the first result
+	auto& metrics = cache->metrics();
+	ASSERT_EQ(metrics.m_num_eval, 7);
+	ASSERT_EQ(metrics.m_num_eval_cache, 3);
+	ASSERT_GE(metrics.m_num_extract_cache, 1);
+
+	// the cached values are refreshed for each event, and the first filter
+	// is not evaluated at all because of its event types
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_INOTIFY_INIT1_X, 2, (int64_t)12, (uint16_t)32);
+	expected = {false, true, true, false, false, false};
+	for (size_t i = 0; i < compiled.size(); i++)
+	{
+		ASSERT_EQ(compiled[i]->run(evt), expected[i]) << filters[i];
+	}
+	ASSERT_EQ(metrics.m_num_eval, 12);
+	ASSERT_EQ(metrics.m_num_eval_cache, 5);
+
+	// the filters keep the cache alive
+	cache.reset();
+	ASSERT_TRUE(compiled[1]->run(evt));
+}
+
+TEST_F(sinsp_with_test_input, filter_cache_distinct_checks)
+{
+	add_default_init_thread();
+	open_inspector();
+
+	// the checks on the same field differ by operator or values
+	std::vector<std::string> filters = {
+		"proc.name = init",
+		"proc.name != init",
+		"proc.name = bash",
+		"proc.name in (init)",
+		"proc.name exists",
+		"fd.name contains /tmp or fd.name endswith .txt",
+		"fd.name endswith .txt or fd.name contains /tmp",
+	};
+	auto cache = std::make_shared<sinsp_filter_cache>();
+	auto compiled = compile_filters(&m_inspector, filters, cache);
+	ASSERT_EQ(cache->num_extraction_entries(), 2);
+	ASSERT_EQ(cache->num_eval_entries(), filters.size());
+
+	sinsp_evt* evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, (int64_t)3,
+					      "/tmp/the_file", (uint32_t)PPM_O_RDWR, (uint32_t)0, (uint32_t)5,
+					      (uint64_t)123);
+	std::vector<bool> expected = {true, false, false, true, true, true, true};
+	for (size_t i = 0; i < compiled.size(); i++)
+	{
+		ASSERT_EQ(compiled[i]->run(evt), expected[i]) << filters[i];
+	}
+	ASSERT_EQ(cache->metrics().m_num_eval_cache, 0);
+}
+
+TEST_F(sinsp_with_test_input, filter_cache_synthetic_events)
+{
+	add_default_init_thread();
+	open_inspector();
+
+	std::vector<std::string> filters = {
+		"evt.asynctype = first",
+		"evt.asynctype = first and evt.is_async = true",
+	};
+	auto cache = std::make_shared<sinsp_filter_cache>();
+	auto compiled = compile_filters(&m_inspector, filters, cache);
+
+	// two async events delivered one after the other
+	const char data[] = "data";
+	auto plugindata = scap_const_sized_buffer{data, sizeof(data)};
+	sinsp_evt* first = add_event_advance_ts(increasing_ts(), 1, PPME_ASYNCEVENT_E, 3, (uint32_t)0, "first", plugindata);
+	ASSERT_TRUE(compiled[0]->run(first));
+	ASSERT_TRUE(compiled[1]->run(first));
+	std::vector<char> first_raw((char*)first->m_pevt, (char*)first->m_pevt + first->m_pevt->len);
+
+	sinsp_evt* other = add_event_advance_ts(increasing_ts(), 1, PPME_ASYNCEVENT_E, 3, (uint32_t)0, "other", plugindata);
+	ASSERT_FALSE(compiled[0]->run(other));
+	ASSERT_FALSE(compiled[1]->run(other));
+	std::vector<char> other_raw((char*)other->m_pevt, (char*)other->m_pevt + other->m_pevt->len);
+	ASSERT_EQ(first_raw.size(), other_raw.size());
+
+	// synthetic events that are not delivered by next() all have number
+	// 0, and here they even reuse the same buffer, so they are not cached
+	sinsp_evt synthetic(&m_inspector);
+	synthetic.m_pevt_storage = new char[first_raw.size()];
+	synthetic.m_pevt = (scap_evt*)synthetic.m_pevt_storage;
+	for(int i = 0; i < 2; i++)
+	{
+		memcpy(synthetic.m_pevt_storage, first_raw.data(), first_raw.size());
+		synthetic.init();
+		synthetic.m_evtnum = 0;
+		ASSERT_TRUE(compiled[0]->run(&synthetic));
+		ASSERT_TRUE(compiled[1]->run(&synthetic));
+
+		memcpy(synthetic.m_pevt_storage, other_raw.data(), other_raw.size());
+		synthetic.init();
+		synthetic.m_evtnum = 0;
+		ASSERT_FALSE(compiled[0]->run(&synthetic));
+		ASSERT_FALSE(compiled[1]->run(&synthetic));
+	}
+}
@@ -249,3 +249,50 @@ TEST(sinsp_filter_compiler, complex_filter)
 
 	test_filter_compile(factory, filter_str);
 }
+
+// A mock event that only exposes its type
+class mock_compiler_event: public gen_event
+{
+public:
+	explicit mock_compiler_event(uint16_t type): m_type(type) {}
+
+	uint64_t get_ts() const override { return 0; }
+	uint16_t get_source() const override { return ESRC_NONE; }
+	uint16_t get_type() const override { return m_type; }
+
+	uint16_t m_type;
+};
+
+TEST(sinsp_filter_compiler, event_type_dispatch)
+{
+	sinsp inspector;
+	std::shared_ptr<gen_event_filter_factory> factory(new mock_compiler_filter_factory(&inspector));
+
+	// filters that can match any event type have no dispatch table
+	sinsp_filter_compiler any_compiler(factory, "c.true=1 or evt.type=open");
+	std::unique_ptr<sinsp_filter> any_filter(any_compiler.compile());
+	ASSERT_TRUE(any_filter->get_event_type_table().empty());
+
+	sinsp_filter_compiler open_compiler(factory, "evt.type in (open, openat) and c.true=1");
+	std::unique_ptr<sinsp_filter> open_filter(open_compiler.compile());
+	auto& table = open_filter->get_event_type_table();
+	ASSERT_EQ(table.size(), PPM_EVENT_MAX);
+	ASSERT_TRUE(table[PPME_SYSCALL_OPEN_E]);
+	ASSERT_TRUE(table[PPME_SYSCALL_OPEN_X]);
+	ASSERT_TRUE(table[PPME_SYSCALL_OPENAT_2_X]);
+	ASSERT_FALSE(table[PPME_SYSCALL_CLOSE_E]);
+	ASSERT_FALSE(table[PPME_GENERIC_E]);
+	// async events carry their own evt.type and are always evaluated
+	ASSERT_TRUE(table[PPME_ASYNCEVENT_E]);
+
+	// the mock evt.type check is always false, so the filter is true
+	// for any event that is not rejected by the dispatch table
+	sinsp_filter_compiler not_close_compiler(factory, "c.true=1 and not evt.type=close");
+	std::unique_ptr<sinsp_filter> not_close_filter(not_close_compiler.compile());
+	mock_compiler_event open_evt(PPME_SYSCALL_OPEN_X);
+	mock_compiler_event close_evt(PPME_SYSCALL_CLOSE_X);
+	mock_compiler_event unknown_evt(PPM_EVENT_MAX + 1);
+	ASSERT_TRUE(not_close_filter->run(&open_evt));
+	ASSERT_FALSE(not_close_filter->run(&close_evt));
+	ASSERT_TRUE(not_close_filter->run(&unknown_evt));
+}
@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2021 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include <gtest/gtest.h>
+
+#include <filter_ruleset.h>
+#include <plugin.h>
+#include "sinsp_with_test_input.h"
+#include "plugins/test_plugins.h"
+
+static std::unique_ptr<sinsp_filter> compile_filter(sinsp* inspector, const std::string& str, std::shared_ptr<sinsp_filter_cache> cache = nullptr)
+{
+	sinsp_filter_compiler compiler(inspector, str);
+	compiler.set_cache(cache);
+	return std::unique_ptr<sinsp_filter>(compiler.compile());
+}
+
+TEST_F(sinsp_with_test_input, filter_ruleset_buckets)
+{
+	add_default_init_thread();
+	open_inspector();
+
+	sinsp_filter_ruleset ruleset;
+	auto cache = ruleset.cache();
+	ruleset.add(10, compile_filter(&m_inspector, "evt.type = open and fd.name contains /tmp", cache));
+	ruleset.add(20, compile_filter(&m_inspector, "evt.type in (open, close) and proc.name = init", cache));
+	ruleset.add(30, compile_filter(&m_inspector, "proc.name = init", cache));
+	ruleset.add(40, compile_filter(&m_inspector, "evt.type = close", cache));
+	ruleset.add(50, compile_filter(&m_inspector, "evt.type != open and proc.name = init", cache));
+	ASSERT_EQ(ruleset.size(), 5);
+	ASSERT_THROW(ruleset.add(10, compile_filter(&m_inspector, "proc.name = bash")), sinsp_exception);
+
+	// the filters not restricted to some event types are in all buckets
+	ASSERT_EQ(ruleset.num_filters(PPME_SYSCALL_OPEN_X), 3);
+	ASSERT_EQ(ruleset.num_filters(PPME_SYSCALL_CLOSE_E), 4);
+	ASSERT_EQ(ruleset.num_filters(PPME_SYSCALL_READ_X), 2);
+	ASSERT_EQ(ruleset.num_filters(PPME_ASYNCEVENT_E), 5);
+
+	std::vector<uint32_t> matched;
+	sinsp_evt* evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, (int64_t)3,
+					      "/tmp/the_file", (uint32_t)PPM_O_RDWR, (uint32_t)0, (uint32_t)5,
+					      (uint64_t)123);
+	ASSERT_TRUE(ruleset.run(evt, matched));
+	ASSERT_EQ(matched, std::vector<uint32_t>({10, 20, 30}));
+
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_CLOSE_E, 1, (int64_t)3);
+	ASSERT_TRUE(ruleset.run(evt, matched));
+	ASSERT_EQ(matched, std::vector<uint32_t>({20, 30, 40, 50}));
+
+	// the IDs of the removed filters are not matched anymore
+	ASSERT_TRUE(ruleset.remove(30));
+	ASSERT_FALSE(ruleset.remove(30));
+	ASSERT_EQ(ruleset.num_filters(PPME_SYSCALL_CLOSE_E), 3);
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_CLOSE_X, 1, (int64_t)0);
+	ASSERT_TRUE(ruleset.run(evt, matched));
+	ASSERT_EQ(matched, std::vector<uint32_t>({20, 40, 50}));
+
+	ruleset.clear();
+	ASSERT_EQ(ruleset.size(), 0);
+	ASSERT_FALSE(ruleset.run(evt, matched));
+	ASSERT_TRUE(matched.empty());
+}
+
+TEST_F(sinsp_with_test_input, filter_ruleset_plugin_field_absent)
+{
+	plugin_api api;
+	std::string err;
+	get_plugin_api_sample_syscall_extract(api);
+	auto pl = m_inspector.register_plugin(&api);
+	ASSERT_TRUE(pl->init("", err)) << err;
+	filter_check_list flist;
+	flist.add_filter_check(m_inspector.new_generic_filtercheck());
+	flist.add_filter_check(sinsp_plugin::new_filtercheck(pl));
+	add_default_init_thread();
+	open_inspector();
+
+	sinsp_filter_ruleset ruleset;
+	auto factory = std::make_shared<sinsp_filter_factory>(&m_inspector, flist);
+	for(const auto& f : std::vector<std::pair<uint32_t, std::string>>{
+		{10, "sample.is_open = 1"},
+		{20, "sample.is_open != 0"},
+		{30, "sample.proc_name = init"}})
+	{
+		sinsp_filter_compiler compiler(factory, f.second);
+		compiler.set_cache(ruleset.cache());
+		ruleset.add(f.first, std::unique_ptr<sinsp_filter>(compiler.compile()));
+	}
+
+	std::vector<uint32_t> matched;
+	sinsp_evt* evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, (uint64_t)3,
+					      "/tmp/the_file", PPM_O_RDWR, 0, 5, (uint64_t)123);
+	ASSERT_TRUE(ruleset.run(evt, matched));
+	ASSERT_EQ(matched, std::vector<uint32_t>({10, 20, 30}));
+
+	// the plugin doesn't extract anything from this event type, the values
+	// of the previous event must not be served from the shared cache
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_BY_HANDLE_AT_X, 4, 4, 5,
+				   PPM_O_RDWR, "/tmp/the_file.txt");
+	ASSERT_FALSE(ruleset.run(evt, matched));
+	ASSERT_TRUE(matched.empty());
+
+	// and the fields are extracted again for the next event
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_INOTIFY_INIT1_X, 2, (int64_t)12, (uint16_t)32);
+	ASSERT_TRUE(ruleset.run(evt, matched));
+	ASSERT_EQ(matched, std::vector<uint32_t>({30}));
+}
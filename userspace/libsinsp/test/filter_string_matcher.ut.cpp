@@ -0,0 +1,144 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <filter/string_matcher.h>
+#include <gtest/gtest.h>
+
+#include "filter_compiler.h"
+#include "sinsp_with_test_input.h"
+
+using namespace libsinsp::filter;
+
+TEST(filter_string_matcher, contains)
+{
+	string_matcher m;
+	m.add_contains("he");
+	m.add_contains("she");
+	m.add_contains("hers");
+	m.compile();
+	ASSERT_TRUE(m.match("ushers"));
+	ASSERT_TRUE(m.match("ahe"));
+	ASSERT_TRUE(m.match("hers"));
+	ASSERT_FALSE(m.match("HE"));
+	ASSERT_FALSE(m.match("h"));
+	ASSERT_FALSE(m.match(""));
+}
+
+TEST(filter_string_matcher, icontains)
+{
+	string_matcher m;
+	m.add_icontains("Bash");
+	m.add_contains("zsh");
+	m.compile();
+	ASSERT_TRUE(m.match("/bin/BASH"));
+	ASSERT_TRUE(m.match("bash"));
+	ASSERT_TRUE(m.match("zsh"));
+	ASSERT_FALSE(m.match("ZSH"));
+	ASSERT_FALSE(m.match("bas"));
+}
+
+TEST(filter_string_matcher, startswith_endswith)
+{
+	string_matcher m;
+	m.add_startswith("/etc/");
+	m.add_startswith("/usr/bin");
+	m.add_endswith(".conf");
+	m.add_endswith("rc");
+	m.compile();
+	ASSERT_TRUE(m.match("/etc/passwd"));
+	ASSERT_TRUE(m.match("/usr/bin"));
+	ASSERT_TRUE(m.match("/usr/binaries"));
+	ASSERT_TRUE(m.match("/home/user/.bashrc"));
+	ASSERT_TRUE(m.match("nginx.conf"));
+	ASSERT_FALSE(m.match("/etc"));
+	ASSERT_FALSE(m.match("/usr/sbin/init"));
+	ASSERT_FALSE(m.match("nginx.conf.bak"));
+	ASSERT_FALSE(m.match(""));
+}
+
+TEST(filter_string_matcher, glob)
+{
+	string_matcher m;
+	m.add_glob("/tmp/*");
+	m.add_glob("*.sh");
+	m.add_glob("*passwd*");
+	m.add_glob("exact");
+	m.add_glob("/dev/tty?");
+	m.add_glob("/proc/[0-9]*/mem");
+	m.compile();
+	ASSERT_TRUE(m.match("/tmp/a/b"));
+	ASSERT_TRUE(m.match("/home/run.sh"));
+	ASSERT_TRUE(m.match("/etc/passwd-"));
+	ASSERT_TRUE(m.match("exact"));
+	ASSERT_TRUE(m.match("/dev/tty1"));
+	ASSERT_TRUE(m.match("/proc/1/mem"));
+	ASSERT_FALSE(m.match("/tmp"));
+	ASSERT_FALSE(m.match("/home/run.sh.old"));
+	ASSERT_FALSE(m.match("exactly"));
+	ASSERT_FALSE(m.match("/dev/tty10"));
+	ASSERT_FALSE(m.match("/proc/self/mem"));
+}
+
+TEST(filter_string_matcher, empty_patterns)
+{
+	string_matcher any;
+	any.add_contains("a");
+	any.add_startswith("");
+	any.compile();
+	ASSERT_TRUE(any.match(""));
+	ASSERT_TRUE(any.match("b"));
+
+	string_matcher stars;
+	stars.add_glob("**");
+	stars.compile();
+	ASSERT_TRUE(stars.match(""));
+	ASSERT_TRUE(stars.match("b"));
+
+	string_matcher empty;
+	empty.add_glob("");
+	empty.add_endswith("x");
+	empty.compile();
+	ASSERT_TRUE(empty.match(""));
+	ASSERT_TRUE(empty.match("x"));
+	ASSERT_FALSE(empty.match("b"));
+}
+
+TEST_F(sinsp_with_test_input, filter_merged_string_checks)
+{
+	add_default_init_thread();
+	open_inspector();
+
+	sinsp_evt* evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, (int64_t)3,
+					      "/home/user/.bashrc", (uint32_t)PPM_O_RDWR, (uint32_t)0, (uint32_t)5,
+					      (uint64_t)123);
+
+	filter_run(evt, true, "fd.name startswith /etc or fd.name endswith rc");
+	filter_run(evt, true, "fd.name contains /tmp or fd.name icontains BASH");
+	filter_run(evt, true, "fd.name glob '/home/*' or fd.name glob '/root/*'");
+	filter_run(evt, true, "fd.name glob '/home/*/.?ashrc' or fd.name glob '/root/*'");
+	filter_run(evt, false, "fd.name startswith /etc or fd.name endswith .conf or fd.name contains /tmp");
+	filter_run(evt, false, "fd.name glob '/home/*.sh' or fd.name glob '/home/*/.?shrc'");
+
+	// merged checks mixed with other ones
+	filter_run(evt, true, "fd.name startswith /etc or proc.name = init or fd.name contains /tmp");
+	filter_run(evt, true, "fd.name startswith /etc or proc.name contains ini or fd.name contains /tmp or proc.name endswith it");
+	filter_run(evt, false, "fd.name startswith /etc or proc.name = bash or fd.name contains /tmp");
+	filter_run(evt, true, "proc.name = bash or (fd.name contains .bash and fd.name startswith /home) or fd.name = /etc/passwd");
+	filter_run(evt, false, "not (fd.name contains .bash or fd.name contains .zsh)");
+	filter_run(evt, true, "proc.name = init and (fd.name contains .bash or fd.name contains .zsh)");
+	filter_run(evt, false, "proc.name = bash and (fd.name contains .bash or fd.name contains .zsh)");
+}
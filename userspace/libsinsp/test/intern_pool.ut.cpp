@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include "intern_pool.h"
+
+static std::string parse(std::string_view raw)
+{
+	return std::string(raw);
+}
+
+TEST(intern_pool, same_key_same_value)
+{
+	libsinsp::intern_pool<std::string> pool;
+	int parsed = 0;
+	auto counting_parse = [&parsed](std::string_view raw)
+	{
+		parsed++;
+		return parse(raw);
+	};
+
+	auto a = pool.intern("hello", counting_parse);
+	auto b = pool.intern(std::string("hello"), counting_parse);
+	auto c = pool.intern("world", counting_parse);
+	ASSERT_EQ(a, b);
+	ASSERT_NE(a, c);
+	ASSERT_EQ(*a, "hello");
+	ASSERT_EQ(*c, "world");
+	ASSERT_EQ(parsed, 2);
+	ASSERT_EQ(pool.size(), 2);
+}
+
+TEST(intern_pool, released_values)
+{
+	libsinsp::intern_pool<std::string> pool;
+
+	std::weak_ptr<const std::string> weak = pool.intern("hello", parse);
+	ASSERT_TRUE(weak.expired());
+
+	/* The value is built again once it has been freed */
+	auto a = pool.intern("hello", parse);
+	ASSERT_EQ(*a, "hello");
+	ASSERT_EQ(pool.size(), 1);
+
+	/* The keys of freed values are eventually reclaimed */
+	for(int i = 0; i < 1000; i++)
+	{
+		pool.intern(std::to_string(i), parse);
+	}
+	ASSERT_LT(pool.size(), 1000);
+	ASSERT_EQ(pool.intern("hello", parse), a);
+}
@@ -243,6 +243,98 @@ TEST_F(sinsp_with_test_input, plugin_custom_source)
 	ASSERT_EQ(next_event(), nullptr); // EOF is expected
 }
 
+static uint32_t s_extract_calls = 0;
+static ss_plugin_rc (*s_extract_fields)(ss_plugin_t*, const ss_plugin_event_input*, const ss_plugin_field_extract_input*) = NULL;
+
+static ss_plugin_rc counting_extract_fields(ss_plugin_t* s, const ss_plugin_event_input* ev, const ss_plugin_field_extract_input* in)
+{
+	s_extract_calls++;
+	return s_extract_fields(s, ev, in);
+}
+
+// scenario: the fields of the same plugin that are in use should be
+// extracted with a single call to the plugin for each event
+TEST_F(sinsp_with_test_input, plugin_extract_batch)
+{
+	plugin_api api;
+	get_plugin_api_sample_syscall_extract(api);
+	s_extract_fields = api.extract_fields;
+	api.extract_fields = counting_extract_fields;
+
+	filter_check_list pl_flist;
+	auto pl = register_plugin_api(&m_inspector, api);
+	add_plugin_filterchecks(&m_inspector, pl, sinsp_syscall_event_source_name, pl_flist);
+	add_default_init_thread();
+	open_inspector();
+
+	std::vector<std::string> fields = {"sample.is_open", "sample.proc_name", "sample.tick", "sample.is_open"};
+	std::vector<std::unique_ptr<sinsp_filter_check>> checks;
+	auto add_check = [&](const std::string& f, bool needed_for_filtering)
+	{
+		checks.emplace_back(pl_flist.new_filter_check_from_fldname(f, &m_inspector, false));
+		checks.back()->parse_field_name(f.c_str(), true, needed_for_filtering);
+	};
+	for (const auto& f : fields)
+	{
+		add_check(f, true);
+	}
+
+	// the fields are added to the batch when they are parsed
+	s_extract_calls = 0;
+	auto evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_INOTIFY_INIT1_X, 2, (int64_t)12, (uint16_t)32);
+	ASSERT_EQ(std::string(checks[0]->tostring(evt)), "0");
+	ASSERT_EQ(std::string(checks[1]->tostring(evt)), "init");
+	ASSERT_EQ(std::string(checks[2]->tostring(evt)), "false");
+	ASSERT_EQ(std::string(checks[3]->tostring(evt)), "0");
+	ASSERT_EQ(s_extract_calls, 1);
+
+	// the values stay valid for the whole event, even if the plugin
+	// extracts other fields in the meantime
+	std::vector<extract_value_t> values;
+	ASSERT_TRUE(checks[1]->extract(evt, values));
+	ASSERT_EQ(values.size(), 1);
+	const char* proc_name = (const char*) values[0].ptr;
+	add_check("sample.proc_name", false);
+	ASSERT_EQ(std::string(checks[4]->tostring(evt)), "init");
+	add_check("sample.tick", false);
+	ASSERT_EQ(std::string(checks[5]->tostring(evt)), "false");
+	ASSERT_EQ(std::string(checks[4]->tostring(evt)), "init");
+	ASSERT_EQ(std::string(checks[1]->tostring(evt)), "init");
+	ASSERT_STREQ(proc_name, "init");
+	ASSERT_EQ(s_extract_calls, 3);
+
+	// the fields only used in outputs are extracted in their own batch
+	s_extract_calls = 0;
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, (uint64_t)3, "/tmp/the_file", PPM_O_RDWR, 0, 5, (uint64_t)123);
+	ASSERT_EQ(std::string(checks[0]->tostring(evt)), "1");
+	ASSERT_EQ(std::string(checks[2]->tostring(evt)), "false");
+	ASSERT_EQ(s_extract_calls, 1);
+	ASSERT_EQ(std::string(checks[4]->tostring(evt)), "init");
+	ASSERT_EQ(std::string(checks[5]->tostring(evt)), "false");
+	ASSERT_EQ(std::string(checks[3]->tostring(evt)), "1");
+	ASSERT_EQ(s_extract_calls, 2);
+	checks.resize(4);
+
+	// a field failing in the batch does not prevent extracting the others
+	add_check("sample.open_count", true);
+	s_extract_calls = 0;
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_OPEN_X, 6, (uint64_t)3, "/tmp/the_file", PPM_O_RDWR, 0, 5, (uint64_t)123);
+	ASSERT_EQ(std::string(checks[0]->tostring(evt)), "1");
+	ASSERT_EQ(std::string(checks[1]->tostring(evt)), "init");
+	ASSERT_EQ(checks[4]->tostring(evt), nullptr);
+	ASSERT_GT(s_extract_calls, 1);
+
+	// removing fields from the batch keeps the others valid
+	checks.pop_back();
+	checks.erase(checks.begin());
+	s_extract_calls = 0;
+	evt = add_event_advance_ts(increasing_ts(), 1, PPME_SYSCALL_INOTIFY_INIT1_X, 2, (int64_t)12, (uint16_t)32);
+	ASSERT_EQ(std::string(checks[0]->tostring(evt)), "init");
+	ASSERT_EQ(std::string(checks[1]->tostring(evt)), "false");
+	ASSERT_EQ(std::string(checks[2]->tostring(evt)), "0");
+	ASSERT_EQ(s_extract_calls, 1);
+}
+
 TEST(sinsp_plugin, plugin_extract_compatibility)
 {
 	std::string tmp;
@@ -408,7 +500,16 @@ TEST_F(sinsp_with_test_input, plugin_syscall_async)
 	sinsp_evt *evt = NULL;
 	int32_t rc = SCAP_SUCCESS;
 	uint64_t last_ts = 0;
+	// the queue of the async events is only created when the plugin is opened
+	// with the capacity rounded up to a power of two, which can't change
+	// once the queue exists
+	ASSERT_EQ(m_inspector.get_async_evts_stats().m_capacity, 0);
+	ASSERT_THROW(m_inspector.set_async_events_queue_capacity(0), sinsp_exception);
+	ASSERT_THROW(m_inspector.set_async_events_queue_capacity(SIZE_MAX), sinsp_exception);
+	m_inspector.set_async_events_queue_capacity(12);
 	m_inspector.open_nodriver();
+	ASSERT_EQ(m_inspector.get_async_evts_stats().m_capacity, 16);
+	ASSERT_THROW(m_inspector.set_async_events_queue_capacity(32), sinsp_exception);
 	while (rc == SCAP_SUCCESS && cycles < max_cycles && count < max_count)
 	{
 		cycles++;
@@ -441,6 +542,12 @@ TEST_F(sinsp_with_test_input, plugin_syscall_async)
 	}
 	m_inspector.close();
 	ASSERT_EQ(count, max_count);
+
+	// the async events went through the queue, and none was dropped
+	auto stats = m_inspector.get_async_evts_stats();
+	ASSERT_EQ(stats.m_pushed, max_count);
+	ASSERT_EQ(stats.m_popped, max_count);
+	ASSERT_EQ(stats.m_dropped, 0);
 }
 #endif // !defined(__EMSCRIPTEN__)
 
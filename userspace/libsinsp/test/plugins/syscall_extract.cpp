@@ -34,9 +34,11 @@ limitations under the License.
 typedef struct plugin_state
 {
     std::string lasterr;
-    uint64_t u64storage;
-    std::string strstorage;
-    const char* strptrstorage;
+    // one storage per field, because the values of all the fields extracted
+    // in a single call must stay valid until the next call
+    uint64_t u64storage[5];
+    std::string strstorage[5];
+    const char* strptrstorage[5];
     ss_plugin_table_t* thread_table;
     ss_plugin_table_field_t* thread_comm_field;
     ss_plugin_table_field_t* thread_opencount_field;
@@ -210,11 +212,12 @@ static ss_plugin_rc plugin_extract_fields(ss_plugin_t *s, const ss_plugin_event_
     plugin_state *ps = (plugin_state *) s;
     for (uint32_t i = 0; i < in->num_fields; i++)
     {
-        switch(in->fields[i].field_id)
+        uint32_t id = in->fields[i].field_id;
+        switch(id)
         {
             case 0: // test.is_open
-                ps->u64storage = evt_type_is_open(ev->evt->type);
-                in->fields[i].res.u64 = &ps->u64storage;
+                ps->u64storage[id] = evt_type_is_open(ev->evt->type);
+                in->fields[i].res.u64 = &ps->u64storage[id];
                 in->fields[i].res_len = 1;
                 break;
             case 1: // sample.open_count
@@ -239,8 +242,8 @@ static ss_plugin_rc plugin_extract_fields(ss_plugin_t *s, const ss_plugin_event_
                     in->table_reader_ext->release_table_entry(ps->thread_table, thread);
                     return SS_PLUGIN_FAILURE;
                 }
-                ps->u64storage = tmp.u64;
-                in->fields[i].res.u64 = &ps->u64storage;
+                ps->u64storage[id] = tmp.u64;
+                in->fields[i].res.u64 = &ps->u64storage[id];
                 in->fields[i].res_len = 1;
                 in->table_reader_ext->release_table_entry(ps->thread_table, thread);
                 break;
@@ -274,10 +277,10 @@ static ss_plugin_rc plugin_extract_fields(ss_plugin_t *s, const ss_plugin_event_
                 if (!evtcount)
                 {
                     // stubbing the counter to 0 if no entry exists
-                    ps->u64storage = 0;
-                    in->fields[i].res.u64 = &ps->u64storage;
+                    ps->u64storage[id] = 0;
+                    in->fields[i].res.u64 = &ps->u64storage[id];
                     in->fields[i].res_len = 1;
-                    return SS_PLUGIN_SUCCESS;
+                    break;
                 }
                 rc = in->table_reader.read_entry_field(ps->evtcount_table, evtcount, ps->evtcount_count_field, &tmp);
                 if (rc != SS_PLUGIN_SUCCESS)
@@ -287,8 +290,8 @@ static ss_plugin_rc plugin_extract_fields(ss_plugin_t *s, const ss_plugin_event_
                     in->table_reader_ext->release_table_entry(ps->evtcount_table, evtcount);
                     return SS_PLUGIN_FAILURE;
                 }
-                ps->u64storage = tmp.u64;
-                in->fields[i].res.u64 = &ps->u64storage;
+                ps->u64storage[id] = tmp.u64;
+                in->fields[i].res.u64 = &ps->u64storage[id];
                 in->fields[i].res_len = 1;
                 in->table_reader_ext->release_table_entry(ps->evtcount_table, evtcount);
                 break;
@@ -309,9 +312,9 @@ static ss_plugin_rc plugin_extract_fields(ss_plugin_t *s, const ss_plugin_event_
                     in->table_reader_ext->release_table_entry(ps->thread_table, thread);
                     return SS_PLUGIN_FAILURE;
                 }
-                ps->strstorage = std::string(tmp.str);
-                ps->strptrstorage = ps->strstorage.c_str();
-                in->fields[i].res.str = &ps->strptrstorage;
+                ps->strstorage[id] = std::string(tmp.str);
+                ps->strptrstorage[id] = ps->strstorage[id].c_str();
+                in->fields[i].res.str = &ps->strptrstorage[id];
                 in->fields[i].res_len = 1;
                 in->table_reader_ext->release_table_entry(ps->thread_table, thread);
                 break;
@@ -319,14 +322,14 @@ static ss_plugin_rc plugin_extract_fields(ss_plugin_t *s, const ss_plugin_event_
                 if (ev->evt->type == PPME_ASYNCEVENT_E
                     && strcmp("sampleticker", get_async_event_name(ev->evt)) == 0)
                 {
-                    ps->strstorage = "true";
+                    ps->strstorage[id] = "true";
                 }
                 else
                 {
-                    ps->strstorage = "false";
+                    ps->strstorage[id] = "false";
                 }
-                ps->strptrstorage = ps->strstorage.c_str();
-                in->fields[i].res.str = &ps->strptrstorage;
+                ps->strptrstorage[id] = ps->strstorage[id].c_str();
+                in->fields[i].res.str = &ps->strptrstorage[id];
                 in->fields[i].res_len = 1;
                 break;
             default:
@@ -18,10 +18,244 @@ limitations under the License.
 #include "sinsp.h"
 
 #include <gtest/gtest.h>
+#include <fstream>
 
 using namespace std;
 
 #ifdef __x86_64__
+static std::vector<std::pair<uint64_t, uint16_t>> read_all_events(const std::string& filename, uint64_t* nthreads)
+{
+	std::vector<std::pair<uint64_t, uint16_t>> res;
+	sinsp inspector;
+	inspector.open_savefile(filename);
+	*nthreads = inspector.m_thread_manager->get_thread_count();
+	sinsp_evt* evt = NULL;
+	int32_t rc;
+	while((rc = inspector.next(&evt)) != SCAP_EOF)
+	{
+		if(rc == SCAP_SUCCESS)
+		{
+			res.push_back({evt->get_ts(), evt->get_type()});
+		}
+	}
+	return res;
+}
+
+static void dump_sample(const std::string& filename, compression_mode compress, uint64_t index_interval_ns = 0)
+{
+	sinsp inspector;
+	inspector.open_savefile(RESOURCE_DIR "/sample.scap");
+	sinsp_dumper dumper;
+	dumper.open(&inspector, filename, compress, true);
+	if(index_interval_ns > 0)
+	{
+		dumper.enable_time_index(index_interval_ns);
+	}
+	sinsp_evt* evt = NULL;
+	while(inspector.next(&evt) != SCAP_EOF)
+	{
+		if(evt != NULL)
+		{
+			dumper.dump(evt);
+		}
+	}
+	dumper.close();
+}
+
+// Dumps sample.scap with the given compression, and checks that the
+// resulting file reads back the same as an uncompressed dump
+static void check_dump_compression(compression_mode compress)
+{
+	std::string filename = "savefile_compression_" + std::to_string(compress) + ".scap";
+	std::string plain_filename = "savefile_compression_none.scap";
+	try
+	{
+		dump_sample(filename, compress);
+	}
+	catch(const sinsp_exception& e)
+	{
+		ASSERT_NE(std::string(e.what()).find("not supported by this build"), std::string::npos) << e.what();
+		GTEST_SKIP() << e.what();
+	}
+	dump_sample(plain_filename, SCAP_COMPRESSION_NONE);
+
+	uint64_t expected_nthreads = 0;
+	uint64_t nthreads = 0;
+	auto expected = read_all_events(plain_filename, &expected_nthreads);
+	auto actual = read_all_events(filename, &nthreads);
+	ASSERT_GT(expected.size(), 0);
+	ASSERT_EQ(actual, expected);
+	ASSERT_EQ(nthreads, expected_nthreads);
+
+	remove(filename.c_str());
+	remove(plain_filename.c_str());
+}
+
+TEST(savefile, dump_compression_lz4)
+{
+	check_dump_compression(SCAP_COMPRESSION_LZ4);
+}
+
+TEST(savefile, dump_compression_zstd)
+{
+	check_dump_compression(SCAP_COMPRESSION_ZSTD);
+}
+
+// Seeks to several timestamps of the given file, and checks that reading
+// resumes from the first event at or after each of them
+static void check_seek_ts(const std::string& filename, const std::vector<std::pair<uint64_t, uint16_t>>& events)
+{
+	std::vector<uint64_t> targets = {
+		0,
+		events[events.size() / 2].first,
+		events[events.size() / 3].first + 1,
+		events[10].first,
+		events.back().first,
+		events.back().first + 1,
+	};
+
+	// event numbers also count the state events at the beginning of the file
+	sinsp inspector;
+	inspector.open_savefile(filename);
+	sinsp_evt* evt = NULL;
+	ASSERT_EQ(inspector.next(&evt), SCAP_SUCCESS);
+	uint64_t first_num = evt->get_num();
+
+	for(uint64_t target : targets)
+	{
+		size_t expected = 0;
+		while(expected < events.size() && events[expected].first < target)
+		{
+			expected++;
+		}
+
+		inspector.seek_ts(target);
+		for(size_t i = expected; i < expected + 5 && i < events.size(); i++)
+		{
+			ASSERT_EQ(inspector.next(&evt), SCAP_SUCCESS);
+			ASSERT_EQ(evt->get_ts(), events[i].first) << "seeking to " << target;
+			ASSERT_EQ(evt->get_type(), events[i].second);
+			ASSERT_EQ(evt->get_num(), first_num + i);
+		}
+		if(expected == events.size())
+		{
+			ASSERT_EQ(inspector.next(&evt), SCAP_EOF);
+		}
+	}
+}
+
+TEST(savefile, seek_ts)
+{
+	std::string filename = "savefile_seek_ts.scap";
+	std::string indexed_filename = "savefile_seek_ts_indexed.scap";
+	std::string compressed_filename = "savefile_seek_ts_lz4.scap";
+	dump_sample(filename, SCAP_COMPRESSION_NONE);
+	dump_sample(indexed_filename, SCAP_COMPRESSION_NONE, 1000000);
+
+	uint64_t nthreads = 0;
+	auto events = read_all_events(filename, &nthreads);
+	ASSERT_GT(events.size(), 10);
+	ASSERT_EQ(read_all_events(indexed_filename, &nthreads), events);
+
+	check_seek_ts(filename, events);
+	check_seek_ts(indexed_filename, events);
+
+	// every index entry starts a new compressed block
+	bool has_lz4 = true;
+	try
+	{
+		dump_sample(compressed_filename, SCAP_COMPRESSION_LZ4, 1000000);
+	}
+	catch(const sinsp_exception& e)
+	{
+		has_lz4 = false;
+	}
+	if(has_lz4)
+	{
+		ASSERT_EQ(read_all_events(compressed_filename, &nthreads), events);
+		check_seek_ts(compressed_filename, events);
+		remove(compressed_filename.c_str());
+	}
+
+	// the index can't be written to gzip compressed files
+	sinsp inspector;
+	inspector.open_savefile(RESOURCE_DIR "/sample.scap");
+	sinsp_dumper dumper;
+	dumper.open(&inspector, compressed_filename, SCAP_COMPRESSION_GZIP, true);
+	ASSERT_THROW(dumper.enable_time_index(), sinsp_exception);
+	dumper.close();
+
+	remove(filename.c_str());
+	remove(indexed_filename.c_str());
+	remove(compressed_filename.c_str());
+}
+
+static void concat_files(const std::string& filename, const std::vector<std::string>& inputs)
+{
+	std::ofstream out(filename, std::ios::binary);
+	for(const auto& input : inputs)
+	{
+		std::ifstream in(input, std::ios::binary);
+		out << in.rdbuf();
+	}
+}
+
+// Dumps sample.scap with the given compression, returning false if it is
+// not supported by this build
+static bool dump_sample_if_supported(const std::string& filename, compression_mode compress, uint64_t index_interval_ns)
+{
+	try
+	{
+		dump_sample(filename, compress, index_interval_ns);
+	}
+	catch(const sinsp_exception&)
+	{
+		return false;
+	}
+	return true;
+}
+
+// The index block closes a file, but must not stop the reads of the files
+// merged after it, and each merged file can use a different compression
+TEST(savefile, concatenated_indexed)
+{
+	std::string indexed_filename = "savefile_concat_indexed.scap";
+	std::string lz4_filename = "savefile_concat_indexed_lz4.scap";
+	std::string zstd_filename = "savefile_concat_indexed_zstd.scap";
+	std::string merged_filename = "savefile_concat_merged.scap";
+	dump_sample(indexed_filename, SCAP_COMPRESSION_NONE, 1000000);
+
+	uint64_t nthreads = 0;
+	auto events = read_all_events(indexed_filename, &nthreads);
+	ASSERT_GT(events.size(), 0);
+	auto expected = events;
+	expected.insert(expected.end(), events.begin(), events.end());
+
+	concat_files(merged_filename, {indexed_filename, indexed_filename});
+	ASSERT_EQ(read_all_events(merged_filename, &nthreads), expected);
+
+	bool has_lz4 = dump_sample_if_supported(lz4_filename, SCAP_COMPRESSION_LZ4, 1000000);
+	bool has_zstd = dump_sample_if_supported(zstd_filename, SCAP_COMPRESSION_ZSTD, 1000000);
+	if(has_lz4)
+	{
+		concat_files(merged_filename, {lz4_filename, indexed_filename});
+		ASSERT_EQ(read_all_events(merged_filename, &nthreads), expected);
+
+		concat_files(merged_filename, {indexed_filename, lz4_filename});
+		ASSERT_EQ(read_all_events(merged_filename, &nthreads), expected);
+	}
+	if(has_lz4 && has_zstd)
+	{
+		concat_files(merged_filename, {lz4_filename, zstd_filename});
+		ASSERT_EQ(read_all_events(merged_filename, &nthreads), expected);
+	}
+
+	remove(indexed_filename.c_str());
+	remove(lz4_filename.c_str());
+	remove(zstd_filename.c_str());
+	remove(merged_filename.c_str());
+}
+
 TEST(savefile, proclist)
 {
 	sinsp inspector;
@@ -29,4 +263,38 @@ TEST(savefile, proclist)
 
 	ASSERT_EQ(inspector.m_thread_manager->get_thread_count(), 94);
 }
+
+TEST(savefile, prefetch_reader)
+{
+	std::vector<std::pair<uint64_t, uint16_t>> expected;
+	sinsp inspector;
+	inspector.open_savefile(RESOURCE_DIR "/sample.scap");
+	sinsp_evt* evt = NULL;
+	while(inspector.next(&evt) != SCAP_EOF)
+	{
+		if(evt != NULL)
+		{
+			expected.push_back({evt->get_ts(), evt->get_type()});
+		}
+	}
+	inspector.close();
+	ASSERT_GT(expected.size(), 0);
+
+	sinsp prefetch_inspector;
+	prefetch_inspector.set_savefile_prefetch_blocks(4);
+	prefetch_inspector.open_savefile(RESOURCE_DIR "/sample.scap");
+	ASSERT_EQ(prefetch_inspector.m_thread_manager->get_thread_count(), 94);
+	size_t i = 0;
+	while(prefetch_inspector.next(&evt) != SCAP_EOF)
+	{
+		if(evt != NULL)
+		{
+			ASSERT_LT(i, expected.size());
+			ASSERT_EQ(evt->get_ts(), expected[i].first);
+			ASSERT_EQ(evt->get_type(), expected[i].second);
+			i++;
+		}
+	}
+	ASSERT_EQ(i, expected.size());
+}
 #endif
\ No newline at end of file
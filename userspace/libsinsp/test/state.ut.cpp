@@ -223,6 +223,75 @@ TEST(dynamic_struct, defs_and_access)
     ASSERT_ANY_THROW(s.get_dynamic_field(acc_num2, tmp));
 }
 
+TEST(dynamic_struct, contiguous_fields)
+{
+    auto fields = std::make_shared<libsinsp::state::dynamic_struct::field_infos>();
+
+    struct sample_struct: public libsinsp::state::dynamic_struct
+    {
+    public:
+        sample_struct(const std::shared_ptr<field_infos>& i): dynamic_struct(i) { }
+    };
+
+    auto acc_u8 = fields->add_field<uint8_t>("u8").new_accessor<uint8_t>();
+    auto acc_str = fields->add_field<std::string>("str").new_accessor<std::string>();
+    auto acc_u64 = fields->add_field<uint64_t>("u64").new_accessor<uint64_t>();
+
+    // long strings are allocated, short ones are stored inline, and both
+    // must survive the block moving around
+    std::string long_str(100, 'x');
+    sample_struct s(fields);
+    s.set_dynamic_field(acc_u8, (uint8_t) 7);
+    s.set_dynamic_field(acc_str, long_str);
+    s.set_dynamic_field(acc_u64, (uint64_t) 42);
+
+    // fields defined after the struct was accessed grow its block
+    auto acc_str2 = fields->add_field<std::string>("str2").new_accessor<std::string>();
+    auto acc_u32 = fields->add_field<uint32_t>("u32").new_accessor<uint32_t>();
+    s.set_dynamic_field(acc_str2, std::string("short"));
+    s.set_dynamic_field(acc_u32, (uint32_t) 3);
+
+    uint8_t u8;
+    uint32_t u32;
+    uint64_t u64;
+    std::string str;
+    s.get_dynamic_field(acc_u8, u8);
+    s.get_dynamic_field(acc_str, str);
+    s.get_dynamic_field(acc_u64, u64);
+    ASSERT_EQ(u8, 7);
+    ASSERT_EQ(str, long_str);
+    ASSERT_EQ(u64, 42);
+
+    // copies are deep, and moves leave the source empty
+    sample_struct copy(s);
+    copy.set_dynamic_field(acc_str2, std::string("changed"));
+    s.get_dynamic_field(acc_str2, str);
+    ASSERT_EQ(str, "short");
+    copy.get_dynamic_field(acc_str, str);
+    ASSERT_EQ(str, long_str);
+    copy.get_dynamic_field(acc_u32, u32);
+    ASSERT_EQ(u32, 3);
+
+    sample_struct moved(std::move(copy));
+    moved.get_dynamic_field(acc_str2, str);
+    ASSERT_EQ(str, "changed");
+
+    sample_struct assigned(fields);
+    assigned.set_dynamic_field(acc_u64, (uint64_t) 1);
+    assigned = s;
+    assigned.get_dynamic_field(acc_u64, u64);
+    ASSERT_EQ(u64, 42);
+    assigned = std::move(moved);
+    assigned.get_dynamic_field(acc_str2, str);
+    ASSERT_EQ(str, "changed");
+
+    // a struct never accessed has no fields to copy
+    sample_struct empty(fields);
+    sample_struct empty_copy(empty);
+    empty_copy.get_dynamic_field(acc_u64, u64);
+    ASSERT_EQ(u64, 0);
+}
+
 TEST(table_registry, defs_and_access)
 {
     class sample_table: public libsinsp::state::table<uint64_t>
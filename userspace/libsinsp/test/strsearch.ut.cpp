@@ -0,0 +1,133 @@
+/*
+Copyright (C) 2023 The Falco Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <cstring>
+#include <string>
+
+#include <strsearch.h>
+
+using namespace libsinsp;
+
+// Byte by byte reference of strsearch::find and strsearch::ifind
+static const char* naive_find(const std::string& haystack, const std::string& needle, bool icase)
+{
+	for(size_t i = 0; i + needle.size() <= haystack.size(); i++)
+	{
+		size_t j = 0;
+		for(; j < needle.size(); j++)
+		{
+			char a = haystack[i + j];
+			char b = needle[j];
+			if(icase && a >= 'A' && a <= 'Z')
+			{
+				a += 'a' - 'A';
+			}
+			if(icase && b >= 'A' && b <= 'Z')
+			{
+				b += 'a' - 'A';
+			}
+			if(a != b)
+			{
+				break;
+			}
+		}
+		if(j == needle.size())
+		{
+			return haystack.data() + i;
+		}
+	}
+	return NULL;
+}
+
+static void check_find(const std::string& haystack, const std::string& needle)
+{
+	ASSERT_EQ(strsearch::find(haystack.data(), haystack.size(), needle.data(), needle.size()),
+		  naive_find(haystack, needle, false))
+		<< "'" << needle << "' in '" << haystack << "'";
+	ASSERT_EQ(strsearch::ifind(haystack.data(), haystack.size(), needle.data(), needle.size()),
+		  naive_find(haystack, needle, true))
+		<< "'" << needle << "' in '" << haystack << "' ignoring case";
+}
+
+TEST(strsearch, basic)
+{
+	ASSERT_NE(strsearch::implementation(), nullptr);
+
+	check_find("", "");
+	check_find("abc", "");
+	check_find("", "a");
+	check_find("ab", "abc");
+	check_find("abc", "abc");
+	check_find("xabc", "abc");
+	check_find("xabcx", "ABC");
+	check_find("/usr/bin/BASH", "bash");
+	check_find("/usr/bin/bash", "zsh");
+	check_find("a-b[c]d", "[C]");
+	check_find("\xc3\xa9t\xc3\xa9", "\xc3\xa9");
+	check_find("\xc3\xa9t\xc3\xa9", "\xc3\x89");
+}
+
+TEST(strsearch, vector_boundaries)
+{
+	// the matches fall at every position of haystacks that are longer and
+	// shorter than the vector blocks, including the overlapping last block
+	for(size_t len = 1; len <= 100; len++)
+	{
+		for(size_t needle_len = 1; needle_len <= 5 && needle_len <= len; needle_len++)
+		{
+			for(size_t pos = 0; pos + needle_len <= len; pos++)
+			{
+				std::string haystack(len, 'a');
+				std::string needle(needle_len, 'B');
+				needle[0] = 'c';
+				haystack.replace(pos, needle_len, needle);
+				check_find(haystack, needle);
+				check_find(haystack, "cB");
+				check_find(haystack, "CBB");
+				check_find(haystack, "aac");
+
+				// false candidates, with the right first and last bytes
+				std::string almost = needle;
+				if(needle_len > 2)
+				{
+					almost[1] = 'x';
+					check_find(haystack, almost);
+				}
+			}
+		}
+	}
+}
+
+TEST(strsearch, realistic)
+{
+	std::string cmdline = "/usr/bin/java -Xmx2g -Dlog4j.configurationFile=/etc/app/log4j2.xml "
+		"-cp /opt/app/lib/*:/opt/app/classes com.example.server.Main --port 8080";
+	check_find(cmdline, "--port");
+	check_find(cmdline, "-DLOG4J");
+	check_find(cmdline, "--password");
+	check_find(cmdline, "8080");
+	check_find(cmdline, "80800");
+
+	std::string path = "/var/lib/docker/overlay2/4f0c1e2b3a/merged/usr/lib/python3.11/site-packages/requests/adapters.py";
+	check_find(path, "site-packages");
+	check_find(path, "SITE-PACKAGES");
+	check_find(path, ".py");
+	check_find(path, "/etc/");
+}
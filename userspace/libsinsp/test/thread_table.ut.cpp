@@ -624,3 +624,59 @@ TEST_F(sinsp_with_test_input, THRD_TABLE_add_and_remove_many_children)
 	/* Only init process */
 	ASSERT_EQ(m_inspector.m_thread_manager->get_thread_count(), 1);
 }
+
+TEST_F(sinsp_with_test_input, THRD_TABLE_threadinfo_map_put_get_erase)
+{
+	threadinfo_map_t map;
+	ASSERT_EQ(map.get(1), nullptr);
+	ASSERT_EQ(map.get_ref(1), nullptr);
+	map.erase(1);
+
+	/* Sparse and negative tids, enough to trigger several rehashes */
+	const int64_t n = 10000;
+	for(int64_t i = 0; i < n; i++)
+	{
+		auto tinfo = m_inspector.build_threadinfo();
+		tinfo->m_tid = (i % 2 == 0) ? i * 4096 : -i;
+		map.put(std::shared_ptr<sinsp_threadinfo>(tinfo));
+	}
+	ASSERT_EQ(map.size(), (size_t)n);
+
+	/* Replacing an entry doesn't change the size */
+	auto replaced = std::shared_ptr<sinsp_threadinfo>(m_inspector.build_threadinfo());
+	replaced->m_tid = 0;
+	map.put(replaced);
+	ASSERT_EQ(map.size(), (size_t)n);
+	ASSERT_EQ(map.get(0), replaced.get());
+
+	/* Remove one entry every three and check that all the others can still be found */
+	for(int64_t i = 0; i < n; i += 3)
+	{
+		map.erase((i % 2 == 0) ? i * 4096 : -i);
+	}
+	int64_t expected = 0;
+	for(int64_t i = 0; i < n; i++)
+	{
+		int64_t tid = (i % 2 == 0) ? i * 4096 : -i;
+		if(i % 3 == 0)
+		{
+			ASSERT_EQ(map.get(tid), nullptr);
+		}
+		else
+		{
+			ASSERT_NE(map.get(tid), nullptr);
+			ASSERT_EQ(map.get(tid)->m_tid, tid);
+			ASSERT_EQ(map.get_ref(tid)->m_tid, tid);
+			expected++;
+		}
+	}
+	ASSERT_EQ(map.size(), (size_t)expected);
+
+	int64_t looped = 0;
+	map.loop([&](sinsp_threadinfo&) { looped++; return true; });
+	ASSERT_EQ(looped, expected);
+
+	map.clear();
+	ASSERT_EQ(map.size(), (size_t)0);
+	ASSERT_EQ(map.get(1), nullptr);
+}
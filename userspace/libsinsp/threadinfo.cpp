@@ -26,6 +26,7 @@ limitations under the License.
 #include "sinsp_int.h"
 #include "protodecoder.h"
 #include "tracers.h"
+#include "evt_buffer_arena.h"
 
 #ifdef HAS_ANALYZER
 #include "tracer_emitter.h"
@@ -43,13 +44,33 @@ static void copy_ipv6_address(uint32_t* dest, uint32_t* src)
 	dest[3] = src[3];
 }
 
+template<typename T>
+static const std::shared_ptr<const T>& empty_block()
+{
+	static const std::shared_ptr<const T> empty = std::make_shared<const T>();
+	return empty;
+}
+
+// Threads without an inspector have no pool to share their values with
+template<typename T, typename Parse>
+static std::shared_ptr<const T> intern_block(libsinsp::intern_pool<T>* pool, std::string_view raw, Parse parse)
+{
+	if(pool == nullptr)
+	{
+		return std::make_shared<const T>(parse(raw));
+	}
+	return pool->intern(raw, parse);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // sinsp_threadinfo implementation
 ///////////////////////////////////////////////////////////////////////////////
 
 sinsp_threadinfo::sinsp_threadinfo(sinsp* inspector, std::shared_ptr<libsinsp::state::dynamic_struct::field_infos> dyn_fields):
 	table_entry(dyn_fields),
-	m_cgroups(new cgroups_t),
+	m_args(empty_block<std::vector<std::string>>()),
+	m_env(empty_block<std::vector<std::string>>()),
+	m_cgroups(empty_block<cgroups_t>()),
 	m_tracer_parser(NULL),
 	m_inspector(inspector),
 	m_fdtable(inspector)
@@ -158,7 +179,8 @@ sinsp_threadinfo::~sinsp_threadinfo()
 {
 	if(m_lastevent_data)
 	{
-		free(m_lastevent_data);
+		// the parser might be gone, the buffer knows its slab
+		libsinsp::evt_buffer_arena::release(m_lastevent_data);
 	}
 
 	if(m_tracer_parser)
@@ -169,36 +191,34 @@ sinsp_threadinfo::~sinsp_threadinfo()
 
 void sinsp_threadinfo::fix_sockets_coming_from_proc()
 {
-	std::unordered_map<int64_t, sinsp_fdinfo_t>::iterator it;
-
-	for(it = m_fdtable.m_table.begin(); it != m_fdtable.m_table.end(); it++)
-	{
-		if(it->second.m_type == SCAP_FD_IPV4_SOCK)
+	m_fdtable.mutable_loop([this](int64_t fd, sinsp_fdinfo_t& fdi) {
+		if(fdi.m_type == SCAP_FD_IPV4_SOCK)
 		{
-			if(m_inspector->m_thread_manager->m_server_ports.find(it->second.m_sockinfo.m_ipv4info.m_fields.m_sport) !=
+			if(m_inspector->m_thread_manager->m_server_ports.find(fdi.m_sockinfo.m_ipv4info.m_fields.m_sport) !=
 				m_inspector->m_thread_manager->m_server_ports.end())
 			{
 				uint32_t tip;
 				uint16_t tport;
 
-				tip = it->second.m_sockinfo.m_ipv4info.m_fields.m_sip;
-				tport = it->second.m_sockinfo.m_ipv4info.m_fields.m_sport;
+				tip = fdi.m_sockinfo.m_ipv4info.m_fields.m_sip;
+				tport = fdi.m_sockinfo.m_ipv4info.m_fields.m_sport;
 
-				it->second.m_sockinfo.m_ipv4info.m_fields.m_sip = it->second.m_sockinfo.m_ipv4info.m_fields.m_dip;
-				it->second.m_sockinfo.m_ipv4info.m_fields.m_dip = tip;
-				it->second.m_sockinfo.m_ipv4info.m_fields.m_sport = it->second.m_sockinfo.m_ipv4info.m_fields.m_dport;
-				it->second.m_sockinfo.m_ipv4info.m_fields.m_dport = tport;
+				fdi.m_sockinfo.m_ipv4info.m_fields.m_sip = fdi.m_sockinfo.m_ipv4info.m_fields.m_dip;
+				fdi.m_sockinfo.m_ipv4info.m_fields.m_dip = tip;
+				fdi.m_sockinfo.m_ipv4info.m_fields.m_sport = fdi.m_sockinfo.m_ipv4info.m_fields.m_dport;
+				fdi.m_sockinfo.m_ipv4info.m_fields.m_dport = tport;
 
-				it->second.m_name = ipv4tuple_to_string(&it->second.m_sockinfo.m_ipv4info, m_inspector->m_hostname_and_port_resolution_enabled);
+				fdi.m_name = ipv4tuple_to_string(&fdi.m_sockinfo.m_ipv4info, m_inspector->m_hostname_and_port_resolution_enabled);
 
-				it->second.set_role_server();
+				fdi.set_role_server();
 			}
 			else
 			{
-				it->second.set_role_client();
+				fdi.set_role_client();
 			}
 		}
-	}
+		return true;
+	});
 }
 
 #define STR_AS_NUM_JAVA 0x6176616a
@@ -222,7 +242,7 @@ void sinsp_threadinfo::compute_program_hash()
 	//
 	// The program hash includes the arguments as well
 	//
-	for (auto arg = m_args.begin(); arg != m_args.end() && rem_len > 0; ++arg)
+	for (auto arg = m_args->begin(); arg != m_args->end() && rem_len > 0; ++arg)
 	{
 		if (arg->size() >= rem_len)
 		{
@@ -621,15 +641,14 @@ void sinsp_threadinfo::set_loginuser(uint32_t loginuid)
 	}
 }
 
-sinsp_threadinfo::cgroups_t& sinsp_threadinfo::cgroups() const
+const sinsp_threadinfo::cgroups_t& sinsp_threadinfo::cgroups() const
 {
 	if(m_cgroups)
 	{
 		return *m_cgroups;
 	}
 
-	static cgroups_t empty;
-	return empty;
+	return *empty_block<cgroups_t>();
 }
 
 std::string sinsp_threadinfo::get_comm() const
@@ -649,14 +668,18 @@ std::string sinsp_threadinfo::get_exepath() const
 
 void sinsp_threadinfo::set_args(const char* args, size_t len)
 {
-	m_args.clear();
-
-	size_t offset = 0;
-	while(offset < len)
+	auto pool = m_inspector && m_inspector->m_thread_manager ? &m_inspector->m_thread_manager->m_args_pool : nullptr;
+	m_args = intern_block(pool, std::string_view(args, len), [](std::string_view raw)
 	{
-		m_args.push_back(args + offset);
-		offset += m_args.back().length() + 1;
-	}
+		std::vector<std::string> res;
+		size_t offset = 0;
+		while(offset < raw.size())
+		{
+			res.emplace_back(raw.data() + offset);
+			offset += res.back().length() + 1;
+		}
+		return res;
+	});
 }
 
 void sinsp_threadinfo::set_env(const char* env, size_t len)
@@ -674,36 +697,35 @@ void sinsp_threadinfo::set_env(const char* env, size_t len)
 		}
 	}
 
-	m_env.clear();
-	size_t offset = 0;
-	while(offset < len)
+	auto pool = m_inspector && m_inspector->m_thread_manager ? &m_inspector->m_thread_manager->m_env_pool : nullptr;
+	m_env = intern_block(pool, std::string_view(env, len), [](std::string_view raw)
 	{
-		const char* left = env + offset;
-		// environment string may actually be shorter than indicated by len
-		// if the rest is empty, we bail out early
-		if(!strlen(left))
+		std::vector<std::string> res;
+		size_t offset = 0;
+		while(offset < raw.size())
 		{
-			size_t sz = len - offset;
-			void* zero = calloc(sz, sizeof(char));
-			if(zero == NULL)
+			const char* left = raw.data() + offset;
+			// environment string may actually be shorter than indicated by len
+			// if the rest is empty, we bail out early
+			if(!strlen(left))
 			{
-				throw sinsp_exception("memory allocation error in sinsp_threadinfo::set_env");
-			}
-			if(!memcmp(left, zero, sz))
-			{
-				free(zero);
-				return;
+				auto rest = raw.substr(offset);
+				if(std::all_of(rest.begin(), rest.end(), [](char c) { return c == '\0'; }))
+				{
+					break;
+				}
 			}
-			free(zero);
-		}
-		m_env.push_back(left);
+			res.emplace_back(left);
 
-		offset += m_env.back().length() + 1;
-	}
+			offset += res.back().length() + 1;
+		}
+		return res;
+	});
 }
 
 bool sinsp_threadinfo::set_env_from_proc() {
-	std::string environ_path = std::string(scap_get_host_root()) + "/proc/" + std::to_string(m_pid) + "/environ";
+	std::string host_root = m_inspector ? m_inspector->get_host_root() : scap_get_host_root();
+	std::string environ_path = host_root + "/proc/" + std::to_string(m_pid) + "/environ";
 
 	std::ifstream environment(environ_path);
 	if (!environment)
@@ -712,15 +734,24 @@ bool sinsp_threadinfo::set_env_from_proc() {
 		return false;
 	}
 
-	m_env.clear();
-	while (environment) {
-		std::string env;
-		getline(environment, env, '\0');
-		if (!env.empty())
+	std::string environ_block((std::istreambuf_iterator<char>(environment)), std::istreambuf_iterator<char>());
+	auto pool = m_inspector && m_inspector->m_thread_manager ? &m_inspector->m_thread_manager->m_proc_env_pool : nullptr;
+	m_env = intern_block(pool, environ_block, [](std::string_view raw)
+	{
+		// unlike the event params, empty strings are skipped here
+		std::vector<std::string> res;
+		size_t offset = 0;
+		while(offset < raw.size())
 		{
-			m_env.emplace_back(env);
+			size_t end = std::min(raw.find('\0', offset), raw.size());
+			if(end > offset)
+			{
+				res.emplace_back(raw.substr(offset, end - offset));
+			}
+			offset = end + 1;
 		}
-	}
+		return res;
+	});
 
 	return true;
 }
@@ -729,7 +760,7 @@ const std::vector<std::string>& sinsp_threadinfo::get_env()
 {
 	if(is_main_thread())
 	{
-		return m_env;
+		return *m_env;
 	}
 	else
 	{
@@ -743,7 +774,7 @@ const std::vector<std::string>& sinsp_threadinfo::get_env()
 			// it should never happen but provide a safe fallback just in case
 			// except during sinsp::scap_open() (see sinsp::get_thread()).
 			ASSERT(false);
-			return m_env;
+			return *m_env;
 		}
 	}
 }
@@ -770,19 +801,17 @@ std::string sinsp_threadinfo::get_env(const std::string& name)
 	return "";
 }
 
-void sinsp_threadinfo::set_cgroups(const char* cgroups, size_t len)
+// Parses a block of subsys=cgroup strings, returns false if it is malformed
+static bool parse_cgroups(std::string_view raw, sinsp_threadinfo::cgroups_t& res)
 {
-	decltype(m_cgroups) tmp_cgroups(new cgroups_t);
-
 	size_t offset = 0;
-	while(offset < len)
+	while(offset < raw.size())
 	{
-		const char* str = cgroups + offset;
+		const char* str = raw.data() + offset;
 		const char* sep = strrchr(str, '=');
 		if(sep == NULL)
 		{
-			ASSERT(false);
-			return;
+			return false;
 		}
 
 		std::string subsys(str, sep - str);
@@ -811,11 +840,31 @@ void sinsp_threadinfo::set_cgroups(const char* cgroups, size_t len)
 			subsys = "blkio";
 		}
 
-		tmp_cgroups->push_back(std::make_pair(subsys, cgroup));
+		res.push_back(std::make_pair(subsys, cgroup));
 		offset += subsys_length + 1 + cgroup.length() + 1;
 	}
+	return true;
+}
+
+void sinsp_threadinfo::set_cgroups(const char* cgroups, size_t len)
+{
+	bool valid = true;
+	auto pool = m_inspector && m_inspector->m_thread_manager ? &m_inspector->m_thread_manager->m_cgroups_pool : nullptr;
+	auto tmp_cgroups = intern_block(pool, std::string_view(cgroups, len), [&valid](std::string_view raw)
+	{
+		cgroups_t res;
+		valid = parse_cgroups(raw, res);
+		return res;
+	});
+
+	// a malformed block is never assigned, so it is freed right away
+	if(!valid)
+	{
+		ASSERT(false);
+		return;
+	}
 
-	m_cgroups.swap(tmp_cgroups);
+	m_cgroups = std::move(tmp_cgroups);
 }
 
 sinsp_threadinfo* sinsp_threadinfo::get_parent_thread()
@@ -866,8 +915,6 @@ bool sinsp_threadinfo::loop_fds(sinsp_fdtable::fdtable_visitor_t visitor)
 
 bool sinsp_threadinfo::is_bound_to_port(uint16_t number)
 {
-	std::unordered_map<int64_t, sinsp_fdinfo_t>::iterator it;
-
 	sinsp_fdtable* fdt = get_fd_table();
 	if(fdt == NULL)
 	{
@@ -875,31 +922,22 @@ bool sinsp_threadinfo::is_bound_to_port(uint16_t number)
 		return false;
 	}
 
-	for(it = fdt->m_table.begin(); it != fdt->m_table.end(); ++it)
-	{
-		if(it->second.m_type == SCAP_FD_IPV4_SOCK)
+	// the loop stops at the first matching fd
+	return !fdt->loop([number](int64_t fd, const sinsp_fdinfo_t& fdi) {
+		if(fdi.m_type == SCAP_FD_IPV4_SOCK)
 		{
-			if(it->second.m_sockinfo.m_ipv4info.m_fields.m_dport == number)
-			{
-				return true;
-			}
+			return fdi.m_sockinfo.m_ipv4info.m_fields.m_dport != number;
 		}
-		else if(it->second.m_type == SCAP_FD_IPV4_SERVSOCK)
+		else if(fdi.m_type == SCAP_FD_IPV4_SERVSOCK)
 		{
-			if(it->second.m_sockinfo.m_ipv4serverinfo.m_port == number)
-			{
-				return true;
-			}
+			return fdi.m_sockinfo.m_ipv4serverinfo.m_port != number;
 		}
-	}
-
-	return false;
+		return true;
+	});
 }
 
 bool sinsp_threadinfo::uses_client_port(uint16_t number)
 {
-	std::unordered_map<int64_t, sinsp_fdinfo_t>::iterator it;
-
 	sinsp_fdtable* fdt = get_fd_table();
 	if(fdt == NULL)
 	{
@@ -907,19 +945,11 @@ bool sinsp_threadinfo::uses_client_port(uint16_t number)
 		return false;
 	}
 
-	for(it = fdt->m_table.begin();
-		it != fdt->m_table.end(); ++it)
-	{
-		if(it->second.m_type == SCAP_FD_IPV4_SOCK)
-		{
-			if(it->second.m_sockinfo.m_ipv4info.m_fields.m_sport == number)
-			{
-				return true;
-			}
-		}
-	}
-
-	return false;
+	// the loop stops at the first matching fd
+	return !fdt->loop([number](int64_t fd, const sinsp_fdinfo_t& fdi) {
+		return fdi.m_type != SCAP_FD_IPV4_SOCK ||
+			fdi.m_sockinfo.m_ipv4info.m_fields.m_sport != number;
+	});
 }
 
 bool sinsp_threadinfo::is_lastevent_data_valid()
@@ -1178,7 +1208,7 @@ void sinsp_threadinfo::populate_cmdline(std::string &cmdline, const sinsp_thread
 {
 	cmdline = tinfo->get_comm();
 
-	for (const auto& arg : tinfo->m_args)
+	for (const auto& arg : tinfo->get_args())
 	{
 		cmdline += " ";
 		cmdline += arg;
@@ -1236,18 +1266,18 @@ std::string sinsp_threadinfo::get_path_for_dir_fd(int64_t dir_fd)
 
 size_t sinsp_threadinfo::args_len() const
 {
-	return strvec_len(m_args);
+	return strvec_len(*m_args);
 }
 
 size_t sinsp_threadinfo::env_len() const
 {
-	return strvec_len(m_env);
+	return strvec_len(*m_env);
 }
 
 void sinsp_threadinfo::args_to_iovec(struct iovec **iov, int *iovcnt,
 				     std::string &rem) const
 {
-	return strvec_to_iovec(m_args,
+	return strvec_to_iovec(*m_args,
 			       iov, iovcnt,
 			       rem);
 }
@@ -1255,7 +1285,7 @@ void sinsp_threadinfo::args_to_iovec(struct iovec **iov, int *iovcnt,
 void sinsp_threadinfo::env_to_iovec(struct iovec **iov, int *iovcnt,
 				    std::string &rem) const
 {
-	return strvec_to_iovec(m_env,
+	return strvec_to_iovec(*m_env,
 			       iov, iovcnt,
 			       rem);
 }
@@ -1690,27 +1720,25 @@ void sinsp_thread_manager::remove_main_thread_fdtable(sinsp_threadinfo* main_thr
 		return;
 	}
 
-	std::unordered_map<int64_t, sinsp_fdinfo_t>* fdtable = &(fd_table_ptr->m_table);
-
 	erase_fd_params eparams;
 	eparams.m_remove_from_table = false;
 	eparams.m_tinfo = main_thread;
 	eparams.m_ts = m_inspector->m_lastevent_ts;
 
-	for(auto fdit = fdtable->begin(); fdit != fdtable->end(); ++fdit)
-	{
-		eparams.m_fd = fdit->first;
+	fd_table_ptr->mutable_loop([&](int64_t fd, sinsp_fdinfo_t& fdinfo) {
+		eparams.m_fd = fd;
 
 		//
 		// The canceled fd should always be deleted immediately, so if it appears
 		// here it means we have a problem.
 		//
 		ASSERT(eparams.m_fd != CANCELED_FD_NUMBER);
-		eparams.m_fdinfo = &(fdit->second);
+		eparams.m_fdinfo = &fdinfo;
 
 		/* Here we are just calling the `on_erase` callback */
 		m_inspector->m_parser->erase_fd(&eparams);
-	}
+		return true;
+	});
 }
 
 void sinsp_thread_manager::remove_thread(int64_t tid)
@@ -1970,7 +1998,7 @@ void sinsp_thread_manager::dump_threads_to_file(scap_dumper_t* dumper)
 		int argscnt, envscnt, cgroupscnt;
 		std::string argsrem, envsrem, cgroupsrem;
 		uint32_t entrylen = 0;
-		auto cg = tinfo.cgroups();
+		const auto& cg = tinfo.cgroups();
 
 		if((sctinfo = scap_proc_alloc(m_inspector->m_h)) == NULL)
 		{
@@ -2042,34 +2070,36 @@ void sinsp_thread_manager::dump_threads_to_file(scap_dumper_t* dumper)
 				return false;
 			}
 
-			std::unordered_map<int64_t, sinsp_fdinfo_t>& fdtable = fd_table_ptr->m_table;
-
-			for(auto it = fdtable.begin(); it != fdtable.end(); ++it)
-			{
+			bool fds_added = fd_table_ptr->mutable_loop([&](int64_t fd, sinsp_fdinfo_t& fdinfo) {
 				//
 				// Allocate the scap fd info
 				//
 				scap_fdinfo* scfdinfo = (scap_fdinfo*)malloc(sizeof(scap_fdinfo));
 				if(scfdinfo == NULL)
 				{
-					scap_proc_free(m_inspector->m_h, sctinfo);
 					return false;
 				}
 
 				//
 				// Populate the fd info
 				//
-				scfdinfo->fd = it->first;
-				tinfo.fd_to_scap(scfdinfo, &it->second);
+				scfdinfo->fd = fd;
+				tinfo.fd_to_scap(scfdinfo, &fdinfo);
 
 				//
 				// Add the new fd to the scap table.
 				//
-				if(scap_fd_add(m_inspector->m_h, sctinfo, it->first, scfdinfo) != SCAP_SUCCESS)
+				if(scap_fd_add(m_inspector->m_h, sctinfo, fd, scfdinfo) != SCAP_SUCCESS)
 				{
 					scap_proc_free(m_inspector->m_h, sctinfo);
 					throw sinsp_exception("error calling scap_fd_add in sinsp_thread_manager::to_scap (" + std::string(scap_getlasterr(m_inspector->m_h)) + ")");
 				}
+				return true;
+			});
+			if(!fds_added)
+			{
+				scap_proc_free(m_inspector->m_h, sctinfo);
+				return false;
 			}
 		}
 
@@ -35,7 +35,9 @@ struct iovec {
 #include <functional>
 #include <memory>
 #include <set>
+#include <vector>
 #include "fdinfo.h"
+#include "intern_pool.h"
 #include "internal_metrics.h"
 #include "state/table.h"
 #include "thread_group_info.h"
@@ -98,6 +100,14 @@ public:
 	*/
 	std::string get_cwd();
 
+	/*!
+	  \brief Return the command line arguments of this thread.
+	*/
+	inline const std::vector<std::string>& get_args() const
+	{
+		return *m_args;
+	}
+
 	/*!
 	  \brief Return the values of all environment variables for the process
 	  containing this thread.
@@ -397,7 +407,7 @@ public:
 	void set_loginuser(uint32_t loginuid);
 
 	using cgroups_t = std::vector<std::pair<std::string, std::string>>;
-	cgroups_t& cgroups() const;
+	const cgroups_t& cgroups() const;
 
 	//
 	// Core state
@@ -413,9 +423,14 @@ public:
 	bool m_exe_writable;
 	bool m_exe_upper_layer; ///< True if the executable file belongs to upper layer in overlayfs
 	bool m_exe_from_memfd;	///< True if the executable is stored in fileless memory referenced by memfd
-	std::vector<std::string> m_args; ///< Command line arguments (e.g. "-d1")
-	std::vector<std::string> m_env; ///< Environment variables
-	std::unique_ptr<cgroups_t> m_cgroups; ///< subsystem-cgroup pairs
+	//
+	// Args, env and cgroups are immutable blocks interned by the thread
+	// manager, so that threads and processes with the same values share a
+	// single copy of them. They are replaced as a whole, never modified.
+	//
+	std::shared_ptr<const std::vector<std::string>> m_args; ///< Command line arguments (e.g. "-d1")
+	std::shared_ptr<const std::vector<std::string>> m_env; ///< Environment variables
+	std::shared_ptr<const cgroups_t> m_cgroups; ///< subsystem-cgroup pairs
 	std::string m_container_id; ///< heuristic-based container id
 	uint32_t m_flags; ///< The thread flags. See the PPM_CL_* declarations in ppm_events_public.h.
 	int64_t m_fdlimit;  ///< The maximum number of FDs this thread can open
@@ -636,6 +651,15 @@ VISIBILITY_PRIVATE
 
 /*@}*/
 
+//
+// Thread table keyed by tid. This is an open-addressing hash table with
+// linear probing: lookups only scan a contiguous array of (tid, pointer)
+// slots and never touch the shared_ptr control blocks, which are kept in
+// a parallel array and only accessed when a reference is requested.
+// Erased slots are refilled by shifting back the following entries of
+// the same probe sequence, so the table never accumulates tombstones.
+// As with any hash table, the table must not be modified while looping.
+//
 class threadinfo_map_t
 {
 public:
@@ -646,44 +670,94 @@ public:
 
 	inline void put(ptr_t tinfo)
 	{
-		m_threads[tinfo->m_tid] = tinfo;
+		if((m_size + 1) * 4 > m_slots.size() * 3)
+		{
+			rehash(m_slots.empty() ? INITIAL_CAPACITY : m_slots.size() * 2);
+		}
+
+		size_t pos = probe(tinfo->m_tid);
+		if(m_slots[pos].m_tinfo == nullptr)
+		{
+			m_size++;
+		}
+		m_slots[pos].m_tid = tinfo->m_tid;
+		m_slots[pos].m_tinfo = tinfo.get();
+		m_refs[pos] = std::move(tinfo);
 	}
 
 	inline sinsp_threadinfo* get(uint64_t tid)
 	{
-		auto it = m_threads.find(tid);
-		if (it == m_threads.end())
+		if(m_size == 0)
 		{
-			return  nullptr;
+			return nullptr;
 		}
-		return it->second.get();
+		return m_slots[probe(tid)].m_tinfo;
 	}
 
 	inline ptr_t get_ref(uint64_t tid)
 	{
-		auto it = m_threads.find(tid);
-		if (it == m_threads.end())
+		if(m_size == 0)
 		{
-			return  nullptr;
+			return nullptr;
+		}
+		size_t pos = probe(tid);
+		if(m_slots[pos].m_tinfo == nullptr)
+		{
+			return nullptr;
 		}
-		return it->second;
+		return m_refs[pos];
 	}
 
 	inline void erase(uint64_t tid)
 	{
-		m_threads.erase(tid);
+		if(m_size == 0)
+		{
+			return;
+		}
+
+		size_t pos = probe(tid);
+		if(m_slots[pos].m_tinfo == nullptr)
+		{
+			return;
+		}
+
+		// keep the reference alive until the table is consistent again,
+		// the threadinfo destructor might look into the table
+		ptr_t removed = std::move(m_refs[pos]);
+		size_t mask = m_slots.size() - 1;
+		size_t next = (pos + 1) & mask;
+		while(m_slots[next].m_tinfo != nullptr)
+		{
+			// move back the entries whose home slot is not
+			// between the hole and their current position
+			size_t home = hash(m_slots[next].m_tid) & mask;
+			if(((next - home) & mask) >= ((next - pos) & mask))
+			{
+				m_slots[pos] = m_slots[next];
+				m_refs[pos] = std::move(m_refs[next]);
+				pos = next;
+			}
+			next = (next + 1) & mask;
+		}
+		m_slots[pos].m_tinfo = nullptr;
+		m_refs[pos].reset();
+		m_size--;
 	}
 
 	inline void clear()
 	{
-		m_threads.clear();
+		// the threadinfos are released after the table is emptied
+		std::vector<ptr_t> refs;
+		refs.swap(m_refs);
+		m_slots.clear();
+		m_size = 0;
 	}
 
 	bool const_loop_shared_pointer(const_shared_ptr_visitor_t callback)
 	{
-		for (auto& it : m_threads)
+		for (size_t i = 0; i < m_slots.size(); i++)
 		{
-			if (!callback(it.second))
+			if (m_slots[i].m_tinfo != nullptr && !callback(m_refs[i]))
 			{
 				return false;
 			}
@@ -693,9 +767,9 @@ public:
 
 	bool const_loop(const_visitor_t callback) const
 	{
-		for (const auto& it : m_threads)
+		for (const auto& slot : m_slots)
 		{
-			if (!callback(*it.second.get()))
+			if (slot.m_tinfo != nullptr && !callback(*slot.m_tinfo))
 			{
 				return false;
 			}
@@ -705,9 +779,9 @@ public:
 
 	bool loop(visitor_t callback)
 	{
-		for (auto& it : m_threads)
+		for (const auto& slot : m_slots)
 		{
-			if (!callback(*it.second.get()))
+			if (slot.m_tinfo != nullptr && !callback(*slot.m_tinfo))
 			{
 				return false;
 			}
@@ -717,11 +791,58 @@ public:
 
 	inline size_t size() const
 	{
-		return m_threads.size();
+		return m_size;
 	}
 
 protected:
-	std::unordered_map<int64_t, ptr_t> m_threads;
+	static constexpr size_t INITIAL_CAPACITY = 64;
+
+	struct slot
+	{
+		int64_t m_tid;
+		sinsp_threadinfo* m_tinfo; // nullptr if the slot is empty
+	};
+
+	static inline size_t hash(int64_t tid)
+	{
+		// tids are mostly sequential, spread them with a fibonacci hash
+		uint64_t h = (uint64_t)tid * 0x9E3779B97F4A7C15ULL;
+		return (size_t)(h ^ (h >> 32));
+	}
+
+	// Returns the slot of tid, or the empty slot where it should be inserted.
+	// The table must not be empty.
+	inline size_t probe(int64_t tid) const
+	{
+		size_t mask = m_slots.size() - 1;
+		size_t pos = hash(tid) & mask;
+		while(m_slots[pos].m_tinfo != nullptr && m_slots[pos].m_tid != tid)
+		{
+			pos = (pos + 1) & mask;
+		}
+		return pos;
+	}
+
+	void rehash(size_t capacity)
+	{
+		std::vector<slot> old_slots(capacity, slot{0, nullptr});
+		std::vector<ptr_t> old_refs(capacity);
+		old_slots.swap(m_slots);
+		old_refs.swap(m_refs);
+		for(size_t i = 0; i < old_slots.size(); i++)
+		{
+			if(old_slots[i].m_tinfo != nullptr)
+			{
+				size_t pos = probe(old_slots[i].m_tid);
+				m_slots[pos] = old_slots[i];
+				m_refs[pos] = std::move(old_refs[i]);
+			}
+		}
+	}
+
+	std::vector<slot> m_slots;
+	std::vector<ptr_t> m_refs;
+	size_t m_size = 0;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -902,6 +1023,15 @@ VISIBILITY_PRIVATE
 	int32_t m_max_n_proc_lookups = -1;
 	int32_t m_max_n_proc_socket_lookups = -1;
 
+	// Shared storage of the threadinfo args, env and cgroups. The env read
+	// from /proc is parsed differently from the one of the events (empty
+	// strings are skipped), so the same bytes may give different values
+	// and each parser has its own pool.
+	libsinsp::intern_pool<std::vector<std::string>> m_args_pool;
+	libsinsp::intern_pool<std::vector<std::string>> m_env_pool;
+	libsinsp::intern_pool<std::vector<std::string>> m_proc_env_pool;
+	libsinsp::intern_pool<sinsp_threadinfo::cgroups_t> m_cgroups_pool;
+
 	INTERNAL_COUNTER(m_failed_lookups);
 	INTERNAL_COUNTER(m_cached_lookups);
 	INTERNAL_COUNTER(m_non_cached_lookups);
@@ -365,7 +365,9 @@ typedef struct ss_plugin_event_parse_input
 // the "err" argument, it will be filled with an error message string
 // in case the handler function returns SS_PLUGIN_FAILURE. The error string
 // has a max length of PLUGIN_MAX_ERRLEN (termination char included) and its
-// memory must be allocated and owned by the plugin.
+// memory must be allocated and owned by the plugin. The owner can queue
+// a bounded number of async events, and the handler returns SS_PLUGIN_FAILURE
+// without retaining the event if the queue is full.
 typedef ss_plugin_rc (*ss_plugin_async_event_handler_t)(ss_plugin_owner_t* o, const ss_plugin_event *evt, char* err);
 
 //